@@ -112,7 +112,8 @@ static int get_2bits(uint8_t *bits, json_object *json, int line_no)
     return 0;
 }
 
-static int get_asb(uint8_t *asb, json_object *json_frame, int line_no)
+static int get_asb(frame_t *fr, int offs, json_object *json_frame,
+        int line_no)
 {
     json_object *json_asb;
     if (!json_object_object_get_ex(json_frame, "asb", &json_asb)) {
@@ -120,10 +121,16 @@ static int get_asb(uint8_t *asb, json_object *json_frame, int line_no)
         return -1;
     }
 
-    return get_2bits(asb, json_asb, line_no);
+    uint8_t asb[2];
+    if (get_2bits(asb, json_asb, line_no)) {
+        return -1;
+    }
+    frame_set_bits(fr, offs, 2, (asb[0] & 1) | ((asb[1] & 1) << 1));
+
+    return 0;
 }
 
-static int get_fn(uint8_t *fn, json_object *json_frame, int line_no)
+static int get_fn(frame_t *fr, json_object *json_frame, int line_no)
 {
     json_object *json_fn;
     if (!json_object_object_get_ex(json_frame, "fn", &json_fn)) {
@@ -131,7 +138,13 @@ static int get_fn(uint8_t *fn, json_object *json_frame, int line_no)
         return -1;
     }
 
-    return get_2bits(fn, json_fn, line_no);
+    uint8_t fn[2];
+    if (get_2bits(fn, json_fn, line_no)) {
+        return -1;
+    }
+    frame_set_bits(fr, FRAME_DATA_FN, 2, (fn[0] & 1) | ((fn[1] & 1) << 1));
+
+    return 0;
 }
 
 static int process_data_frame(FILE *out, json_object *json_frame,
@@ -148,15 +161,15 @@ static int process_data_frame(FILE *out, json_object *json_frame,
     if (r) {
         return r;
     }
-    for (uint8_t i = 0; i < 64; ++i) {
-        fr.data.data[i+2] = (fr_data[i / 8] >> (i % 8)) & 0x01;
+    for (uint8_t i = 0; i < 8; ++i) {
+        frame_set_bits(&fr, FRAME_DATA_PAYLOAD + 8 * i, 8, fr_data[i]);
     }
 
-    if (get_fn(fr.data.data, json_frame, line_no)) {
+    if (get_fn(&fr, json_frame, line_no)) {
         return -1;
     }
 
-    if (get_asb(fr.data.asb, json_frame, line_no)) {
+    if (get_asb(&fr, FRAME_DATA_ASB, json_frame, line_no)) {
         return -1;
     }
 
@@ -182,14 +195,13 @@ static int process_voice_frame(FILE *out, json_object *json_frame,
     if (r) {
         return r;
     }
-    for (uint8_t i = 0; i < 20; ++i) {
-        fr.voice.voice1[i] = (fr_data[i / 8] >> (i % 8)) & 0x01;
-    }
-    for (uint8_t i = 20; i < 120; ++i) {
-        fr.voice.voice2[i - 20] = (fr_data[i / 8] >> (i % 8)) & 0x01;
+    for (uint8_t i = 0; i < 120; ++i) {
+        // voice1 (20 bits) is followed by voice2 (100 bits)
+        const int offs = (i < 20) ? FRAME_VOICE1 + i : FRAME_VOICE2 + i - 20;
+        frame_set_bits(&fr, offs, 1, (fr_data[i / 8] >> (i % 8)) & 0x01);
     }
 
-    if (get_asb(fr.voice.asb, json_frame, line_no)) {
+    if (get_asb(&fr, FRAME_VOICE_ASB, json_frame, line_no)) {
         return -1;
     }
 
@@ -1,4 +1,8 @@
+// for madvise()
+#define _DEFAULT_SOURCE
+
 #include <tetrapol/tetrapol.h>
+#include <tetrapol/engine.h>
 // TODO: should use only tetrapol.h, but hi-level interface not implemented yet
 #include <tetrapol/phys_ch.h>
 
@@ -6,11 +10,17 @@
 #include <poll.h>
 #include <signal.h>
 #include <getopt.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
+// size of mapped file slice passed to physical channel at once
+#define MMAP_CHUNK_LEN (64 * 1024)
+
 // set on SIGINT
 volatile static int do_exit = 0;
 
@@ -77,14 +87,108 @@ static int tetrapol_dump_loop(phys_ch_t *phys_ch, int fd)
     return ret;
 }
 
+/**
+  Decode regular file mapped into memory. Slices of mapping are passed to
+  physical channel directly, without copying into intermediate buffer.
+
+  @return 0 on success, -1 on error, 1 when input is not mappable file.
+  */
+static int tetrapol_dump_mmap(phys_ch_t *phys_ch, int fd)
+{
+    struct stat st;
+    if (fstat(fd, &st) || !S_ISREG(st.st_mode) || !st.st_size ||
+            (uintmax_t)st.st_size > SIZE_MAX) {
+        return 1;
+    }
+
+    const size_t size = st.st_size;
+    uint8_t *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        return 1;
+    }
+    madvise(data, size, MADV_SEQUENTIAL);
+
+    signal(SIGINT, sigint_handler);
+
+    int ret = 0;
+    size_t offs = 0;
+    while (ret == 0 && !do_exit && offs < size) {
+        const int len = (size - offs < MMAP_CHUNK_LEN) ?
+            size - offs : MMAP_CHUNK_LEN;
+        const int rsize = tetrapol_phys_ch_recv(phys_ch, data + offs, len);
+        if (rsize < 0) {
+            ret = rsize;
+            break;
+        }
+        offs += rsize;
+
+        ret = tetrapol_phys_ch_process(phys_ch);
+    }
+
+    munmap(data, size);
+
+    return ret;
+}
+
+static int engine_read(void *ctx, uint8_t *buf, int len)
+{
+    if (do_exit) {
+        return 0;
+    }
+
+    const int rsize = read(*(int *)ctx, buf, len);
+    if (rsize < 0 && do_exit) {
+        return 0;
+    }
+
+    return rsize;
+}
+
+/// decode multiple inputs in parallel, channel id is index of input
+static int tetrapol_dump_engine(const tetrapol_cfg_t *cfg, const int *infds,
+        int ninputs, int nworkers, int stats_period)
+{
+    tetrapol_engine_t *engine = tetrapol_engine_create(nworkers);
+    if (!engine) {
+        fprintf(stderr, "Failed to initialize TETRAPOL engine.");
+        return -1;
+    }
+
+    for (int i = 0; i < ninputs; ++i) {
+        if (tetrapol_engine_add_channel(engine, cfg, engine_read,
+                    (void *)&infds[i]) < 0) {
+            fprintf(stderr, "Failed to initialize TETRAPOL instance.");
+            tetrapol_engine_destroy(engine);
+            return -1;
+        }
+        tetrapol_set_stats_period(tetrapol_engine_get_tetrapol(engine, i),
+                stats_period);
+    }
+
+    signal(SIGINT, sigint_handler);
+    const int ret = tetrapol_engine_run(engine);
+    tetrapol_engine_destroy(engine);
+
+    return ret;
+}
+
 static void print_help(const char *prg_name)
 {
     fprintf(stderr, "Decode data from demodulated TETRAPOL channel.\n");
     fprintf(stderr, "Usage: %s [OPTIONS ...]\n", prg_name);
-    fprintf(stderr, "    -i <PATH>               input file with demodulated bits\n");
+    fprintf(stderr, "    -i <PATH>               input file with demodulated bits, can be used\n");
+    fprintf(stderr, "                            multiple times to decode channels in parallel,\n");
+    fprintf(stderr, "                            events are tagged with input index\n");
+    fprintf(stderr, "    -j <N>                  number of worker threads for multiple inputs\n");
+    fprintf(stderr, "                            (default is number of CPUs)\n");
     fprintf(stderr, "    -b { UHF | VHF }        radio band (default is UHF\n");
-    fprintf(stderr, "    -t { CCH | TCH }        select betwen control and traffic channel\n");
+    fprintf(stderr, "    -t { CCH | TCH | AUTO } select betwen control and traffic channel,\n");
+    fprintf(stderr, "                            AUTO detects channel type from received frames\n");
     fprintf(stderr, "    -d { DOWN | UP }        direction, downlink/direct or uplink\n");
+    fprintf(stderr, "    -f { unpacked | packed | soft }\n");
+    fprintf(stderr, "                            input format, one or 8 bits per byte or int8 soft\n");
+    fprintf(stderr, "                            decision per byte (default is unpacked)\n");
+    fprintf(stderr, "    -s <SECONDS>            emit decoder stats every SECONDS of stream time\n");
 }
 
 int main(int argc, char* argv[])
@@ -93,12 +197,16 @@ int main(int argc, char* argv[])
         .band = TETRAPOL_BAND_UHF,
         .dir = DIR_DOWNLINK,
         .radio_ch_type = TETRAPOL_RADIO_CCH,
+        .input_fmt = TETRAPOL_INPUT_UNPACKED,
     };
 
-    const char *in = NULL;
+    const char *ins[argc];
+    int ninputs = 0;
+    int nworkers = sysconf(_SC_NPROCESSORS_ONLN);
+    int stats_period = 0;
 
     int opt;
-    while ((opt = getopt(argc, argv, "b:hi:t:d:")) != -1) {
+    while ((opt = getopt(argc, argv, "b:hi:j:t:d:f:s:")) != -1) {
         switch (opt) {
             case 'b':
                 if (!strcmp(optarg, "VHF")) {
@@ -112,7 +220,15 @@ int main(int argc, char* argv[])
                 break;
 
             case 'i':
-                in = optarg;
+                ins[ninputs++] = optarg;
+                break;
+
+            case 'j':
+                nworkers = atoi(optarg);
+                if (nworkers < 1) {
+                    print_help(argv[0]);
+                    exit(EXIT_FAILURE);
+                }
                 break;
 
             case 't':
@@ -120,6 +236,8 @@ int main(int argc, char* argv[])
                     cfg.radio_ch_type = TETRAPOL_RADIO_CCH;
                 } else if (!strcmp("TCH", optarg)) {
                     cfg.radio_ch_type = TETRAPOL_RADIO_TCH;
+                } else if (!strcmp("AUTO", optarg)) {
+                    cfg.radio_ch_type = TETRAPOL_RADIO_AUTO;
                 } else {
                     print_help(argv[0]);
                     exit(EXIT_FAILURE);
@@ -142,6 +260,27 @@ int main(int argc, char* argv[])
                 }
                 break;
 
+            case 'f':
+                if (!strcmp("unpacked", optarg)) {
+                    cfg.input_fmt = TETRAPOL_INPUT_UNPACKED;
+                } else if (!strcmp("packed", optarg)) {
+                    cfg.input_fmt = TETRAPOL_INPUT_PACKED;
+                } else if (!strcmp("soft", optarg)) {
+                    cfg.input_fmt = TETRAPOL_INPUT_SOFT;
+                } else {
+                    print_help(argv[0]);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+
+            case 's':
+                stats_period = atoi(optarg);
+                if (stats_period < 1) {
+                    print_help(argv[0]);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+
             default:
                 print_help(argv[0]);
                 exit(EXIT_FAILURE);
@@ -149,6 +288,31 @@ int main(int argc, char* argv[])
         }
     }
 
+    if (ninputs > 1) {
+        int infds[ninputs];
+        for (int i = 0; i < ninputs; ++i) {
+            infds[i] = strcmp(ins[i], "-") ?
+                open(ins[i], O_RDONLY) : STDIN_FILENO;
+            if (infds[i] == -1) {
+                perror("Failed to open input file");
+                return -1;
+            }
+        }
+
+        const int ret = tetrapol_dump_engine(&cfg, infds, ninputs,
+                (nworkers > 0) ? nworkers : 1, stats_period);
+        for (int i = 0; i < ninputs; ++i) {
+            if (infds[i] != STDIN_FILENO) {
+                close(infds[i]);
+            }
+        }
+
+        fprintf(stderr, "Exiting.\n");
+
+        return ret;
+    }
+
+    const char *in = ninputs ? ins[0] : NULL;
     int infd = STDIN_FILENO;
     if (in && strcmp(in, "-")) {
         infd = open(in, O_RDONLY);
@@ -163,13 +327,17 @@ int main(int argc, char* argv[])
         fprintf(stderr, "Failed to initialize TETRAPOL instance.");
         return -1;
     }
+    tetrapol_set_stats_period(tetrapol, stats_period);
     phys_ch_t *phys_ch = tetrapol_phys_ch_create(tetrapol);
     if (phys_ch == NULL) {
         fprintf(stderr, "Failed to initialize TETRAPOL instance.");
         return -1;
     }
 
-    const int ret = tetrapol_dump_loop(phys_ch, infd);
+    int ret = tetrapol_dump_mmap(phys_ch, infd);
+    if (ret > 0) {
+        ret = tetrapol_dump_loop(phys_ch, infd);
+    }
     tetrapol_phys_ch_destroy(phys_ch);
     if (infd != STDIN_FILENO) {
         close(infd);
@@ -0,0 +1,178 @@
+#include <tetrapol/tetrapol.h>
+#include <tetrapol/chan_gen.h>
+
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void print_help(const char *prg_name)
+{
+    fprintf(stderr, "Generate synthetic TETRAPOL downlink channel.\n");
+    fprintf(stderr, "Usage: %s [OPTIONS ...]\n", prg_name);
+    fprintf(stderr, "    -o <PATH>               output file (default is stdout)\n");
+    fprintf(stderr, "    -b { UHF | VHF }        radio band (default is UHF)\n");
+    fprintf(stderr, "    -t { CCH | TCH }        control or traffic channel (default is CCH)\n");
+    fprintf(stderr, "    -f { unpacked | packed }\n");
+    fprintf(stderr, "                            output format, one or 8 bits per byte\n");
+    fprintf(stderr, "                            (default is unpacked)\n");
+    fprintf(stderr, "    -s <SCR>                scrambling constant (default is 0)\n");
+    fprintf(stderr, "    -n <N>                  number of frames (default is 2000)\n");
+    fprintf(stderr, "    -m <N>                  number of terminals (default is 100)\n");
+    fprintf(stderr, "    -r <SEED>               seed of random generator (default is 1)\n");
+    fprintf(stderr, "    -e <PPM>                random bit errors, parts per million\n");
+    fprintf(stderr, "    -B <PPM>:<BITS>         error bursts, per frame probability and length\n");
+    fprintf(stderr, "    -S <PPM>                bit slips, per frame probability\n");
+    fprintf(stderr, "    -D <PPM>:<FRAMES>       dropouts, per frame probability and length\n");
+}
+
+static int parse_ppm_len(const char *arg, int *ppm, int *len)
+{
+    return (sscanf(arg, "%d:%d", ppm, len) == 2 && *ppm >= 0 && *len > 0) ?
+        0 : -1;
+}
+
+int main(int argc, char* argv[])
+{
+    chan_gen_cfg_t cfg = {
+        .band = TETRAPOL_BAND_UHF,
+        .radio_ch_type = TETRAPOL_RADIO_CCH,
+        .input_fmt = TETRAPOL_INPUT_UNPACKED,
+        .nterminals = 100,
+        .nframes = 2000,
+        .seed = 1,
+    };
+    const char *out_path = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "b:t:f:s:n:m:r:e:B:S:D:o:h")) != -1) {
+        switch (opt) {
+            case 'b':
+                if (!strcmp(optarg, "VHF")) {
+                    cfg.band = TETRAPOL_BAND_VHF;
+                } else if (!strcmp(optarg, "UHF")) {
+                    cfg.band = TETRAPOL_BAND_UHF;
+                } else {
+                    print_help(argv[0]);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+
+            case 't':
+                if (!strcmp("CCH", optarg)) {
+                    cfg.radio_ch_type = TETRAPOL_RADIO_CCH;
+                } else if (!strcmp("TCH", optarg)) {
+                    cfg.radio_ch_type = TETRAPOL_RADIO_TCH;
+                } else {
+                    print_help(argv[0]);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+
+            case 'f':
+                if (!strcmp("unpacked", optarg)) {
+                    cfg.input_fmt = TETRAPOL_INPUT_UNPACKED;
+                } else if (!strcmp("packed", optarg)) {
+                    cfg.input_fmt = TETRAPOL_INPUT_PACKED;
+                } else {
+                    print_help(argv[0]);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+
+            case 's':
+                cfg.scr = atoi(optarg);
+                break;
+
+            case 'n':
+                cfg.nframes = atoll(optarg);
+                break;
+
+            case 'm':
+                cfg.nterminals = atoi(optarg);
+                break;
+
+            case 'r':
+                cfg.seed = strtoull(optarg, NULL, 0);
+                break;
+
+            case 'e':
+                cfg.ber_ppm = atoi(optarg);
+                break;
+
+            case 'B':
+                if (parse_ppm_len(optarg, &cfg.burst_ppm, &cfg.burst_len)) {
+                    print_help(argv[0]);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+
+            case 'S':
+                cfg.slip_ppm = atoi(optarg);
+                break;
+
+            case 'D':
+                if (parse_ppm_len(optarg, &cfg.dropout_ppm,
+                            &cfg.dropout_len)) {
+                    print_help(argv[0]);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+
+            case 'o':
+                out_path = optarg;
+                break;
+
+            case 'h':
+                print_help(argv[0]);
+                exit(0);
+                break;
+
+            default:
+                print_help(argv[0]);
+                exit(EXIT_FAILURE);
+                break;
+        }
+    }
+
+    FILE *out = out_path ? fopen(out_path, "wb") : stdout;
+    if (!out) {
+        perror("Failed to open output file");
+        return -1;
+    }
+
+    chan_gen_t *gen = chan_gen_create(&cfg);
+    if (!gen) {
+        if (out != stdout) {
+            fclose(out);
+        }
+        return -1;
+    }
+
+    int ret = 0;
+    uint8_t buf[4096];
+    int len;
+    while ((len = chan_gen_read(gen, buf, sizeof(buf))) > 0) {
+        if (fwrite(buf, 1, len, out) != len) {
+            perror("Failed to write output");
+            ret = -1;
+            break;
+        }
+    }
+
+    const chan_gen_stats_t *stats = chan_gen_get_stats(gen);
+    fprintf(stderr, "frames=%" PRId64 " frames_lost=%" PRId64 " bits=%" PRId64
+            " bit_errs=%" PRId64 " bursts=%" PRId64 " slips=%" PRId64
+            " dropouts=%" PRId64 " hdlc_frames=%" PRId64 "\n",
+            stats->frames, stats->frames_lost, stats->bits, stats->bit_errs,
+            stats->bursts, stats->slips, stats->dropouts, stats->hdlc_frames);
+
+    chan_gen_destroy(gen);
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    return ret;
+}
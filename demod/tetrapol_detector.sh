@@ -51,9 +51,13 @@ timeout ${TIMEOUT} \
         -o ${OUT_DIR}/channel%%.bits \
         -l "${FREQS}"
 
+# all channels are decoded by single process, events are tagged by channel
+# index (order of frequencies in FREQS), type of each channel (CCH or TCH) is
+# detected by decoder and reported by radio_ch_type event
+INPUTS=""
 for f in `echo "${FREQS}" | tr , ' '`; do
-    ../build/apps/tetrapol_dump -t CCH -i ${OUT_DIR}/channel${f}.bits \
-            >${OUT_DIR}/cch_${f}.json 2>${OUT_DIR}/cch_${f}.log
-    ../build/apps/tetrapol_dump -t TCH -i ${OUT_DIR}/channel${f}.bits \
-            >${OUT_DIR}/tch_${f}.json 2>${OUT_DIR}/tch_${f}.log
+    INPUTS="${INPUTS} -i ${OUT_DIR}/channel${f}.bits"
 done
+echo "${FREQS}" | tr , \\012 >${OUT_DIR}/channels.txt
+../build/apps/tetrapol_dump -t AUTO ${INPUTS} \
+        >${OUT_DIR}/decoded.json 2>${OUT_DIR}/decoded.log
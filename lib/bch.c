@@ -32,7 +32,7 @@ bch_t *bch_create(tpol_t *tpol)
         return NULL;
     }
 
-    bch->tpdu = tpdu_ui_create(tpol, FRAME_TYPE_DATA, LOG_CH_BCH);
+    bch->tpdu = tpdu_ui_create(tpol, FRAME_TYPE_DATA, TETRAPOL_LOG_CH_BCH);
     if (!bch->tpdu) {
         free(bch);
         data_frame_destroy(bch->data_fr);
@@ -73,7 +73,7 @@ bool bch_push_frame(bch_t *bch, const frame_t *fr)
     }
 
     if (!addr_is_tti_all_st(&hdlc_fr.addr, true)) {
-        if (bch->tpol->frame_no == FRAME_NO_UNKNOWN) {
+        if (bch->tpol->frame_no == TETRAPOL_FRAME_NO_UNKNOWN) {
             LOG_IF(DBG) {
                 char buf[ADDR_PRINT_BUF_SIZE];
                 LOG(DBG, "invalid address for BCH %s",
@@ -103,7 +103,7 @@ bool bch_push_frame(bch_t *bch, const frame_t *fr)
     bch->tsdu = (tsdu_d_system_info_t *)tsdu;
 
     const int bch_frame_no = 100 * bch->tsdu->cell_state.bch + nblocks - 1;
-    if (bch->tpol->frame_no != FRAME_NO_UNKNOWN &&
+    if (bch->tpol->frame_no != TETRAPOL_FRAME_NO_UNKNOWN &&
             bch->tpol->frame_no != bch_frame_no) {
         LOG(ERR, "Frame skew detected %d to %d\n",
                 bch->tpol->frame_no, bch_frame_no);
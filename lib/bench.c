@@ -0,0 +1,141 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "bench.h"
+
+#include <tetrapol/tsc.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+struct bench_priv_t {
+    FILE *out;
+    bool json;
+    double min_time;
+    const char *filter;
+    /// results of operations, keeps them from being optimized out
+    volatile int sink;
+};
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+bench_t *bench_create(FILE *out, bool json, double min_time,
+        const char *filter)
+{
+    bench_t *bench = calloc(1, sizeof(bench_t));
+    if (!bench) {
+        return NULL;
+    }
+
+    bench->out = out;
+    bench->json = json;
+    bench->min_time = min_time;
+    bench->filter = filter;
+
+    return bench;
+}
+
+void bench_destroy(bench_t *bench)
+{
+    free(bench);
+}
+
+bool bench_enabled(const bench_t *bench, const char *name)
+{
+    return !bench->filter || strstr(name, bench->filter);
+}
+
+/**
+  Run batch of operations.
+
+  @return time spent in seconds
+  */
+static double run_batch(bench_t *bench, bench_op_t op, void *ctx, long n,
+        uint64_t *ncycles)
+{
+    int sink = 0;
+    const uint64_t c0 = tsc_read();
+    const double t0 = now();
+    for (long i = 0; i < n; ++i) {
+        sink += op(ctx);
+    }
+    const double t = now() - t0;
+    *ncycles = tsc_read() - c0;
+    bench->sink += sink;
+
+    return t;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    const double x = *(const double *)a;
+    const double y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+void bench_run(bench_t *bench, const char *name, bench_op_t op, void *ctx)
+{
+    if (!bench_enabled(bench, name)) {
+        return;
+    }
+
+    // calibrate size of batch, also warms up caches
+    const double batch_time = bench->min_time / BENCH_SAMPLES;
+    long n = 1;
+    uint64_t ncycles;
+    while (run_batch(bench, op, ctx, n, &ncycles) < batch_time) {
+        n *= 2;
+    }
+
+    double ns[BENCH_SAMPLES];
+    double cyc[BENCH_SAMPLES];
+    for (int i = 0; i < BENCH_SAMPLES; ++i) {
+        ns[i] = run_batch(bench, op, ctx, n, &ncycles) * 1e9 / n;
+        cyc[i] = (double)ncycles / n;
+    }
+    qsort(ns, BENCH_SAMPLES, sizeof(double), cmp_double);
+    qsort(cyc, BENCH_SAMPLES, sizeof(double), cmp_double);
+    const double ns_op = ns[BENCH_SAMPLES / 2];
+    const double cyc_op = cyc[BENCH_SAMPLES / 2];
+
+    if (bench->json) {
+        fprintf(bench->out, "{ \"bench\": \"%s\", \"ns_per_op\": %.2f, "
+                "\"ops_per_s\": %.0f, ", name, ns_op, 1e9 / ns_op);
+        if (HAVE_TSC) {
+            fprintf(bench->out, "\"cycles_per_op\": %.1f }\n", cyc_op);
+        } else {
+            fprintf(bench->out, "\"cycles_per_op\": null }\n");
+        }
+    } else {
+        fprintf(bench->out, "%-32s %10.1f ns/op %12.0f ops/s", name, ns_op,
+                1e9 / ns_op);
+        if (HAVE_TSC) {
+            fprintf(bench->out, " %10.1f cycles/op", cyc_op);
+        }
+        fprintf(bench->out, "\n");
+    }
+    fflush(bench->out);
+}
+
+void bench_report(bench_t *bench, const char *name, double value,
+        const char *unit)
+{
+    if (!bench_enabled(bench, name)) {
+        return;
+    }
+
+    if (bench->json) {
+        fprintf(bench->out, "{ \"bench\": \"%s\", \"value\": %.1f, "
+                "\"unit\": \"%s\" }\n", name, value, unit);
+    } else {
+        fprintf(bench->out, "%-32s %10.1f %s\n", name, value, unit);
+    }
+    fflush(bench->out);
+}
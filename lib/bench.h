@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdio.h>
+
+/**
+  Microbenchmark harness.
+
+  Operation is called in batches, size of batch is calibrated so single batch
+  runs for at least min_time / BENCH_SAMPLES seconds. Median of BENCH_SAMPLES
+  batches is reported as ns/op, ops/s and cycles/op. Cycles are measured by
+  timestamp counter (reference cycles, not affected by frequency scaling)
+  and are not available on all architectures.
+  */
+typedef struct bench_priv_t bench_t;
+
+enum {
+    BENCH_SAMPLES = 5,
+};
+
+/**
+  Benchmarked operation.
+
+  @return Any value derived from result of operation, prevents compiler from
+    optimizing operation out.
+  */
+typedef int (*bench_op_t)(void *ctx);
+
+/**
+  Create benchmark harness.
+
+  @param out Output for results.
+  @param json Report results as JSON, single object per line.
+  @param min_time Minimal time spent by single benchmark in seconds.
+  @param filter Run only benchmarks with name containing filter, NULL for all.
+  */
+bench_t *bench_create(FILE *out, bool json, double min_time,
+        const char *filter);
+void bench_destroy(bench_t *bench);
+
+/**
+  Check if benchmark should run, allows to skip expensive setup.
+  */
+bool bench_enabled(const bench_t *bench, const char *name);
+
+/**
+  Measure and report operation, does nothing when benchmark is filtered out.
+  */
+void bench_run(bench_t *bench, const char *name, bench_op_t op, void *ctx);
+
+/**
+  Report value measured by benchmark itself, e.g. memory usage, does nothing
+  when benchmark is filtered out.
+  */
+void bench_report(bench_t *bench, const char *name, double value,
+        const char *unit);
+
+// groups of benchmarks, see bench_tetrapol*.c
+void bench_tetrapol_dump(bench_t *bench);
+void bench_tetrapol_frame(bench_t *bench);
+void bench_tetrapol_phys_ch(bench_t *bench);
+void bench_tetrapol_scr_search(bench_t *bench);
+void bench_tetrapol_terminal(bench_t *bench);
+void bench_tetrapol_timer(bench_t *bench);
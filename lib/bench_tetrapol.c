@@ -0,0 +1,358 @@
+/**
+  Per-stage microbenchmarks of the decoding chain.
+
+  usage: bench_tetrapol [-j] [-t SECONDS] [FILTER]
+
+  -j  print results as JSON, single object per line
+  -t  minimal time spent by single benchmark, 0.5 s by default
+  FILTER  run only benchmarks with name containing FILTER
+  */
+
+#define _POSIX_C_SOURCE 200112L
+
+#define LOG_PREFIX "bench"
+#include <tetrapol/log.h>
+#include <tetrapol/bit_utils.h>
+#include <tetrapol/data_frame.h>
+#include <tetrapol/frame_json.h>
+#include <tetrapol/hdlc_frame.h>
+#include <tetrapol/misc.h>
+#include <tetrapol/tetrapol_int.h>
+#include <tetrapol/tpdu.h>
+#include <tetrapol/tsdu.h>
+
+#include "bench.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct {
+    uint8_t hdlc[8];
+    data_frame_t *data_fr;
+    frame_t fr[2];
+    uint8_t tsdu[17];
+    tsdu_arena_t *arena;
+    hdlc_frame_t bch_hdlc;
+    tpdu_ui_t *bch_tpdu;
+    hdlc_frame_t seg_hdlc[3];
+    tpdu_ui_t *sdch_tpdu;
+    tpol_t *tpol;
+} ctx_t;
+
+static int op_check_fcs(void *arg)
+{
+    ctx_t *ctx = arg;
+
+    return check_fcs(ctx->hdlc, 8 * ARRAY_LEN(ctx->hdlc));
+}
+
+static int op_hdlc_frame_parse(void *arg)
+{
+    ctx_t *ctx = arg;
+    hdlc_frame_t hdlc_fr;
+
+    return hdlc_frame_parse(&hdlc_fr, ctx->hdlc, 8 * ARRAY_LEN(ctx->hdlc)) +
+        hdlc_fr.nbits;
+}
+
+// dual frame (FN 01, FN 11) as used by SDCH
+static int op_data_frame(void *arg)
+{
+    ctx_t *ctx = arg;
+    uint8_t data[8 * 2];
+
+    int ret = data_frame_push_frame(ctx->data_fr, &ctx->fr[0]);
+    ret += data_frame_push_frame(ctx->data_fr, &ctx->fr[1]);
+    if (ret == 1) {
+        ret += data_frame_get_bytes(ctx->data_fr, data);
+    }
+    data_frame_reset(ctx->data_fr);
+
+    return ret + data[0];
+}
+
+static int op_tsdu_decode(void *arg)
+{
+    ctx_t *ctx = arg;
+    tsdu_t *tsdu;
+
+    int ret = tsdu_decode(ctx->tsdu, ARRAY_LEN(ctx->tsdu), &tsdu);
+    tsdu_destroy(tsdu);
+
+    return ret;
+}
+
+static int op_tsdu_decode_arena(void *arg)
+{
+    ctx_t *ctx = arg;
+    tsdu_t *tsdu;
+
+    int ret = tsdu_decode_arena(ctx->tsdu, ARRAY_LEN(ctx->tsdu), ctx->arena,
+            &tsdu);
+    tsdu_arena_reset(ctx->arena);
+
+    return ret;
+}
+
+// typical downlink TSDUs, D_GROUP_PAGING prevails in captured CCH
+static const uint8_t tsdu_paging[] = {
+    D_GROUP_PAGING, 0x02, 0x80, 0xc2, 0x00,
+};
+static const uint8_t tsdu_system_info[] = {
+    D_SYSTEM_INFO, 0x00, 0x00, 0x21, 0x10, 0x01, 0x01, 0x12, 0x34,
+    0x56, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+static const uint8_t tsdu_group_list[] = {
+    D_GROUP_LIST, 0x20, 0x07,
+    0x42, 0x01, 0x00, 0x01, 0x23, 0x02, 0x00, 0x04, 0x56,
+    0x81, 0x01, 0x20,
+    0xc1, 0x05, 0x31, 0x23, 0x01, 0x11,
+    0x00,
+};
+static const uint8_t tsdu_group_activation[] = {
+    D_GROUP_ACTIVATION, 0x12, 0x34, 0x05, 0x01, 0x23, 0x45, 0x67, 0x00,
+};
+static const uint8_t tsdu_neighbouring_cell[] = {
+    D_NEIGHBOURING_CELL, 0x02, 0x00,
+    0x11, 0x23, 0x00, 0x21, 0x45, 0x00,
+    IEI_CELL_ID_LIST, 0x04, 0x01, 0x20, 0x02, 0x30,
+    IEI_ADJACENT_BN_LIST, 0x03, 0x12, 0x34, 0x56,
+};
+static const uint8_t tsdu_registration_ack[] = {
+    D_REGISTRATION_ACK, 0x01, 0x10, 0x00, 0x00, 0x71, 0x23, 0x45, 0x00,
+    0x20, 0x05, 0x00, 0x12, 0x30,
+};
+static const uint8_t tsdu_ech_overload_id[] = {
+    D_ECH_OVERLOAD_ID, 0x12, 0x34, 0x01, 0x20, 0x05,
+};
+static const uint8_t tsdu_call_connect[] = {
+    D_CALL_CONNECT, 0x00, 0x01, 0x23, 0x45, 0x67, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+static const struct {
+    const uint8_t *data;
+    int len;
+} tsdu_mix[] = {
+    { tsdu_paging, ARRAY_LEN(tsdu_paging) },
+    { tsdu_system_info, ARRAY_LEN(tsdu_system_info) },
+    { tsdu_paging, ARRAY_LEN(tsdu_paging) },
+    { tsdu_group_list, ARRAY_LEN(tsdu_group_list) },
+    { tsdu_paging, ARRAY_LEN(tsdu_paging) },
+    { tsdu_group_activation, ARRAY_LEN(tsdu_group_activation) },
+    { tsdu_paging, ARRAY_LEN(tsdu_paging) },
+    { tsdu_neighbouring_cell, ARRAY_LEN(tsdu_neighbouring_cell) },
+    { tsdu_paging, ARRAY_LEN(tsdu_paging) },
+    { tsdu_registration_ack, ARRAY_LEN(tsdu_registration_ack) },
+    { tsdu_paging, ARRAY_LEN(tsdu_paging) },
+    { tsdu_ech_overload_id, ARRAY_LEN(tsdu_ech_overload_id) },
+    { tsdu_paging, ARRAY_LEN(tsdu_paging) },
+    { tsdu_call_connect, ARRAY_LEN(tsdu_call_connect) },
+};
+
+// whole mix per operation
+static int op_tsdu_decode_mix(void *arg)
+{
+    ctx_t *ctx = arg;
+    tsdu_t *tsdu;
+    int ret = 0;
+
+    for (int i = 0; i < ARRAY_LEN(tsdu_mix); ++i) {
+        ret += tsdu_decode_arena(tsdu_mix[i].data, tsdu_mix[i].len,
+                ctx->arena, &tsdu);
+        ret += tsdu ? tsdu->codop : -1;
+        tsdu_arena_reset(ctx->arena);
+    }
+
+    return ret;
+}
+
+// D_SYSTEM_INFO in unsegmented TPDU_UI as received on BCH, with events
+static int op_tpdu_ui_bch(void *arg)
+{
+    ctx_t *ctx = arg;
+    tsdu_t *tsdu;
+
+    int ret = tpdu_ui_push_hdlc_frame2(ctx->bch_tpdu, &ctx->bch_hdlc, &tsdu);
+    tsdu_destroy(tsdu);
+
+    return ret;
+}
+
+// D_SYSTEM_INFO in TPDU_UI split into 3 segments, the last arrives first
+static int op_tpdu_ui_segmented(void *arg)
+{
+    ctx_t *ctx = arg;
+    tsdu_t *tsdu = NULL;
+    int ret = 0;
+
+    for (int i = ARRAY_LEN(ctx->seg_hdlc) - 1; i >= 0; --i) {
+        ret += tpdu_ui_push_hdlc_frame(ctx->sdch_tpdu, &ctx->seg_hdlc[i],
+                &tsdu);
+    }
+    ret += tsdu ? tsdu->codop : -1;
+    tsdu_destroy(tsdu);
+
+    return ret;
+}
+
+static int op_frame_json(void *arg)
+{
+    ctx_t *ctx = arg;
+    frame_json(ctx->tpol, &ctx->fr[0]);
+
+    return 0;
+}
+
+static void bench_tetrapol_api(bench_t *bench)
+{
+    ctx_t ctx;
+    memset(&ctx, 0, sizeof(ctx));
+
+    const tetrapol_cfg_t cfg = {
+        .band = TETRAPOL_BAND_UHF,
+        .dir = DIR_DOWNLINK,
+        .radio_ch_type = TETRAPOL_RADIO_CCH,
+        .input_fmt = TETRAPOL_INPUT_PACKED,
+    };
+    tetrapol_t *tetrapol = tetrapol_create(&cfg);
+    FILE *out = fopen("/dev/null", "w");
+    ctx.data_fr = data_frame_create();
+    ctx.arena = tsdu_arena_create(4096);
+    if (tetrapol) {
+        ctx.bch_tpdu = tpdu_ui_create(tetrapol_get_tpol(tetrapol),
+                FRAME_TYPE_DATA, TETRAPOL_LOG_CH_BCH);
+        ctx.sdch_tpdu = tpdu_ui_create(tetrapol_get_tpol(tetrapol),
+                FRAME_TYPE_DATA, TETRAPOL_LOG_CH_SDCH);
+    }
+    if (!tetrapol || !out || !ctx.data_fr || !ctx.arena || !ctx.bch_tpdu ||
+            !ctx.sdch_tpdu) {
+        LOG(ERR, "Failed to initialize benchmark");
+        goto err;
+    }
+    tetrapol_set_output(tetrapol, out);
+    ctx.tpol = tetrapol_get_tpol(tetrapol);
+
+    for (int i = 0; i < ARRAY_LEN(ctx.hdlc); ++i) {
+        ctx.hdlc[i] = rand();
+    }
+
+    for (int n = 0; n < ARRAY_LEN(ctx.fr); ++n) {
+        frame_t *fr = &ctx.fr[n];
+        fr->fr_type = FRAME_TYPE_DATA;
+        for (int i = 0; i < 2 + 64; ++i) {
+            frame_set_bits(fr, FRAME_DATA_FN + i, 1, rand() & 1);
+        }
+    }
+    // FN 01 and FN 11
+    frame_set_bits(&ctx.fr[0], FRAME_DATA_FN, 2, 1);
+    frame_set_bits(&ctx.fr[1], FRAME_DATA_FN, 2, 3);
+
+    // D_SYSTEM_INFO, normal mode
+    ctx.tsdu[0] = D_SYSTEM_INFO;
+    for (int i = 2; i < ARRAY_LEN(ctx.tsdu); ++i) {
+        ctx.tsdu[i] = rand();
+    }
+
+    // DU without extension and segmentation, length in the second byte
+    // TTI all stations
+    ctx.bch_hdlc.addr.y = 7;
+    ctx.bch_hdlc.addr.x = 0xfff;
+    ctx.bch_hdlc.command.cmd = COMMAND_UNNUMBERED_UI;
+    ctx.bch_hdlc.data[0] = 0;
+    ctx.bch_hdlc.data[1] = ARRAY_LEN(ctx.tsdu);
+    memcpy(&ctx.bch_hdlc.data[2], ctx.tsdu, sizeof(ctx.tsdu));
+    ctx.bch_hdlc.nbits = 8 * (2 + ARRAY_LEN(ctx.tsdu));
+
+    // the same TSDU segmented, header with extension, seg_ref 5, id_tsap 1
+    const int seg_len = 6;
+    for (int i = 0; i < ARRAY_LEN(ctx.seg_hdlc); ++i) {
+        hdlc_frame_t *hdlc_fr = &ctx.seg_hdlc[i];
+        const bool last = i == ARRAY_LEN(ctx.seg_hdlc) - 1;
+        const int len = last ? ARRAY_LEN(ctx.tsdu) - i * seg_len : seg_len;
+
+        hdlc_fr->addr.y = 1;
+        hdlc_fr->addr.x = 0x123;
+        hdlc_fr->command.cmd = COMMAND_UNNUMBERED_UI;
+        hdlc_fr->data[0] = 0x80 | (last ? 0 : 0x40) | 0x01;
+        hdlc_fr->data[1] = 0x80 | 5;
+        hdlc_fr->data[2] = i;
+        int hdr_len = 3;
+        if (last) {
+            hdlc_fr->data[hdr_len++] = len;
+        }
+        memcpy(&hdlc_fr->data[hdr_len], &ctx.tsdu[i * seg_len], len);
+        hdlc_fr->nbits = 8 * (hdr_len + len);
+    }
+
+    bench_run(bench, "check_fcs", op_check_fcs, &ctx);
+    bench_run(bench, "hdlc_frame_parse", op_hdlc_frame_parse, &ctx);
+    bench_run(bench, "data_frame_push_frame_x2", op_data_frame, &ctx);
+    bench_run(bench, "tsdu_decode", op_tsdu_decode, &ctx);
+    bench_run(bench, "tsdu_decode_arena", op_tsdu_decode_arena, &ctx);
+    bench_run(bench, "tsdu_decode_mix", op_tsdu_decode_mix, &ctx);
+    bench_run(bench, "tpdu_ui_bch", op_tpdu_ui_bch, &ctx);
+    tetrapol_set_event_handler(tetrapol, NULL, NULL);
+    bench_run(bench, "tpdu_ui_bch_noevt", op_tpdu_ui_bch, &ctx);
+    bench_run(bench, "tpdu_ui_segmented", op_tpdu_ui_segmented, &ctx);
+    tetrapol_set_event_handler(tetrapol, &tetrapol_json_handler, NULL);
+    bench_run(bench, "frame_json", op_frame_json, &ctx);
+
+err:
+    tpdu_ui_destroy(ctx.sdch_tpdu);
+    tpdu_ui_destroy(ctx.bch_tpdu);
+    tsdu_arena_destroy(ctx.arena);
+    data_frame_destroy(ctx.data_fr);
+    // flushes buffered output, keep it open until then
+    tetrapol_destroy(tetrapol);
+    if (out) {
+        fclose(out);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    bool json = false;
+    double min_time = 0.5;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "jt:")) != -1) {
+        switch (opt) {
+            case 'j':
+                json = true;
+                break;
+
+            case 't':
+                min_time = atof(optarg);
+                break;
+
+            default:
+                fprintf(stderr, "usage: %s [-j] [-t SECONDS] [FILTER]\n",
+                        argv[0]);
+                return -1;
+        }
+    }
+    const char *filter = (optind < argc) ? argv[optind] : NULL;
+
+    // decoding errors of random data are expected
+    log_set_lvl(WTF);
+    srand(0);
+
+    bench_t *bench = bench_create(stdout, json, min_time, filter);
+    if (!bench) {
+        return -1;
+    }
+
+    bench_tetrapol_phys_ch(bench);
+    bench_tetrapol_scr_search(bench);
+    bench_tetrapol_frame(bench);
+    bench_tetrapol_api(bench);
+    bench_tetrapol_terminal(bench);
+    bench_tetrapol_timer(bench);
+    bench_tetrapol_dump(bench);
+
+    bench_destroy(bench);
+
+    return 0;
+}
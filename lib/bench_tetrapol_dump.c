@@ -0,0 +1,107 @@
+// input path of tetrapol_dump, see bench_tetrapol.c
+
+// include, we are testing static methods
+#define main tetrapol_dump_main
+#include "../apps/tetrapol_dump.c"
+#undef main
+
+#define LOG_PREFIX "bench"
+#include <tetrapol/log.h>
+
+#include "bench.h"
+
+enum {
+    /// noise, one bit per byte, input is dominated by frame sync. search
+    DUMP_SIZE = 16 * 1000 * 1000,
+};
+
+typedef struct {
+    const char *fname;
+    FILE *out;
+    int (*dump)(phys_ch_t *phys_ch, int fd);
+} ctx_t;
+
+// decode whole file
+static int op_dump(void *arg)
+{
+    ctx_t *ctx = arg;
+    const tetrapol_cfg_t cfg = {
+        .band = TETRAPOL_BAND_UHF,
+        .dir = DIR_DOWNLINK,
+        .radio_ch_type = TETRAPOL_RADIO_CCH,
+        .input_fmt = TETRAPOL_INPUT_UNPACKED,
+    };
+    tetrapol_t *tetrapol = tetrapol_create(&cfg);
+    phys_ch_t *phys_ch = tetrapol ? tetrapol_phys_ch_create(tetrapol) : NULL;
+    const int fd = open(ctx->fname, O_RDONLY);
+    int ret = -1;
+    if (phys_ch && fd != -1) {
+        tetrapol_set_output(tetrapol, ctx->out);
+        ret = ctx->dump(phys_ch, fd);
+    }
+
+    if (fd != -1) {
+        close(fd);
+    }
+    tetrapol_phys_ch_destroy(phys_ch);
+    tetrapol_destroy(tetrapol);
+
+    return ret;
+}
+
+static int mk_input(char *fname)
+{
+    const int fd = mkstemp(fname);
+    if (fd == -1) {
+        return -1;
+    }
+
+    uint8_t buf[4096];
+    for (int offs = 0; offs < DUMP_SIZE; offs += sizeof(buf)) {
+        for (int i = 0; i < sizeof(buf); ++i) {
+            buf[i] = (rand() >> 8) & 1;
+        }
+        const int len = (DUMP_SIZE - offs < sizeof(buf)) ?
+            DUMP_SIZE - offs : sizeof(buf);
+        if (write(fd, buf, len) != len) {
+            close(fd);
+            return -1;
+        }
+    }
+    close(fd);
+
+    return 0;
+}
+
+/**
+  read() loop against memory mapped file, both read the same file from page
+  cache, difference of times is the cost of input path.
+  */
+void bench_tetrapol_dump(bench_t *bench)
+{
+    if (!bench_enabled(bench, "dump_input")) {
+        return;
+    }
+
+    char fname[] = "/tmp/bench_tetrapol_dump_XXXXXX";
+    FILE *out = fopen("/dev/null", "w");
+    if (!out || mk_input(fname)) {
+        LOG(ERR, "Failed to initialize benchmark");
+        if (out) {
+            fclose(out);
+        }
+        return;
+    }
+
+    ctx_t ctx = {
+        .fname = fname,
+        .out = out,
+        .dump = tetrapol_dump_loop,
+    };
+    bench_run(bench, "dump_input_read_16mb", op_dump, &ctx);
+    ctx.dump = tetrapol_dump_mmap;
+    bench_run(bench, "dump_input_mmap_16mb", op_dump, &ctx);
+
+    unlink(fname);
+    fclose(out);
+}
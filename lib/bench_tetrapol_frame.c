@@ -0,0 +1,132 @@
+// frame decoding stages, see bench_tetrapol.c
+
+// include, we are testing static methods
+#include "frame.c"
+
+#include <tetrapol/misc.h>
+
+#include "bench.h"
+
+enum {
+    SCR = 42,
+};
+
+typedef struct {
+    frame_decoder_t *fd;
+    /// received data frame after differential decoding in physical channel
+    uint8_t fr_data[FRAME_DATA_LEN];
+    uint8_t fr_tmp[FRAME_DATA_LEN];
+    uint8_t fr_deint[FRAME_DATA_LEN];
+    /// decoded bits of the first and second part of frame
+    frame_t fr_dec;
+    frame_t fr;
+} ctx_t;
+
+static int op_descramble(void *arg)
+{
+    ctx_t *ctx = arg;
+    frame_descramble(ctx->fr_tmp, ctx->fr_data, SCR);
+
+    return ctx->fr_tmp[FRAME_DATA_LEN - 1];
+}
+
+static int op_diff_dec(void *arg)
+{
+    ctx_t *ctx = arg;
+    frame_diff_dec(ctx->fr_tmp);
+
+    return ctx->fr_tmp[FRAME_DATA_LEN - 1];
+}
+
+static int op_deinterleave(void *arg)
+{
+    ctx_t *ctx = arg;
+    frame_deinterleave1(ctx->fr_deint, ctx->fr_tmp, TETRAPOL_BAND_UHF);
+
+    return ctx->fr_deint[FRAME_DATA_LEN1 - 1];
+}
+
+static int op_plan_apply(void *arg)
+{
+    ctx_t *ctx = arg;
+    plan_apply(ctx->fd, ctx->fr_deint, ctx->fr_data, 0, FRAME_DATA_LEN);
+
+    return ctx->fr_deint[FRAME_DATA_LEN - 1];
+}
+
+static int op_viterbi(void *arg)
+{
+    ctx_t *ctx = arg;
+
+    return viterbi_decode_bits(ctx->fr_dec.bits, 0, ctx->fr_deint, 26) +
+        viterbi_decode_bits(ctx->fr_dec.bits, 26, ctx->fr_deint + 2*26, 50);
+}
+
+static int op_check_crc(void *arg)
+{
+    ctx_t *ctx = arg;
+
+    return frame_check_crc(&ctx->fr_dec, FRAME_TYPE_DATA);
+}
+
+static int op_decode(void *arg)
+{
+    ctx_t *ctx = arg;
+    frame_decoder_decode(ctx->fd, &ctx->fr, ctx->fr_data);
+
+    return ctx->fr.broken;
+}
+
+void bench_tetrapol_frame(bench_t *bench)
+{
+    ctx_t ctx;
+    memset(&ctx, 0, sizeof(ctx));
+
+    frame_encoder_t *fe = frame_encoder_create(TETRAPOL_BAND_UHF, SCR,
+            DIR_DOWNLINK);
+    ctx.fd = frame_decoder_create(TETRAPOL_BAND_UHF, SCR, FRAME_TYPE_DATA);
+    if (!fe || !ctx.fd) {
+        LOG(ERR, "Failed to create frame encoder/decoder");
+        frame_encoder_destroy(fe);
+        frame_decoder_destroy(ctx.fd);
+        return;
+    }
+
+    // valid data frame, differential decoding as done by physical channel
+    frame_t fr;
+    memset(&fr, 0, sizeof(fr));
+    fr.fr_type = FRAME_TYPE_DATA;
+    for (int i = 0; i < 2 + 64; ++i) {
+        frame_set_bits(&fr, FRAME_DATA_FN + i, 1, rand() & 1);
+    }
+    uint8_t fr_bytes[FRAME_LEN / 8];
+    frame_encoder_encode(fe, fr_bytes, &fr);
+    uint8_t bit = 0;
+    for (int i = 0; i < FRAME_DATA_LEN; ++i) {
+        bit ^= (fr_bytes[1 + i / 8] >> (i % 8)) & 1;
+        ctx.fr_data[i] = bit;
+    }
+    frame_encoder_destroy(fe);
+
+    // prepare input of each stage by the previous stages
+    frame_descramble(ctx.fr_tmp, ctx.fr_data, SCR);
+    frame_diff_dec(ctx.fr_tmp);
+    plan_apply(ctx.fd, ctx.fr_deint, ctx.fr_data, 0, FRAME_DATA_LEN);
+    op_viterbi(&ctx);
+    if (!frame_check_crc(&ctx.fr_dec, FRAME_TYPE_DATA)) {
+        LOG(ERR, "Frame used for benchmark is not valid");
+    }
+
+    // stages of the reference decoder, input of in-place stages is
+    // not restored between runs, it does not affect running time
+    bench_run(bench, "frame_descramble", op_descramble, &ctx);
+    bench_run(bench, "frame_diff_dec", op_diff_dec, &ctx);
+    bench_run(bench, "frame_deinterleave1", op_deinterleave, &ctx);
+    // fused descrambling, differential decoding and deinterleaving
+    bench_run(bench, "frame_plan_apply", op_plan_apply, &ctx);
+    bench_run(bench, "viterbi_decode", op_viterbi, &ctx);
+    bench_run(bench, "frame_check_crc", op_check_crc, &ctx);
+    bench_run(bench, "frame_decoder_decode", op_decode, &ctx);
+
+    frame_decoder_destroy(ctx.fd);
+}
@@ -0,0 +1,331 @@
+// physical channel stages, see bench_tetrapol.c
+
+// must be defined before any system header, see phys_ch.c
+#define _GNU_SOURCE
+
+// include, we are testing static methods
+#include "phys_ch.c"
+
+#include "bench.h"
+
+#include <math.h>
+
+enum {
+    // frames of random noise scanned by single frame sync. search
+    SEARCH_FRAMES = 80,
+    SOFT_SCR = 67,
+    // frames of stream decoded by soft decision benchmarks
+    SOFT_FRAMES = 200,
+    SOFT_FRAMES_QUALITY = 2000,
+    // scale of soft decisions, noiseless symbol is +-LLR_SCALE
+    LLR_SCALE = 32,
+};
+
+typedef struct {
+    phys_ch_t *phys_ch;
+    int pos;
+    uint8_t fr_bytes[FRAME_DATA_LEN / 8 + 16];
+} ctx_t;
+
+static int op_cmp_frame_sync(void *arg)
+{
+    ctx_t *ctx = arg;
+    ctx->pos = (ctx->pos + 1) % (SEARCH_FRAMES * FRAME_LEN);
+
+    return cmp_frame_sync(ctx->phys_ch->data, ctx->pos);
+}
+
+static int op_corr_frame_sync(void *arg)
+{
+    ctx_t *ctx = arg;
+    ctx->pos = (ctx->pos + 64) % (SEARCH_FRAMES * FRAME_LEN);
+    uint64_t errs[SYNC_ERR_BITS];
+    corr_frame_sync(errs, ctx->phys_ch->data, ctx->pos);
+
+    return errs[0] ^ errs[SYNC_ERR_BITS - 1];
+}
+
+// original bit by bit search, for comparison
+static int find_frame_sync_ref(phys_ch_t *phys_ch)
+{
+    const int end = phys_ch->data_end - FRAME_LEN - FRAME_HDR_LEN;
+    while (phys_ch->data_begin <= end) {
+        const int sync_err =
+            cmp_frame_sync(phys_ch->data, phys_ch->data_begin) +
+            cmp_frame_sync(phys_ch->data, phys_ch->data_begin + FRAME_LEN);
+        if (sync_err <= MAX_FRAME_SYNC_ERR) {
+            phys_ch->sync_errs = 0;
+            return 1;
+        }
+        ++phys_ch->data_begin;
+        ++phys_ch->tpol->rx_offs;
+    }
+
+    return 0;
+}
+
+static int op_find_frame_sync_ref(void *arg)
+{
+    ctx_t *ctx = arg;
+    phys_ch_t *phys_ch = ctx->phys_ch;
+
+    int nsync = 0;
+    phys_ch->data_begin = DATA_OFFS;
+    while (find_frame_sync_ref(phys_ch)) {
+        ++nsync;
+        ++phys_ch->data_begin;
+    }
+
+    return nsync;
+}
+
+static int op_find_frame_sync(void *arg)
+{
+    ctx_t *ctx = arg;
+    phys_ch_t *phys_ch = ctx->phys_ch;
+
+    int nsync = 0;
+    phys_ch->data_begin = DATA_OFFS;
+    while (find_frame_sync(phys_ch)) {
+        ++nsync;
+        ++phys_ch->data_begin;
+    }
+
+    return nsync;
+}
+
+static int op_differential_dec(void *arg)
+{
+    ctx_t *ctx = arg;
+
+    return differential_dec(ctx->fr_bytes, FRAME_DATA_LEN, 0);
+}
+
+static double gauss(void)
+{
+    const double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+    const double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+    return sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+}
+
+/**
+  Generate stream of encoded data frames, BPSK with AWGN.
+
+  @return soft decisions, one per symbol, NULL on failure
+  */
+static uint8_t *mk_soft_stream(int nframes, double sigma)
+{
+    uint8_t *soft = malloc(nframes * FRAME_LEN);
+    frame_encoder_t *fe = frame_encoder_create(TETRAPOL_BAND_UHF, SOFT_SCR,
+            DIR_DOWNLINK);
+    if (!soft || !fe) {
+        free(soft);
+        frame_encoder_destroy(fe);
+        return NULL;
+    }
+
+    for (int n = 0; n < nframes; ++n) {
+        frame_t fr;
+        memset(&fr, 0, sizeof(fr));
+        fr.fr_type = FRAME_TYPE_DATA;
+        for (int i = 0; i < 2 + 64; ++i) {
+            frame_set_bits(&fr, FRAME_DATA_FN + i, 1, rand() & 1);
+        }
+        uint8_t fr_bytes[FRAME_LEN / 8];
+        frame_encoder_encode(fe, fr_bytes, &fr);
+
+        for (int i = 0; i < FRAME_LEN; ++i) {
+            const int bit = (fr_bytes[i / 8] >> (i % 8)) & 1;
+            const double y = LLR_SCALE * ((bit ? 1 : -1) + sigma * gauss());
+            const double llr = (y > 127) ? 127 : ((y < -127) ? -127 : y);
+            soft[n * FRAME_LEN + i] = (int8_t)lrint(llr);
+        }
+    }
+    frame_encoder_destroy(fe);
+
+    return soft;
+}
+
+/// hard decisions are derived from the same soft stream
+static void soft_to_hard(uint8_t *hard, const uint8_t *soft, int len)
+{
+    for (int i = 0; i < len; ++i) {
+        hard[i] = (int8_t)soft[i] > 0;
+    }
+}
+
+/**
+  Push stream through physical channel and frame decoder.
+
+  @return number of frames decoded without errors, -1 on failure
+  */
+static int decode_stream(int input_fmt, uint8_t *stream, int len)
+{
+    tetrapol_cfg_t cfg = {
+        .band = TETRAPOL_BAND_UHF,
+        .dir = DIR_DOWNLINK,
+        .radio_ch_type = TETRAPOL_RADIO_CCH,
+        .input_fmt = input_fmt,
+    };
+    tetrapol_t *tetrapol = tetrapol_create(&cfg);
+    phys_ch_t *phys_ch = tetrapol ? tetrapol_phys_ch_create(tetrapol) : NULL;
+    frame_decoder_t *fd = frame_decoder_create(TETRAPOL_BAND_UHF, SOFT_SCR,
+            FRAME_TYPE_DATA);
+    int nok = -1;
+    if (!phys_ch || !fd) {
+        goto err;
+    }
+
+    nok = 0;
+    for (int offs = 0; offs < len; ) {
+        const int n = (len - offs > 4096) ? 4096 : len - offs;
+        offs += tetrapol_phys_ch_recv(phys_ch, &stream[offs], n);
+
+        if (!phys_ch->has_frame_sync) {
+            phys_ch->has_frame_sync = find_frame_sync(phys_ch);
+            if (!phys_ch->has_frame_sync) {
+                continue;
+            }
+        }
+
+        uint8_t fr_data[FRAME_DATA_LEN];
+        uint8_t fr_rel[FRAME_DATA_LEN];
+        int r;
+        while ((r = get_frame(phys_ch, fr_data, fr_rel)) > 0) {
+            frame_t fr;
+            if (phys_ch->rel) {
+                frame_decoder_decode_soft(fd, &fr, fr_data, fr_rel);
+            } else {
+                frame_decoder_decode(fd, &fr, fr_data);
+            }
+            nok += !fr.broken;
+        }
+        if (r < 0) {
+            phys_ch->has_frame_sync = false;
+        }
+    }
+
+err:
+    frame_decoder_destroy(fd);
+    tetrapol_phys_ch_destroy(phys_ch);
+    tetrapol_destroy(tetrapol);
+
+    return nok;
+}
+
+typedef struct {
+    uint8_t *soft;
+    uint8_t *hard;
+} soft_ctx_t;
+
+static int op_decode_hard(void *arg)
+{
+    soft_ctx_t *ctx = arg;
+
+    return decode_stream(TETRAPOL_INPUT_UNPACKED, ctx->hard,
+            SOFT_FRAMES * FRAME_LEN);
+}
+
+static int op_decode_soft(void *arg)
+{
+    soft_ctx_t *ctx = arg;
+
+    return decode_stream(TETRAPOL_INPUT_SOFT, ctx->soft,
+            SOFT_FRAMES * FRAME_LEN);
+}
+
+/// soft vs. hard decision decoding on synthetic noisy channel
+static void bench_soft(bench_t *bench)
+{
+    soft_ctx_t ctx;
+    ctx.soft = mk_soft_stream(SOFT_FRAMES, 0.45);
+    ctx.hard = malloc(SOFT_FRAMES * FRAME_LEN);
+    if (!ctx.soft || !ctx.hard) {
+        LOG(ERR, "Failed to initialize benchmark");
+        goto err;
+    }
+    soft_to_hard(ctx.hard, ctx.soft, SOFT_FRAMES * FRAME_LEN);
+
+    // whole stream including setup of physical channel, sigma 0.45
+    bench_run(bench, "phys_ch_decode_hard_200fr", op_decode_hard, &ctx);
+    bench_run(bench, "phys_ch_decode_soft_200fr", op_decode_soft, &ctx);
+
+    // frames decoded without errors
+    const char *sigmas[] = { "0.35", "0.40", "0.45", "0.50", };
+    for (int i = 0; i < ARRAY_LEN(sigmas); ++i) {
+        char name_hard[64];
+        char name_soft[64];
+        snprintf(name_hard, sizeof(name_hard), "phys_ch_decoded_hard_sigma%s",
+                sigmas[i]);
+        snprintf(name_soft, sizeof(name_soft), "phys_ch_decoded_soft_sigma%s",
+                sigmas[i]);
+        if (!bench_enabled(bench, name_hard) &&
+                !bench_enabled(bench, name_soft)) {
+            continue;
+        }
+
+        const int len = SOFT_FRAMES_QUALITY * FRAME_LEN;
+        uint8_t *soft = mk_soft_stream(SOFT_FRAMES_QUALITY, atof(sigmas[i]));
+        uint8_t *hard = malloc(len);
+        if (!soft || !hard) {
+            LOG(ERR, "Failed to initialize benchmark");
+            free(soft);
+            free(hard);
+            goto err;
+        }
+        soft_to_hard(hard, soft, len);
+        bench_report(bench, name_hard, 100.0 *
+                decode_stream(TETRAPOL_INPUT_UNPACKED, hard, len) /
+                SOFT_FRAMES_QUALITY, "%");
+        bench_report(bench, name_soft, 100.0 *
+                decode_stream(TETRAPOL_INPUT_SOFT, soft, len) /
+                SOFT_FRAMES_QUALITY, "%");
+        free(hard);
+        free(soft);
+    }
+
+err:
+    free(ctx.hard);
+    free(ctx.soft);
+}
+
+void bench_tetrapol_phys_ch(bench_t *bench)
+{
+    tetrapol_cfg_t cfg = {
+        .band = TETRAPOL_BAND_UHF,
+        .dir = DIR_DOWNLINK,
+        .radio_ch_type = TETRAPOL_RADIO_CCH,
+        .input_fmt = TETRAPOL_INPUT_PACKED,
+    };
+    tetrapol_t *tetrapol = tetrapol_create(&cfg);
+    phys_ch_t *phys_ch = tetrapol ? tetrapol_phys_ch_create(tetrapol) : NULL;
+    if (!phys_ch) {
+        LOG(ERR, "Failed to create physical channel");
+        tetrapol_destroy(tetrapol);
+        return;
+    }
+
+    ctx_t ctx = {
+        .phys_ch = phys_ch,
+    };
+    phys_ch->data_end = SEARCH_FRAMES * FRAME_LEN;
+    for (int i = 0; i < phys_ch->data_end / 8 + 32; ++i) {
+        phys_ch->data[i] = rand();
+    }
+    for (int i = 0; i < ARRAY_LEN(ctx.fr_bytes); ++i) {
+        ctx.fr_bytes[i] = rand();
+    }
+
+    bench_run(bench, "cmp_frame_sync", op_cmp_frame_sync, &ctx);
+    bench_run(bench, "corr_frame_sync", op_corr_frame_sync, &ctx);
+    // whole window, 80 frames of noise
+    bench_run(bench, "find_frame_sync_ref_80fr", op_find_frame_sync_ref,
+            &ctx);
+    bench_run(bench, "find_frame_sync_80fr", op_find_frame_sync, &ctx);
+    bench_run(bench, "differential_dec", op_differential_dec, &ctx);
+
+    tetrapol_phys_ch_destroy(phys_ch);
+    tetrapol_destroy(tetrapol);
+
+    bench_soft(bench);
+}
@@ -0,0 +1,226 @@
+// SCR detection, see bench_tetrapol.c
+
+#define LOG_PREFIX "bench"
+#include <tetrapol/log.h>
+#include <tetrapol/frame.h>
+#include <tetrapol/misc.h>
+#include <tetrapol/scr_search.h>
+#include <tetrapol/tetrapol.h>
+
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+    CONFIDENCE = 50,
+    /// detection fails when SCR is not detected after so many frames
+    MAX_FRAMES = 10 * CONFIDENCE,
+    /// detections averaged by frames to lock
+    NRUNS = 10,
+    SCR = 42,
+};
+
+static void mk_frame(uint8_t *fr_data, frame_encoder_t *fe, int ber)
+{
+    frame_t fr;
+    memset(&fr, 0, sizeof(fr));
+    fr.fr_type = FRAME_TYPE_DATA;
+    for (int i = 0; i < 2 + 64; ++i) {
+        frame_set_bits(&fr, FRAME_DATA_FN + i, 1, rand() & 1);
+    }
+
+    uint8_t fr_bytes[FRAME_LEN / 8];
+    frame_encoder_encode(fe, fr_bytes, &fr);
+
+    // differential decoding, as done by physical channel
+    uint8_t bit = 0;
+    for (int i = 0; i < FRAME_DATA_LEN; ++i) {
+        bit ^= (fr_bytes[1 + i / 8] >> (i % 8)) & 1;
+        fr_data[i] = bit;
+        if (ber && !(rand() % ber)) {
+            fr_data[i] ^= 1;
+        }
+    }
+}
+
+// original SCR detection, decodes frame with all candidates
+typedef struct {
+    frame_decoder_t *fd;
+    int band;
+    int confidence;
+    int stat[SCR_SEARCH_NSCR];
+} ref_search_t;
+
+static int ref_search_push(ref_search_t *rs, const uint8_t *fr_data)
+{
+    for (int scr = 0; scr < SCR_SEARCH_NSCR; ++scr) {
+        frame_t fr;
+        frame_decoder_reset(rs->fd, rs->band, scr, FRAME_TYPE_AUTO);
+        frame_decoder_decode(rs->fd, &fr, fr_data);
+        if (fr.broken) {
+            rs->stat[scr] -= 2;
+            if (rs->stat[scr] < 0) {
+                rs->stat[scr] = 0;
+            }
+            continue;
+        }
+
+        ++rs->stat[scr];
+    }
+
+    int scr_max = 0, scr_max2 = 1;
+    if (rs->stat[0] < rs->stat[1]) {
+        scr_max = 1;
+        scr_max2 = 0;
+    }
+    for (int scr = 2; scr < SCR_SEARCH_NSCR; ++scr) {
+        if (rs->stat[scr] >= rs->stat[scr_max]) {
+            scr_max2 = scr_max;
+            scr_max = scr;
+        }
+    }
+    if (rs->stat[scr_max] - rs->confidence > rs->stat[scr_max2]) {
+        return scr_max;
+    }
+
+    return SCR_SEARCH_NONE;
+}
+
+typedef struct {
+    scr_search_t *ss;
+    ref_search_t rs;
+    /// frames scrambled by SCR
+    uint8_t frames[MAX_FRAMES][FRAME_DATA_LEN];
+} ctx_t;
+
+static int ref_push(ctx_t *ctx, const uint8_t *fr_data)
+{
+    return ref_search_push(&ctx->rs, fr_data);
+}
+
+static void ref_reset(ctx_t *ctx)
+{
+    memset(ctx->rs.stat, 0, sizeof(ctx->rs.stat));
+}
+
+static int ss_push(ctx_t *ctx, const uint8_t *fr_data)
+{
+    return scr_search_push(ctx->ss, fr_data);
+}
+
+static void ss_reset(ctx_t *ctx)
+{
+    scr_search_reset(ctx->ss);
+}
+
+typedef struct {
+    int (*push)(ctx_t *ctx, const uint8_t *fr_data);
+    void (*reset)(ctx_t *ctx);
+} search_t;
+
+static const search_t search_ref = { ref_push, ref_reset, };
+static const search_t search_ss = { ss_push, ss_reset, };
+
+/// @return number of frames pushed until detection
+static int lock(ctx_t *ctx, const search_t *search)
+{
+    search->reset(ctx);
+    for (int i = 0; i < MAX_FRAMES; ++i) {
+        if (search->push(ctx, ctx->frames[i]) != SCR_SEARCH_NONE) {
+            return i + 1;
+        }
+    }
+
+    return MAX_FRAMES;
+}
+
+static int op_lock_ref(void *arg)
+{
+    return lock(arg, &search_ref);
+}
+
+static int op_lock(void *arg)
+{
+    return lock(arg, &search_ss);
+}
+
+/// report average frames to lock for streams with random SCR
+static void bench_frames_to_lock(bench_t *bench, const char *name,
+        ctx_t *ctx, const search_t *search, int ber)
+{
+    if (!bench_enabled(bench, name)) {
+        return;
+    }
+
+    int nframes = 0;
+    for (int run = 0; run < NRUNS; ++run) {
+        const int scr = rand() % SCR_SEARCH_NSCR;
+        frame_encoder_t *fe = frame_encoder_create(TETRAPOL_BAND_UHF, scr,
+                DIR_DOWNLINK);
+        if (!fe) {
+            LOG(ERR, "Failed to initialize benchmark");
+            return;
+        }
+        search->reset(ctx);
+        int scr_detected = SCR_SEARCH_NONE;
+        for (int i = 0; i < MAX_FRAMES && scr_detected == SCR_SEARCH_NONE;
+                ++i) {
+            uint8_t fr_data[FRAME_DATA_LEN];
+            mk_frame(fr_data, fe, ber);
+            scr_detected = search->push(ctx, fr_data);
+            ++nframes;
+        }
+        frame_encoder_destroy(fe);
+        if (scr_detected != scr) {
+            LOG(ERR, "%s: SCR %d detected as %d", name, scr, scr_detected);
+        }
+    }
+
+    bench_report(bench, name, (double)nframes / NRUNS, "frames");
+}
+
+void bench_tetrapol_scr_search(bench_t *bench)
+{
+    ctx_t *ctx = calloc(1, sizeof(ctx_t));
+    frame_encoder_t *fe = frame_encoder_create(TETRAPOL_BAND_UHF, SCR,
+            DIR_DOWNLINK);
+    if (ctx) {
+        ctx->ss = scr_search_create(TETRAPOL_BAND_UHF, CONFIDENCE);
+        ctx->rs.fd = frame_decoder_create(TETRAPOL_BAND_UHF, 0,
+                FRAME_TYPE_AUTO);
+        ctx->rs.band = TETRAPOL_BAND_UHF;
+        ctx->rs.confidence = CONFIDENCE;
+    }
+    if (!ctx || !fe || !ctx->ss || !ctx->rs.fd) {
+        LOG(ERR, "Failed to initialize benchmark");
+        goto err;
+    }
+
+    for (int i = 0; i < MAX_FRAMES; ++i) {
+        mk_frame(ctx->frames[i], fe, 100);
+    }
+    // whole detection from reset, BER 1/100
+    bench_run(bench, "scr_search_lock_ref", op_lock_ref, ctx);
+    bench_run(bench, "scr_search_lock", op_lock, ctx);
+
+    const int bers[] = { 1000, 100, 50, };
+    for (int i = 0; i < ARRAY_LEN(bers); ++i) {
+        char name[64];
+        snprintf(name, sizeof(name), "scr_search_frames_to_lock_ref_ber%d",
+                bers[i]);
+        bench_frames_to_lock(bench, name, ctx, &search_ref, bers[i]);
+        snprintf(name, sizeof(name), "scr_search_frames_to_lock_ber%d",
+                bers[i]);
+        bench_frames_to_lock(bench, name, ctx, &search_ss, bers[i]);
+    }
+
+err:
+    if (ctx) {
+        frame_decoder_destroy(ctx->rs.fd);
+        scr_search_destroy(ctx->ss);
+    }
+    free(ctx);
+    frame_encoder_destroy(fe);
+}
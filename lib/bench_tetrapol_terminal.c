@@ -0,0 +1,240 @@
+// terminal list of SDCH, see bench_tetrapol.c
+
+#define LOG_PREFIX "bench"
+#include <tetrapol/log.h>
+#include <tetrapol/misc.h>
+#include <tetrapol/terminal.h>
+
+#include "bench.h"
+
+#include <stdlib.h>
+#include <string.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+enum {
+    NTERMINALS = 10000,
+    /// addresses looked up in single run, live and unknown ones
+    NLOOKUPS = 4096,
+    /// frame duration, resolution of terminal timers
+    TICK_USEC = 20000,
+    /// terminals per list, addresses of single logical channel are 16 bit
+    MEM_TERMINALS_PER_LIST = 50000,
+    MEM_NLISTS_MAX = 4,
+};
+
+typedef struct {
+    terminal_list_t *tlist;
+    addr_t live[NTERMINALS];
+    addr_t lookups[NLOOKUPS];
+    int next;
+    time_evt_t te;
+    /// terminals evicted by last tick, inserted again to keep list full
+    addr_t evicted[NTERMINALS];
+    int nevicted;
+} ctx_t;
+
+static void rand_addr(addr_t *addr)
+{
+    addr->z = rand() & 1;
+    addr->y = rand() & 7;
+    addr->x = rand() & 0xfff;
+}
+
+static int op_lookup(void *arg)
+{
+    ctx_t *ctx = arg;
+    ctx->next = (ctx->next + 1) % NLOOKUPS;
+
+    return terminal_list_lookup(ctx->tlist, &ctx->lookups[ctx->next]) != NULL;
+}
+
+// new terminal appears and another one disappears
+static int op_insert_erase(void *arg)
+{
+    ctx_t *ctx = arg;
+    ctx->next = (ctx->next + 1) % NTERMINALS;
+    addr_t *addr = &ctx->live[ctx->next];
+
+    terminal_list_erase(ctx->tlist, addr);
+    do {
+        rand_addr(addr);
+    } while (terminal_list_lookup(ctx->tlist, addr));
+
+    return terminal_list_insert(ctx->tlist, addr) != NULL;
+}
+
+static void advance(ctx_t *ctx)
+{
+    ctx->te.tv.tv_usec += TICK_USEC;
+    ctx->te.tv.tv_sec += ctx->te.tv.tv_usec / 1000000;
+    ctx->te.tv.tv_usec %= 1000000;
+    terminal_list_tick(ctx->tlist, &ctx->te);
+}
+
+static void evict(tetrapol_t *tetrapol, void *arg,
+        const tetrapol_evt_evict_t *evt)
+{
+    ctx_t *ctx = arg;
+    ctx->evicted[ctx->nevicted++] = evt->addr;
+}
+
+// single frame passes, terminals expire continuously as they were inserted
+static int op_tick(void *arg)
+{
+    ctx_t *ctx = arg;
+    advance(ctx);
+
+    const int n = ctx->nevicted;
+    for (int i = 0; i < n; ++i) {
+        terminal_list_insert(ctx->tlist, &ctx->evicted[i]);
+    }
+    ctx->nevicted = 0;
+
+    return n;
+}
+
+/// heap in use, -1 when it is not available
+static long heap_used(void)
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    const struct mallinfo2 mi = mallinfo2();
+    return mi.uordblks;
+#else
+    return -1;
+#endif
+}
+
+/// memory used by terminals which sent single frame each
+static void bench_memory(bench_t *bench, const char *name, int nterms)
+{
+    if (!bench_enabled(bench, name) || heap_used() == -1) {
+        return;
+    }
+
+    const tetrapol_cfg_t cfg = {
+        .band = TETRAPOL_BAND_UHF,
+        .dir = DIR_DOWNLINK,
+        .radio_ch_type = TETRAPOL_RADIO_CCH,
+        .input_fmt = TETRAPOL_INPUT_PACKED,
+    };
+    tetrapol_t *tetrapol = tetrapol_create(&cfg);
+    if (!tetrapol) {
+        LOG(ERR, "Failed to initialize benchmark");
+        return;
+    }
+    tetrapol_set_event_handler(tetrapol, NULL, NULL);
+
+    terminal_list_t *tlists[MEM_NLISTS_MAX] = { NULL };
+    const int nlists = (nterms + MEM_TERMINALS_PER_LIST - 1) /
+        MEM_TERMINALS_PER_LIST;
+    const long heap = heap_used();
+    for (int i = 0; i < nlists; ++i) {
+        tlists[i] = terminal_list_create(tetrapol_get_tpol(tetrapol),
+                TETRAPOL_LOG_CH_SDCH);
+        if (!tlists[i]) {
+            LOG(ERR, "Failed to initialize benchmark");
+            goto err;
+        }
+    }
+
+    // receive ready without data
+    hdlc_frame_t hdlc_fr;
+    memset(&hdlc_fr, 0, sizeof(hdlc_fr));
+    hdlc_fr.command.cmd = COMMAND_SUPERVISION_RR;
+    hdlc_fr.nbits = 8 * 2;
+    for (int i = 0; i < nterms; ++i) {
+        const int a = i % MEM_TERMINALS_PER_LIST;
+        hdlc_fr.addr.z = a >> 15;
+        hdlc_fr.addr.y = (a >> 12) & 7;
+        hdlc_fr.addr.x = a & 0xfff;
+        if (terminal_list_push_hdlc_frame(tlists[i / MEM_TERMINALS_PER_LIST],
+                    &hdlc_fr)) {
+            LOG(ERR, "Failed to initialize benchmark");
+            goto err;
+        }
+    }
+    bench_report(bench, name, (double)(heap_used() - heap) / nterms,
+            "B/terminal");
+
+err:
+    for (int i = 0; i < nlists; ++i) {
+        if (tlists[i]) {
+            terminal_list_destroy(tlists[i]);
+        }
+    }
+    tetrapol_destroy(tetrapol);
+}
+
+void bench_tetrapol_terminal(bench_t *bench)
+{
+    bench_memory(bench, "terminal_memory_1k", 1000);
+    bench_memory(bench, "terminal_memory_10k", 10000);
+    bench_memory(bench, "terminal_memory_100k", 100000);
+
+    if (!bench_enabled(bench, "terminal_list")) {
+        return;
+    }
+
+    const tetrapol_cfg_t cfg = {
+        .band = TETRAPOL_BAND_UHF,
+        .dir = DIR_DOWNLINK,
+        .radio_ch_type = TETRAPOL_RADIO_CCH,
+        .input_fmt = TETRAPOL_INPUT_PACKED,
+    };
+    tetrapol_t *tetrapol = tetrapol_create(&cfg);
+    ctx_t *ctx = calloc(1, sizeof(ctx_t));
+    if (!tetrapol || !ctx) {
+        LOG(ERR, "Failed to initialize benchmark");
+        goto err;
+    }
+    const tetrapol_event_handler_t handler = {
+        .evict = evict,
+    };
+    tetrapol_set_event_handler(tetrapol, &handler, ctx);
+    ctx->tlist = terminal_list_create(tetrapol_get_tpol(tetrapol),
+            TETRAPOL_LOG_CH_SDCH);
+    if (!ctx->tlist) {
+        LOG(ERR, "Failed to initialize benchmark");
+        goto err;
+    }
+
+    // activity of terminals is spread over whole terminal timeout
+    const int ticks = tetrapol_get_terminal_timeout(tetrapol) *
+        (1000000 / TICK_USEC);
+    for (int i = 0; i < NTERMINALS; ++i) {
+        while (i * (long)ticks / NTERMINALS >
+                (ctx->te.tv.tv_sec * 1000000 + ctx->te.tv.tv_usec) / TICK_USEC) {
+            advance(ctx);
+        }
+        addr_t *addr = &ctx->live[i];
+        do {
+            rand_addr(addr);
+        } while (terminal_list_lookup(ctx->tlist, addr));
+        if (!terminal_list_insert(ctx->tlist, addr)) {
+            LOG(ERR, "Failed to initialize benchmark");
+            goto err;
+        }
+    }
+    // 3/4 of lookups hits live terminal
+    for (int i = 0; i < NLOOKUPS; ++i) {
+        if (i % 4) {
+            ctx->lookups[i] = ctx->live[rand() % NTERMINALS];
+        } else {
+            rand_addr(&ctx->lookups[i]);
+        }
+    }
+
+    bench_run(bench, "terminal_list_lookup_10k", op_lookup, ctx);
+    bench_run(bench, "terminal_list_tick_10k", op_tick, ctx);
+    ctx->next = 0;
+    bench_run(bench, "terminal_list_insert_erase_10k", op_insert_erase, ctx);
+
+err:
+    if (ctx && ctx->tlist) {
+        terminal_list_destroy(ctx->tlist);
+    }
+    free(ctx);
+    tetrapol_destroy(tetrapol);
+}
@@ -0,0 +1,69 @@
+// scheduler of callbacks, see bench_tetrapol.c
+
+#define LOG_PREFIX "bench"
+#include <tetrapol/log.h>
+#include <tetrapol/tp_timer.h>
+
+#include "bench.h"
+
+#include <stdlib.h>
+
+enum {
+    NTIMERS = 10000,
+    /// frame duration, usual tick
+    TICK_USEC = 20000,
+    /// period of callbacks with deadline, like T454
+    PERIOD_USEC = 10 * 1000000,
+};
+
+static int ncalls;
+
+static void callback(time_evt_t *te, void *ptr)
+{
+    ++ncalls;
+}
+
+static int op_tick(void *arg)
+{
+    tp_timer_tick(arg, false, TICK_USEC);
+
+    return ncalls;
+}
+
+static void run(bench_t *bench, const char *name, bool every_tick)
+{
+    tp_timer_t *timer = tp_timer_create();
+    if (!timer) {
+        LOG(ERR, "Failed to initialize benchmark");
+        return;
+    }
+
+    // registration on every tick must be unique, ptr is not used otherwise
+    static char ptrs[NTIMERS];
+    for (int i = 0; i < NTIMERS; ++i) {
+        const tp_timer_entry_t *entry = every_tick ?
+            tp_timer_register(timer, callback, &ptrs[i]) :
+            tp_timer_add(timer, rand() % PERIOD_USEC, PERIOD_USEC, callback,
+                    NULL);
+        if (!entry) {
+            LOG(ERR, "Failed to initialize benchmark");
+            tp_timer_destroy(timer);
+            return;
+        }
+    }
+
+    bench_run(bench, name, op_tick, timer);
+    tp_timer_destroy(timer);
+}
+
+void bench_tetrapol_timer(bench_t *bench)
+{
+    // callbacks with deadline, only due ones are called
+    if (bench_enabled(bench, "tp_timer_tick_10k_deadline")) {
+        run(bench, "tp_timer_tick_10k_deadline", false);
+    }
+    // all callbacks called by each tick
+    if (bench_enabled(bench, "tp_timer_tick_10k_every_tick")) {
+        run(bench, "tp_timer_tick_10k_every_tick", true);
+    }
+}
@@ -91,7 +91,7 @@ int cch_push_frame(cch_t *cch, const frame_t *fr)
         }
     }
 
-    if (cch->tpol->frame_no == FRAME_NO_UNKNOWN) {
+    if (cch->tpol->frame_no == TETRAPOL_FRAME_NO_UNKNOWN) {
         return 0;
     }
 
@@ -146,4 +146,6 @@ void cch_fr_error(cch_t *cch)
 
 void cch_tick(time_evt_t *te, void *cch)
 {
+    cch_t *cch_ = cch;
+    sdch_tick(te, cch_->sdch);
 }
@@ -0,0 +1,521 @@
+#define LOG_PREFIX "chan_gen"
+#include <tetrapol/log.h>
+#include <tetrapol/chan_gen.h>
+#include <tetrapol/frame.h>
+#include <tetrapol/hdlc_frame.h>
+#include <tetrapol/misc.h>
+#include <tetrapol/system_config.h>
+#include <tetrapol/tsdu.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+    SUPERFRAME_LEN = 200,
+    BLOCK_LEN = 8,          ///< data block size in bytes
+    // longest output of single frame (with inserted bit) + unread bits
+    BITS_LEN = 3 * FRAME_LEN,
+    // terminal addresses used for pool, x = 0 and y = 7 are special
+    ADDR_X_NUM = 4094,
+    ADDR_Y_NUM = 7,
+};
+
+// frame number within data frame, see data_frame.c
+enum {
+    FN_00 = 00,
+    FN_01 = 01,
+    FN_10 = 02,
+    FN_11 = 03,
+};
+
+/// data blocks of logical channel waiting for transmission
+typedef struct {
+    frame_t frames[SYS_PAR_DATA_FRAME_BLOCKS_MAX + 1];
+    int len;
+    int pos;
+} block_queue_t;
+
+struct chan_gen_priv_t {
+    chan_gen_cfg_t cfg;
+    chan_gen_stats_t stats;
+    frame_encoder_t *fe;
+    uint64_t rnd;           ///< xorshift state
+    int frame_no;
+    int superframe_cpt;
+    int burst_left;         ///< bits remaining in current error burst
+    int dropout_left;       ///< frames remaining in current dropout
+    block_queue_t bch;
+    block_queue_t pch;
+    block_queue_t rch;
+    block_queue_t sdch;     ///< SDCH on CCH, SCH on TCH
+    /// generated bits, one bit per byte, waiting for read
+    uint8_t bits[BITS_LEN];
+    int bits_begin;
+    int bits_end;
+};
+
+static uint64_t rnd_next(chan_gen_t *gen)
+{
+    // xorshift64*
+    gen->rnd ^= gen->rnd >> 12;
+    gen->rnd ^= gen->rnd << 25;
+    gen->rnd ^= gen->rnd >> 27;
+
+    return gen->rnd * 0x2545f4914f6cdd1dULL;
+}
+
+static int rnd_int(chan_gen_t *gen, int n)
+{
+    return (rnd_next(gen) >> 32) % n;
+}
+
+static bool rnd_ppm(chan_gen_t *gen, int ppm)
+{
+    return ppm && rnd_int(gen, 1000000) < ppm;
+}
+
+chan_gen_t *chan_gen_create(const chan_gen_cfg_t *cfg)
+{
+    if (cfg->radio_ch_type != TETRAPOL_RADIO_CCH &&
+            cfg->radio_ch_type != TETRAPOL_RADIO_TCH) {
+        LOG(ERR, "Unsupported radio channel type %d", cfg->radio_ch_type);
+        return NULL;
+    }
+    if (cfg->input_fmt != TETRAPOL_INPUT_UNPACKED &&
+            cfg->input_fmt != TETRAPOL_INPUT_PACKED) {
+        LOG(ERR, "Unsupported input format %d", cfg->input_fmt);
+        return NULL;
+    }
+    if (cfg->scr < 0 || cfg->scr > 127) {
+        LOG(ERR, "Invalid SCR %d", cfg->scr);
+        return NULL;
+    }
+    if (cfg->nterminals < 1 || cfg->nterminals > ADDR_X_NUM * ADDR_Y_NUM) {
+        LOG(ERR, "Invalid number of terminals %d", cfg->nterminals);
+        return NULL;
+    }
+    if (!cfg->seed) {
+        LOG(ERR, "Seed must not be 0");
+        return NULL;
+    }
+
+    chan_gen_t *gen = calloc(1, sizeof(chan_gen_t));
+    if (!gen) {
+        return NULL;
+    }
+
+    gen->fe = frame_encoder_create(cfg->band, cfg->scr, DIR_DOWNLINK);
+    if (!gen->fe) {
+        free(gen);
+        return NULL;
+    }
+
+    memcpy(&gen->cfg, cfg, sizeof(gen->cfg));
+    gen->rnd = cfg->seed;
+
+    // receiver is not aligned to frames, start with random noise
+    gen->bits_end = rnd_int(gen, FRAME_LEN);
+    for (int i = 0; i < gen->bits_end; ++i) {
+        gen->bits[i] = rnd_next(gen) & 1;
+    }
+    gen->stats.bits = gen->bits_end;
+
+    return gen;
+}
+
+void chan_gen_destroy(chan_gen_t *gen)
+{
+    if (gen) {
+        frame_encoder_destroy(gen->fe);
+    }
+    free(gen);
+}
+
+const chan_gen_stats_t *chan_gen_get_stats(const chan_gen_t *gen)
+{
+    return &gen->stats;
+}
+
+/**
+  Compute FCS of HDLC frame, FCS is stored behind data, see check_fcs().
+
+  @param nbits Length of data without FCS.
+  */
+static void mk_fcs(uint8_t *data, int nbits)
+{
+    uint32_t crc = 0;
+    for (int i = 0; i < nbits + 16; ++i) {
+        const int bit = (i < nbits) ? (data[i / 8] >> (i % 8)) & 1 : 0;
+        crc = (crc << 1) | bit;
+        if (crc & 0x10000) {
+            crc ^= 0x11021;
+        }
+        // first 16 bits are inverted
+        if (i == 15) {
+            crc ^= 0xffff;
+        }
+    }
+
+    // remainder of frame including FCS must be 0xffff
+    const uint32_t fcs = crc ^ 0xffff;
+    data[nbits / 8] = 0;
+    data[nbits / 8 + 1] = 0;
+    for (int i = 0; i < 16; ++i) {
+        data[(nbits + i) / 8] |= ((fcs >> (15 - i)) & 1) << (i % 8);
+    }
+}
+
+static void put_addr(uint8_t *data, int z, int y, int x)
+{
+    data[0] = (z << 7) | (y << 4) | (x >> 8);
+    data[1] = x;
+}
+
+/// random terminal from pool
+static void put_term_addr(chan_gen_t *gen, uint8_t *data)
+{
+    const int idx = rnd_int(gen, gen->cfg.nterminals);
+    put_addr(data, 0, idx / ADDR_X_NUM, idx % ADDR_X_NUM + 1);
+}
+
+/**
+  Split data into frames of logical channel. Multiblock data frame is
+  followed by parity frame (PAS 0001-3-3 5.2).
+  */
+static void mk_blocks(block_queue_t *q, const uint8_t *data, int nblocks)
+{
+    q->pos = 0;
+    q->len = (nblocks < 3) ? nblocks : nblocks + 1;
+    memset(q->frames, 0, q->len * sizeof(frame_t));
+
+    for (int n = 0; n < q->len; ++n) {
+        frame_t *fr = &q->frames[n];
+        fr->fr_type = FRAME_TYPE_DATA;
+
+        int fn;
+        if (nblocks == 1) {
+            fn = FN_00;
+        } else if (nblocks == 2) {
+            fn = n ? FN_11 : FN_01;
+        } else if (n == 0 || n == q->len - 1) {
+            fn = FN_01;
+        } else if (n == 1 || n == q->len - 2) {
+            fn = FN_10;
+        } else {
+            fn = FN_11;
+        }
+        frame_set_bits(fr, FRAME_DATA_FN, 2, fn);
+
+        uint64_t payload = 0;
+        if (n < nblocks) {
+            for (int i = 0; i < BLOCK_LEN; ++i) {
+                payload |= (uint64_t)data[BLOCK_LEN * n + i] << (8 * i);
+            }
+        } else {
+            for (int k = 0; k < n; ++k) {
+                payload ^= frame_data_payload(&q->frames[k]);
+            }
+        }
+        frame_set_bits(fr, FRAME_DATA_PAYLOAD, 64, payload);
+    }
+}
+
+/**
+  Create HDLC frame of nblocks data blocks, payload is padded by zeros.
+  */
+static void mk_hdlc(uint8_t *data, int nblocks, const uint8_t *addr,
+        uint8_t cmd, const uint8_t *payload, int len)
+{
+    const int size = BLOCK_LEN * nblocks;
+
+    memset(data, 0, size);
+    memcpy(data, addr, 2);
+    data[2] = cmd;
+    if (len) {
+        memcpy(data + 3, payload, len);
+    }
+    mk_fcs(data, 8 * (size - 2));
+}
+
+/// PAS 0001-3-3 7.4.1.6, BCH carries D_SYSTEM_INFO in UI frame
+static void mk_bch(chan_gen_t *gen)
+{
+    uint8_t tsdu[17];
+    memset(tsdu, 0, sizeof(tsdu));
+    tsdu[0] = D_SYSTEM_INFO;
+    // cell_state: normal mode, BCH number
+    tsdu[1] = (gen->frame_no >= SUPERFRAME_LEN / 2) << 4;
+    // cell_config: default multiplexing
+    tsdu[2] = CELL_CONFIG_MUX_TYPE_DEFAULT << 2;
+    tsdu[3] = 0x21;     // country_code
+    tsdu[4] = 0x10;     // system_id
+    tsdu[5] = 0x01;     // loc_area_id
+    tsdu[6] = 0x01;     // bn_id
+    tsdu[7] = 0x12;     // cell_id
+    tsdu[8] = 0x34;
+    tsdu[9] = 0x56;
+    tsdu[10] = gen->cfg.scr;
+    tsdu[15] = (gen->superframe_cpt >> 8) & 0x0f;
+    tsdu[16] = gen->superframe_cpt;
+
+    // TPDU UI: no segmentation, length of TSDU
+    uint8_t payload[2 + sizeof(tsdu)];
+    payload[0] = 0x00;
+    payload[1] = sizeof(tsdu);
+    memcpy(payload + 2, tsdu, sizeof(tsdu));
+
+    uint8_t addr[2];
+    put_addr(addr, 0, 7, 0xfff);
+
+    uint8_t data[3 * BLOCK_LEN];
+    mk_hdlc(data, 3, addr, COMMAND_UNNUMBERED_UI, payload, sizeof(payload));
+    mk_blocks(&gen->bch, data, 3);
+}
+
+/// activation bitmap followed by paged addresses
+static void mk_pch(chan_gen_t *gen)
+{
+    uint8_t data[2 * BLOCK_LEN];
+    memset(data, 0, BLOCK_LEN);
+    const int act = rnd_int(gen, 8 * BLOCK_LEN);
+    data[act / 8] = 1 << (act % 8);
+    const int naddrs = rnd_int(gen, 5);
+    for (int i = 0; i < 4; ++i) {
+        if (i < naddrs) {
+            put_term_addr(gen, &data[BLOCK_LEN + 2*i]);
+        } else {
+            put_addr(&data[BLOCK_LEN + 2*i], 0, 7, 0);
+        }
+    }
+    mk_blocks(&gen->pch, data, 2);
+}
+
+/// random access acknowledgments protected by FCS
+static void mk_rch(chan_gen_t *gen)
+{
+    uint8_t data[BLOCK_LEN];
+    const int naddrs = rnd_int(gen, 4);
+    for (int i = 0; i < 3; ++i) {
+        if (i < naddrs) {
+            put_term_addr(gen, &data[2*i]);
+        } else {
+            put_addr(&data[2*i], 0, 7, 0);
+        }
+    }
+    mk_fcs(data, 8 * (BLOCK_LEN - 2));
+    mk_blocks(&gen->rch, data, 1);
+}
+
+/// HDLC traffic of terminals, UI D_GROUP_PAGING or RR
+static void mk_sdch(chan_gen_t *gen)
+{
+    uint8_t addr[2];
+    put_term_addr(gen, addr);
+    ++gen->stats.hdlc_frames;
+
+    if (rnd_int(gen, 4) == 0) {
+        uint8_t data[BLOCK_LEN];
+        const uint8_t cmd = (rnd_int(gen, 8) << 5) | COMMAND_SUPERVISION_RR;
+        mk_hdlc(data, 1, addr, cmd, NULL, 0);
+        mk_blocks(&gen->sdch, data, 1);
+        return;
+    }
+
+    const int group_id = rnd_int(gen, 0x1000);
+    const uint8_t payload[] = {
+        // TPDU UI: no segmentation, length of TSDU
+        0x00, 5,
+        D_GROUP_PAGING, group_id >> 8, group_id, rnd_next(gen), 0x00,
+    };
+    uint8_t data[2 * BLOCK_LEN];
+    mk_hdlc(data, 2, addr, COMMAND_UNNUMBERED_UI, payload, sizeof(payload));
+    mk_blocks(&gen->sdch, data, 2);
+}
+
+static const frame_t *pop_block(block_queue_t *q)
+{
+    return &q->frames[q->pos++];
+}
+
+static void next_cch_frame(chan_gen_t *gen, frame_t *fr)
+{
+    const int fn_mod = gen->frame_no % 100;
+
+    if (fn_mod == 0) {
+        mk_bch(gen);
+    }
+    if (fn_mod <= 3) {
+        memcpy(fr, pop_block(&gen->bch), sizeof(frame_t));
+        return;
+    }
+
+    if (fn_mod == 98) {
+        mk_pch(gen);
+    }
+    if (fn_mod == 98 || fn_mod == 99) {
+        memcpy(fr, pop_block(&gen->pch), sizeof(frame_t));
+        return;
+    }
+
+    if (fn_mod % 25 == 14) {
+        mk_rch(gen);
+        memcpy(fr, pop_block(&gen->rch), sizeof(frame_t));
+        return;
+    }
+
+    if (gen->sdch.pos == gen->sdch.len) {
+        mk_sdch(gen);
+    }
+    memcpy(fr, pop_block(&gen->sdch), sizeof(frame_t));
+}
+
+static void next_tch_frame(chan_gen_t *gen, frame_t *fr)
+{
+    if (gen->frame_no % 25 < 2) {
+        if (gen->sdch.pos == gen->sdch.len) {
+            mk_sdch(gen);
+        }
+        memcpy(fr, pop_block(&gen->sdch), sizeof(frame_t));
+        return;
+    }
+
+    memset(fr, 0, sizeof(frame_t));
+    fr->fr_type = FRAME_TYPE_VOICE;
+    for (int i = 0; i < 20; ++i) {
+        frame_set_bits(fr, FRAME_VOICE1 + i, 1, rnd_next(gen) & 1);
+    }
+    for (int i = 0; i < 100; ++i) {
+        frame_set_bits(fr, FRAME_VOICE2 + i, 1, rnd_next(gen) & 1);
+    }
+}
+
+/// apply bit errors and dropouts to frame
+static void impair(chan_gen_t *gen, uint8_t *bits)
+{
+    if (gen->dropout_left || rnd_ppm(gen, gen->cfg.dropout_ppm)) {
+        if (!gen->dropout_left) {
+            ++gen->stats.dropouts;
+            gen->dropout_left = gen->cfg.dropout_len;
+        }
+        --gen->dropout_left;
+        ++gen->stats.frames_lost;
+        for (int i = 0; i < FRAME_LEN; ++i) {
+            bits[i] = rnd_next(gen) & 1;
+        }
+        return;
+    }
+
+    if (rnd_ppm(gen, gen->cfg.burst_ppm)) {
+        ++gen->stats.bursts;
+        gen->burst_left = gen->cfg.burst_len;
+    }
+
+    for (int i = 0; i < FRAME_LEN; ++i) {
+        bool err = rnd_ppm(gen, gen->cfg.ber_ppm);
+        if (gen->burst_left) {
+            --gen->burst_left;
+            err |= rnd_next(gen) & 1;
+        }
+        if (err) {
+            bits[i] ^= 1;
+            ++gen->stats.bit_errs;
+        }
+    }
+}
+
+/**
+  Generate next frame into bits.
+
+  @return false at the end of stream
+  */
+static bool gen_frame(chan_gen_t *gen)
+{
+    if (gen->cfg.nframes && gen->stats.frames == gen->cfg.nframes) {
+        return false;
+    }
+
+    frame_t fr;
+    if (gen->cfg.radio_ch_type == TETRAPOL_RADIO_CCH) {
+        next_cch_frame(gen, &fr);
+    } else {
+        next_tch_frame(gen, &fr);
+    }
+
+    uint8_t fr_bytes[FRAME_LEN / 8];
+    frame_encoder_encode(gen->fe, fr_bytes, &fr);
+
+    // drop bits already read
+    memmove(gen->bits, gen->bits + gen->bits_begin,
+            gen->bits_end - gen->bits_begin);
+    gen->bits_end -= gen->bits_begin;
+    gen->bits_begin = 0;
+
+    uint8_t *bits = gen->bits + gen->bits_end;
+    for (int i = 0; i < FRAME_LEN; ++i) {
+        bits[i] = (fr_bytes[i / 8] >> (i % 8)) & 1;
+    }
+    impair(gen, bits);
+    int nbits = FRAME_LEN;
+
+    if (rnd_ppm(gen, gen->cfg.slip_ppm)) {
+        ++gen->stats.slips;
+        const int pos = rnd_int(gen, FRAME_LEN);
+        if (rnd_next(gen) & 1) {
+            memmove(bits + pos, bits + pos + 1, FRAME_LEN - pos - 1);
+            --nbits;
+        } else {
+            memmove(bits + pos + 1, bits + pos, FRAME_LEN - pos);
+            bits[pos] = rnd_next(gen) & 1;
+            ++nbits;
+        }
+    }
+
+    gen->bits_end += nbits;
+    gen->stats.bits += nbits;
+    ++gen->stats.frames;
+
+    if (++gen->frame_no == SUPERFRAME_LEN) {
+        gen->frame_no = 0;
+        gen->superframe_cpt = (gen->superframe_cpt + 1) % 0x1000;
+    }
+
+    return true;
+}
+
+int chan_gen_read(void *gen_, uint8_t *buf, int len)
+{
+    chan_gen_t *gen = gen_;
+
+    int n = 0;
+    if (gen->cfg.input_fmt == TETRAPOL_INPUT_UNPACKED) {
+        while (n < len) {
+            if (gen->bits_begin == gen->bits_end && !gen_frame(gen)) {
+                break;
+            }
+            int l = gen->bits_end - gen->bits_begin;
+            l = (l > len - n) ? len - n : l;
+            memcpy(buf + n, gen->bits + gen->bits_begin, l);
+            gen->bits_begin += l;
+            n += l;
+        }
+
+        return n;
+    }
+
+    while (n < len) {
+        while (gen->bits_end - gen->bits_begin < 8 && gen_frame(gen));
+        const int l = gen->bits_end - gen->bits_begin;
+        if (!l) {
+            break;
+        }
+        // the last byte of stream is padded by zeros
+        buf[n] = 0;
+        for (int i = 0; i < 8 && i < l; ++i) {
+            buf[n] |= gen->bits[gen->bits_begin + i] << i;
+        }
+        gen->bits_begin += (l < 8) ? l : 8;
+        ++n;
+    }
+
+    return n;
+}
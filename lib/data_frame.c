@@ -16,9 +16,29 @@ enum {
     FN_11 = 03,
 };
 
+enum {
+    /// bits of block_t.fn_asb
+    BLOCK_FN1 = 1 << 1,
+    BLOCK_ASB0 = 1 << 2,
+};
+
+/// payload bits covered by multiblock parity, it checks bits 3-66 of
+/// frame_data_t.data, so the first payload bit is not checked
+#define BLOCK_PARITY_DATA (~(uint64_t)1)
+
+/**
+  Block of data frame, bits of frame_data_t packed into words. Repair by
+  parity restores bits 1-66 of frame_data_t.data, FN bit 1 up to ASB bit 0.
+  */
+typedef struct {
+    uint64_t data;      ///< payload, the first bit in LSB
+    uint8_t fn_asb;     ///< FN in bits 0-1, ASB in bits 2-3
+    int8_t fn;          ///< FN_xx, -1 for broken frame
+    bool broken;
+} block_t;
+
 struct data_frame_priv_t {
-    frame_t frames[SYS_PAR_DATA_FRAME_BLOCKS_MAX + 1];
-    int fn[SYS_PAR_DATA_FRAME_BLOCKS_MAX + 1];
+    block_t blocks[SYS_PAR_DATA_FRAME_BLOCKS_MAX + 1];
     int nframes;
     int nerrs;
 };
@@ -51,19 +71,24 @@ void data_frame_reset(data_frame_t *data_fr)
     data_fr->nerrs = 0;
 }
 
+static void block_pack(block_t *blk, const frame_t *fr)
+{
+    blk->data = frame_data_payload(fr);
+    blk->fn_asb = frame_fn(fr) |
+        (frame_get_bits(fr, FRAME_DATA_ASB, 2) << 2);
+    blk->broken = fr->broken;
+}
+
 static bool check_parity(data_frame_t *data_fr)
 {
-    for (int i = 3; i < 3 + 64; ++i) {
-        int parity = 0;
-        for (int fr_no = 0; fr_no < data_fr->nframes; ++fr_no) {
-            parity ^= data_fr->frames[fr_no].data.data[i];
-        }
-        if (parity) {
-            return false;
-        }
+    uint64_t data = 0;
+    uint8_t fn_asb = 0;
+    for (int fr_no = 0; fr_no < data_fr->nframes; ++fr_no) {
+        data ^= data_fr->blocks[fr_no].data;
+        fn_asb ^= data_fr->blocks[fr_no].fn_asb;
     }
 
-    return true;
+    return !(data & BLOCK_PARITY_DATA) && !(fn_asb & BLOCK_ASB0);
 }
 
 static void fix_by_parity(data_frame_t *data_fr)
@@ -71,7 +96,7 @@ static void fix_by_parity(data_frame_t *data_fr)
     int err_fr_no = 0;
 
     for (int fr_no = 0; fr_no < data_fr->nframes; ++fr_no) {
-        if (data_fr->frames[fr_no].broken) {
+        if (data_fr->blocks[fr_no].broken) {
             err_fr_no = fr_no;
             break;
         }
@@ -82,15 +107,18 @@ static void fix_by_parity(data_frame_t *data_fr)
         return;
     }
 
-    for (int i = 1; i < 1 + 64 + 2; ++i) {
-        int bit = 0;
-        for (int fr_no = 0; fr_no < data_fr->nframes; ++fr_no) {
-            if (fr_no != err_fr_no) {
-                bit ^= data_fr->frames[fr_no].data.data[i];
-            }
-            data_fr->frames[err_fr_no].data.data[i] = bit;
+    uint64_t data = 0;
+    uint8_t fn_asb = 0;
+    for (int fr_no = 0; fr_no < data_fr->nframes; ++fr_no) {
+        if (fr_no != err_fr_no) {
+            data ^= data_fr->blocks[fr_no].data;
+            fn_asb ^= data_fr->blocks[fr_no].fn_asb;
         }
     }
+    block_t *blk = &data_fr->blocks[err_fr_no];
+    blk->data = data;
+    blk->fn_asb = (blk->fn_asb & ~(BLOCK_FN1 | BLOCK_ASB0)) |
+        (fn_asb & (BLOCK_FN1 | BLOCK_ASB0));
 }
 
 static int data_frame_check_multiblock(data_frame_t *data_fr)
@@ -124,7 +152,7 @@ static int data_frame_push_frame_(data_frame_t *data_fr, const frame_t *fr)
 
 int data_frame_push_frame(data_frame_t *data_fr, const frame_t *fr)
 {
-    if (data_fr->nframes == ARRAY_LEN(data_fr->frames)) {
+    if (data_fr->nframes == ARRAY_LEN(data_fr->blocks)) {
         data_frame_reset(data_fr);
     }
 
@@ -135,10 +163,10 @@ int data_frame_push_frame(data_frame_t *data_fr, const frame_t *fr)
         return -1;
     }
 
-    const int fn = fr->data.data[0] | (fr->data.data[1] << 1);
-    data_fr->fn[data_fr->nframes] = fr->broken ? -1 : fn;
-
-    memcpy(&data_fr->frames[data_fr->nframes], fr, sizeof(frame_t));
+    const int fn = frame_fn(fr);
+    block_t *blk = &data_fr->blocks[data_fr->nframes];
+    block_pack(blk, fr);
+    blk->fn = fr->broken ? -1 : fn;
     ++data_fr->nframes;
 
     // single frame
@@ -157,8 +185,8 @@ int data_frame_push_frame(data_frame_t *data_fr, const frame_t *fr)
         return 0;
     }
 
-    const int fn_prev = data_fr->fn[data_fr->nframes - 2];
-    const bool fr_errors_prev = data_fr->frames[data_fr->nframes - 2].broken;
+    const int fn_prev = data_fr->blocks[data_fr->nframes - 2].fn;
+    const bool fr_errors_prev = data_fr->blocks[data_fr->nframes - 2].broken;
 
     // check for dualframe or multiframe
     if (data_fr->nframes == 2) {
@@ -245,9 +273,11 @@ int data_frame_get_bytes(data_frame_t *data_fr, uint8_t *data)
     const int nframes = (data_fr->nframes <= 2) ?
         data_fr->nframes : data_fr->nframes - 1;
 
-    memset(data, 0, 8*nframes);
     for (int fr_no = 0; fr_no < nframes; ++fr_no) {
-        pack_bits(data, data_fr->frames[fr_no].data.data + 2, 64*fr_no, 64);
+        const uint64_t w = data_fr->blocks[fr_no].data;
+        for (int i = 0; i < 8; ++i) {
+            data[8*fr_no + i] = w >> (8*i);
+        }
     }
 
     data_frame_reset(data_fr);
@@ -0,0 +1,254 @@
+#define _POSIX_C_SOURCE 200112L
+
+#define LOG_PREFIX "engine"
+#include <tetrapol/log.h>
+#include <tetrapol/engine.h>
+#include <tetrapol/phys_ch.h>
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+enum {
+    // input data processed by worker in single run of channel
+    CHUNK_LEN = 64 * 1024,
+};
+
+enum {
+    CH_STATE_READY,
+    CH_STATE_DONE,
+    CH_STATE_ERR,
+};
+
+typedef struct {
+    tetrapol_t *tetrapol;
+    phys_ch_t *phys_ch;
+    tetrapol_engine_read_t read;
+    void *ctx;
+    int state;
+} channel_t;
+
+struct tetrapol_engine_priv_t {
+    int nworkers;
+    int nchannels;
+    channel_t *channels;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    /// ring of channels waiting for worker
+    int *queue;
+    int queue_begin;
+    int queue_len;
+    /// number of channels with remaining input
+    int nactive;
+};
+
+tetrapol_engine_t *tetrapol_engine_create(int nworkers)
+{
+    if (nworkers < 1) {
+        LOG(ERR, "Invalid number of workers %d", nworkers);
+        return NULL;
+    }
+
+    tetrapol_engine_t *engine = calloc(1, sizeof(tetrapol_engine_t));
+    if (!engine) {
+        return NULL;
+    }
+
+    engine->nworkers = nworkers;
+    if (pthread_mutex_init(&engine->mutex, NULL)) {
+        free(engine);
+        return NULL;
+    }
+    if (pthread_cond_init(&engine->cond, NULL)) {
+        pthread_mutex_destroy(&engine->mutex);
+        free(engine);
+        return NULL;
+    }
+
+    return engine;
+}
+
+void tetrapol_engine_destroy(tetrapol_engine_t *engine)
+{
+    for (int i = 0; i < engine->nchannels; ++i) {
+        tetrapol_phys_ch_destroy(engine->channels[i].phys_ch);
+        tetrapol_destroy(engine->channels[i].tetrapol);
+    }
+    pthread_cond_destroy(&engine->cond);
+    pthread_mutex_destroy(&engine->mutex);
+    free(engine->queue);
+    free(engine->channels);
+    free(engine);
+}
+
+int tetrapol_engine_add_channel(tetrapol_engine_t *engine,
+        const tetrapol_cfg_t *cfg, tetrapol_engine_read_t read, void *ctx)
+{
+    channel_t *channels = realloc(engine->channels,
+            (engine->nchannels + 1) * sizeof(channel_t));
+    if (!channels) {
+        return -1;
+    }
+    engine->channels = channels;
+
+    channel_t *ch = &engine->channels[engine->nchannels];
+    ch->tetrapol = tetrapol_create(cfg);
+    if (!ch->tetrapol) {
+        return -1;
+    }
+    ch->phys_ch = tetrapol_phys_ch_create(ch->tetrapol);
+    if (!ch->phys_ch) {
+        tetrapol_destroy(ch->tetrapol);
+        return -1;
+    }
+    ch->read = read;
+    ch->ctx = ctx;
+    ch->state = CH_STATE_READY;
+    tetrapol_set_ch_id(ch->tetrapol, engine->nchannels);
+
+    return engine->nchannels++;
+}
+
+tetrapol_t *tetrapol_engine_get_tetrapol(tetrapol_engine_t *engine,
+        int ch_id)
+{
+    if (ch_id < 0 || ch_id >= engine->nchannels) {
+        return NULL;
+    }
+
+    return engine->channels[ch_id].tetrapol;
+}
+
+/**
+  Read and decode single chunk of channel input.
+
+  @return CH_STATE_READY when more data may follow, CH_STATE_DONE at the end
+    of input, CH_STATE_ERR on error.
+  */
+static int process_chunk(channel_t *ch, uint8_t *buf)
+{
+    log_set_lvl(tetrapol_get_log_lvl(ch->tetrapol));
+
+    const int len = ch->read(ch->ctx, buf, CHUNK_LEN);
+    if (len < 0) {
+        return CH_STATE_ERR;
+    }
+    if (len == 0) {
+        return CH_STATE_DONE;
+    }
+
+    for (int offs = 0; offs < len; ) {
+        const int rsize = tetrapol_phys_ch_recv(ch->phys_ch, buf + offs,
+                len - offs);
+        if (rsize < 0) {
+            return CH_STATE_ERR;
+        }
+        offs += rsize;
+
+        if (tetrapol_phys_ch_process(ch->phys_ch)) {
+            return CH_STATE_ERR;
+        }
+    }
+
+    return CH_STATE_READY;
+}
+
+static void *worker(void *arg)
+{
+    tetrapol_engine_t *engine = arg;
+
+    uint8_t *buf = malloc(CHUNK_LEN);
+    if (!buf) {
+        LOG(ERR, "Worker failed to allocate buffer");
+        return NULL;
+    }
+
+    pthread_mutex_lock(&engine->mutex);
+    while (true) {
+        while (!engine->queue_len && engine->nactive) {
+            pthread_cond_wait(&engine->cond, &engine->mutex);
+        }
+        if (!engine->nactive) {
+            break;
+        }
+
+        const int ch_id = engine->queue[engine->queue_begin];
+        engine->queue_begin = (engine->queue_begin + 1) % engine->nchannels;
+        --engine->queue_len;
+        pthread_mutex_unlock(&engine->mutex);
+
+        channel_t *ch = &engine->channels[ch_id];
+        const int state = process_chunk(ch, buf);
+
+        pthread_mutex_lock(&engine->mutex);
+        if (state == CH_STATE_READY) {
+            const int tail = (engine->queue_begin + engine->queue_len) %
+                engine->nchannels;
+            engine->queue[tail] = ch_id;
+            ++engine->queue_len;
+            pthread_cond_signal(&engine->cond);
+        } else {
+            ch->state = state;
+            if (!--engine->nactive) {
+                pthread_cond_broadcast(&engine->cond);
+            }
+        }
+    }
+    pthread_mutex_unlock(&engine->mutex);
+
+    free(buf);
+
+    return NULL;
+}
+
+int tetrapol_engine_run(tetrapol_engine_t *engine)
+{
+    if (!engine->nchannels) {
+        return 0;
+    }
+
+    free(engine->queue);
+    engine->queue = malloc(engine->nchannels * sizeof(int));
+    if (!engine->queue) {
+        return -1;
+    }
+    engine->queue_begin = 0;
+    engine->queue_len = 0;
+    engine->nactive = 0;
+    for (int i = 0; i < engine->nchannels; ++i) {
+        if (engine->channels[i].state == CH_STATE_READY) {
+            engine->queue[engine->queue_len++] = i;
+            ++engine->nactive;
+        }
+    }
+
+    // there is no use for more workers than channels
+    const int nworkers = (engine->nworkers < engine->nchannels) ?
+        engine->nworkers : engine->nchannels;
+    pthread_t threads[nworkers];
+    int nthreads = 0;
+    for (; nthreads < nworkers; ++nthreads) {
+        if (pthread_create(&threads[nthreads], NULL, worker, engine)) {
+            LOG(ERR, "Failed to start worker thread");
+            break;
+        }
+    }
+    if (!nthreads) {
+        return -1;
+    }
+
+    for (int i = 0; i < nthreads; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    // channel is not finished on error or when all workers failed to start
+    int ret = 0;
+    for (int i = 0; i < engine->nchannels; ++i) {
+        if (engine->channels[i].state != CH_STATE_DONE) {
+            ret = -1;
+        }
+    }
+
+    return ret;
+}
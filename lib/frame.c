@@ -9,6 +9,8 @@
 #include <tetrapol/bit_utils.h>
 #include <tetrapol/tetrapol.h>
 #include <tetrapol/frame.h>
+#include <tetrapol/misc.h>
+#include <tetrapol/viterbi.h>
 #include <limits.h>
 #include <stdbool.h>
 #include <stdlib.h>
@@ -17,12 +19,34 @@
 // used when decoding firts part of frame, common to data and voice frames
 enum {
     FRAME_DATA_LEN1 = 52,
+    FRAME_DATA_LEN2 = FRAME_DATA_LEN - FRAME_DATA_LEN1,
+    // data frame followed by second part of voice frame
+    PLAN_LEN = FRAME_DATA_LEN + FRAME_DATA_LEN2,
+    // second part of voice frame in plan
+    PLAN_VOICE2 = FRAME_DATA_LEN,
+    SCR_NUM = 128,
 };
 
+/*
+  Descrambling, differential decoding and deinterleaving are fused into
+  single pass driven by plan. Each output bit is xor of one or two bits of
+  frame data and of constant given by scrambling sequence. Plan depends on
+  band only, scrambling constants are built for each SCR when first used.
+  */
 struct frame_decoder_priv_t {
     int band;
     int scr;
     int fr_type;
+    /// band for which is plan built
+    int plan_band;
+    /// the first term of output bit, index into frame data
+    uint8_t src1[PLAN_LEN];
+    /// the second term of output bit, used only when diff is 1
+    uint8_t src2[PLAN_LEN];
+    uint8_t diff[PLAN_LEN];
+    /// scrambling constant for each output bit and SCR
+    uint64_t scr_mask[SCR_NUM][(PLAN_LEN + 63) / 64];
+    uint64_t scr_mask_valid[SCR_NUM / 64];
 };
 
 struct frame_encoder_priv_t {
@@ -225,68 +249,44 @@ static void frame_deinterleave1(uint8_t *fr_data_deint, const uint8_t *fr_data,
     }
 }
 
-/**
-  Deinterleave second part of frame (differs for data and voice frames)
-  */
-static void frame_deinterleave2(uint8_t *fr_data_deint, const uint8_t *fr_data,
-        int band, int fr_type)
+void frame_descramble_deint1(uint8_t *fr_data_deint, const uint8_t *fr_data,
+        int band, int scr)
 {
-    const uint8_t *int_table;
-
-    if (band == TETRAPOL_BAND_VHF) {
-        if (fr_type == FRAME_TYPE_DATA) {
-            int_table = interleave_data_VHF;
-        } else {
-            int_table = interleave_voice_VHF;
-        }
-    } else {
-        if (fr_type == FRAME_TYPE_DATA) {
-            int_table = interleave_data_UHF;
-        } else {
-            int_table = interleave_voice_UHF;
-        }
-    }
+    uint8_t fr_data_tmp[FRAME_DATA_LEN];
 
-    for (int j = FRAME_DATA_LEN1; j < FRAME_DATA_LEN; ++j) {
-        fr_data_deint[j] = fr_data[int_table[j]];
+    frame_descramble(fr_data_tmp, fr_data, scr);
+    if (band == TETRAPOL_BAND_UHF) {
+        frame_diff_dec(fr_data_tmp);
     }
+    frame_deinterleave1(fr_data_deint, fr_data_tmp, band);
 }
 
+/**
+  CRC of the first input_len bits of frame, bit res[k] of the original
+  bit per byte implementation is held in bit k of result.
+  */
 // http://ghsi.de/CRC/index.php?Polynom=10010
-static void mk_crc5(uint8_t *res, const uint8_t *input, int input_len)
+static uint8_t mk_crc5(const frame_t *fr, int input_len)
 {
-    uint8_t inv;
-    memset(res, 0, 5);
-
-    for (int i = 0; i < input_len; ++i)
-    {
-        inv = input[i] ^ res[0];
-
-        res[0] = res[1];
-        res[1] = res[2];
-        res[2] = res[3] ^ inv;
-        res[3] = res[4];
-        res[4] = inv;
+    uint8_t res = 0;
+    for (int i = 0; i < input_len; ++i) {
+        const uint8_t inv = ((fr->bits[i / 64] >> (i % 64)) ^ res) & 1;
+        res = (res >> 1) ^ (inv ? 0x14 : 0);
     }
+
+    return res;
 }
 
 // http://ghsi.de/CRC/index.php?Polynom=1010
-static void mk_crc3(uint8_t *res, const uint8_t *input, int input_len)
+static uint8_t mk_crc3(const frame_t *fr, int input_len)
 {
-    uint8_t inv;
-    memset(res, 0, 3);
-
-    for (int i = 0; i < input_len; ++i)
-    {
-        inv = input[i] ^ res[0];
-
-        res[0] = res[1];
-        res[1] = res[2] ^ inv;
-        res[2] = inv;
+    uint8_t res = 0;
+    for (int i = 0; i < input_len; ++i) {
+        const uint8_t inv = ((fr->bits[i / 64] >> (i % 64)) ^ res) & 1;
+        res = (res >> 1) ^ (inv ? 0x6 : 0);
     }
-    res[0] = res[0] ^ 1;
-    res[1] = res[1] ^ 1;
-    res[2] = res[2] ^ 1;
+
+    return res ^ 0x7;
 }
 
 /**
@@ -359,32 +359,122 @@ static int frame_decode2(uint8_t *fr_sol, uint8_t *fr_errs,
     return nerrs;
 }
 
-static bool frame_check_crc(const uint8_t *fr_data, frame_type_t fr_type)
+static bool frame_check_crc(const frame_t *fr, frame_type_t fr_type)
 {
     if (fr_type == FRAME_TYPE_AUTO) {
-        fr_type = fr_data[0];
+        fr_type = frame_d(fr);
     } else {
-        if (fr_type != fr_data[0]) {
+        if (fr_type != frame_d(fr)) {
             return false;
         }
     }
 
     if (fr_type == FRAME_TYPE_DATA) {
-        uint8_t crc[5];
-
-        mk_crc5(crc, fr_data, 69);
-        return !memcmp(fr_data + 69, crc, 5);
+        return mk_crc5(fr, FRAME_DATA_CRC) ==
+            frame_get_bits(fr, FRAME_DATA_CRC, 5);
     }
 
     if (fr_type == FRAME_TYPE_VOICE) {
-        uint8_t crc[3];
-
-        mk_crc3(crc, fr_data, 23);
-        return !memcmp(fr_data + 23, crc, 3);
+        return mk_crc3(fr, FRAME_VOICE_CRC) ==
+            frame_get_bits(fr, FRAME_VOICE_CRC, 3);
     }
     return false;
 }
 
+/// store len bits, one bit per byte, into frame starting at bit offs
+static void frame_put_unpacked(frame_t *fr, int offs, const uint8_t *bits,
+        int len)
+{
+    int i = 0;
+    for (; i + 64 <= len; i += 64) {
+        frame_set_bits(fr, offs + i, 64, pack_bits64(&bits[i]));
+    }
+    for (; i + 8 <= len; i += 8) {
+        frame_set_bits(fr, offs + i, 8, pack_bits8(&bits[i]));
+    }
+    for (; i < len; ++i) {
+        frame_set_bits(fr, offs + i, 1, bits[i]);
+    }
+}
+
+void frame_unpack(frame_unpacked_t *u, const frame_t *fr)
+{
+    for (int i = 0; i < ARRAY_LEN(u->blob_); ++i) {
+        u->blob_[i] = (fr->bits[i / 64] >> (i % 64)) & 1;
+    }
+}
+
+static uint64_t scramb_bit(int scr, int k)
+{
+    return scr ? scramb_table[(k + scr) % 127] : 0;
+}
+
+static void plan_build(frame_decoder_t *fd, int band)
+{
+    const uint8_t *data_table = interleave_data_UHF;
+    const uint8_t *voice_table = interleave_voice_UHF;
+    if (band == TETRAPOL_BAND_VHF) {
+        data_table = interleave_data_VHF;
+        voice_table = interleave_voice_VHF;
+    }
+
+    for (int i = 0; i < PLAN_LEN; ++i) {
+        const int j = (i < PLAN_VOICE2) ?
+            data_table[i] : voice_table[i - FRAME_DATA_LEN2];
+        fd->src1[i] = j;
+        fd->src2[i] = j;
+        fd->diff[i] = 0;
+        if (band == TETRAPOL_BAND_UHF && j > 0) {
+            fd->src2[i] = j - diff_precod_UHF[j];
+            fd->diff[i] = 1;
+        }
+    }
+
+    fd->plan_band = band;
+    memset(fd->scr_mask_valid, 0, sizeof(fd->scr_mask_valid));
+}
+
+static void plan_build_scr(frame_decoder_t *fd, int scr)
+{
+    if (fd->scr_mask_valid[scr / 64] & (1ULL << (scr % 64))) {
+        return;
+    }
+
+    uint64_t *mask = fd->scr_mask[scr];
+    memset(mask, 0, sizeof(fd->scr_mask[scr]));
+    for (int i = 0; i < PLAN_LEN; ++i) {
+        uint64_t bit = scramb_bit(scr, fd->src1[i]);
+        if (fd->diff[i]) {
+            bit ^= scramb_bit(scr, fd->src2[i]);
+        }
+        mask[i / 64] |= bit << (i % 64);
+    }
+    fd->scr_mask_valid[scr / 64] |= 1ULL << (scr % 64);
+}
+
+/**
+  Descramble, decode and deinterleave len bits of frame starting at plan
+  index begin.
+  */
+static void plan_apply(const frame_decoder_t *fd, uint8_t *out,
+        const uint8_t *fr_data, int begin, int len)
+{
+    const uint64_t *mask = fd->scr_mask[fd->scr];
+    for (int i = begin; i < begin + len; ++i) {
+        *out++ = fr_data[fd->src1[i]] ^ (fr_data[fd->src2[i]] & fd->diff[i]) ^
+            ((mask[i / 64] >> (i % 64)) & 1);
+    }
+}
+
+/// deinterleave reliability of len bits starting at plan index begin
+static void plan_apply_rel(const frame_decoder_t *fd, uint8_t *out,
+        const uint8_t *rel, int begin, int len)
+{
+    for (int i = begin; i < begin + len; ++i) {
+        *out++ = rel[fd->src1[i]];
+    }
+}
+
 frame_decoder_t *frame_decoder_create(int band, int scr, int fr_type)
 {
     frame_decoder_t *fd = malloc(sizeof(frame_decoder_t));
@@ -392,6 +482,7 @@ frame_decoder_t *frame_decoder_create(int band, int scr, int fr_type)
         return NULL;
     }
 
+    fd->plan_band = 0;
     frame_decoder_reset(fd, band, scr, fr_type);
 
     return fd;
@@ -405,13 +496,17 @@ void frame_decoder_destroy(frame_decoder_t *fd)
 void frame_decoder_reset(frame_decoder_t *fd, int band, int scr, int fr_type)
 {
     fd->band = band;
-    fd->scr = scr;
     fd->fr_type = fr_type;
+    if (fd->plan_band != band) {
+        plan_build(fd, band);
+    }
+    frame_decoder_set_scr(fd, scr);
 }
 
 void frame_decoder_set_scr(frame_decoder_t *fd, int scr)
 {
     fd->scr = scr;
+    plan_build_scr(fd, scr);
 }
 
 /**
@@ -513,49 +608,30 @@ int frame_fix_errs(uint8_t *fr_data, uint8_t *fr_errs, int len, int *bits_fixed)
 }
 
 /**
-  Fix errors in frame, using the Viterbi algorithm.
+  Get reliability of bits after differential decoding from reliability
+  of received symbols. Physical channel decodes the first differential
+  encoding, each bit is xor of all previous symbols. Decoding of UHF
+  precoding leaves xor of one or two symbols. Reliability of xor is
+  the lowest reliability of its terms.
   */
-int frame_viterbi(uint8_t *dec,const uint8_t *in_bits,int size)
-{
-  static unsigned char viterbi_table[8]={0,3,1,2,3,0,2,1};
-  int mi=999;
-  for(int s=0;s<4;s++) {
-    int back[size][4];
-    int tab[4],tab2[4];
-    memset(back,-1,sizeof(back));
-    for(int i=0;i<4;i++)
-      tab[i]=9999;
-    tab[s]=0;
-    for(int p=size-1;p>=0;p--) {
-      for(int i=0;i<4;i++) tab2[i]=9999;
-      for(int u=0;u<4;u++) {
-        for(int x=0;x<2;x++) {
-          int v=(u<<1)|x;
-          int e=viterbi_table[v];           //auto e=(encode64(v)>>4)&3;
-          int r=tab[u];
-          if(in_bits[2*p]!=(e&1)) r++;
-          if(in_bits[2*p+1]!=((e>>1)&1)) r++;
-          if(tab2[v%4]>r) {
-            tab2[v%4]=r;
-            back[p][v%4]=u;
-          }
+static void frame_rel(uint8_t *rel_tmp, const uint8_t *fr_rel, int band)
+{
+    rel_tmp[0] = fr_rel[0];
+    for (int j = 1; j < FRAME_DATA_LEN; ++j) {
+        uint8_t rel = fr_rel[j];
+        if (band == TETRAPOL_BAND_UHF) {
+            if (diff_precod_UHF[j] == 2 && fr_rel[j - 1] < rel) {
+                rel = fr_rel[j - 1];
+            }
+        } else if (rel_tmp[j - 1] < rel) {
+            rel = rel_tmp[j - 1];
         }
-      }
-      memcpy(tab,tab2,sizeof(tab));
-    }
-    if(mi>tab[s]) {
-      mi=tab[s];
-      int z=s;
-      for(int p=0;p<size;p++) {
-        dec[(size+p-2)%size]=(z&1);
-        z=back[p][z];
-      }
+        rel_tmp[j] = rel;
     }
-  }
-  return mi;
 }
 
-void frame_decoder_decode(frame_decoder_t *fd, frame_t *fr, const uint8_t *fr_data)
+static void decode(frame_decoder_t *fd, frame_t *fr, const uint8_t *fr_data,
+        const uint8_t *fr_rel)
 {
     if (fd->fr_type != FRAME_TYPE_AUTO &&
             fd->fr_type != FRAME_TYPE_VOICE &&
@@ -567,68 +643,58 @@ void frame_decoder_decode(frame_decoder_t *fd, frame_t *fr, const uint8_t *fr_da
 
     fr->bits_fixed = 0;
 
-    uint8_t fr_data_tmp[FRAME_DATA_LEN];
-
-    frame_descramble(fr_data_tmp, fr_data, fd->scr);
-    if (fd->band == TETRAPOL_BAND_UHF) {
-        frame_diff_dec(fr_data_tmp);
-    }
-
     uint8_t fr_data_deint[FRAME_DATA_LEN];
-#if 0
-    uint8_t fr_errs[FRAME_DATA_LEN];
-
-    frame_deinterleave1(fr_data_deint, fr_data_tmp, fd->band);
-    fr->broken = frame_decode1(fr->blob_, fr_errs, fr_data_deint, fd->fr_type);
-    fr->syndromes = fr->broken;
-
-    fr->fr_type = (fd->fr_type == FRAME_TYPE_AUTO) ? fr->d : fd->fr_type;
-
-    if (fr->broken) {
-        fr->broken -= frame_fix_errs(fr->blob_, fr_errs, 26, &fr->bits_fixed);
-        if (fr->broken > 0) {
-            return;
-        }
+    uint8_t rel_tmp[FRAME_DATA_LEN];
+    uint8_t rel_deint[FRAME_DATA_LEN];
+    if (fr_rel) {
+        frame_rel(rel_tmp, fr_rel, fd->band);
+        plan_apply_rel(fd, rel_deint, rel_tmp, 0, FRAME_DATA_LEN1);
     }
 
-    frame_deinterleave2(fr_data_deint, fr_data_tmp, fd->band, fr->fr_type);
-    fr->broken = frame_decode2(fr->blob_, fr_errs, fr_data_deint, fr->fr_type);
-    fr->syndromes += fr->broken;
-
-    if (fr->fr_type == FRAME_TYPE_VOICE) {
-        fr->broken = frame_check_crc(fr->blob_, fr->fr_type) ? 0 : -1;
-        return;
-    }
-
-    if (fr->broken) {
-        fr->broken -= frame_fix_errs(fr->blob_ + 26, fr_errs + 26, 50, &fr->bits_fixed);
-        if (fr->broken > 0) {
-            return;
-        }
-    }
-
-#else
     fr->broken=0;
-    frame_deinterleave1(fr_data_deint, fr_data_tmp, fd->band);
-    int f1=frame_viterbi(fr->blob_,fr_data_deint,26);
+    fr->bits[0] = fr->bits[1] = 0;
+    plan_apply(fd, fr_data_deint, fr_data, 0, FRAME_DATA_LEN1);
+    int f1 = fr_rel ?
+        viterbi_decode_soft_bits(fr->bits, 0, fr_data_deint, rel_deint, 26) :
+        viterbi_decode_bits(fr->bits, 0, fr_data_deint, 26);
     fr->bits_fixed+=f1;
     if(f1>=6) fr->broken=1; //if too many bits are fixed, we suppose that the packet is broken
 
-    fr->fr_type = (fd->fr_type == FRAME_TYPE_AUTO) ? (frame_type_t)fr->d : fd->fr_type;
+    fr->fr_type = (fd->fr_type == FRAME_TYPE_AUTO) ? (frame_type_t)frame_d(fr) : fd->fr_type;
 
-    frame_deinterleave2(fr_data_deint, fr_data_tmp, fd->band, fr->fr_type);
+    const int plan2 = (fr->fr_type == FRAME_TYPE_DATA) ?
+        FRAME_DATA_LEN1 : PLAN_VOICE2;
+    plan_apply(fd, fr_data_deint + FRAME_DATA_LEN1, fr_data, plan2,
+            FRAME_DATA_LEN2);
     if (fr->broken==0 && fr->fr_type != FRAME_TYPE_VOICE) {
-      int f2=frame_viterbi(fr->blob_+26,fr_data_deint+52,50);
+      int f2;
+      if (fr_rel) {
+        plan_apply_rel(fd, rel_deint + FRAME_DATA_LEN1, rel_tmp, plan2,
+                FRAME_DATA_LEN2);
+        f2 = viterbi_decode_soft_bits(fr->bits, 26, fr_data_deint+52, rel_deint+52, 50);
+      } else {
+        f2 = viterbi_decode_bits(fr->bits, 26, fr_data_deint+52, 50);
+      }
       if(f2>=11) fr->broken=1;
       fr->bits_fixed+=f2;
     }
     else {
-      memcpy(fr->blob_+26,fr_data_deint+52,100);
+      frame_put_unpacked(fr, 26, fr_data_deint+52, 100);
     }
     if(fr->broken) return;
-#endif
 
-    fr->broken = frame_check_crc(fr->blob_, fr->fr_type) ? 0 : -1;
+    fr->broken = frame_check_crc(fr, fr->fr_type) ? 0 : -1;
+}
+
+void frame_decoder_decode(frame_decoder_t *fd, frame_t *fr, const uint8_t *fr_data)
+{
+    decode(fd, fr, fr_data, NULL);
+}
+
+void frame_decoder_decode_soft(frame_decoder_t *fd, frame_t *fr,
+        const uint8_t *fr_data, const uint8_t *fr_rel)
+{
+    decode(fd, fr, fr_data, fr_rel);
 }
 
 frame_encoder_t *frame_encoder_create(int band, int scr, int dir)
@@ -656,24 +722,25 @@ void frame_encoder_set_scr(frame_encoder_t *fe, int scr)
     fe->scr = scr;
 }
 
-/** Pack bits, duplicate each bit. This prepares data for encoding. */
-static uint64_t pack_2x4b_64(const uint8_t *bits, int len)
+/** Duplicate each of 32 bits. This prepares data for encoding. */
+static uint64_t spread_2x(uint32_t bits)
 {
-    uint64_t val = 0;
-    while (len) {
-        --len;
-        val <<= 2;
-        val |= bits[len] * 0x03;
-    }
+    uint64_t val = bits;
+    val = (val | (val << 16)) & 0x0000ffff0000ffffLL;
+    val = (val | (val << 8)) & 0x00ff00ff00ff00ffLL;
+    val = (val | (val << 4)) & 0x0f0f0f0f0f0f0f0fLL;
+    val = (val | (val << 2)) & 0x3333333333333333LL;
+    val = (val | (val << 1)) & 0x5555555555555555LL;
 
-    return val;
+    return val * 0x03;
 }
 
 // PAS 0001-2 6.1.2 - protected part
 // PAS 0001-2 6.2.2 - protected part
-static void frame_encode1(uint8_t *out_bytes, const uint8_t *in_bits)
+/// @param in_bits The first 26 bits of frame, the first bit in LSB.
+static void frame_encode1(uint8_t *out_bytes, uint64_t in_bits)
 {
-    uint64_t data = pack_2x4b_64(in_bits, 26);
+    uint64_t data = spread_2x(in_bits & ((1LL << 26) - 1));
 
     // create data shifted by 1 and 2 (double)bits
     uint64_t data_1 = data << 2;
@@ -685,19 +752,20 @@ static void frame_encode1(uint8_t *out_bytes, const uint8_t *in_bits)
     // drop one bit copy from data_1
     data_1 &= 0x5555555555555555LL;
 
-    *(uint64_t *)out_bytes = htole64(data ^ data_1 ^ data_2);
+    // keep only 2*26 bits, the rest belongs to the second part of frame
+    *(uint64_t *)out_bytes = htole64((data ^ data_1 ^ data_2) & ((1LL << (2*26)) - 1));
 }
 
 /**
   Encode second part of data for data frame. Bits already encoded by
   frame_encode1 are skipped.
+
+  @param in_bits Bits 26 to 75 of frame, bit 26 in LSB.
   */
-static void frame_encode2(uint8_t *out_bytes, const uint8_t *in_bits)
+static void frame_encode2(uint8_t *out_bytes, uint64_t in_bits)
 {
-    in_bits += 26;
-
-    uint64_t data_a = pack_2x4b_64(in_bits, 18);
-    uint64_t data_b = pack_2x4b_64(in_bits + 18, 32);
+    uint64_t data_a = spread_2x(in_bits & ((1LL << 18) - 1));
+    uint64_t data_b = spread_2x(in_bits >> 18);
 
     // create data with shifted by -1 and -2
     uint64_t data_a_1 = data_a << 2;
@@ -841,15 +909,14 @@ static uint8_t differential_enc(uint8_t *data, int size, uint8_t first_bit)
 
 static int encode_data(frame_encoder_t *fe, uint8_t *fr_data, frame_t *fr)
 {
-    fr->data.d = 1;
-    mk_crc5(fr->data.crc, fr->data.crc_data, sizeof(fr->data.crc_data));
-
-    memset(fr->data.zero, 0, sizeof(fr->data.zero));
+    frame_set_bits(fr, FRAME_D, 1, 1);
+    frame_set_bits(fr, FRAME_DATA_CRC, 5, mk_crc5(fr, FRAME_DATA_CRC));
+    frame_set_bits(fr, FRAME_DATA_ZERO, 2, 0);
 
     uint8_t buf[19];
     memset(buf, 0, sizeof(buf));
-    frame_encode1(buf, fr->blob_);
-    frame_encode2(buf, fr->blob_);
+    frame_encode1(buf, frame_get_bits(fr, 0, 26));
+    frame_encode2(buf, frame_get_bits(fr, 26, 50));
 
     if (fe->band == TETRAPOL_BAND_VHF) {
         frame_interleave(&fr_data[1], buf, interleave_data_VHF);
@@ -875,14 +942,19 @@ static int encode_data(frame_encoder_t *fe, uint8_t *fr_data, frame_t *fr)
 
 static int encode_voice(frame_encoder_t *fe, uint8_t *fr_data, frame_t *fr)
 {
-    fr->voice.d = 0;
-    mk_crc3(fr->voice.crc, fr->voice.crc_data, sizeof(fr->voice.crc_data));
+    frame_set_bits(fr, FRAME_D, 1, 0);
+    frame_set_bits(fr, FRAME_VOICE_CRC, 3, mk_crc3(fr, FRAME_VOICE_CRC));
 
     uint8_t buf[19];
     memset(buf, 0, sizeof(buf));
-    frame_encode1(buf, fr->voice.crc_data);
+    frame_encode1(buf, frame_get_bits(fr, 0, 26));
     // PAS 0001-2 6.2.1 - unprotected part
-    pack_bits(buf, fr->voice.voice2, 2*26, 100);
+    for (int i = 0; i < 100; ) {
+        const int k = 2*26 + i;
+        const int len = (8 - k % 8 < 100 - i) ? 8 - k % 8 : 100 - i;
+        buf[k / 8] |= frame_get_bits(fr, FRAME_VOICE2 + i, len) << (k % 8);
+        i += len;
+    }
 
     if (fe->band == TETRAPOL_BAND_VHF) {
         frame_interleave(&fr_data[1], buf, interleave_voice_VHF);
@@ -1,39 +1,77 @@
 #include <tetrapol/frame_json.h>
-#include <tetrapol/misc.h>
 
-#include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/time.h>
 #include <time.h>
 
-void frame_json(tpol_t *tpol, const frame_t *fr)
+/// write receive time, formatted date and time is cached for whole second
+static void put_rx_time(tpol_t *tpol)
 {
-    printf("{ \"event\": \"frame\", ");
-    printf("\"rx_offs\": %" PRIu64 ", ", tpol->rx_offs);
-
     struct timeval tv;
-    struct tm gmt;
     gettimeofday(&tv, NULL);
-    gmtime_r(&tv.tv_sec, &gmt);
 
-    printf("\"rx_time\": \"%4d-%02d-%02dT%02d-%02d-%02d.%06ld\", ",
-            gmt.tm_year + 1900, gmt.tm_mon + 1, gmt.tm_mday,
-            gmt.tm_hour, gmt.tm_min, gmt.tm_sec, tv.tv_usec);
+    if (tv.tv_sec != tpol->rx_time_sec) {
+        struct tm gmt;
+        gmtime_r(&tv.tv_sec, &gmt);
+        snprintf(tpol->rx_time, sizeof(tpol->rx_time),
+                "%4d-%02d-%02dT%02d-%02d-%02d.",
+                gmt.tm_year + 1900, gmt.tm_mon + 1, gmt.tm_mday,
+                gmt.tm_hour, gmt.tm_min, gmt.tm_sec);
+        tpol->rx_time_sec = tv.tv_sec;
+    }
+
+    out_buf_puts(tpol->out, "\"rx_time\": \"");
+    out_buf_puts(tpol->out, tpol->rx_time);
+    out_buf_put_uint0(tpol->out, tv.tv_usec, 6);
+    out_buf_puts(tpol->out, "\", ");
+}
+
+/// write "asb": [a, b], pair
+static void put_asb(out_buf_t *out, int asb)
+{
+    out_buf_puts(out, "\"asb\": [");
+    out_buf_put_int(out, asb & 1);
+    out_buf_puts(out, ", ");
+    out_buf_put_int(out, asb >> 1);
+    out_buf_puts(out, "], ");
+}
+
+static void put_hex_data(out_buf_t *out, const uint8_t *data, int len)
+{
+    out_buf_puts(out, "\"data\": { \"encoding\": \"hex\", \"value\": \"");
+    out_buf_put_hex(out, data, len);
+    out_buf_puts(out, "\" } ");
+}
+
+void frame_json(tpol_t *tpol, const frame_t *fr)
+{
+    out_buf_t *out = tpol->out;
 
+    tetrapol_json_begin(tpol, "frame");
+    out_buf_puts(out, "\"rx_offs\": ");
+    out_buf_put_uint(out, tpol->rx_offs);
+    out_buf_puts(out, ", ");
 
-    printf("\"frame\": { ");
+    put_rx_time(tpol);
+
+    out_buf_puts(out, "\"frame\": { ");
     {
-        if (tpol->frame_no != FRAME_NO_UNKNOWN) {
-            printf("\"frame_no\": %d, ", tpol->frame_no);
+        if (tpol->frame_no != TETRAPOL_FRAME_NO_UNKNOWN) {
+            out_buf_puts(out, "\"frame_no\": ");
+            out_buf_put_int(out, tpol->frame_no);
+            out_buf_puts(out, ", ");
         } else {
-            printf("\"frame_no\": null, ");
+            out_buf_puts(out, "\"frame_no\": null, ");
         }
 
         if (!fr->broken) {
-            printf("\"state\": \"ok\", ");
-            printf("\"syndromes\": %d, ", fr->syndromes);
-            printf("\"bits_fixed\": %d, ", fr->bits_fixed);
+            out_buf_puts(out, "\"state\": \"ok\", ");
+            out_buf_puts(out, "\"syndromes\": ");
+            out_buf_put_int(out, fr->syndromes);
+            out_buf_puts(out, ", \"bits_fixed\": ");
+            out_buf_put_int(out, fr->bits_fixed);
+            out_buf_puts(out, ", ");
 
             const char *fr_type;
             switch (fr->fr_type) {
@@ -48,51 +86,60 @@ void frame_json(tpol_t *tpol, const frame_t *fr)
                 default:
                     fr_type = "FIXME";
             }
-            printf("\"type\": \"%s\", ", fr_type);
+            out_buf_puts(out, "\"type\": \"");
+            out_buf_puts(out, fr_type);
+            out_buf_puts(out, "\", ");
 
             if (fr->fr_type == FRAME_TYPE_DATA) {
-                printf("\"asb\": [%d, %d], ", fr->data.asb[0], fr->data.asb[1]);
-                printf("\"fn\": [%d, %d], ", fr->data.data[0], fr->data.data[1]);
-
+                put_asb(out, frame_asb(fr));
+                const int fn = frame_fn(fr);
+                out_buf_puts(out, "\"fn\": [");
+                out_buf_put_int(out, fn & 1);
+                out_buf_puts(out, ", ");
+                out_buf_put_int(out, fn >> 1);
+                out_buf_puts(out, "], ");
+
+                const uint64_t payload = frame_data_payload(fr);
                 uint8_t data[8];
-                memset(data, 0, sizeof(data));
-                for (int i = 0; i < 8*8; ++i) {
-                    data[i / 8] |= fr->data.data[i + 2] << (i % 8);
+                for (int i = 0; i < 8; ++i) {
+                    data[i] = payload >> (8 * i);
                 }
-                char buf[3*sizeof(data)];
-                printf("\"data\": { \"encoding\": \"hex\", \"value\": \"%s\" } ",
-                        sprint_hex2(buf, data, sizeof(data)));
+                put_hex_data(out, data, sizeof(data));
 
             } else if (fr->fr_type == FRAME_TYPE_VOICE) {
-                printf("\"asb\": [%d, %d], ", fr->voice.asb[0], fr->voice.asb[1]);
+                put_asb(out, frame_asb(fr));
+                // voice1 (20 bits) followed by voice2 (100 bits)
+                const uint64_t voice_lo = frame_get_bits(fr, FRAME_VOICE1, 20) |
+                    (frame_get_bits(fr, FRAME_VOICE2, 44) << 20);
+                const uint64_t voice_hi = frame_get_bits(fr, FRAME_VOICE2 + 44, 56);
                 uint8_t voice[120/8];
-                memset(voice, 0, sizeof(voice));
-
-                for (int i = 0; i < 20; ++i) {
-                    voice[i / 8] |= fr->voice.voice1[i] << (i % 8);
+                for (int i = 0; i < 8; ++i) {
+                    voice[i] = voice_lo >> (8 * i);
                 }
-                for (int i = 20; i < 120; ++i) {
-                    voice[i / 8] |= fr->voice.voice2[i - 20] << (i % 8);
+                for (int i = 8; i < sizeof(voice); ++i) {
+                    voice[i] = voice_hi >> (8 * (i - 8));
                 }
-
-                char buf[120/8*3];
-                printf("\"data\": { \"encoding\": \"hex\", \"value\": \"%s\" } ",
-                        sprint_hex2(buf, voice, 120/8));
+                put_hex_data(out, voice, sizeof(voice));
 
             } else {
-                printf("\"FIXME\": \"FIXME\" ");
+                out_buf_puts(out, "\"FIXME\": \"FIXME\" ");
             }
         } else if (fr->broken == -1) {
-            printf("\"state\": \"bad_CRC\", ");
-            printf("\"syndromes\": %d, ", fr->syndromes);
-            printf("\"bits_fixed\": %d ", fr->bits_fixed);
+            out_buf_puts(out, "\"state\": \"bad_CRC\", ");
+            out_buf_puts(out, "\"syndromes\": ");
+            out_buf_put_int(out, fr->syndromes);
+            out_buf_puts(out, ", \"bits_fixed\": ");
+            out_buf_put_int(out, fr->bits_fixed);
+            out_buf_puts(out, " ");
         } else if (fr->broken > 0) {
-            printf("\"state\": %d, ", fr->broken);
+            out_buf_puts(out, "\"state\": ");
+            out_buf_put_int(out, fr->broken);
+            out_buf_puts(out, ", ");
         } else {
-            printf("\"state\": \"FIXME\", ");
+            out_buf_puts(out, "\"state\": \"FIXME\", ");
         }
     }
-    printf("}");
+    out_buf_puts(out, "}");
 
-    printf("}\n");
+    tetrapol_json_end(tpol);
 }
@@ -13,6 +13,8 @@
 struct link_priv_t {
     tpdu_t *tpdu;
     tpdu_ui_t *tpdu_ui;
+    tpol_t *tpol;
+    int log_ch;
     uint8_t v_r;    ///< v(r) PAS 0001-3-3 7.5.4.2.2
     uint8_t v_s;    ///< v(s) PAS 0001-3-3 7.5.4.2.2
     bool rx_glitch;
@@ -31,13 +33,15 @@ link_t *link_create(tpol_t *tpol, int log_ch)
         return NULL;
     }
 
-    link->tpdu = tpdu_create(tpol, LOG_CH_SDCH);
+    link->tpdu = tpdu_create(tpol, TETRAPOL_LOG_CH_SDCH);
     if (!link->tpdu) {
         tpdu_ui_destroy(link->tpdu_ui);
         free(link);
         return NULL;
     }
 
+    link->tpol = tpol;
+    link->log_ch = log_ch;
     link->v_r = 0;
     link->v_s = 0;
     link->rx_glitch = true;
@@ -185,8 +189,13 @@ int link_push_hdlc_frame(link_t *link, const hdlc_frame_t *hdlc_fr)
 
         lsdu_vch_t *lsdu;
         if (!lsdu_vch_decode_hdlc_frame(hdlc_fr, &lsdu)) {
-            // LSDU should be send upwards like TSDU
             lsdu_vch_print(lsdu);
+            const tetrapol_evt_lsdu_t evt = {
+                .log_ch = link->log_ch,
+                .addr = hdlc_fr->addr,
+                .vch = lsdu,
+            };
+            tetrapol_evt_lsdu(link->tpol, &evt);
             lsdu_vch_destroy(lsdu);
         }
 
@@ -204,8 +213,13 @@ int link_push_hdlc_frame(link_t *link, const hdlc_frame_t *hdlc_fr)
 
         lsdu_cd_t *lsdu;
         if (!lsdu_cd_decode(hdlc_fr->data, hdlc_fr->nbits / 8, &lsdu)) {
-            // LSDU should be send upwards like TSDU
             lsdu_cd_print(lsdu);
+            const tetrapol_evt_lsdu_t evt = {
+                .log_ch = link->log_ch,
+                .addr = hdlc_fr->addr,
+                .cd = lsdu,
+            };
+            tetrapol_evt_lsdu(link->tpol, &evt);
             lsdu_cd_destroy(lsdu);
         }
         return 0;
@@ -221,8 +235,7 @@ void link_rx_glitch(link_t *link)
     link->rx_glitch = true;
 }
 
-void link_tick(time_evt_t* te, link_t *link)
+int link_tick(time_evt_t* te, link_t *link)
 {
-    link->rx_glitch |= te->rx_glitch;
-    tpdu_du_tick(te, link->tpdu_ui);
+    return tpdu_du_tick(te, link->tpdu_ui);
 }
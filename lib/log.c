@@ -1,3 +1,3 @@
 #include <tetrapol/log.h>
 
-int log_global_lvl = INFO;
+_Thread_local int log_global_lvl = INFO;
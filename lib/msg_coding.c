@@ -91,14 +91,17 @@ void address_print(const address_t *address)
     }
 }
 
-int address_list_decode(address_list_t **ptr_addrs, const uint8_t *data)
+int address_list_decode(address_list_t **ptr_addrs, const uint8_t *data,
+        tsdu_arena_t *arena)
 {
     // TODO: check len
     address_list_t *addrs = *ptr_addrs;
     do {
-        const int n = addrs ? (addrs->nadrs + 1) : 1;
+        const int n_old = addrs ? addrs->nadrs : 0;
+        const int n = n_old + 1;
         const int l = sizeof(address_list_t) + n * sizeof(address_t);
-        address_list_t *p = realloc(addrs, l);
+        address_list_t *p = tsdu_arena_realloc(arena, addrs,
+                sizeof(address_list_t) + n_old * sizeof(address_t), l);
         if (!p) {
             *ptr_addrs = addrs;
             return -1;
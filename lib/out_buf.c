@@ -0,0 +1,246 @@
+// flockfile, fileno
+#define _POSIX_C_SOURCE 200112L
+
+#define LOG_PREFIX "out_buf"
+
+#include <tetrapol/log.h>
+#include <tetrapol/out_buf.h>
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+enum {
+    OUT_BUF_LEN_DEFAULT = 64 * 1024,
+    /// buffer is flushed at the end of event when it holds so many bytes
+    OUT_BUF_FLUSH_LEN = 48 * 1024,
+    /// the longest integer in decimal, 20 digits and sign
+    INT_LEN_MAX = 21,
+};
+
+struct out_buf_priv_t {
+    FILE *out;
+    char *data;
+    int len;
+    int cap;
+};
+
+/// decimal digits of 0 to 99
+static const char digits2[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const char hex_digits[] = "0123456789abcdef";
+
+out_buf_t *out_buf_create(FILE *out)
+{
+    out_buf_t *ob = malloc(sizeof(out_buf_t));
+    if (!ob) {
+        return NULL;
+    }
+
+    ob->data = malloc(OUT_BUF_LEN_DEFAULT);
+    if (!ob->data) {
+        free(ob);
+        return NULL;
+    }
+    ob->out = out;
+    ob->len = 0;
+    ob->cap = OUT_BUF_LEN_DEFAULT;
+
+    return ob;
+}
+
+void out_buf_destroy(out_buf_t *ob)
+{
+    if (!ob) {
+        return;
+    }
+    out_buf_flush(ob);
+    free(ob->data);
+    free(ob);
+}
+
+void out_buf_set_output(out_buf_t *ob, FILE *out)
+{
+    out_buf_flush(ob);
+    ob->out = out;
+}
+
+/// write all data into file descriptor
+static int write_all(int fd, const char *data, int len)
+{
+    while (len > 0) {
+        const ssize_t r = write(fd, data, len);
+        if (r < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        data += r;
+        len -= r;
+    }
+
+    return 0;
+}
+
+int out_buf_flush(out_buf_t *ob)
+{
+    if (!ob->len) {
+        return 0;
+    }
+
+    int ret = 0;
+    flockfile(ob->out);
+    // data already buffered in stream goes first, stream without file
+    // descriptor (e.g. memory stream) is written through stdio
+    const int fd = fileno(ob->out);
+    if (fd == -1) {
+        if (fwrite(ob->data, 1, ob->len, ob->out) != ob->len) {
+            ret = -1;
+        }
+    } else if (fflush(ob->out) || write_all(fd, ob->data, ob->len)) {
+        ret = -1;
+    }
+    funlockfile(ob->out);
+
+    if (ret) {
+        LOG(ERR, "Failed to write events");
+    }
+    ob->len = 0;
+
+    return ret;
+}
+
+void out_buf_end_event(out_buf_t *ob)
+{
+    if (ob->len >= OUT_BUF_FLUSH_LEN) {
+        out_buf_flush(ob);
+    }
+}
+
+/// make space for len bytes
+static bool reserve(out_buf_t *ob, int len)
+{
+    if (ob->len + len <= ob->cap) {
+        return true;
+    }
+
+    int cap = 2 * ob->cap;
+    while (cap < ob->len + len) {
+        cap *= 2;
+    }
+    char *data = realloc(ob->data, cap);
+    if (!data) {
+        LOG(ERR, "ERR OOM");
+        return false;
+    }
+    ob->data = data;
+    ob->cap = cap;
+
+    return true;
+}
+
+void out_buf_write(out_buf_t *ob, const char *str, int len)
+{
+    if (!reserve(ob, len)) {
+        return;
+    }
+    memcpy(&ob->data[ob->len], str, len);
+    ob->len += len;
+}
+
+void out_buf_puts(out_buf_t *ob, const char *str)
+{
+    out_buf_write(ob, str, strlen(str));
+}
+
+void out_buf_putc(out_buf_t *ob, char c)
+{
+    if (!reserve(ob, 1)) {
+        return;
+    }
+    ob->data[ob->len++] = c;
+}
+
+/**
+  Format integer into the end of buffer buf_end, two digits at a time.
+
+  @return pointer to the first digit
+  */
+static char *fmt_uint(char *buf_end, uint64_t val)
+{
+    char *p = buf_end;
+    while (val >= 100) {
+        const int i = 2 * (val % 100);
+        val /= 100;
+        p -= 2;
+        p[0] = digits2[i];
+        p[1] = digits2[i + 1];
+    }
+    if (val >= 10) {
+        p -= 2;
+        p[0] = digits2[2 * val];
+        p[1] = digits2[2 * val + 1];
+    } else {
+        *--p = '0' + val;
+    }
+
+    return p;
+}
+
+void out_buf_put_uint(out_buf_t *ob, uint64_t val)
+{
+    char buf[INT_LEN_MAX];
+    const char *p = fmt_uint(buf + sizeof(buf), val);
+    out_buf_write(ob, p, buf + sizeof(buf) - p);
+}
+
+void out_buf_put_int(out_buf_t *ob, int64_t val)
+{
+    char buf[INT_LEN_MAX];
+    // negation done on unsigned type, works also for INT64_MIN
+    char *p = fmt_uint(buf + sizeof(buf),
+            (val < 0) ? -(uint64_t)val : (uint64_t)val);
+    if (val < 0) {
+        *--p = '-';
+    }
+    out_buf_write(ob, p, buf + sizeof(buf) - p);
+}
+
+void out_buf_put_uint0(out_buf_t *ob, uint64_t val, int width)
+{
+    char buf[INT_LEN_MAX];
+    char *p = fmt_uint(buf + sizeof(buf), val);
+    if (width > INT_LEN_MAX) {
+        width = INT_LEN_MAX;
+    }
+    while (buf + sizeof(buf) - p < width) {
+        *--p = '0';
+    }
+    out_buf_write(ob, p, buf + sizeof(buf) - p);
+}
+
+void out_buf_put_hex(out_buf_t *ob, const uint8_t *bytes, int n)
+{
+    if (!reserve(ob, 2 * n)) {
+        return;
+    }
+    char *p = &ob->data[ob->len];
+    for (int i = 0; i < n; ++i) {
+        p[2*i] = hex_digits[bytes[i] >> 4];
+        p[2*i + 1] = hex_digits[bytes[i] & 0xf];
+    }
+    ob->len += 2 * n;
+}
@@ -1,21 +1,30 @@
+// for memfd_create() and endian.h
+#define _GNU_SOURCE
+#include <endian.h>
+
 #define LOG_PREFIX "phys_ch"
 
 #include <tetrapol/tetrapol_int.h>
 #include <tetrapol/log.h>
-#include <tetrapol/frame_json.h>
+#include <tetrapol/bit_utils.h>
 #include <tetrapol/system_config.h>
 #include <tetrapol/tsdu.h>
 #include <tetrapol/misc.h>
 #include <tetrapol/phys_ch.h>
+#include <tetrapol/scr_search.h>
 #include <tetrapol/tp_timer.h>
+#include <tetrapol/tsc.h>
 #include <tetrapol/frame.h>
 #include <tetrapol/cch.h>
 #include <tetrapol/tch.h>
+#include <tetrapol/viterbi.h>
 
 #include <limits.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <time.h>
 #include <unistd.h>
 
 // max error rate for 2 frame synchronization sequences
@@ -23,29 +32,162 @@
 
 #define DATA_OFFS (FRAME_LEN/2)
 
+// default capacity of receive buffer in bits
+#define DATA_LEN_DEFAULT (1 << 17)
+
+// space behind the end of data reserved for wide (64 bit) access
+#define DATA_PAD (2*FRAME_LEN)
+
+// TETRAPOL_RADIO_AUTO, frames without BCH lock before channel is considered
+// to be TCH (BCH is transmitted twice per superframe of 200 frames)
+#define AUTO_BCH_TIMEOUT 200
+
+// TETRAPOL_RADIO_AUTO, valid voice frames required to switch into TCH
+#define AUTO_VOICE_FRAMES 4
+
 struct phys_ch_priv_t {
     int band;           ///< VHF or UHF
     uint8_t dir;        ///< direction (downlink / uplink)
-    int radio_ch_type;  ///< control or traffic
+    int radio_ch_type;  ///< control, traffic or auto
+    /// Detected channel type (CCH, TCH, AUTO when unknown) for
+    /// TETRAPOL_RADIO_AUTO, equal to radio_ch_type otherwise.
+    int role;
+    int role_frames;    ///< frames received while role is unknown
+    int role_voice;     ///< valid voice frames received in current role
     int sync_errs;      ///< cumulative no. of errors in frame synchronisation
     bool has_frame_sync;
     int scr;            ///< SCR, scrambling constant
     int scr_last;       ///< SCR, used to detech if SRC changes
-    int scr_guess;      ///< SCR with best score when guessing SCR
-    int scr_confidence; ///< required confidence for SCR detection
-    int scr_stat[128];  ///< statistics for SCR detection
-    uint8_t *data_begin;    ///< start of unprocessed part of data
-    uint8_t *data_end;      ///< end of unprocessed part of data
-    uint8_t data[10*FRAME_LEN];
+    int input_fmt;      ///< packed or unpacked input bits
+    int data_begin;     ///< start of unprocessed part of data (bit index)
+    int data_end;       ///< end of unprocessed part of data (bit index)
+    int data_len;       ///< capacity of receive buffer in bits
+    /// Received bits packed into bytes, first bit in LSB. Ring buffer
+    /// mapped twice in a row, any window of up to data_len bits is
+    /// contiguous in memory.
+    uint8_t *data;
+    /// Reliability of each bit in data (soft input only), ring buffer mapped
+    /// in the same way as data.
+    uint8_t *rel;
     frame_decoder_t *fd;
+    scr_search_t *scr_search;
     // CCH specific data, will be union with traffich CH specicic data
     tp_timer_t *tp_timer;
     cch_t *cch;
     tch_t *tch;
     tpol_t *tpol;
+    long stats_next;    ///< stream time of next stats event, 0 not planned
 };
 
-static int process_frame(phys_ch_t *phys_ch, const uint8_t *fr_data);
+static int process_frame(phys_ch_t *phys_ch, const uint8_t *fr_data,
+        const uint8_t *fr_rel, uint64_t *t);
+
+/// time stamp for cycle counters of decoding stages
+static inline uint64_t stats_now(void)
+{
+#if HAVE_TSC
+    return tsc_read();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+/// start measurement of stage cycles, returns 0 when stats are disabled
+static inline uint64_t stats_begin(const phys_ch_t *phys_ch)
+{
+    return phys_ch->tpol->stats_period ? stats_now() : 0;
+}
+
+/// account cycles since *t to stage and restart measurement
+static inline void stats_stage(phys_ch_t *phys_ch, int stage, uint64_t *t)
+{
+    if (phys_ch->tpol->stats_period) {
+        const uint64_t now = stats_now();
+        phys_ch->tpol->stats.cycles[stage] += now - *t;
+        *t = now;
+    }
+}
+
+/// emit stats event every stats_period seconds of stream time
+static void stats_tick(time_evt_t *te, void *ptr)
+{
+    phys_ch_t *phys_ch = ptr;
+    const int period = phys_ch->tpol->stats_period;
+    if (!period) {
+        phys_ch->stats_next = 0;
+        return;
+    }
+
+    if (!phys_ch->stats_next) {
+        phys_ch->stats_next = te->tv.tv_sec + period;
+        return;
+    }
+
+    if (te->tv.tv_sec >= phys_ch->stats_next) {
+        tetrapol_evt_stats(phys_ch->tpol, te->tv.tv_sec);
+        phys_ch->stats_next = te->tv.tv_sec + period;
+    }
+}
+
+/**
+  Allocate ring buffer, the same memory is mapped twice in a row
+  (data[i] and data[i + size] are the same byte).
+
+  @param size Size of ring buffer, must be multiple of page size.
+
+  @return Pointer to mapping of 2 * size bytes or NULL.
+  */
+static uint8_t *ring_alloc(size_t size)
+{
+    const int fd = memfd_create("tetrapol_phys_ch", MFD_CLOEXEC);
+    if (fd == -1) {
+        LOG(ERR, "memfd_create() failed");
+        return NULL;
+    }
+    if (ftruncate(fd, size)) {
+        close(fd);
+        return NULL;
+    }
+
+    // reserve address space for both mappings
+    uint8_t *data = mmap(NULL, 2 * size, PROT_NONE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED) {
+        close(fd);
+        return NULL;
+    }
+
+    for (int i = 0; i < 2; ++i) {
+        if (mmap(data + i * size, size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+            munmap(data, 2 * size);
+            close(fd);
+            return NULL;
+        }
+    }
+    close(fd);
+
+    return data;
+}
+
+static void ring_free(uint8_t *data, size_t size)
+{
+    if (data) {
+        munmap(data, 2 * size);
+    }
+}
+
+static void phys_ch_free(phys_ch_t *phys_ch)
+{
+    ring_free(phys_ch->rel, phys_ch->data_len);
+    ring_free(phys_ch->data, phys_ch->data_len / 8);
+    scr_search_destroy(phys_ch->scr_search);
+    frame_decoder_destroy(phys_ch->fd);
+    tp_timer_destroy(phys_ch->tp_timer);
+    free(phys_ch);
+}
 
 phys_ch_t *tetrapol_phys_ch_create(tetrapol_t *tetrapol)
 {
@@ -60,55 +202,82 @@ phys_ch_t *tetrapol_phys_ch_create(tetrapol_t *tetrapol)
     phys_ch->band = cfg->band;
     phys_ch->dir = cfg->dir;
     phys_ch->radio_ch_type = cfg->radio_ch_type;
-    phys_ch->data_begin = phys_ch->data_end = phys_ch->data + DATA_OFFS;
+    phys_ch->role = cfg->radio_ch_type;
+    phys_ch->input_fmt = cfg->input_fmt;
+    phys_ch->data_begin = phys_ch->data_end = DATA_OFFS;
     phys_ch->tpol->rx_offs = 0;
-    phys_ch->tpol->frame_no = FRAME_NO_UNKNOWN;
+    phys_ch->tpol->frame_no = TETRAPOL_FRAME_NO_UNKNOWN;
     phys_ch->scr = PHYS_CH_SCR_DETECT;
     phys_ch->scr_last = PHYS_CH_SCR_DETECT;
-    phys_ch->scr_confidence = 50;
     phys_ch->tp_timer = tp_timer_create();
 
     phys_ch->fd = frame_decoder_create(cfg->band, 0, FRAME_TYPE_AUTO);
-    if (!phys_ch->fd) {
-        tp_timer_destroy(phys_ch->tp_timer);
-        free(phys_ch);
+    phys_ch->scr_search = scr_search_create(cfg->band, 50);
+    if (!phys_ch->fd || !phys_ch->scr_search) {
+        phys_ch_free(phys_ch);
+        return NULL;
+    }
+
+    // capacity is rounded up to whole pages of packed data
+    const size_t page_size = sysconf(_SC_PAGESIZE);
+    const size_t data_size = cfg->rx_buf_len ? cfg->rx_buf_len : DATA_LEN_DEFAULT;
+    const size_t size = ((data_size + 7) / 8 + page_size - 1) / page_size *
+        page_size;
+    phys_ch->data = ring_alloc(size);
+    if (!phys_ch->data) {
+        phys_ch_free(phys_ch);
         return NULL;
     }
+    phys_ch->data_len = 8 * size;
 
-    if (cfg->radio_ch_type == TETRAPOL_RADIO_CCH) {
+    if (cfg->input_fmt == TETRAPOL_INPUT_SOFT) {
+        phys_ch->rel = ring_alloc(phys_ch->data_len);
+        if (!phys_ch->rel) {
+            phys_ch_free(phys_ch);
+            return NULL;
+        }
+    }
+
+    // in auto mode both are present, frames are routed by detected role
+    bool ok = true;
+    if (cfg->radio_ch_type != TETRAPOL_RADIO_TCH) {
         phys_ch->cch = cch_create(phys_ch->tpol);
-        if (phys_ch->cch) {
-            tp_timer_register(phys_ch->tp_timer, cch_tick, phys_ch->cch);
-            return phys_ch;
+        if (!phys_ch->cch ||
+                !tp_timer_register(phys_ch->tp_timer, cch_tick, phys_ch->cch)) {
+            ok = false;
         }
     }
 
-    if (cfg->radio_ch_type == TETRAPOL_RADIO_TCH) {
+    if (cfg->radio_ch_type != TETRAPOL_RADIO_CCH) {
         phys_ch->tch = tch_create(phys_ch->tpol);
-        if (phys_ch->tch) {
-            tp_timer_register(phys_ch->tp_timer, tch_tick, phys_ch->tch);
-            return phys_ch;
+        if (!phys_ch->tch ||
+                !tp_timer_register(phys_ch->tp_timer, tch_tick, phys_ch->tch)) {
+            ok = false;
         }
     }
 
-    frame_decoder_destroy(phys_ch->fd);
-    tp_timer_destroy(phys_ch->tp_timer);
-    free(phys_ch);
+    if (ok) {
+        // stats are reported at whole seconds, period can be changed later
+        ok = tp_timer_add(phys_ch->tp_timer, 0, 1000000, stats_tick,
+                phys_ch) != NULL;
+    }
+
+    if (ok) {
+        return phys_ch;
+    }
+
+    cch_destroy(phys_ch->cch);
+    tch_destroy(phys_ch->tch);
+    phys_ch_free(phys_ch);
 
     return NULL;
 }
 
 void tetrapol_phys_ch_destroy(phys_ch_t *phys_ch)
 {
-    if (phys_ch->radio_ch_type == TETRAPOL_RADIO_CCH) {
-        cch_destroy(phys_ch->cch);
-    }
-    if (phys_ch->radio_ch_type == TETRAPOL_RADIO_TCH) {
-        tch_destroy(phys_ch->tch);
-    }
-    frame_decoder_destroy(phys_ch->fd);
-    tp_timer_destroy(phys_ch->tp_timer);
-    free(phys_ch);
+    cch_destroy(phys_ch->cch);
+    tch_destroy(phys_ch->tch);
+    phys_ch_free(phys_ch);
 }
 
 int tetrapol_phys_ch_get_scr(phys_ch_t *phys_ch)
@@ -119,61 +288,309 @@ int tetrapol_phys_ch_get_scr(phys_ch_t *phys_ch)
 void tetrapol_phys_ch_set_scr(phys_ch_t *phys_ch, int scr)
 {
     phys_ch->scr = scr;
-    memset(&phys_ch->scr_stat, 0, sizeof(phys_ch->scr_stat));
+    scr_search_reset(phys_ch->scr_search);
 }
 
 int tetrapol_phys_ch_get_scr_confidence(phys_ch_t *phys_ch)
 {
-    return phys_ch->scr_confidence;
+    return scr_search_get_confidence(phys_ch->scr_search);
 }
 
 void tetrapol_phys_ch_set_scr_confidence(
         phys_ch_t *phys_ch, int scr_confidence)
 {
-    phys_ch->scr_confidence = scr_confidence;
+    scr_search_set_confidence(phys_ch->scr_search, scr_confidence);
+}
+
+static inline uint64_t get_le64(const uint8_t *data)
+{
+    uint64_t w;
+    memcpy(&w, data, sizeof(w));
+    return le64toh(w);
+}
+
+static inline void put_le64(uint8_t *data, uint64_t w)
+{
+    w = htole64(w);
+    memcpy(data, &w, sizeof(w));
+}
+
+/// get 8 bits starting at bit offset pos
+static inline uint8_t get_byte(const uint8_t *data, int pos)
+{
+    const int idx = pos / 8;
+    return (data[idx] | (data[idx + 1] << 8)) >> (pos % 8);
+}
+
+/// get 64 bits starting at bit offset pos, reads 9B of data
+static inline uint64_t get_bits64(const uint8_t *data, int pos)
+{
+    const int sh = pos % 8;
+    data += pos / 8;
+    uint64_t w = get_le64(data) >> sh;
+    if (sh) {
+        w |= (uint64_t)data[8] << (64 - sh);
+    }
+    return w;
+}
+
+/**
+  Copy nbits starting at bit offset pos from src to start of dst.
+  Both buffers must have at least 8B of space behind copied bits.
+  */
+static void copy_bits(uint8_t *dst, const uint8_t *src, int pos, int nbits)
+{
+    for ( ; nbits > 0; nbits -= 64, pos += 64, dst += 8) {
+        put_le64(dst, get_bits64(src, pos));
+    }
+}
+
+/**
+  Append bytes with packed bits at bit offset pos. Bits behind pos are
+  overwritten, data must have at least 8B of space behind appended bits.
+
+  @param inv Mask XORed with input, used for signal inversion.
+  */
+static void append_bytes(uint8_t *data, int pos, const uint8_t *bytes,
+        int len, uint64_t inv)
+{
+    const int sh = pos % 8;
+    data += pos / 8;
+    uint64_t carry = *data & ((1 << sh) - 1);
+
+    for ( ; len >= 8; len -= 8, bytes += 8, data += 8) {
+        const uint64_t w = get_le64(bytes) ^ inv;
+        put_le64(data, (w << sh) | carry);
+        carry = sh ? (w >> (64 - sh)) : 0;
+    }
+    for ( ; len; --len, ++bytes, ++data) {
+        const uint8_t b = *bytes ^ inv;
+        *data = (b << sh) | carry;
+        carry = b >> (8 - sh);
+    }
+    *data = carry;
+}
+
+/// pack 8 bits (one bit per byte) into single byte, first bit into LSB
+static inline uint8_t pack_8bits(const uint8_t *bits)
+{
+    return ((get_le64(bits) & 0x0101010101010101ULL) *
+            0x0102040810204080ULL) >> 56;
 }
 
-static uint8_t differential_dec(uint8_t *data, int size, uint8_t first_bit)
+static void unpack_bits(uint8_t *bits, const uint8_t *bytes, int nbits)
 {
-    while (size--) {
-        first_bit = *data = *data ^ first_bit;
-        ++data;
+    for (int i = 0; i < nbits; ++i) {
+        bits[i] = (bytes[i / 8] >> (i % 8)) & 1;
     }
-    return first_bit;
+}
+
+/**
+  Differential decoding of packed bits, done 64 bits at a time.
+  Requires 8B of space behind the last byte of data.
+
+  @return last decoded bit
+  */
+static uint8_t differential_dec(uint8_t *data, int nbits, uint8_t first_bit)
+{
+    uint64_t carry = first_bit ? ~0ULL : 0;
+    for (int i = 0; i < nbits; i += 64) {
+        uint64_t w = get_le64(&data[i / 8]);
+        // prefix XOR, each bit is XORed with all previous bits
+        w ^= w << 1;
+        w ^= w << 2;
+        w ^= w << 4;
+        w ^= w << 8;
+        w ^= w << 16;
+        w ^= w << 32;
+        w ^= carry;
+        put_le64(&data[i / 8], w);
+        carry = (w >> 63) ? ~0ULL : 0;
+    }
+
+    return (data[(nbits - 1) / 8] >> ((nbits - 1) % 8)) & 1;
 }
 
 int tetrapol_phys_ch_recv(phys_ch_t *phys_ch, uint8_t *buf, int len)
 {
-    const int data_len = phys_ch->data_end - phys_ch->data_begin;
+    // Processed data are dropped by moving positions within ring, DATA_OFFS
+    // bits before data_begin are kept. Data are never moved, the ring is
+    // mapped twice so positions up to 2 * data_len are valid.
+    if (phys_ch->data_begin - DATA_OFFS >= phys_ch->data_len) {
+        phys_ch->data_begin -= phys_ch->data_len;
+        phys_ch->data_end -= phys_ch->data_len;
+    }
+
+    const uint64_t inv = (phys_ch->dir == DIR_UPLINK) ? ~0ULL : 0;
+    const int space = phys_ch->data_len - DATA_PAD -
+        (phys_ch->data_end - phys_ch->data_begin + DATA_OFFS);
 
-    memmove(phys_ch->data, phys_ch->data_begin - DATA_OFFS, data_len + DATA_OFFS);
-    phys_ch->data_begin = phys_ch->data + DATA_OFFS;
-    phys_ch->data_end = phys_ch->data_begin + data_len;
+    if (phys_ch->input_fmt == TETRAPOL_INPUT_PACKED) {
+        len = (len > space / 8) ? space / 8 : len;
+        append_bytes(phys_ch->data, phys_ch->data_end, buf, len, inv);
+        phys_ch->data_end += 8 * len;
+
+        return len;
+    }
 
-    const int space = sizeof(phys_ch->data) - data_len - DATA_OFFS;
     len = (len > space) ? space : len;
 
-    memcpy(phys_ch->data_end, buf, len);
-    phys_ch->data_end += len;
+    uint8_t bytes[64];
+    uint8_t hard[8 * sizeof(bytes)];
+    for (int offs = 0; offs < len; ) {
+        int nbits = len - offs;
+        if (nbits > 8 * sizeof(bytes)) {
+            nbits = 8 * sizeof(bytes);
+        }
+
+        const uint8_t *bits = &buf[offs];
+        if (phys_ch->rel) {
+            // split soft decisions into bits and reliability
+            uint8_t *rel = &phys_ch->rel[phys_ch->data_end];
+            for (int i = 0; i < nbits; ++i) {
+                const int v = (int8_t)buf[offs + i];
+                hard[i] = v > 0;
+                rel[i] = (v < -VITERBI_MAX_REL) ? VITERBI_MAX_REL : abs(v);
+            }
+            bits = hard;
+        }
 
-    if (phys_ch->dir == DIR_UPLINK) {
-        for (uint8_t *b = phys_ch->data_end - len; b < phys_ch->data_end; ++b) {
-            *b ^= 0x01;
+        for (int i = 0; i < nbits / 8; ++i) {
+            bytes[i] = pack_8bits(&bits[8 * i]);
         }
+        if (nbits % 8) {
+            bytes[nbits / 8] = 0;
+            pack_bits(&bytes[nbits / 8], &bits[nbits / 8 * 8],
+                    0, nbits % 8);
+        }
+
+        append_bytes(phys_ch->data, phys_ch->data_end, bytes,
+                (nbits + 7) / 8, inv);
+        phys_ch->data_end += nbits;
+        offs += nbits;
     }
 
     return len;
 }
 
 // compare bite stream to differentialy encoded synchronization sequence
-static int cmp_frame_sync(const uint8_t *data)
+static int cmp_frame_sync(const uint8_t *data, int pos)
 {
-    const uint8_t frame_dsync[] = { 1, 0, 1, 0, 0, 1, 1, };
-    int sync_err = 0;
-    for(int i = 0; i < sizeof(frame_dsync); ++i) {
-        sync_err += frame_dsync[i] ^ data[i + 1];
+    // differentialy encoded sync. sequence { x, 1, 0, 1, 0, 0, 1, 1, }
+    // packed into byte, the first bit depends on previous frame
+    const uint8_t frame_dsync = 0xca;
+    const uint8_t frame_dsync_mask = 0xfe;
+
+    return __builtin_popcount(
+            (get_byte(data, pos) ^ frame_dsync) & frame_dsync_mask);
+}
+
+enum {
+    // no. of bits in error counter of frame sync. correlator, max. is 7 errors
+    SYNC_ERR_BITS = 3,
+    // no. of 64 bit words of correlator used when synchronization is lost
+    SYNC_SEARCH_WORDS = (2*DATA_OFFS + 63) / 64,
+};
+
+/**
+  Word-parallel frame synchronization correlator. Compares synchronization
+  sequence with data at 64 consecutive bit offsets at once.
+
+  Error counts are bit-sliced, bit j of errs[k] holds k-th bit of number of
+  errors for offset pos + j.
+  */
+static void corr_frame_sync(uint64_t *errs, const uint8_t *data, int pos)
+{
+    // see cmp_frame_sync
+    const uint8_t frame_dsync = 0xca;
+
+    memset(errs, 0, sizeof(uint64_t[SYNC_ERR_BITS]));
+    for (int i = 1; i < 8; ++i) {
+        uint64_t e = get_bits64(data, pos + i);
+        if ((frame_dsync >> i) & 1) {
+            e = ~e;
+        }
+        // add errors into bit-sliced counters
+        for (int k = 0; k < SYNC_ERR_BITS; ++k) {
+            const uint64_t carry = errs[k] & e;
+            errs[k] ^= e;
+            e = carry;
+        }
     }
-    return sync_err;
+}
+
+/// Get mask of bit-sliced lanes where value is lower or equal to val.
+static uint64_t lanes_le(const uint64_t *bits, int nbits, int val)
+{
+    uint64_t gt = 0;
+    uint64_t eq = ~0ULL;
+    for (int k = nbits - 1; k >= 0; --k) {
+        if ((val >> k) & 1) {
+            eq &= bits[k];
+        } else {
+            gt |= eq & bits[k];
+            eq &= ~bits[k];
+        }
+    }
+
+    return ~gt;
+}
+
+/// set lanes from lo to hi (inclusive)
+static void lanes_range(uint64_t *lanes, int nwords, int lo, int hi)
+{
+    for (int w = 0; w < nwords; ++w, lo -= 64, hi -= 64) {
+        lanes[w] = (lo <= 0) ? ~0ULL : ((lo < 64) ? (~0ULL << lo) : 0);
+        lanes[w] &= (hi >= 63) ? ~0ULL : ((hi >= 0) ? ((2ULL << hi) - 1) : 0);
+    }
+}
+
+/// lowest set lane >= lane, -1 if there is none
+static int lane_up(const uint64_t *lanes, int nwords, int lane)
+{
+    for (int w = lane / 64; w < nwords; ++w) {
+        uint64_t m = lanes[w];
+        if (w == lane / 64) {
+            m &= ~0ULL << (lane % 64);
+        }
+        if (m) {
+            return 64 * w + __builtin_ctzll(m);
+        }
+    }
+
+    return -1;
+}
+
+/// highest set lane <= lane, -1 if there is none
+static int lane_down(const uint64_t *lanes, int lane)
+{
+    for (int w = lane / 64; w >= 0; --w) {
+        uint64_t m = lanes[w];
+        if (w == lane / 64 && lane % 64 != 63) {
+            m &= (2ULL << (lane % 64)) - 1;
+        }
+        if (m) {
+            return 64 * w + 63 - __builtin_clzll(m);
+        }
+    }
+
+    return -1;
+}
+
+/**
+  Get lane nearest to center, lanes above center are preferred.
+
+  @return lane or -1 if no lane is set
+  */
+static int lane_nearest(const uint64_t *lanes, int nwords, int center)
+{
+    const int up = lane_up(lanes, nwords, center);
+    const int down = lane_down(lanes, center);
+
+    if (down == -1 || (up != -1 && up - center <= center - down)) {
+        return up;
+    }
+    return down;
 }
 
 /**
@@ -182,49 +599,155 @@ static int cmp_frame_sync(const uint8_t *data)
   Using raw stream (before differential decoding) simplyfies search
   because only signal polarity must be considered,
   there is lot of troubles with error handlig after differential decoding.
+
+  Correlator is used to check 64 offsets at once, the first offset where
+  sum of errors is lower or equal to MAX_FRAME_SYNC_ERR wins.
   */
 static int find_frame_sync(phys_ch_t *phys_ch)
 {
-    const uint8_t *end = phys_ch->data_end - FRAME_LEN - FRAME_HDR_LEN;
-    int sync_err = MAX_FRAME_SYNC_ERR + 1;
+    const int end = phys_ch->data_end - FRAME_LEN - FRAME_HDR_LEN;
     while (phys_ch->data_begin <= end) {
-        sync_err = cmp_frame_sync(phys_ch->data_begin) +
-            cmp_frame_sync(phys_ch->data_begin + FRAME_LEN);
-        if (sync_err <= MAX_FRAME_SYNC_ERR) {
-            break;
+        uint64_t errs1[SYNC_ERR_BITS];
+        uint64_t errs2[SYNC_ERR_BITS];
+        corr_frame_sync(errs1, phys_ch->data, phys_ch->data_begin);
+        corr_frame_sync(errs2, phys_ch->data, phys_ch->data_begin + FRAME_LEN);
+
+        // bit-sliced sum of errors for both sequences
+        uint64_t errs[SYNC_ERR_BITS + 1];
+        uint64_t carry = 0;
+        for (int k = 0; k < SYNC_ERR_BITS; ++k) {
+            errs[k] = errs1[k] ^ errs2[k] ^ carry;
+            carry = (errs1[k] & errs2[k]) | (carry & (errs1[k] ^ errs2[k]));
+        }
+        errs[SYNC_ERR_BITS] = carry;
+
+        int n = end - phys_ch->data_begin + 1;
+        uint64_t sync = lanes_le(errs, ARRAY_LEN(errs), MAX_FRAME_SYNC_ERR);
+        if (n < 64) {
+            sync &= (1ULL << n) - 1;
+        } else {
+            n = 64;
         }
 
-        ++phys_ch->data_begin;
-        ++phys_ch->tpol->rx_offs;
-    }
+        if (sync) {
+            n = __builtin_ctzll(sync);
+            phys_ch->data_begin += n;
+            phys_ch->tpol->rx_offs += n;
+            phys_ch->sync_errs = 0;
+            return 1;
+        }
 
-    if (sync_err <= MAX_FRAME_SYNC_ERR) {
-        phys_ch->sync_errs = 0;
-        return 1;
+        phys_ch->data_begin += n;
+        phys_ch->tpol->rx_offs += n;
     }
 
     return 0;
 }
 
-static void copy_frame_data(phys_ch_t *phys_ch, uint8_t *fr_data)
+/**
+  Look for synchoronization pattern shifted by some offset from expected
+  possition. At the same time look for synchronization pattern of the
+  following frame.
+
+  Offsets are checked in order of distance from begin, the higher offset goes
+  first for the same distance, first offset with the lowest number of errors
+  wins. Search stops at distance where any pattern without errors is found.
+
+  @param pos Best position of sync. pattern (for current and following frame)
+  @param errs Number of errors for pos.
+
+  @return 1 on success, 0 when more data is required
+  */
+static int search_frame_sync(const uint8_t *data, int begin, int end,
+        int pos[2], int errs[2])
 {
-    memcpy(fr_data, phys_ch->data_begin + FRAME_HDR_LEN, FRAME_DATA_LEN);
+    if (begin > end) {
+        return 0;
+    }
+
+    // lane of begin in correlator results
+    const int center = DATA_OFFS - 1;
+    const int base = begin - center;
+    uint64_t corr[2][SYNC_SEARCH_WORDS][SYNC_ERR_BITS];
+    for (int w = 0; w < SYNC_SEARCH_WORDS; ++w) {
+        corr_frame_sync(corr[0][w], data, base + 64 * w);
+        corr_frame_sync(corr[1][w], data, base + 64 * w + FRAME_LEN);
+    }
+
+    const int dist = (end - begin < DATA_OFFS - 1) ? end - begin : DATA_OFFS - 1;
+
+    // lanes within distance dist from center
+    uint64_t range[SYNC_SEARCH_WORDS];
+    lanes_range(range, SYNC_SEARCH_WORDS, center - dist, center + dist);
+
+    uint64_t zero[SYNC_SEARCH_WORDS];
+    for (int w = 0; w < SYNC_SEARCH_WORDS; ++w) {
+        zero[w] = range[w] & (
+                lanes_le(corr[0][w], SYNC_ERR_BITS, 0) |
+                lanes_le(corr[1][w], SYNC_ERR_BITS, 0));
+    }
+    const int lane = lane_nearest(zero, SYNC_SEARCH_WORDS, center);
+    if (lane == -1) {
+        // search would continue behind end of data
+        if (end - begin < DATA_OFFS - 1) {
+            return 0;
+        }
+    } else {
+        // search stops at distance where pattern without errors is found
+        const int d = abs(lane - center);
+        lanes_range(range, SYNC_SEARCH_WORDS, center - d, center + d);
+    }
+
+    for (int i = 0; i < 2; ++i) {
+        for (int e = 0; e < 8; ++e) {
+            uint64_t lanes[SYNC_SEARCH_WORDS];
+            for (int w = 0; w < SYNC_SEARCH_WORDS; ++w) {
+                lanes[w] = range[w] & lanes_le(corr[i][w], SYNC_ERR_BITS, e);
+            }
+            const int lane = lane_nearest(lanes, SYNC_SEARCH_WORDS, center);
+            if (lane != -1) {
+                pos[i] = base + lane;
+                errs[i] = e;
+                break;
+            }
+        }
+    }
+
+    return 1;
+}
+
+static void copy_frame_data(phys_ch_t *phys_ch, uint8_t *fr_data,
+        uint8_t *fr_rel)
+{
+    uint8_t fr_bytes[FRAME_DATA_LEN / 8 + 16];
+
+    copy_bits(fr_bytes, phys_ch->data, phys_ch->data_begin + FRAME_HDR_LEN,
+            FRAME_DATA_LEN);
+    if (phys_ch->rel) {
+        memcpy(fr_rel, &phys_ch->rel[phys_ch->data_begin + FRAME_HDR_LEN],
+                FRAME_DATA_LEN);
+    }
     phys_ch->data_begin += FRAME_LEN;
     phys_ch->tpol->rx_offs += FRAME_LEN;
 
-    differential_dec(fr_data, FRAME_DATA_LEN, 0);
+    differential_dec(fr_bytes, FRAME_DATA_LEN, 0);
+    unpack_bits(fr_data, fr_bytes, FRAME_DATA_LEN);
 }
 
-/// return number of acquired frames (0 or 1) or -1 on error
-static int get_frame(phys_ch_t *phys_ch, uint8_t *fr_data)
+/**
+  @param fr_rel Reliability of frame data, filled only for soft input.
+
+  @return number of acquired frames (0 or 1) or -1 on error
+  */
+static int get_frame(phys_ch_t *phys_ch, uint8_t *fr_data, uint8_t *fr_rel)
 {
     if (phys_ch->data_end - phys_ch->data_begin < FRAME_LEN) {
         return 0;
     }
 
     // are we in sync?
-    if (cmp_frame_sync(phys_ch->data_begin) == 0) {
-        copy_frame_data(phys_ch, fr_data);
+    if (cmp_frame_sync(phys_ch->data, phys_ch->data_begin) == 0) {
+        copy_frame_data(phys_ch, fr_data, fr_rel);
         if (phys_ch->sync_errs > 0) {
             --phys_ch->sync_errs;
         }
@@ -236,55 +759,17 @@ static int get_frame(phys_ch_t *phys_ch, uint8_t *fr_data)
         return -1;
     }
 
-    // look for synchoronization pattern shifted by some offset from expected
-    // possition. At the same time look for synchronization pattern of the
-    // following frame. If pattern(s) are found, synchronization is restored.
-    int sync_errs1 = INT_MAX;
-    int sync_errs2 = INT_MAX;
-    const uint8_t *end = phys_ch->data_end - FRAME_LEN - FRAME_HDR_LEN;
-    uint8_t *data = phys_ch->data_begin;
-    uint8_t *rdata = phys_ch->data_begin;
-    uint8_t *sync_pos1 = NULL;
-    uint8_t *sync_pos2 = NULL;
-    for (int i = 0; i < DATA_OFFS; ++i) {
-        if (data > end) {
-            return 0;
-        }
-
-        int e = cmp_frame_sync(data);
-        if (e < sync_errs1) {
-            sync_pos1 = data;
-            sync_errs1 = e;
-        }
-
-        e = cmp_frame_sync(rdata);
-        if (e < sync_errs1) {
-            sync_pos1 = rdata;
-            sync_errs1 = e;
-        }
-
-        e = cmp_frame_sync(data + FRAME_LEN);
-        if (e < sync_errs2) {
-            sync_pos2 = data;
-            sync_errs2 = e;
-        }
-
-        e = cmp_frame_sync(rdata + FRAME_LEN);
-        if (e < sync_errs2) {
-            sync_pos2 = rdata;
-            sync_errs2 = e;
-        }
-
-        if (sync_errs1 == 0 || sync_errs2 == 0) {
-            break;
-        }
-
-        ++data;
-        --rdata;
+    // If pattern(s) are found, synchronization is restored.
+    int sync_pos[2];
+    int sync_errs[2];
+    const int end = phys_ch->data_end - FRAME_LEN - FRAME_HDR_LEN;
+    if (!search_frame_sync(phys_ch->data, phys_ch->data_begin, end,
+                sync_pos, sync_errs)) {
+        return 0;
     }
 
     // increase error counter only if we have not found 2 consecutive sync patterns
-    if (sync_errs1 != 0 || sync_errs2 != 0 || sync_pos1 != sync_pos2) {
+    if (sync_errs[0] != 0 || sync_errs[1] != 0 || sync_pos[0] != sync_pos[1]) {
         phys_ch->sync_errs = 2 * phys_ch->sync_errs + 2;
     }
 
@@ -293,51 +778,90 @@ static int get_frame(phys_ch_t *phys_ch, uint8_t *fr_data)
         return -1;
     }
 
-    uint8_t *sync_pos = (sync_errs1 < sync_errs2) ? sync_pos1 : sync_pos2;
-    phys_ch->tpol->rx_offs += sync_pos - phys_ch->data_begin;
-    phys_ch->data_begin = sync_pos;
+    const int sync_pos_ = (sync_errs[0] < sync_errs[1]) ? sync_pos[0] : sync_pos[1];
+    phys_ch->tpol->rx_offs += sync_pos_ - phys_ch->data_begin;
+    phys_ch->data_begin = sync_pos_;
 
-    copy_frame_data(phys_ch, fr_data);
+    copy_frame_data(phys_ch, fr_data, fr_rel);
     LOG(INFO, "get_frame() sync fail sync_errs=%d", phys_ch->sync_errs);
 
     return 1;
 }
 
-int tetrapol_phys_ch_process(phys_ch_t *phys_ch)
+/**
+  Advance timers by stream time of n bits scanned without frame sync.
+  Long sync search is split into frame sized ticks, timers are run in order
+  and single tick does not move timer wheel by hours of stream time.
+  */
+static void tick_no_sync(phys_ch_t *phys_ch, int n)
 {
-    if (!phys_ch->has_frame_sync) {
-        int n = phys_ch->data_end - phys_ch->data_begin;
-        phys_ch->has_frame_sync = find_frame_sync(phys_ch);
-        n -= phys_ch->data_end - phys_ch->data_begin;
+    int64_t usec = (int64_t)n * 20000 / 160;
+    bool rx_glitch = true;
+    do {
+        const int step = (usec > 20000) ? 20000 : usec;
+        tp_timer_tick(phys_ch->tp_timer, rx_glitch, step);
+        rx_glitch = false;
+        usec -= step;
+    } while (usec > 0);
+}
+
+static int process(phys_ch_t *phys_ch)
+{
+    // process all received data, sync. can be lost and found multiple times
+    while (true) {
         if (!phys_ch->has_frame_sync) {
-            tp_timer_tick(phys_ch->tp_timer, true, n * 20000 / 160);
-            return 0;
+            uint64_t t = stats_begin(phys_ch);
+            int n = phys_ch->data_end - phys_ch->data_begin;
+            phys_ch->has_frame_sync = find_frame_sync(phys_ch);
+            n -= phys_ch->data_end - phys_ch->data_begin;
+            phys_ch->tpol->stats.sync_bits += n;
+            stats_stage(phys_ch, TETRAPOL_STAGE_SYNC, &t);
+            if (!phys_ch->has_frame_sync) {
+                tick_no_sync(phys_ch, n);
+                return 0;
+            }
+            LOG(INFO, "Frame sync found");
+            ++phys_ch->tpol->stats.sync_found;
+            tetrapol_evt_sync(phys_ch->tpol, true);
+            phys_ch->tpol->frame_no = TETRAPOL_FRAME_NO_UNKNOWN;
+            if (phys_ch->cch) {
+                cch_fr_error(phys_ch->cch);
+            }
         }
-        LOG(INFO, "Frame sync found");
-        phys_ch->tpol->frame_no = FRAME_NO_UNKNOWN;
-        if (phys_ch->cch) {
-            cch_fr_error(phys_ch->cch);
+
+        int r = 1;
+        uint8_t fr_data[FRAME_DATA_LEN];
+        uint8_t fr_rel[FRAME_DATA_LEN];
+        uint64_t t = stats_begin(phys_ch);
+        while ((r = get_frame(phys_ch, fr_data, fr_rel)) > 0) {
+            stats_stage(phys_ch, TETRAPOL_STAGE_SYNC, &t);
+            process_frame(phys_ch, fr_data, phys_ch->rel ? fr_rel : NULL, &t);
+            tp_timer_tick(phys_ch->tp_timer, false, 20000);
+            if (phys_ch->tpol->frame_no != TETRAPOL_FRAME_NO_UNKNOWN) {
+                phys_ch->tpol->frame_no = (phys_ch->tpol->frame_no + 1) % 200;
+            }
+            stats_stage(phys_ch, TETRAPOL_STAGE_LOG_CH, &t);
         }
-    }
+        stats_stage(phys_ch, TETRAPOL_STAGE_SYNC, &t);
 
-    int r = 1;
-    uint8_t fr_data[FRAME_DATA_LEN];
-    while ((r = get_frame(phys_ch, fr_data)) > 0) {
-        process_frame(phys_ch, fr_data);
-        tp_timer_tick(phys_ch->tp_timer, false, 20000);
-        if (phys_ch->tpol->frame_no != FRAME_NO_UNKNOWN) {
-            phys_ch->tpol->frame_no = (phys_ch->tpol->frame_no + 1) % 200;
+        if (r == 0) {
+            return 0;
         }
-    }
 
-    if (r == 0) {
-        return 0;
+        LOG(INFO, "Frame sync lost");
+        ++phys_ch->tpol->stats.sync_lost;
+        tetrapol_evt_sync(phys_ch->tpol, false);
+        phys_ch->has_frame_sync = false;
     }
+}
 
-    LOG(INFO, "Frame sync lost");
-    phys_ch->has_frame_sync = false;
+int tetrapol_phys_ch_process(phys_ch_t *phys_ch)
+{
+    const int ret = process(phys_ch);
+    // events of processed data are written in single batch
+    out_buf_flush(phys_ch->tpol->out);
 
-    return 0;
+    return ret;
 }
 
 /**
@@ -347,54 +871,147 @@ int tetrapol_phys_ch_process(phys_ch_t *phys_ch)
   */
 static void detect_scr(phys_ch_t *phys_ch, const uint8_t *fr_data)
 {
-    // compute SCR statistics
-    for(int scr = 0; scr < ARRAY_LEN(phys_ch->scr_stat); ++scr) {
-        frame_t fr;
-        frame_decoder_reset(phys_ch->fd, phys_ch->band, scr, FRAME_TYPE_AUTO);
-        frame_decoder_decode(phys_ch->fd, &fr, fr_data);
-        if (fr.broken) {
-            phys_ch->scr_stat[scr] -= 2;
-            if (phys_ch->scr_stat[scr] < 0) {
-                phys_ch->scr_stat[scr] = 0;
+    const uint64_t trials = scr_search_get_trials(phys_ch->scr_search);
+    const int scr = scr_search_push(phys_ch->scr_search, fr_data);
+    phys_ch->tpol->stats.scr_trials +=
+        scr_search_get_trials(phys_ch->scr_search) - trials;
+    if (scr != SCR_SEARCH_NONE) {
+        tetrapol_phys_ch_set_scr(phys_ch, scr);
+        LOG(INFO, "SCR detected %d", scr);
+    }
+}
+
+static int tch_process_frame(phys_ch_t *phys_ch, const frame_t *fr, int scr)
+{
+    if (!tch_push_frame(phys_ch->tch, fr)) {
+        return 0;
+    }
+
+    // HACK: force SCR detection on TCH when SCR changes
+    if (phys_ch->scr != PHYS_CH_SCR_DETECT) {
+        phys_ch->scr = PHYS_CH_SCR_DETECT;
+        scr_search_add_score(phys_ch->scr_search, scr, 3);
+    }
+
+    return 0;
+}
+
+static void set_role(phys_ch_t *phys_ch, int role)
+{
+    static const char *role_names[] = {
+        [TETRAPOL_RADIO_AUTO] = "AUTO",
+        [TETRAPOL_RADIO_CCH] = "CCH",
+        [TETRAPOL_RADIO_TCH] = "TCH",
+    };
+
+    phys_ch->role = role;
+    phys_ch->role_frames = 0;
+    phys_ch->role_voice = 0;
+    LOG(INFO, "Radio channel type %s", role_names[role]);
+
+    tetrapol_evt_radio_ch_type(phys_ch->tpol, role);
+}
+
+/**
+  Route frame of TETRAPOL_RADIO_AUTO channel by detected channel type.
+
+  Until type is known, frames are passed into CCH which is looking for BCH.
+  BCH lock (known frame number) means CCH, voice frames or missing BCH for
+  whole superframe means TCH. TCH frames are still passed into CCH to
+  detect when the channel becomes CCH, CCH falls back into detection when
+  BCH lock is lost or when voice frames are received.
+  */
+static int route_frame(phys_ch_t *phys_ch, frame_t *fr, int scr)
+{
+    // CCH counts voice frames per superframe
+    if (phys_ch->role == TETRAPOL_RADIO_CCH && phys_ch->tpol->frame_no == 0) {
+        phys_ch->role_voice = 0;
+    }
+
+    const bool is_voice = !fr->broken && fr->fr_type == FRAME_TYPE_VOICE;
+    if (is_voice) {
+        ++phys_ch->role_voice;
+    }
+
+    if (phys_ch->role == TETRAPOL_RADIO_TCH) {
+        // voice frames carry no BCH, CCH is not locked while in TCH role
+        if (!is_voice) {
+            cch_push_frame(phys_ch->cch, fr);
+            if (phys_ch->tpol->frame_no != TETRAPOL_FRAME_NO_UNKNOWN) {
+                set_role(phys_ch, TETRAPOL_RADIO_CCH);
+                return 0;
             }
-            continue;
         }
-
-        ++phys_ch->scr_stat[scr];
+        return tch_process_frame(phys_ch, fr, scr);
     }
 
-    // get difference in statistic for two best SCRs
-    // and check best SCR confidence
-    int scr_max = 0, scr_max2 = 1;
-    if (phys_ch->scr_stat[0] < phys_ch->scr_stat[1]) {
-        scr_max = 1;
-        scr_max2 = 0;
+    if (phys_ch->role == TETRAPOL_RADIO_CCH) {
+        if (phys_ch->role_voice >= AUTO_VOICE_FRAMES) {
+            phys_ch->tpol->frame_no = TETRAPOL_FRAME_NO_UNKNOWN;
+            set_role(phys_ch, TETRAPOL_RADIO_TCH);
+            return tch_process_frame(phys_ch, fr, scr);
+        }
+        if (phys_ch->tpol->frame_no == TETRAPOL_FRAME_NO_UNKNOWN) {
+            set_role(phys_ch, TETRAPOL_RADIO_AUTO);
+        } else {
+            if (is_voice) {
+                // not a valid CCH frame, treat it as broken one
+                fr->broken = -2;
+            }
+            return cch_push_frame(phys_ch->cch, fr);
+        }
     }
-    for(int scr = 2; scr < ARRAY_LEN(phys_ch->scr_stat); ++scr) {
-        if (phys_ch->scr_stat[scr] >= phys_ch->scr_stat[scr_max]) {
-            scr_max2 = scr_max;
-            scr_max = scr;
+
+    if (is_voice) {
+        if (phys_ch->role_voice >= AUTO_VOICE_FRAMES) {
+            set_role(phys_ch, TETRAPOL_RADIO_TCH);
+            return tch_process_frame(phys_ch, fr, scr);
         }
+        return 0;
     }
-    if (phys_ch->scr_stat[scr_max] - phys_ch->scr_confidence > phys_ch->scr_stat[scr_max2]) {
-        tetrapol_phys_ch_set_scr(phys_ch, scr_max);
-        LOG(INFO, "SCR detected %d", scr_max);
+
+    const int r = cch_push_frame(phys_ch->cch, fr);
+    if (phys_ch->tpol->frame_no != TETRAPOL_FRAME_NO_UNKNOWN) {
+        set_role(phys_ch, TETRAPOL_RADIO_CCH);
+    } else if (++phys_ch->role_frames >= AUTO_BCH_TIMEOUT) {
+        set_role(phys_ch, TETRAPOL_RADIO_TCH);
     }
 
-    phys_ch->scr_guess = scr_max;
+    return r;
 }
 
-static int process_frame(phys_ch_t *phys_ch, const uint8_t *fr_data)
+/// update frame counters of stats
+static void stats_frame(tetrapol_stats_t *stats, const frame_t *fr)
+{
+    ++stats->frames;
+    if (fr->broken) {
+        ++stats->frames_broken;
+        if (fr->broken == -1) {
+            ++stats->crc_errs;
+        }
+    }
+    const int bits_fixed = (fr->bits_fixed < TETRAPOL_STATS_BITS_FIXED_MAX) ?
+        fr->bits_fixed : TETRAPOL_STATS_BITS_FIXED_MAX;
+    ++stats->bits_fixed[bits_fixed];
+}
+
+/**
+  @param fr_rel Reliability of frame data for soft decoding, or NULL.
+  @param t Start of stage cycles measurement, see stats_stage().
+  */
+static int process_frame(phys_ch_t *phys_ch, const uint8_t *fr_data,
+        const uint8_t *fr_rel, uint64_t *t)
 {
     if (phys_ch->scr == PHYS_CH_SCR_DETECT) {
         detect_scr(phys_ch, fr_data);
+        stats_stage(phys_ch, TETRAPOL_STAGE_SCR, t);
     }
 
     const int scr = (phys_ch->scr == PHYS_CH_SCR_DETECT) ?
-        phys_ch->scr_guess : phys_ch->scr;
+        scr_search_get_guess(phys_ch->scr_search) : phys_ch->scr;
 
     if (phys_ch->scr_last != scr) {
-        printf("{ \"event\": \"scr\", \"scr\": %d }\n", scr);
+        tetrapol_evt_scr(phys_ch->tpol, scr);
         phys_ch-> scr_last = scr;
     }
 
@@ -403,10 +1020,18 @@ static int process_frame(phys_ch_t *phys_ch, const uint8_t *fr_data)
 
     frame_t fr;
     frame_decoder_reset(phys_ch->fd, phys_ch->band, scr, fr_type);
-    frame_decoder_decode(phys_ch->fd, &fr, fr_data);
+    if (fr_rel) {
+        frame_decoder_decode_soft(phys_ch->fd, &fr, fr_data, fr_rel);
+    } else {
+        frame_decoder_decode(phys_ch->fd, &fr, fr_data);
+    }
+    stats_frame(&phys_ch->tpol->stats, &fr);
+    stats_stage(phys_ch, TETRAPOL_STAGE_DECODE, t);
 
-    if (!fr.broken) {
-        frame_json(phys_ch->tpol, &fr);
+    tetrapol_evt_frame(phys_ch->tpol, &fr, scr);
+
+    if (phys_ch->radio_ch_type == TETRAPOL_RADIO_AUTO) {
+        return route_frame(phys_ch, &fr, scr);
     }
 
     if (phys_ch->radio_ch_type == TETRAPOL_RADIO_CCH) {
@@ -414,15 +1039,5 @@ static int process_frame(phys_ch_t *phys_ch, const uint8_t *fr_data)
         return cch_push_frame(phys_ch->cch, &fr);
     }
 
-    if (!tch_push_frame(phys_ch->tch, &fr)) {
-        return 0;
-    }
-
-    // HACK: force SCR detection on TCH when SCR changes
-    if (phys_ch->scr != PHYS_CH_SCR_DETECT) {
-        phys_ch->scr = PHYS_CH_SCR_DETECT;
-        phys_ch->scr_stat[scr] += 3;
-    }
-
-    return 0;
+    return tch_process_frame(phys_ch, &fr, scr);
 }
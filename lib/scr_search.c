@@ -0,0 +1,262 @@
+#define LOG_PREFIX "scr_search"
+#include <tetrapol/log.h>
+#include <tetrapol/frame.h>
+#include <tetrapol/misc.h>
+#include <tetrapol/scr_search.h>
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+    // first part of frame, common to data and voice frames
+    FRAME_DATA_LEN1 = 52,
+    // frame is broken when viterbi_decode() fixes so many bits in first part
+    MAX_FIXED1 = 6,
+    // when less candidates is active, filter is not used
+    MIN_FILTER_CANDIDATES = 8,
+};
+
+struct scr_search_priv_t {
+    int band;
+    int confidence;     ///< required confidence for SCR detection
+    int guess;          ///< SCR with best score
+    int stat[SCR_SEARCH_NSCR];  ///< score of each SCR candidate
+    uint64_t trials;    ///< frames fully decoded for candidates
+    /// First part of zeroed frame processed by frame_descramble_deint1() for
+    /// all candidates, bit j of scr_pat[i][w] is bit i for SCR 64*w + j.
+    uint64_t scr_pat[FRAME_DATA_LEN1][SCR_SEARCH_NSCR / 64];
+    frame_decoder_t *fd;
+};
+
+scr_search_t *scr_search_create(int band, int confidence)
+{
+    scr_search_t *ss = calloc(1, sizeof(scr_search_t));
+    if (!ss) {
+        return NULL;
+    }
+
+    ss->fd = frame_decoder_create(band, 0, FRAME_TYPE_AUTO);
+    if (!ss->fd) {
+        free(ss);
+        return NULL;
+    }
+
+    ss->band = band;
+    ss->confidence = confidence;
+
+    const uint8_t zero[FRAME_DATA_LEN] = { 0 };
+    for (int scr = 0; scr < SCR_SEARCH_NSCR; ++scr) {
+        uint8_t pat[FRAME_DATA_LEN1];
+        frame_descramble_deint1(pat, zero, band, scr);
+        for (int i = 0; i < FRAME_DATA_LEN1; ++i) {
+            ss->scr_pat[i][scr / 64] |= (uint64_t)pat[i] << (scr % 64);
+        }
+    }
+
+    return ss;
+}
+
+void scr_search_destroy(scr_search_t *ss)
+{
+    if (!ss) {
+        return;
+    }
+    frame_decoder_destroy(ss->fd);
+    free(ss);
+}
+
+void scr_search_reset(scr_search_t *ss)
+{
+    memset(ss->stat, 0, sizeof(ss->stat));
+}
+
+int scr_search_get_confidence(scr_search_t *ss)
+{
+    return ss->confidence;
+}
+
+void scr_search_set_confidence(scr_search_t *ss, int confidence)
+{
+    ss->confidence = confidence;
+}
+
+int scr_search_get_guess(scr_search_t *ss)
+{
+    return ss->guess;
+}
+
+uint64_t scr_search_get_trials(scr_search_t *ss)
+{
+    return ss->trials;
+}
+
+void scr_search_add_score(scr_search_t *ss, int scr, int score)
+{
+    ss->stat[scr] += score;
+    if (ss->stat[scr] < 0) {
+        ss->stat[scr] = 0;
+    }
+}
+
+/// r = min(a + b, 7), a is 3 bit and b 2 bit bit-sliced value
+static inline void add_sat3(uint64_t *r, const uint64_t *a,
+        uint64_t b0, uint64_t b1)
+{
+    const uint64_t c0 = a[0] & b0;
+    const uint64_t c1 = (a[1] & b1) | (c0 & (a[1] ^ b1));
+    const uint64_t c2 = a[2] & c1;
+    r[0] = (a[0] ^ b0) | c2;
+    r[1] = (a[1] ^ b1 ^ c0) | c2;
+    r[2] = (a[2] ^ c1) | c2;
+}
+
+/// r = min(a, b) for 3 bit bit-sliced values
+static inline void min3(uint64_t *r, const uint64_t *a, const uint64_t *b)
+{
+    const uint64_t lt = (~a[2] & b[2]) | (~(a[2] ^ b[2]) &
+            ((~a[1] & b[1]) | (~(a[1] ^ b[1]) & ~a[0] & b[0])));
+    for (int k = 0; k < 3; ++k) {
+        r[k] = (a[k] & lt) | (b[k] & ~lt);
+    }
+}
+
+/**
+  Bit-sliced viterbi_decode(), evaluates 64 candidates at once. Only the number
+  of fixed bits is computed, path metrics saturate at 7 which is enough
+  for comparison with MAX_FIXED1.
+
+  @param in Received bits, in[i] holds bit i of all candidates.
+  @param size Number of decoded bits.
+
+  @return mask of candidates where less than MAX_FIXED1 bits is fixed
+  */
+static uint64_t viterbi_filter(const uint64_t *in, int size)
+{
+    // the same trellis as viterbi_decode()
+    static const uint8_t viterbi_table[8] = { 0, 3, 1, 2, 3, 0, 2, 1 };
+
+    uint64_t ok = 0;
+    for (int s = 0; s < 4; ++s) {
+        uint64_t tab[4][3];
+        memset(tab, 0xff, sizeof(tab));
+        memset(tab[s], 0, sizeof(tab[s]));
+
+        for (int p = size - 1; p >= 0; --p) {
+            uint64_t tab2[4][3];
+            for (int v = 0; v < 4; ++v) {
+                uint64_t r[2][3];
+                for (int j = 0; j < 2; ++j) {
+                    // transition from state u into state v
+                    const int u = (v >> 1) + 2 * j;
+                    const int e = viterbi_table[(u << 1) | (v & 1)];
+                    const uint64_t d0 = in[2*p] ^ -(uint64_t)(e & 1);
+                    const uint64_t d1 = in[2*p + 1] ^ -(uint64_t)(e >> 1);
+                    add_sat3(r[j], tab[u], d0 ^ d1, d0 & d1);
+                }
+                min3(tab2[v], r[0], r[1]);
+            }
+            memcpy(tab, tab2, sizeof(tab));
+        }
+
+        // tab[s] < MAX_FIXED1 (6)
+        ok |= ~(tab[s][2] & tab[s][1]);
+    }
+
+    return ok;
+}
+
+static void update_score(scr_search_t *ss, int scr, const uint8_t *fr_data)
+{
+    frame_t fr;
+    frame_decoder_reset(ss->fd, ss->band, scr, FRAME_TYPE_AUTO);
+    frame_decoder_decode(ss->fd, &fr, fr_data);
+    ++ss->trials;
+    scr_search_add_score(ss, scr, fr.broken ? -2 : 1);
+}
+
+/**
+  Check if leader will be detected regardless of result for remaining
+  candidates, they can gain at most one point.
+  */
+static bool is_detected(scr_search_t *ss, int scr_max)
+{
+    for (int scr = 0; scr < SCR_SEARCH_NSCR; ++scr) {
+        if (scr != scr_max &&
+                ss->stat[scr_max] - ss->confidence <= ss->stat[scr] + 1) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int scr_search_push(scr_search_t *ss, const uint8_t *fr_data)
+{
+    // candidates to check, only those with positive score if there are any
+    uint64_t active[SCR_SEARCH_NSCR / 64];
+    memset(active, 0, sizeof(active));
+    for (int scr = 0; scr < SCR_SEARCH_NSCR; ++scr) {
+        if (ss->stat[scr] > 0) {
+            active[scr / 64] |= 1ULL << (scr % 64);
+        }
+    }
+    if (!(active[0] | active[1])) {
+        memset(active, 0xff, sizeof(active));
+    }
+
+    // check current leader first, search can be finished without checking
+    // other candidates
+    if (active[ss->guess / 64] & (1ULL << (ss->guess % 64))) {
+        active[ss->guess / 64] &= ~(1ULL << (ss->guess % 64));
+        update_score(ss, ss->guess, fr_data);
+        if (is_detected(ss, ss->guess)) {
+            return ss->guess;
+        }
+    }
+
+    uint8_t fr_deint[FRAME_DATA_LEN1];
+    frame_descramble_deint1(fr_deint, fr_data, ss->band, 0);
+
+    for (int w = 0; w < ARRAY_LEN(active); ++w) {
+        uint64_t pass = active[w];
+        if (__builtin_popcountll(pass) >= MIN_FILTER_CANDIDATES) {
+            uint64_t in[FRAME_DATA_LEN1];
+            for (int i = 0; i < FRAME_DATA_LEN1; ++i) {
+                in[i] = ss->scr_pat[i][w] ^ -(uint64_t)fr_deint[i];
+            }
+            pass &= viterbi_filter(in, FRAME_DATA_LEN1 / 2);
+        }
+
+        for (int j = 0; j < 64; ++j) {
+            const int scr = 64 * w + j;
+            if (pass & (1ULL << j)) {
+                update_score(ss, scr, fr_data);
+            } else if (active[w] & (1ULL << j)) {
+                // rejected by filter, frame would be broken
+                scr_search_add_score(ss, scr, -2);
+            }
+        }
+    }
+
+    // get difference in statistic for two best SCRs
+    // and check best SCR confidence
+    int scr_max = 0, scr_max2 = 1;
+    if (ss->stat[0] < ss->stat[1]) {
+        scr_max = 1;
+        scr_max2 = 0;
+    }
+    for(int scr = 2; scr < SCR_SEARCH_NSCR; ++scr) {
+        if (ss->stat[scr] >= ss->stat[scr_max]) {
+            scr_max2 = scr_max;
+            scr_max = scr;
+        }
+    }
+
+    ss->guess = scr_max;
+    if (ss->stat[scr_max] - ss->confidence > ss->stat[scr_max2]) {
+        return scr_max;
+    }
+
+    return SCR_SEARCH_NONE;
+}
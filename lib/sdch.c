@@ -13,6 +13,7 @@
 struct sdch_priv_t {
     data_frame_t *data_fr;
     terminal_list_t *tlist;
+    tpol_t *tpol;
     bool rx_glitch;
     // This is used for re-sending tick event with changed state
     // do not allocate or release.
@@ -27,13 +28,14 @@ sdch_t *sdch_create(tpol_t *tpol)
     }
 
     sdch->te = NULL;
+    sdch->tpol = tpol;
 
     sdch->data_fr = data_frame_create();
     if (!sdch->data_fr) {
         goto err_data_fr;
     }
 
-    sdch->tlist = terminal_list_create(tpol, LOG_CH_SDCH);
+    sdch->tlist = terminal_list_create(tpol, TETRAPOL_LOG_CH_SDCH);
     if (!sdch->tlist) {
         goto err_tlist;
     }
@@ -66,6 +68,7 @@ bool sdch_dl_push_data_frame(sdch_t *sdch, const frame_t *fr)
 
     if (res < 0) {
         sdch->rx_glitch = true;
+        ++sdch->tpol->stats.mb_errs;
     }
 
     if (res <= 0) {
@@ -86,8 +89,10 @@ bool sdch_dl_push_data_frame(sdch_t *sdch, const frame_t *fr)
         int idx = hdlc_frame_stuffing_idx(&hdlc_fr);
         if (idx == -1) {
             sdch->rx_glitch = true;
+            ++sdch->tpol->stats.fcs_errs;
             LOG(INFO, "HDLC: broken frame");
         } else {
+            ++sdch->tpol->stats.stuffing;
             LOG(INFO, "HDLC: stuffing idx=%d", idx);
         }
         return false;
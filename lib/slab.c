@@ -0,0 +1,110 @@
+#define LOG_PREFIX "slab"
+#include <tetrapol/log.h>
+#include <tetrapol/slab.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+typedef union obj_t {
+    union obj_t *next;  ///< next free object
+    uint64_t u;
+    double d;
+} obj_t;
+
+struct slab_priv_t {
+    int obj_size;
+    int chunk_len;
+    obj_t *free;
+    void **chunks;
+    int nchunks;
+    int count;
+};
+
+slab_t *slab_create(int obj_size, int chunk_len)
+{
+    slab_t *slab = calloc(1, sizeof(slab_t));
+    if (!slab) {
+        return NULL;
+    }
+
+    // keep all objects aligned
+    if (obj_size < (int)sizeof(obj_t)) {
+        obj_size = sizeof(obj_t);
+    }
+    slab->obj_size = (obj_size + sizeof(obj_t) - 1) / sizeof(obj_t) *
+        sizeof(obj_t);
+    slab->chunk_len = chunk_len;
+
+    return slab;
+}
+
+void slab_destroy(slab_t *slab)
+{
+    if (!slab) {
+        return;
+    }
+    if (slab->count) {
+        LOG(WTF, "%d objects not released", slab->count);
+    }
+    for (int i = 0; i < slab->nchunks; ++i) {
+        free(slab->chunks[i]);
+    }
+    free(slab->chunks);
+    free(slab);
+}
+
+static bool grow(slab_t *slab)
+{
+    void **chunks = realloc(slab->chunks,
+            (slab->nchunks + 1) * sizeof(*chunks));
+    if (!chunks) {
+        return false;
+    }
+    slab->chunks = chunks;
+
+    char *chunk = malloc((size_t)slab->obj_size * slab->chunk_len);
+    if (!chunk) {
+        return false;
+    }
+    slab->chunks[slab->nchunks++] = chunk;
+    for (int i = slab->chunk_len - 1; i >= 0; --i) {
+        obj_t *obj = (obj_t *)(chunk + (size_t)i * slab->obj_size);
+        obj->next = slab->free;
+        slab->free = obj;
+    }
+
+    return true;
+}
+
+void *slab_alloc(slab_t *slab)
+{
+    if (!slab->free && !grow(slab)) {
+        LOG(ERR, "ERR OOM");
+        return NULL;
+    }
+
+    obj_t *obj = slab->free;
+    slab->free = obj->next;
+    ++slab->count;
+
+    return obj;
+}
+
+void slab_free(slab_t *slab, void *obj)
+{
+    if (!obj) {
+        return;
+    }
+
+    obj_t *o = obj;
+    o->next = slab->free;
+    slab->free = o;
+    --slab->count;
+}
+
+int slab_count(const slab_t *slab)
+{
+    return slab->count;
+}
@@ -57,7 +57,7 @@ int tch_push_frame(tch_t *tch, const frame_t *fr)
     }
 
     if (fr->fr_type == FRAME_TYPE_VOICE) {
-        LOG(INFO,"VOICE FRAME asb=%i", (fr->voice.asb[0] << 1) | fr->voice.asb[1]);
+        LOG(INFO,"VOICE FRAME asb=%i", ((frame_asb(fr) & 1) << 1) | (frame_asb(fr) >> 1));
         return 0;
     }
 
@@ -67,7 +67,7 @@ int tch_push_frame(tch_t *tch, const frame_t *fr)
         return -1;
     }
 
-    if (fr->data.asb[0]) {
+    if (frame_asb(fr) & 1) {
         sdch_dl_push_data_frame(tch->vch, fr);
         return 0;
     }
@@ -3,173 +3,342 @@
 #include <tetrapol/log.h>
 #include <tetrapol/terminal.h>
 #include <tetrapol/link.h>
+#include <tetrapol/timer_wheel.h>
 #include <stdlib.h>
 #include <string.h>
 
-#include <glib.h>
+enum {
+    /// index is split into pages by z and y, pages are indexed by x
+    TLIST_NPAGES = 2 * 8,
+    TLIST_PAGE_LEN = 0x1000,
+    /// terminals are allocated in chunks, so they are never moved
+    TLIST_CHUNK_LEN = 256,
+    /// resolution of terminal timers, single frame
+    TLIST_TICK_USEC = 20000,
+    TLIST_TICKS_PER_SEC = 1000000 / TLIST_TICK_USEC,
+};
 
 struct terminal_priv_t {
     link_t *link;
 };
 
+typedef struct tlist_entry_t tlist_entry_t;
+
+struct tlist_entry_t {
+    terminal_t term;
+    addr_t addr;
+    int32_t id;             ///< position in chunks
+    uint32_t glitch_gen;    ///< last RX glitch reported to link
+    uint64_t last_seen;     ///< tick of the last frame
+    tw_timer_t timer;       ///< T454 of link or terminal timeout
+    /// list of live terminals, least recently active first,
+    /// free entries are linked by lru_next
+    tlist_entry_t *lru_prev;
+    tlist_entry_t *lru_next;
+};
+
 struct terminal_list_priv_t {
-    GTree *tree;
+    /// id of terminal + 1 for packed address, 0 for unknown address,
+    /// pages are allocated when the first terminal is inserted
+    int32_t *index[TLIST_NPAGES];
+    tlist_entry_t **chunks;
+    int nchunks;
+    tlist_entry_t *free;
+    tlist_entry_t *lru_first;
+    tlist_entry_t *lru_last;
+    int nterms;
+    timer_wheel_t *tw;
+    time_evt_t te;          ///< the last tick
+    /// RX glitches are counted and reported to link lazily by next frame
+    uint32_t glitch_gen;
     tpol_t *tpol;
     int log_ch;
 };
 
-static terminal_t* terminal_create(tpol_t *tpol, int log_ch)
+int terminal_push_hdlc_frame(terminal_t* term, const hdlc_frame_t *hdlc_fr)
+{
+    return link_push_hdlc_frame(term->link, hdlc_fr);
+}
+
+terminal_list_t *terminal_list_create(tpol_t * tpol, int log_ch)
 {
-    terminal_t *term = malloc(sizeof(terminal_t));
-    if (!term) {
+    terminal_list_t *tlist = calloc(1, sizeof(terminal_list_t));
+    if (!tlist) {
         return NULL;
     }
 
-    term->link = link_create(tpol, log_ch);
-    if (!term->link) {
-        free(term);
+    tlist->tw = timer_wheel_create(0);
+    if (!tlist->tw) {
+        free(tlist);
         return NULL;
     }
 
-    return term;
+    tlist->tpol = tpol;
+    tlist->log_ch = log_ch;
+
+    return tlist;
 }
 
-static void terminal_destroy(terminal_t *term)
+void terminal_list_destroy(terminal_list_t *tlist)
 {
-    if (!term) {
-        return;
+    for (tlist_entry_t *e = tlist->lru_first; e; e = e->lru_next) {
+        link_destroy(e->term.link);
     }
-
-    link_destroy(term->link);
-    free(term);
+    for (int i = 0; i < TLIST_NPAGES; ++i) {
+        free(tlist->index[i]);
+    }
+    for (int i = 0; i < tlist->nchunks; ++i) {
+        free(tlist->chunks[i]);
+    }
+    free(tlist->chunks);
+    timer_wheel_destroy(tlist->tw);
+    free(tlist);
 }
 
-static inline void terminal_destroy_(gpointer term)
+/// get index slot for address, NULL if page is not allocated
+static inline int32_t *index_slot(const terminal_list_t *tlist,
+        const addr_t *addr)
 {
-    terminal_destroy(term);
+    const uint16_t a = addr_pack(addr);
+    int32_t *page = tlist->index[a / TLIST_PAGE_LEN];
+
+    return page ? &page[a % TLIST_PAGE_LEN] : NULL;
 }
 
-int terminal_push_hdlc_frame(terminal_t* term, const hdlc_frame_t *hdlc_fr)
+static tlist_entry_t *lookup_entry(const terminal_list_t* tlist,
+        const addr_t *addr)
 {
-    return link_push_hdlc_frame(term->link, hdlc_fr);
+    const int32_t *slot = index_slot(tlist, addr);
+    if (!slot || !*slot) {
+        return NULL;
+    }
+
+    const int id = *slot - 1;
+    return &tlist->chunks[id / TLIST_CHUNK_LEN][id % TLIST_CHUNK_LEN];
 }
 
-static inline void addr_free(gpointer data)
+terminal_t* terminal_list_lookup(const terminal_list_t* tlist, const addr_t *addr)
 {
-    free(data);
+    tlist_entry_t *e = lookup_entry(tlist, addr);
+
+    return e ? &e->term : NULL;
 }
 
-static gint addr_cmp(gconstpointer _a1, gconstpointer _a2, gpointer user_data)
+static void lru_unlink(terminal_list_t *tlist, tlist_entry_t *e)
 {
-    const addr_t *a1 = _a1;
-    const addr_t *a2 = _a2;
-
-    if (a1->z != a2->z) {
-        return a2->z - a1->z;
+    if (e->lru_prev) {
+        e->lru_prev->lru_next = e->lru_next;
+    } else {
+        tlist->lru_first = e->lru_next;
     }
-    if (a1->y != a2->y) {
-        return a2->y - a1->y;
+    if (e->lru_next) {
+        e->lru_next->lru_prev = e->lru_prev;
+    } else {
+        tlist->lru_last = e->lru_prev;
     }
-    return a2->x - a1->x;
 }
 
-terminal_list_t *terminal_list_create(tpol_t * tpol, int log_ch)
+static void lru_append(terminal_list_t *tlist, tlist_entry_t *e)
 {
-    terminal_list_t *tlist = malloc(sizeof(terminal_list_t));
-    if (!tlist) {
-        return NULL;
+    e->lru_prev = tlist->lru_last;
+    e->lru_next = NULL;
+    if (tlist->lru_last) {
+        tlist->lru_last->lru_next = e;
+    } else {
+        tlist->lru_first = e;
     }
+    tlist->lru_last = e;
+}
 
-    tlist->tree = g_tree_new_full(addr_cmp, NULL, addr_free, terminal_destroy_);
-    if (!tlist->tree) {
-        free(tlist);
-        return NULL;
+/**
+  Start timer of terminal for the earlier of terminal timeout and T454 of
+  link.
+
+  @param usec Time until T454 expires or -1.
+  */
+static void schedule(terminal_list_t *tlist, tlist_entry_t *e, int usec)
+{
+    uint64_t expires = UINT64_MAX;
+    if (tlist->tpol->terminal_timeout > 0) {
+        expires = e->last_seen +
+            (uint64_t)tlist->tpol->terminal_timeout * TLIST_TICKS_PER_SEC;
+    }
+    if (usec >= 0) {
+        const uint64_t t = timer_wheel_now(tlist->tw) +
+            (usec + TLIST_TICK_USEC - 1) / TLIST_TICK_USEC;
+        if (t < expires) {
+            expires = t;
+        }
     }
 
-    tlist->tpol = tpol;
-    tlist->log_ch = log_ch;
+    if (expires == UINT64_MAX) {
+        timer_wheel_cancel(tlist->tw, &e->timer);
+    } else {
+        timer_wheel_add(tlist->tw, &e->timer, expires);
+    }
+}
 
-    return tlist;
+static void remove_entry(terminal_list_t *tlist, tlist_entry_t *e)
+{
+    *index_slot(tlist, &e->addr) = 0;
+    link_destroy(e->term.link);
+    timer_wheel_cancel(tlist->tw, &e->timer);
+    lru_unlink(tlist, e);
+    e->lru_next = tlist->free;
+    tlist->free = e;
+    --tlist->nterms;
 }
 
-void terminal_list_destroy(terminal_list_t *tlist)
+static void evict(terminal_list_t *tlist, tlist_entry_t *e, int reason)
 {
-    g_tree_destroy(tlist->tree);
-    free(tlist);
+    LOG_IF(INFO) {
+        char buf[ADDR_PRINT_BUF_SIZE];
+        LOG(INFO, "evict %s reason=%d", addr_print(buf, &e->addr), reason);
+    }
+    const tetrapol_evt_evict_t evt = {
+        .log_ch = tlist->log_ch,
+        .addr = e->addr,
+        .reason = reason,
+    };
+    tetrapol_evt_evict(tlist->tpol, &evt);
+    remove_entry(tlist, e);
 }
 
-terminal_t* terminal_list_lookup(const terminal_list_t* tlist, const addr_t *addr)
+/// add chunk of free entries
+static bool grow(terminal_list_t *tlist)
 {
-    return g_tree_lookup(tlist->tree, addr);
+    tlist_entry_t **chunks = realloc(tlist->chunks,
+            (tlist->nchunks + 1) * sizeof(*chunks));
+    if (!chunks) {
+        return false;
+    }
+    tlist->chunks = chunks;
+
+    tlist_entry_t *chunk = calloc(TLIST_CHUNK_LEN, sizeof(tlist_entry_t));
+    if (!chunk) {
+        return false;
+    }
+    for (int i = TLIST_CHUNK_LEN - 1; i >= 0; --i) {
+        chunk[i].id = tlist->nchunks * TLIST_CHUNK_LEN + i;
+        chunk[i].lru_next = tlist->free;
+        tlist->free = &chunk[i];
+    }
+    tlist->chunks[tlist->nchunks++] = chunk;
+
+    return true;
 }
 
-terminal_t* terminal_list_insert(terminal_list_t* tlist, const addr_t *addr)
+static tlist_entry_t *insert_entry(terminal_list_t* tlist, const addr_t *addr)
 {
-    terminal_t *term = terminal_create(tlist->tpol, tlist->log_ch);
-    if (!term) {
-        return NULL;
+    tlist_entry_t *e = lookup_entry(tlist, addr);
+    if (e) {
+        return e;
+    }
+
+    int32_t **page = &tlist->index[addr_pack(addr) / TLIST_PAGE_LEN];
+    if (!*page) {
+        *page = calloc(TLIST_PAGE_LEN, sizeof(int32_t));
+        if (!*page) {
+            return NULL;
+        }
     }
 
-    addr_t *addr_new = malloc(sizeof(addr_t));
-    if (!addr_new) {
-        terminal_destroy(term);
+    if (tlist->tpol->terminals_max > 0 &&
+            tlist->nterms >= tlist->tpol->terminals_max) {
+        evict(tlist, tlist->lru_first, TETRAPOL_EVICT_LRU);
+    }
+
+    if (!tlist->free && !grow(tlist)) {
         return NULL;
     }
-    memcpy(addr_new, addr, sizeof(addr_t));
+    e = tlist->free;
+    e->term.link = link_create(tlist->tpol, tlist->log_ch);
+    if (!e->term.link) {
+        return NULL;
+    }
+    tlist->free = e->lru_next;
+
+    memcpy(&e->addr, addr, sizeof(addr_t));
+    e->glitch_gen = tlist->glitch_gen;
+    e->last_seen = timer_wheel_now(tlist->tw);
+    tw_timer_init(&e->timer);
+    lru_append(tlist, e);
+    *index_slot(tlist, addr) = e->id + 1;
+    ++tlist->nterms;
+    schedule(tlist, e, -1);
+
+    return e;
+}
 
-    g_tree_insert(tlist->tree, addr_new, term);
+terminal_t* terminal_list_insert(terminal_list_t* tlist, const addr_t *addr)
+{
+    tlist_entry_t *e = insert_entry(tlist, addr);
 
-    return term;
+    return e ? &e->term : NULL;
 }
 
 void terminal_list_erase(terminal_list_t* tlist, const addr_t *addr)
 {
-    g_tree_remove(tlist->tree, addr);
+    tlist_entry_t *e = lookup_entry(tlist, addr);
+    if (e) {
+        remove_entry(tlist, e);
+    }
 }
 
 int terminal_list_push_hdlc_frame(terminal_list_t* tlist,
         const hdlc_frame_t *hdlc_fr)
 {
-    terminal_t *term = terminal_list_lookup(tlist, &hdlc_fr->addr);
-    if (!term) {
-        term = terminal_list_insert(tlist, &hdlc_fr->addr);
-        if (!term) {
-            LOG(ERR, "Terminal allocation failed");
-            return -1;
-        }
+    tlist_entry_t *e = insert_entry(tlist, &hdlc_fr->addr);
+    if (!e) {
+        LOG(ERR, "Terminal allocation failed");
+        return -1;
     }
 
-    return terminal_push_hdlc_frame(term, hdlc_fr);
-}
-
-static gboolean terminal_rx_glitch(gpointer key, gpointer value,
-        gpointer data)
-{
-    terminal_t *term = value;
+    if (e->glitch_gen != tlist->glitch_gen) {
+        link_rx_glitch(e->term.link);
+        e->glitch_gen = tlist->glitch_gen;
+    }
+    e->last_seen = timer_wheel_now(tlist->tw);
+    if (e != tlist->lru_last) {
+        lru_unlink(tlist, e);
+        lru_append(tlist, e);
+    }
 
-    link_rx_glitch(term->link);
+    const int ret = terminal_push_hdlc_frame(&e->term, hdlc_fr);
+    // start T454 for new segments
+    schedule(tlist, e, link_tick(&tlist->te, e->term.link));
 
-    return false;
+    return ret;
 }
 
 void terminal_list_rx_glitch(terminal_list_t* tlist)
 {
-    g_tree_foreach(tlist->tree, terminal_rx_glitch, NULL);
+    ++tlist->glitch_gen;
 }
 
-static gboolean terminal_tick(gpointer key, gpointer value,
-        gpointer data)
+static void expire(tw_timer_t *timer, void *ctx)
 {
-    terminal_t *term = value;
-    time_evt_t *te = data;
+    terminal_list_t *tlist = ctx;
+    tlist_entry_t *e = TW_CONTAINER_OF(timer, tlist_entry_t, timer);
 
-    link_tick(te, term->link);
+    const int timeout = tlist->tpol->terminal_timeout;
+    if (timeout > 0 && timer_wheel_now(tlist->tw) - e->last_seen >=
+            (uint64_t)timeout * TLIST_TICKS_PER_SEC) {
+        evict(tlist, e, TETRAPOL_EVICT_IDLE);
+        return;
+    }
 
-    return false;
+    schedule(tlist, e, link_tick(&tlist->te, e->term.link));
 }
 
 void terminal_list_tick(terminal_list_t* tlist, time_evt_t *te)
 {
-    g_tree_foreach(tlist->tree, terminal_tick, te);
-}
+    tlist->te = *te;
+    if (te->rx_glitch) {
+        terminal_list_rx_glitch(tlist);
+    }
 
+    const uint64_t now = (uint64_t)te->tv.tv_sec * TLIST_TICKS_PER_SEC +
+        te->tv.tv_usec / TLIST_TICK_USEC;
+    timer_wheel_advance(tlist->tw, now, expire, tlist);
+}
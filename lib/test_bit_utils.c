@@ -6,6 +6,11 @@
 // include, we are testing static methods
 #include "bit_utils.c"
 
+#include <tetrapol/misc.h>
+
+#include <stdlib.h>
+#include <string.h>
+
 
 /// test few results known as good
 static void test_check_fcs(void **state)
@@ -43,10 +48,99 @@ static void test_check_fcs(void **state)
     }
 }
 
+static void test_pack_bits64(void **state)
+{
+    (void) state;   // unused
+
+    for (int round = 0; round < 1000; ++round) {
+        uint8_t bits[64];
+        for (int i = 0; i < ARRAY_LEN(bits); ++i) {
+            bits[i] = rand() & 1;
+        }
+        uint8_t exp[8];
+        memset(exp, 0, sizeof(exp));
+        pack_bits(exp, bits, 0, ARRAY_LEN(bits));
+
+        const uint64_t w = pack_bits64(bits);
+        for (int i = 0; i < ARRAY_LEN(exp); ++i) {
+            assert_int_equal(exp[i], pack_bits8(&bits[8 * i]));
+            assert_int_equal(exp[i], (uint8_t)(w >> (8 * i)));
+        }
+    }
+}
+
+// bits stored into words must be read back, other bits are left untouched
+static void test_word_bits(void **state)
+{
+    (void) state;   // unused
+
+    uint8_t bits[128];
+    uint64_t words[2] = { 0, 0 };
+    memset(bits, 0, sizeof(bits));
+
+    for (int round = 0; round < 10000; ++round) {
+        const int len = 1 + rand() % 64;
+        const int offs = rand() % (ARRAY_LEN(bits) - len + 1);
+        const uint64_t val = ((uint64_t)rand() << 62) ^
+            ((uint64_t)rand() << 31) ^ rand();
+
+        put_word_bits(words, offs, len, val);
+        for (int i = 0; i < len; ++i) {
+            bits[offs + i] = (val >> i) & 1;
+        }
+
+        for (int i = 0; i < ARRAY_LEN(bits); ++i) {
+            assert_int_equal(bits[i], (words[i / 64] >> (i % 64)) & 1);
+        }
+        const uint64_t mask = (len < 64) ? (UINT64_C(1) << len) - 1 : ~UINT64_C(0);
+        assert_int_equal(val & mask, get_word_bits(words, offs, len));
+    }
+}
+
+// fields read by bit reader must match get_bits(), bits past end are zeros
+static void test_bit_reader(void **state)
+{
+    (void) state;   // unused
+
+    uint8_t data[24];
+    uint8_t padded[sizeof(data) + 8];
+
+    for (int round = 0; round < 10000; ++round) {
+        const int len = rand() % (ARRAY_LEN(data) + 1);
+        for (int i = 0; i < len; ++i) {
+            data[i] = rand();
+        }
+        memset(padded, 0, sizeof(padded));
+        memcpy(padded, data, len);
+
+        bit_reader_t br;
+        br_init(&br, data, len);
+        int pos = rand() % 8;
+        br_skip(&br, pos);
+        while (pos < 8 * (len + 2)) {
+            const int nbits = 1 + rand() % 32;
+            assert_int_equal(get_bits(nbits, padded, pos), br_read(&br, nbits));
+            pos += nbits;
+            assert_int_equal(pos, br.pos);
+            assert_int_equal(pos > 8 * len, br_overflow(&br));
+        }
+
+        pos = rand() % (8 * ARRAY_LEN(data));
+        br_seek(&br, pos);
+        if (pos + 12 <= 8 * len) {
+            assert_int_equal(get_bits(12, padded, pos), br_read(&br, 12));
+            assert_false(br_overflow(&br));
+        }
+    }
+}
+
 int main(void)
 {
     const UnitTest tests[] = {
         unit_test(test_check_fcs),
+        unit_test(test_pack_bits64),
+        unit_test(test_word_bits),
+        unit_test(test_bit_reader),
     };
 
     return run_tests(tests);
@@ -6,6 +6,75 @@
 // include, we are testing static methods
 #include "data_frame.c"
 
+enum {
+    NBLOCKS_MAX = ARRAY_LEN(((data_frame_t *)NULL)->blocks),
+};
+
+// reference implementation working directly on bits of frames,
+// bit 1 + i of frame is bit i of frame_data_t.data including ASB
+
+static bool ref_check_parity(const frame_t *frames, int nframes)
+{
+    for (int i = 3; i < 3 + 64; ++i) {
+        int parity = 0;
+        for (int fr_no = 0; fr_no < nframes; ++fr_no) {
+            parity ^= frame_get_bits(&frames[fr_no], 1 + i, 1);
+        }
+        if (parity) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void ref_fix_by_parity(frame_t *frames, int nframes)
+{
+    int err_fr_no = 0;
+    for (int fr_no = 0; fr_no < nframes; ++fr_no) {
+        if (frames[fr_no].broken) {
+            err_fr_no = fr_no;
+            break;
+        }
+    }
+    if (err_fr_no == nframes - 1) {
+        return;
+    }
+
+    for (int i = 1; i < 1 + 64 + 2; ++i) {
+        int bit = 0;
+        for (int fr_no = 0; fr_no < nframes; ++fr_no) {
+            if (fr_no != err_fr_no) {
+                bit ^= frame_get_bits(&frames[fr_no], 1 + i, 1);
+            }
+        }
+        frame_set_bits(&frames[err_fr_no], 1 + i, 1, bit);
+    }
+}
+
+static int ref_get_bytes(const frame_t *frames, int nframes, uint8_t *data)
+{
+    nframes = (nframes <= 2) ? nframes : nframes - 1;
+    memset(data, 0, 8*nframes);
+    for (int fr_no = 0; fr_no < nframes; ++fr_no) {
+        frame_unpacked_t u;
+        frame_unpack(&u, &frames[fr_no]);
+        pack_bits(data, u.data.data + 2, 64*fr_no, 64);
+    }
+
+    return nframes * 64;
+}
+
+static void rand_frame(frame_t *fr, int fn)
+{
+    memset(fr, 0, sizeof(*fr));
+    fr->fr_type = FRAME_TYPE_DATA;
+    for (int i = 0; i < FRAME_DATA_CRC; ++i) {
+        frame_set_bits(fr, i, 1, rand() & 1);
+    }
+    frame_set_bits(fr, FRAME_DATA_FN, 2, fn);
+}
+
 static void test_pack_bits(void **state)
 {
     {
@@ -38,10 +107,116 @@ static void test_pack_bits(void **state)
     }
 }
 
+// packed blocks are checked and repaired as frames bit by bit
+static void test_parity_random(void **state)
+{
+    (void) state;   // unused
+
+    data_frame_t *data_fr = data_frame_create();
+    assert_non_null(data_fr);
+
+    frame_t frames[NBLOCKS_MAX];
+    for (int round = 0; round < 20000; ++round) {
+        const int nframes = 1 + rand() % NBLOCKS_MAX;
+        for (int fr_no = 0; fr_no < nframes; ++fr_no) {
+            rand_frame(&frames[fr_no], rand() % 4);
+        }
+        // valid parity block, possibly with error
+        if (rand() % 2) {
+            frame_t *par = &frames[nframes - 1];
+            for (int i = 0; i < FRAME_DATA_CRC; ++i) {
+                int bit = 0;
+                for (int fr_no = 0; fr_no < nframes - 1; ++fr_no) {
+                    bit ^= frame_get_bits(&frames[fr_no], i, 1);
+                }
+                frame_set_bits(par, i, 1, bit);
+            }
+            if (rand() % 2) {
+                frame_t *fr = &frames[rand() % nframes];
+                const int i = rand() % FRAME_DATA_CRC;
+                frame_set_bits(fr, i, 1, frame_get_bits(fr, i, 1) ^ 1);
+            }
+        }
+        if (rand() % 2) {
+            frames[rand() % nframes].broken = 1;
+        }
+
+        data_frame_reset(data_fr);
+        for (int fr_no = 0; fr_no < nframes; ++fr_no) {
+            block_pack(&data_fr->blocks[fr_no], &frames[fr_no]);
+        }
+        data_fr->nframes = nframes;
+
+        assert_int_equal(ref_check_parity(frames, nframes),
+                check_parity(data_fr));
+
+        ref_fix_by_parity(frames, nframes);
+        fix_by_parity(data_fr);
+
+        uint8_t exp[8 * NBLOCKS_MAX];
+        uint8_t res[8 * NBLOCKS_MAX];
+        const int nbits = ref_get_bytes(frames, nframes, exp);
+        assert_int_equal(nbits, data_frame_get_bytes(data_fr, res));
+        assert_memory_equal(exp, res, nbits / 8);
+    }
+
+    data_frame_destroy(data_fr);
+}
+
+// multiblock FN 01, 10, 11, 10, 01 with one broken block repaired
+static void test_multiblock_random(void **state)
+{
+    (void) state;   // unused
+
+    static const int fns[] = { FN_01, FN_10, FN_11, FN_10, FN_01, };
+    data_frame_t *data_fr = data_frame_create();
+    assert_non_null(data_fr);
+
+    frame_t frames[ARRAY_LEN(fns)];
+    for (int round = 0; round < 1000; ++round) {
+        for (int fr_no = 0; fr_no < ARRAY_LEN(fns); ++fr_no) {
+            rand_frame(&frames[fr_no], fns[fr_no]);
+        }
+        frame_t *par = &frames[ARRAY_LEN(fns) - 1];
+        for (int i = 1 + 2; i < 1 + 2 + 64 + 1; ++i) {
+            int bit = 0;
+            for (int fr_no = 0; fr_no < ARRAY_LEN(fns) - 1; ++fr_no) {
+                bit ^= frame_get_bits(&frames[fr_no], i, 1);
+            }
+            frame_set_bits(par, i, 1, bit);
+        }
+        uint8_t exp[8 * ARRAY_LEN(fns)];
+        const int nbits = ref_get_bytes(frames, ARRAY_LEN(fns), exp);
+
+        const int broken = rand() % (ARRAY_LEN(fns) + 1);
+        if (broken < ARRAY_LEN(fns) - 1) {
+            frames[broken].broken = 1;
+            for (int i = 2; i < 2 + 64; ++i) {
+                frame_set_bits(&frames[broken], 1 + i, 1, rand() & 1);
+            }
+        }
+
+        for (int fr_no = 0; fr_no < ARRAY_LEN(fns) - 1; ++fr_no) {
+            assert_int_equal(0, data_frame_push_frame(data_fr, &frames[fr_no]));
+        }
+        assert_int_equal(1, data_frame_push_frame(data_fr, par));
+
+        uint8_t res[8 * ARRAY_LEN(fns)];
+        assert_int_equal(nbits, data_frame_get_bytes(data_fr, res));
+        assert_memory_equal(exp, res, nbits / 8);
+    }
+
+    data_frame_destroy(data_fr);
+}
+
 int main(void)
 {
+    srand(0);
+
     const UnitTest tests[] = {
         unit_test(test_pack_bits),
+        unit_test(test_parity_random),
+        unit_test(test_multiblock_random),
     };
 
     return run_tests(tests);
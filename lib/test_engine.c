@@ -0,0 +1,169 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <tetrapol/engine.h>
+#include <tetrapol/frame.h>
+#include <tetrapol/log.h>
+#include <tetrapol/misc.h>
+#include <tetrapol/phys_ch.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+    NCHANNELS = 5,
+    NWORKERS = 3,
+    // small reads to make workers switch channels often
+    READ_LEN = 1000,
+};
+
+typedef struct {
+    uint8_t *data;
+    int len;
+    int pos;
+} input_t;
+
+static int input_read(void *ctx, uint8_t *buf, int len)
+{
+    input_t *in = ctx;
+    if (len > READ_LEN) {
+        len = READ_LEN;
+    }
+    if (len > in->len - in->pos) {
+        len = in->len - in->pos;
+    }
+    memcpy(buf, in->data + in->pos, len);
+    in->pos += len;
+
+    return len;
+}
+
+/// stream of data frames, one bit per byte
+static void mk_input(input_t *in, int nframes, int scr)
+{
+    frame_encoder_t *fe = frame_encoder_create(TETRAPOL_BAND_UHF, scr,
+            DIR_DOWNLINK);
+    assert_non_null(fe);
+
+    in->len = nframes * FRAME_LEN;
+    in->pos = 0;
+    in->data = malloc(in->len);
+    assert_non_null(in->data);
+
+    for (int n = 0; n < nframes; ++n) {
+        frame_t fr;
+        memset(&fr, 0, sizeof(fr));
+        fr.fr_type = FRAME_TYPE_DATA;
+        for (int i = 0; i < 2 + 64; ++i) {
+            frame_set_bits(&fr, FRAME_DATA_FN + i, 1, rand() & 1);
+        }
+        uint8_t fr_bytes[FRAME_LEN / 8];
+        assert_int_equal(0, frame_encoder_encode(fe, fr_bytes, &fr));
+        for (int i = 0; i < FRAME_LEN; ++i) {
+            in->data[n * FRAME_LEN + i] = (fr_bytes[i / 8] >> (i % 8)) & 1;
+        }
+    }
+
+    frame_encoder_destroy(fe);
+}
+
+/// count lines in output, check all are complete events of the channel
+static int count_events(FILE *out, int ch_id, const char *event)
+{
+    char tag[32];
+    snprintf(tag, sizeof(tag), "\"channel\": %d, ", ch_id);
+    char ev[32];
+    snprintf(ev, sizeof(ev), "{ \"event\": \"%s\", ", event);
+
+    int n = 0;
+    char line[4096];
+    rewind(out);
+    while (fgets(line, sizeof(line), out)) {
+        assert_int_equal('\n', line[strlen(line) - 1]);
+        assert_memory_equal("{ \"event\": ", line, 11);
+        if (strstr(line, tag) && !strncmp(line, ev, strlen(ev))) {
+            ++n;
+        }
+    }
+
+    return n;
+}
+
+// channels decoded in parallel must produce the same events as decoded alone
+static void test_engine_run(void **state)
+{
+    (void) state;   // unused
+
+    const tetrapol_cfg_t cfg = {
+        .band = TETRAPOL_BAND_UHF,
+        .dir = DIR_DOWNLINK,
+        .radio_ch_type = TETRAPOL_RADIO_CCH,
+        .input_fmt = TETRAPOL_INPUT_UNPACKED,
+    };
+
+    log_set_lvl(ERR);
+    srand(0);
+
+    input_t inputs[NCHANNELS];
+    for (int i = 0; i < NCHANNELS; ++i) {
+        mk_input(&inputs[i], 300 + 100 * i, 10 * i + 1);
+    }
+
+    // reference, each channel decoded alone
+    int nframes[NCHANNELS];
+    int nscr[NCHANNELS];
+    for (int i = 0; i < NCHANNELS; ++i) {
+        FILE *out = tmpfile();
+        assert_non_null(out);
+        tetrapol_t *tetrapol = tetrapol_create(&cfg);
+        assert_non_null(tetrapol);
+        tetrapol_set_output(tetrapol, out);
+        tetrapol_set_ch_id(tetrapol, i);
+        phys_ch_t *phys_ch = tetrapol_phys_ch_create(tetrapol);
+        assert_non_null(phys_ch);
+
+        for (int offs = 0; offs < inputs[i].len; ) {
+            offs += tetrapol_phys_ch_recv(phys_ch, inputs[i].data + offs,
+                    inputs[i].len - offs);
+            assert_int_equal(0, tetrapol_phys_ch_process(phys_ch));
+        }
+        tetrapol_phys_ch_destroy(phys_ch);
+        tetrapol_destroy(tetrapol);
+
+        nframes[i] = count_events(out, i, "frame");
+        assert_true(nframes[i] > 0);
+        nscr[i] = count_events(out, i, "scr");
+        fclose(out);
+    }
+
+    FILE *out = tmpfile();
+    assert_non_null(out);
+    tetrapol_engine_t *engine = tetrapol_engine_create(NWORKERS);
+    assert_non_null(engine);
+    for (int i = 0; i < NCHANNELS; ++i) {
+        assert_int_equal(i, tetrapol_engine_add_channel(engine, &cfg,
+                    input_read, &inputs[i]));
+        tetrapol_set_output(tetrapol_engine_get_tetrapol(engine, i), out);
+    }
+    assert_int_equal(0, tetrapol_engine_run(engine));
+    tetrapol_engine_destroy(engine);
+
+    for (int i = 0; i < NCHANNELS; ++i) {
+        assert_int_equal(inputs[i].len, inputs[i].pos);
+        assert_int_equal(nframes[i], count_events(out, i, "frame"));
+        assert_int_equal(nscr[i], count_events(out, i, "scr"));
+        free(inputs[i].data);
+    }
+    fclose(out);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_engine_run),
+    };
+
+    return run_tests(tests);
+}
@@ -6,6 +6,47 @@
 // include, we are testing static methods
 #include "frame.c"
 
+#include <tetrapol/misc.h>
+
+/// pack bits, one bit per byte, into word, the first bit in LSB
+static uint64_t bits_to_word(const uint8_t *bits, int len)
+{
+    uint64_t w = 0;
+    for (int i = 0; i < len; ++i) {
+        w |= (uint64_t)bits[i] << i;
+    }
+
+    return w;
+}
+
+/// bits of packed frame must match expected bits, one bit per byte
+static void assert_frame_bits(const uint8_t *bits_exp, const frame_t *fr,
+        int len)
+{
+    frame_unpacked_t u;
+    frame_unpack(&u, fr);
+    assert_memory_equal(bits_exp, u.blob_, len);
+}
+
+// reference second part deinterleaving, the library uses fused plan instead
+static void frame_deinterleave2(uint8_t *fr_data_deint, const uint8_t *fr_data,
+        int band, int fr_type)
+{
+    const uint8_t *int_table;
+
+    if (band == TETRAPOL_BAND_VHF) {
+        int_table = (fr_type == FRAME_TYPE_DATA) ?
+            interleave_data_VHF : interleave_voice_VHF;
+    } else {
+        int_table = (fr_type == FRAME_TYPE_DATA) ?
+            interleave_data_UHF : interleave_voice_UHF;
+    }
+
+    for (int j = FRAME_DATA_LEN1; j < FRAME_DATA_LEN; ++j) {
+        fr_data_deint[j] = fr_data[int_table[j]];
+    }
+}
+
 // the goal is just to make sure the function provides the same results
 // after refactorization
 static void test_frame_diff_dec(void **state)
@@ -70,6 +111,51 @@ static void test_frame_deinterleave(void **state)
     assert_memory_equal(data_exp, fr_data_deint, FRAME_DATA_LEN);
 }
 
+// fused plan must give the same result as separate passes
+static void test_frame_decoder_plan(void **state)
+{
+    (void) state;   // unused
+
+    const int bands[] = { TETRAPOL_BAND_VHF, TETRAPOL_BAND_UHF, };
+    const int fr_types[] = { FRAME_TYPE_VOICE, FRAME_TYPE_DATA, };
+    frame_decoder_t *fd = frame_decoder_create(TETRAPOL_BAND_UHF, 0,
+            FRAME_TYPE_AUTO);
+    assert_non_null(fd);
+
+    srand(0);
+    for (int b = 0; b < ARRAY_LEN(bands); ++b) {
+        for (int scr = 0; scr < SCR_NUM; ++scr) {
+            frame_decoder_reset(fd, bands[b], scr, FRAME_TYPE_AUTO);
+
+            uint8_t fr_data[FRAME_DATA_LEN];
+            for (int i = 0; i < FRAME_DATA_LEN; ++i) {
+                fr_data[i] = rand() & 1;
+            }
+
+            uint8_t fr_data_tmp[FRAME_DATA_LEN];
+            frame_descramble(fr_data_tmp, fr_data, scr);
+            if (bands[b] == TETRAPOL_BAND_UHF) {
+                frame_diff_dec(fr_data_tmp);
+            }
+
+            for (int t = 0; t < ARRAY_LEN(fr_types); ++t) {
+                uint8_t exp[FRAME_DATA_LEN];
+                frame_deinterleave1(exp, fr_data_tmp, bands[b]);
+                frame_deinterleave2(exp, fr_data_tmp, bands[b], fr_types[t]);
+
+                uint8_t res[FRAME_DATA_LEN];
+                plan_apply(fd, res, fr_data, 0, FRAME_DATA_LEN1);
+                plan_apply(fd, res + FRAME_DATA_LEN1, fr_data,
+                        (fr_types[t] == FRAME_TYPE_DATA) ?
+                        FRAME_DATA_LEN1 : PLAN_VOICE2, FRAME_DATA_LEN2);
+                assert_memory_equal(exp, res, FRAME_DATA_LEN);
+            }
+        }
+    }
+
+    frame_decoder_destroy(fd);
+}
+
 // the goal is just to make sure the function provides the same results
 // after refactorization
 static void test_frame_decoder_data_01(void **state)
@@ -102,7 +188,7 @@ static void test_frame_decoder_data_01(void **state)
     assert_non_null(fd);
     frame_decoder_decode(fd, &fr, fr_data);
     assert_int_equal(sizeof(data_exp), sizeof(frame_data_t));
-    assert_memory_equal(data_exp, fr.blob_, sizeof(frame_data_t));
+    assert_frame_bits(data_exp, &fr, sizeof(frame_data_t));
     assert_int_equal(0, fr.broken);
     frame_decoder_destroy(fd);
 }
@@ -142,7 +228,7 @@ static void test_frame_decoder_data_02(void **state)
         frame_t fr;
         frame_decoder_decode(fd, &fr, fr_data);
         assert_int_equal(sizeof(data_exp), sizeof(frame_data_t));
-        assert_memory_equal(data_exp, fr.blob_, sizeof(frame_data_t));
+        assert_frame_bits(data_exp, &fr, sizeof(frame_data_t));
         assert_int_equal(0, fr.broken);
         fr_data[i] ^= 1;
     }
@@ -185,7 +271,7 @@ static void test_frame_decoder_voice_01(void **state)
     assert_non_null(fd);
     frame_decoder_decode(fd, &fr, fr_data);
     assert_int_equal(sizeof(data_exp), sizeof(frame_voice_t));
-    assert_memory_equal(data_exp, fr.blob_, sizeof(frame_data_t));
+    assert_frame_bits(data_exp, &fr, sizeof(frame_data_t));
     assert_int_equal(0, fr.broken);
     frame_decoder_destroy(fd);
 }
@@ -197,25 +283,31 @@ static void test_mk_crc5(void **state)
     {
         const uint8_t in[] = { 1, 0, 1, 0, 1, 0 };
         const uint8_t out_exp[] = { 0, 1, 0, 1, 1 };
-        uint8_t out[5];
-        mk_crc5(out, in, sizeof(out_exp));
-        assert_memory_equal(out, out_exp, sizeof(out_exp));
+        frame_t fr;
+        memset(&fr, 0, sizeof(fr));
+        frame_put_unpacked(&fr, 0, in, sizeof(in));
+        assert_int_equal(bits_to_word(out_exp, sizeof(out_exp)),
+                mk_crc5(&fr, sizeof(out_exp)));
     }
 
     {
         const uint8_t in[] = { 0, 0, 0, 0, 0, 0 };
         const uint8_t out_exp[] = { 0, 0, 0, 0, 0 };
-        uint8_t out[5];
-        mk_crc5(out, in, sizeof(out_exp));
-        assert_memory_equal(out, out_exp, sizeof(out_exp));
+        frame_t fr;
+        memset(&fr, 0, sizeof(fr));
+        frame_put_unpacked(&fr, 0, in, sizeof(in));
+        assert_int_equal(bits_to_word(out_exp, sizeof(out_exp)),
+                mk_crc5(&fr, sizeof(out_exp)));
     }
 
     {
         const uint8_t in[] = { 1, 1, 1, 1, 1, 1 };
         const uint8_t out_exp[] = { 0, 1, 1, 0, 0 };
-        uint8_t out[5];
-        mk_crc5(out, in, sizeof(out_exp));
-        assert_memory_equal(out, out_exp, sizeof(out_exp));
+        frame_t fr;
+        memset(&fr, 0, sizeof(fr));
+        frame_put_unpacked(&fr, 0, in, sizeof(in));
+        assert_int_equal(bits_to_word(out_exp, sizeof(out_exp)),
+                mk_crc5(&fr, sizeof(out_exp)));
     }
 }
 
@@ -230,7 +322,10 @@ static void test_frame_encode1(void **state)
     };
     uint8_t sol[8];
     memset(sol, 0, sizeof(sol));
-    frame_encode1(sol, sol_exp);
+    frame_encode1(sol, bits_to_word(sol_exp, 26));
+    // bits behind first part of frame must be left untouched
+    assert_int_equal(0, sol[6] & 0xf0);
+    assert_int_equal(0, sol[7]);
 
     uint8_t bits[52];
     for (int i = 0; i < sizeof(bits); ++i) {
@@ -263,7 +358,7 @@ static void test_frame_encode2(void **state)
     };
     uint8_t frame_enc[19];
     memset(frame_enc, 0, sizeof(frame_enc));
-    frame_encode2(frame_enc, frame_dec);
+    frame_encode2(frame_enc, bits_to_word(frame_dec + 26, 50));
 
     uint8_t bits[152];
     for (int i = 2*26; i < sizeof(bits); ++i) {
@@ -278,17 +373,198 @@ static void test_frame_encode2(void **state)
     assert_memory_equal(frame_dec2+26, frame_dec+26, 50);
 }
 
+// original implementation of Viterbi decoder, one pass for each starting state
+static int frame_viterbi_ref(uint8_t *dec,const uint8_t *in_bits,int size)
+{
+  static unsigned char viterbi_table[8]={0,3,1,2,3,0,2,1};
+  int mi=999;
+  for(int s=0;s<4;s++) {
+    int back[size][4];
+    int tab[4],tab2[4];
+    memset(back,-1,sizeof(back));
+    for(int i=0;i<4;i++)
+      tab[i]=9999;
+    tab[s]=0;
+    for(int p=size-1;p>=0;p--) {
+      for(int i=0;i<4;i++) tab2[i]=9999;
+      for(int u=0;u<4;u++) {
+        for(int x=0;x<2;x++) {
+          int v=(u<<1)|x;
+          int e=viterbi_table[v];           //auto e=(encode64(v)>>4)&3;
+          int r=tab[u];
+          if(in_bits[2*p]!=(e&1)) r++;
+          if(in_bits[2*p+1]!=((e>>1)&1)) r++;
+          if(tab2[v%4]>r) {
+            tab2[v%4]=r;
+            back[p][v%4]=u;
+          }
+        }
+      }
+      memcpy(tab,tab2,sizeof(tab));
+    }
+    if(mi>tab[s]) {
+      mi=tab[s];
+      int z=s;
+      for(int p=0;p<size;p++) {
+        dec[(size+p-2)%size]=(z&1);
+        z=back[p][z];
+      }
+    }
+  }
+  return mi;
+}
+
+// single pass decoder must give the same results as the original one
+static void test_viterbi_decode(void **state)
+{
+    (void) state;   // unused
+
+    const int sizes[] = { 26, 50, 2, 3, VITERBI_MAX_SIZE, };
+
+    srand(0);
+    for (int i = 0; i < ARRAY_LEN(sizes); ++i) {
+        const int size = sizes[i];
+        for (int n = 0; n < 20000; ++n) {
+            uint8_t in_bits[2 * VITERBI_MAX_SIZE];
+            // random data and zero codeword with random errors
+            const int ber = (n % 2) ? 2 : 1 + n % 32;
+            for (int j = 0; j < 2 * size; ++j) {
+                in_bits[j] = !(rand() % ber);
+            }
+            if (n % 3 == 0) {
+                // encoded random data with errors
+                uint8_t data[26];
+                for (int j = 0; j < ARRAY_LEN(data); ++j) {
+                    data[j] = rand() & 1;
+                }
+                uint8_t enc[8];
+                memset(enc, 0, sizeof(enc));
+                frame_encode1(enc, bits_to_word(data, 26));
+                for (int j = 0; j < 2 * 26 && j < 2 * size; ++j) {
+                    in_bits[j] ^= (enc[j / 8] >> (j % 8)) & 1;
+                }
+            }
+
+            uint8_t dec_exp[VITERBI_MAX_SIZE];
+            uint8_t dec[VITERBI_MAX_SIZE];
+            const int fixed_exp = frame_viterbi_ref(dec_exp, in_bits, size);
+            const int fixed = viterbi_decode(dec, in_bits, size);
+            assert_int_equal(fixed_exp, fixed);
+            assert_memory_equal(dec_exp, dec, size);
+
+            // packed output, bits around decoded ones are left untouched
+            const uint64_t orig[2] = { UINT64_C(0x0123456789abcdef), ~UINT64_C(0) };
+            uint64_t packed[2] = { orig[0], orig[1] };
+            const int offs = n % (2 * 64 - size + 1);
+            assert_int_equal(fixed, viterbi_decode_bits(packed, offs, in_bits, size));
+            for (int j = 0; j < 2 * 64; ++j) {
+                const int bit_exp = (j >= offs && j < offs + size) ?
+                    dec[j - offs] : (orig[j / 64] >> (j % 64)) & 1;
+                assert_int_equal(bit_exp, (packed[j / 64] >> (j % 64)) & 1);
+            }
+        }
+    }
+}
+
+/**
+  Cost of tail-biting path given by decoded bits, bits are the same as inputs
+  of encoder.
+  */
+static int viterbi_path_cost(const uint8_t *dec, const uint8_t *in_bits,
+        const uint8_t *in_rel, int size)
+{
+    static const uint8_t viterbi_table[8] = { 0, 3, 1, 2, 3, 0, 2, 1 };
+
+    int cost = 0;
+    for (int p = 0; p < size; ++p) {
+        // input bit for step p and state before step p
+        const int x = dec[(size + p - 2) % size];
+        const int u = (dec[(size + p) % size] << 1) | dec[(size + p - 1) % size];
+        const int e = viterbi_table[(u << 1) | x];
+        cost += (in_bits[2*p] != (e & 1)) * in_rel[2*p];
+        cost += (in_bits[2*p + 1] != (e >> 1)) * in_rel[2*p + 1];
+    }
+
+    return cost;
+}
+
+// soft decoder must find the path with the lowest cost
+static void test_viterbi_decode_soft(void **state)
+{
+    (void) state;   // unused
+
+    enum { SIZE = 10, };
+
+    srand(0);
+    for (int n = 0; n < 200; ++n) {
+        uint8_t in_bits[2 * SIZE];
+        uint8_t in_rel[2 * SIZE];
+        for (int j = 0; j < 2 * SIZE; ++j) {
+            in_bits[j] = rand() & 1;
+            in_rel[j] = rand() % (VITERBI_MAX_REL + 1);
+        }
+
+        uint8_t dec[SIZE];
+        const int fixed = viterbi_decode_soft(dec, in_bits, in_rel, SIZE);
+        const int cost = viterbi_path_cost(dec, in_bits, in_rel, SIZE);
+
+        // try all possible inputs of encoder
+        int cost_min = INT_MAX;
+        for (int x = 0; x < (1 << SIZE); ++x) {
+            uint8_t bits[SIZE];
+            for (int j = 0; j < SIZE; ++j) {
+                bits[j] = (x >> j) & 1;
+            }
+            const int c = viterbi_path_cost(bits, in_bits, in_rel, SIZE);
+            cost_min = (c < cost_min) ? c : cost_min;
+        }
+        assert_int_equal(cost_min, cost);
+
+        uint8_t ones[2 * SIZE];
+        memset(ones, 1, sizeof(ones));
+        assert_int_equal(fixed, viterbi_path_cost(dec, in_bits, ones, SIZE));
+    }
+
+    // for the same reliability of all bits soft decoder equals to hard one
+    for (int n = 0; n < 20000; ++n) {
+        const int size = 26 + 24 * (n % 2);
+        uint8_t in_bits[2 * 50];
+        uint8_t in_rel[2 * 50];
+        const int ber = 1 + n % 16;
+        for (int j = 0; j < 2 * size; ++j) {
+            in_bits[j] = !(rand() % ber);
+            in_rel[j] = 1 + n % VITERBI_MAX_REL;
+        }
+
+        uint8_t dec_exp[50];
+        uint8_t dec[50];
+        const int fixed_exp = viterbi_decode(dec_exp, in_bits, size);
+        const int fixed = viterbi_decode_soft(dec, in_bits, in_rel, size);
+        assert_int_equal(fixed_exp, fixed);
+        assert_memory_equal(dec_exp, dec, size);
+
+        uint64_t packed[2] = { 0, 0 };
+        assert_int_equal(fixed, viterbi_decode_soft_bits(packed, 13, in_bits,
+                    in_rel, size));
+        assert_int_equal(bits_to_word(dec, size),
+                (packed[0] >> 13) | (packed[1] << (64 - 13)));
+    }
+}
+
 int main(void)
 {
     const UnitTest tests[] = {
         unit_test(test_frame_diff_dec),
         unit_test(test_frame_deinterleave),
+        unit_test(test_frame_decoder_plan),
         unit_test(test_frame_decoder_data_01),
         unit_test(test_frame_decoder_data_02),
         unit_test(test_frame_decoder_voice_01),
         unit_test(test_mk_crc5),
         unit_test(test_frame_encode1),
         unit_test(test_frame_encode2),
+        unit_test(test_viterbi_decode),
+        unit_test(test_viterbi_decode_soft),
     };
 
     return run_tests(tests);
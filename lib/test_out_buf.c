@@ -0,0 +1,119 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <tetrapol/out_buf.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+    NVALS = 10000,
+    // enough for all formatted values
+    EXP_LEN = 64 * NVALS,
+};
+
+/// read whole content of file
+static char *read_all(FILE *f, char *buf, int len)
+{
+    rewind(f);
+    const size_t n = fread(buf, 1, len - 1, f);
+    buf[n] = 0;
+
+    return buf;
+}
+
+static uint64_t rand64(void)
+{
+    uint64_t r = 0;
+    for (int i = 0; i < 4; ++i) {
+        r = (r << 16) ^ (rand() & 0xffff);
+    }
+    // values of all lengths
+    return r >> (rand() % 64);
+}
+
+// formatters must produce the same output as printf
+static void test_formatters(void **state)
+{
+    (void) state;   // unused
+
+    char *exp = malloc(EXP_LEN);
+    char *res = malloc(EXP_LEN);
+    assert_non_null(exp);
+    assert_non_null(res);
+    FILE *f = tmpfile();
+    assert_non_null(f);
+    out_buf_t *ob = out_buf_create(f);
+    assert_non_null(ob);
+
+    const int64_t edge[] = { 0, 1, -1, 9, 10, 99, 100, -100, INT64_MAX,
+        INT64_MIN, };
+    int len = 0;
+    for (int i = 0; i < NVALS; ++i) {
+        const uint64_t u = (i < 10) ? (uint64_t)edge[i] : rand64();
+        const int64_t v = (i < 10) ? edge[i] : (int64_t)rand64() * (1 - 2 * (i % 2));
+        const uint8_t bytes[3] = { u, u >> 8, u >> 16, };
+        len += sprintf(exp + len, "%" PRIu64 " %" PRId64 " %06" PRIu64 " ",
+                u, v, u % 1000000);
+        len += sprintf(exp + len, "%02x%02x%02x\n", bytes[0], bytes[1],
+                bytes[2]);
+
+        out_buf_put_uint(ob, u);
+        out_buf_putc(ob, ' ');
+        out_buf_put_int(ob, v);
+        out_buf_puts(ob, " ");
+        out_buf_put_uint0(ob, u % 1000000, 6);
+        out_buf_write(ob, " ", 1);
+        out_buf_put_hex(ob, bytes, sizeof(bytes));
+        out_buf_puts(ob, "\n");
+        out_buf_end_event(ob);
+    }
+    assert_int_equal(0, out_buf_flush(ob));
+    assert_string_equal(exp, read_all(f, res, EXP_LEN));
+
+    out_buf_destroy(ob);
+    fclose(f);
+    free(res);
+    free(exp);
+}
+
+// buffered events are written into the old stream when output is changed
+static void test_set_output(void **state)
+{
+    (void) state;   // unused
+
+    char buf[64];
+    FILE *f1 = tmpfile();
+    FILE *f2 = tmpfile();
+    assert_non_null(f1);
+    assert_non_null(f2);
+    out_buf_t *ob = out_buf_create(f1);
+    assert_non_null(ob);
+
+    // data written by stdio goes first
+    fputs("a\n", f1);
+    out_buf_puts(ob, "b\n");
+    out_buf_set_output(ob, f2);
+    out_buf_puts(ob, "c\n");
+    out_buf_destroy(ob);
+
+    assert_string_equal("a\nb\n", read_all(f1, buf, sizeof(buf)));
+    assert_string_equal("c\n", read_all(f2, buf, sizeof(buf)));
+
+    fclose(f1);
+    fclose(f2);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_formatters),
+        unit_test(test_set_output),
+    };
+
+    return run_tests(tests);
+}
@@ -0,0 +1,366 @@
+// must be defined before any system header, see phys_ch.c
+#define _GNU_SOURCE
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+// include, we are testing static methods
+#include "phys_ch.c"
+
+// word-at-a-time decoding must match naive bit-by-bit implementation
+static void test_differential_dec(void **state)
+{
+    (void) state;   // unused
+
+    uint8_t bits[FRAME_DATA_LEN];
+    uint8_t bytes[FRAME_DATA_LEN / 8 + 16];
+
+    srand(0);
+    for (int n = 0; n < 100; ++n) {
+        memset(bytes, 0, sizeof(bytes));
+        for (int i = 0; i < FRAME_DATA_LEN; ++i) {
+            bits[i] = rand() & 1;
+        }
+        pack_bits(bytes, bits, 0, FRAME_DATA_LEN);
+
+        uint8_t first_bit = n % 2;
+        for (int i = 0; i < FRAME_DATA_LEN; ++i) {
+            first_bit = bits[i] = bits[i] ^ first_bit;
+        }
+
+        const uint8_t last_bit = differential_dec(bytes, FRAME_DATA_LEN, n % 2);
+        assert_int_equal(first_bit, last_bit);
+
+        uint8_t bits_dec[FRAME_DATA_LEN];
+        unpack_bits(bits_dec, bytes, FRAME_DATA_LEN);
+        assert_memory_equal(bits, bits_dec, FRAME_DATA_LEN);
+    }
+}
+
+// packed and unpacked input must produce the same content of receive buffer
+static void test_recv_packed(void **state)
+{
+    (void) state;   // unused
+
+    tetrapol_cfg_t cfg = {
+        .band = TETRAPOL_BAND_UHF,
+        .dir = DIR_UPLINK,
+        .radio_ch_type = TETRAPOL_RADIO_CCH,
+        .input_fmt = TETRAPOL_INPUT_UNPACKED,
+    };
+    tetrapol_t *tetrapol1 = tetrapol_create(&cfg);
+    assert_non_null(tetrapol1);
+    phys_ch_t *phys_ch1 = tetrapol_phys_ch_create(tetrapol1);
+    assert_non_null(phys_ch1);
+
+    cfg.input_fmt = TETRAPOL_INPUT_PACKED;
+    tetrapol_t *tetrapol2 = tetrapol_create(&cfg);
+    assert_non_null(tetrapol2);
+    phys_ch_t *phys_ch2 = tetrapol_phys_ch_create(tetrapol2);
+    assert_non_null(phys_ch2);
+
+    uint8_t bits[8*123];
+    uint8_t bytes[123];
+    memset(bytes, 0, sizeof(bytes));
+    srand(0);
+    for (int i = 0; i < sizeof(bits); ++i) {
+        bits[i] = rand() & 1;
+    }
+    pack_bits(bytes, bits, 0, sizeof(bits));
+
+    // push unpacked data in chunks not aligned to byte boundary
+    for (int offs = 0; offs < sizeof(bits); ) {
+        int len = 1 + rand() % 77;
+        if (offs + len > sizeof(bits)) {
+            len = sizeof(bits) - offs;
+        }
+        assert_int_equal(len, tetrapol_phys_ch_recv(phys_ch1, &bits[offs], len));
+        offs += len;
+    }
+    assert_int_equal(sizeof(bytes),
+            tetrapol_phys_ch_recv(phys_ch2, bytes, sizeof(bytes)));
+
+    assert_int_equal(phys_ch1->data_begin, phys_ch2->data_begin);
+    assert_int_equal(phys_ch1->data_end, phys_ch2->data_end);
+    for (int i = 0; i < sizeof(bits); ++i) {
+        const int pos = phys_ch1->data_begin + i;
+        const uint8_t b1 = (phys_ch1->data[pos / 8] >> (pos % 8)) & 1;
+        const uint8_t b2 = (phys_ch2->data[pos / 8] >> (pos % 8)) & 1;
+        assert_int_equal(bits[i] ^ 1, b1);
+        assert_int_equal(bits[i] ^ 1, b2);
+    }
+
+    tetrapol_phys_ch_destroy(phys_ch1);
+    tetrapol_phys_ch_destroy(phys_ch2);
+    tetrapol_destroy(tetrapol1);
+    tetrapol_destroy(tetrapol2);
+}
+
+// received bits are readable at contiguous positions across ring wrap
+static void test_recv_ring(void **state)
+{
+    (void) state;   // unused
+
+    tetrapol_cfg_t cfg = {
+        .band = TETRAPOL_BAND_UHF,
+        .dir = DIR_DOWNLINK,
+        .radio_ch_type = TETRAPOL_RADIO_CCH,
+        .input_fmt = TETRAPOL_INPUT_PACKED,
+    };
+    tetrapol_t *tetrapol = tetrapol_create(&cfg);
+    assert_non_null(tetrapol);
+    phys_ch_t *phys_ch = tetrapol_phys_ch_create(tetrapol);
+    assert_non_null(phys_ch);
+    assert_int_equal(DATA_LEN_DEFAULT, phys_ch->data_len);
+
+    // large batch is accepted in single call
+    static uint8_t stream[64 * 1024];
+    srand(0);
+    for (int i = 0; i < sizeof(stream); ++i) {
+        stream[i] = rand();
+    }
+    assert_int_equal(DATA_LEN_DEFAULT / 8 / 2,
+            tetrapol_phys_ch_recv(phys_ch, stream, DATA_LEN_DEFAULT / 8 / 2));
+    tetrapol_phys_ch_destroy(phys_ch);
+    tetrapol_destroy(tetrapol);
+
+    // the smallest capacity (single page) wraps many times
+    cfg.rx_buf_len = 1;
+    tetrapol = tetrapol_create(&cfg);
+    assert_non_null(tetrapol);
+    phys_ch = tetrapol_phys_ch_create(tetrapol);
+    assert_non_null(phys_ch);
+    assert_int_equal(8 * sysconf(_SC_PAGESIZE), phys_ch->data_len);
+
+    int offs = 0;
+    // bit index in stream of data_begin
+    int consumed = 0;
+    while (offs < sizeof(stream)) {
+        int len = 1 + rand() % 2000;
+        if (offs + len > sizeof(stream)) {
+            len = sizeof(stream) - offs;
+        }
+        const int rsize = tetrapol_phys_ch_recv(phys_ch, stream + offs, len);
+        assert_true(rsize >= 0 && rsize <= len);
+        offs += rsize;
+
+        assert_int_equal(8 * offs - consumed,
+                phys_ch->data_end - phys_ch->data_begin);
+        for (int pos = phys_ch->data_begin; pos < phys_ch->data_end; ++pos) {
+            const int i = consumed + pos - phys_ch->data_begin;
+            assert_int_equal((stream[i / 8] >> (i % 8)) & 1,
+                    (phys_ch->data[pos / 8] >> (pos % 8)) & 1);
+        }
+
+        const int n = rand() % (phys_ch->data_end - phys_ch->data_begin + 1);
+        phys_ch->data_begin += n;
+        consumed += n;
+    }
+
+    tetrapol_phys_ch_destroy(phys_ch);
+    tetrapol_destroy(tetrapol);
+}
+
+// correlator must give the same number of errors as cmp_frame_sync
+static void test_corr_frame_sync(void **state)
+{
+    (void) state;   // unused
+
+    uint8_t data[64];
+
+    srand(0);
+    for (int n = 0; n < 100; ++n) {
+        for (int i = 0; i < sizeof(data); ++i) {
+            data[i] = rand();
+        }
+
+        const int pos = rand() % 100;
+        uint64_t errs[SYNC_ERR_BITS];
+        corr_frame_sync(errs, data, pos);
+        for (int j = 0; j < 64; ++j) {
+            int e = 0;
+            for (int k = 0; k < SYNC_ERR_BITS; ++k) {
+                e |= ((errs[k] >> j) & 1) << k;
+            }
+            assert_int_equal(cmp_frame_sync(data, pos + j), e);
+            for (int val = 0; val < 8; ++val) {
+                assert_int_equal(e <= val,
+                        (lanes_le(errs, SYNC_ERR_BITS, val) >> j) & 1);
+            }
+        }
+    }
+}
+
+// reference implementation of search_frame_sync, one offset at time
+static int search_frame_sync_ref(const uint8_t *data, int begin, int end,
+        int pos[2], int errs[2])
+{
+    int fwd = begin;
+    int rev = begin;
+    errs[0] = errs[1] = INT_MAX;
+    for (int i = 0; i < DATA_OFFS; ++i) {
+        if (fwd > end) {
+            return 0;
+        }
+
+        const int offs[2] = { fwd, rev };
+        for (int j = 0; j < 2; ++j) {
+            for (int k = 0; k < 2; ++k) {
+                const int e = cmp_frame_sync(data, offs[j] + k * FRAME_LEN);
+                if (e < errs[k]) {
+                    pos[k] = offs[j];
+                    errs[k] = e;
+                }
+            }
+        }
+
+        if (errs[0] == 0 || errs[1] == 0) {
+            break;
+        }
+
+        ++fwd;
+        --rev;
+    }
+
+    return 1;
+}
+
+static void test_search_frame_sync(void **state)
+{
+    (void) state;   // unused
+
+    uint8_t data[80 * FRAME_LEN / 8 + 32];
+
+    srand(0);
+    for (int n = 0; n < 10000; ++n) {
+        // use biased noise to get long runs without zero errors
+        const int bias = rand() % 3;
+        for (int i = 0; i < sizeof(data); ++i) {
+            data[i] = rand();
+            if (bias) {
+                data[i] = (data[i] & 0xfe) | (0xca & ~data[i] & rand());
+                data[i] ^= 0xca & rand() & rand() & rand();
+            }
+        }
+
+        const int begin = DATA_OFFS + rand() % (2 * FRAME_LEN);
+        const int end = begin - 5 + rand() % (2 * DATA_OFFS);
+        int pos1[2] = { -1, -1 }, errs1[2] = { -1, -1 };
+        int pos2[2] = { -1, -1 }, errs2[2] = { -1, -1 };
+        const int r1 = search_frame_sync_ref(data, begin, end, pos1, errs1);
+        const int r2 = search_frame_sync(data, begin, end, pos2, errs2);
+        assert_int_equal(r1, r2);
+        if (r1) {
+            assert_int_equal(pos1[0], pos2[0]);
+            assert_int_equal(pos1[1], pos2[1]);
+            assert_int_equal(errs1[0], errs2[0]);
+            assert_int_equal(errs1[1], errs2[1]);
+        }
+    }
+}
+
+static void push_frames(phys_ch_t *phys_ch, int fr_type, int n)
+{
+    for (int i = 0; i < n; ++i) {
+        frame_t fr;
+        memset(&fr, 0, sizeof(fr));
+        fr.fr_type = fr_type;
+        frame_set_bits(&fr, FRAME_D, 1, fr_type);
+        route_frame(phys_ch, &fr, 0);
+    }
+}
+
+// channel type is detected from BCH lock, voice frames and BCH timeout
+static void test_auto_role(void **state)
+{
+    (void) state;   // unused
+
+    const tetrapol_cfg_t cfg = {
+        .band = TETRAPOL_BAND_UHF,
+        .dir = DIR_DOWNLINK,
+        .radio_ch_type = TETRAPOL_RADIO_AUTO,
+        .input_fmt = TETRAPOL_INPUT_UNPACKED,
+    };
+    tetrapol_t *tetrapol = tetrapol_create(&cfg);
+    assert_non_null(tetrapol);
+    FILE *out = tmpfile();
+    assert_non_null(out);
+    tetrapol_set_output(tetrapol, out);
+    phys_ch_t *phys_ch = tetrapol_phys_ch_create(tetrapol);
+    assert_non_null(phys_ch);
+    assert_non_null(phys_ch->cch);
+    assert_non_null(phys_ch->tch);
+    tpol_t *tpol = phys_ch->tpol;
+
+    // data frames without BCH
+    push_frames(phys_ch, FRAME_TYPE_DATA, AUTO_BCH_TIMEOUT - 1);
+    assert_int_equal(TETRAPOL_RADIO_AUTO, phys_ch->role);
+    push_frames(phys_ch, FRAME_TYPE_DATA, 1);
+    assert_int_equal(TETRAPOL_RADIO_TCH, phys_ch->role);
+
+    // BCH found, frame_no is set by BCH decoder
+    tpol->frame_no = 10;
+    push_frames(phys_ch, FRAME_TYPE_DATA, 1);
+    assert_int_equal(TETRAPOL_RADIO_CCH, phys_ch->role);
+
+    // few voice frames are not enough, counter restarts with superframe
+    push_frames(phys_ch, FRAME_TYPE_VOICE, AUTO_VOICE_FRAMES - 1);
+    assert_int_equal(TETRAPOL_RADIO_CCH, phys_ch->role);
+    tpol->frame_no = 0;
+    push_frames(phys_ch, FRAME_TYPE_VOICE, 1);
+    tpol->frame_no = 1;
+    push_frames(phys_ch, FRAME_TYPE_VOICE, AUTO_VOICE_FRAMES - 2);
+    assert_int_equal(TETRAPOL_RADIO_CCH, phys_ch->role);
+    push_frames(phys_ch, FRAME_TYPE_VOICE, 1);
+    assert_int_equal(TETRAPOL_RADIO_TCH, phys_ch->role);
+    assert_int_equal(TETRAPOL_FRAME_NO_UNKNOWN, tpol->frame_no);
+
+    // BCH lock lost
+    tpol->frame_no = 10;
+    push_frames(phys_ch, FRAME_TYPE_DATA, 1);
+    assert_int_equal(TETRAPOL_RADIO_CCH, phys_ch->role);
+    tpol->frame_no = TETRAPOL_FRAME_NO_UNKNOWN;
+    push_frames(phys_ch, FRAME_TYPE_DATA, 1);
+    assert_int_equal(TETRAPOL_RADIO_AUTO, phys_ch->role);
+
+    push_frames(phys_ch, FRAME_TYPE_VOICE, AUTO_VOICE_FRAMES);
+    assert_int_equal(TETRAPOL_RADIO_TCH, phys_ch->role);
+
+    // each change is reported
+    const char *roles[] = { "TCH", "CCH", "TCH", "CCH", "AUTO", "TCH", };
+    int n = 0;
+    char line[256];
+    // events are buffered, frames were not pushed by tetrapol_phys_ch_process
+    out_buf_flush(tpol->out);
+    rewind(out);
+    while (fgets(line, sizeof(line), out)) {
+        char exp[128];
+        snprintf(exp, sizeof(exp),
+                "{ \"event\": \"radio_ch_type\", \"radio_ch_type\": \"%s\" }\n",
+                roles[n]);
+        assert_true(n < ARRAY_LEN(roles));
+        assert_string_equal(exp, line);
+        ++n;
+    }
+    assert_int_equal(ARRAY_LEN(roles), n);
+
+    fclose(out);
+    tetrapol_phys_ch_destroy(phys_ch);
+    tetrapol_destroy(tetrapol);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_differential_dec),
+        unit_test(test_recv_packed),
+        unit_test(test_recv_ring),
+        unit_test(test_corr_frame_sync),
+        unit_test(test_search_frame_sync),
+        unit_test(test_auto_role),
+    };
+
+    return run_tests(tests);
+}
@@ -0,0 +1,126 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+// include, we are testing static methods
+#include "scr_search.c"
+
+#include <tetrapol/tetrapol.h>
+#include <tetrapol/viterbi.h>
+
+/**
+  Create frame data as received by physical channel (after differential
+  decoding), flip bits with probability 1/ber.
+  */
+static void mk_frame(uint8_t *fr_data, frame_encoder_t *fe, int ber)
+{
+    frame_t fr;
+    memset(&fr, 0, sizeof(fr));
+    fr.fr_type = FRAME_TYPE_DATA;
+    for (int i = 0; i < 2 + 64; ++i) {
+        frame_set_bits(&fr, FRAME_DATA_FN + i, 1, rand() & 1);
+    }
+
+    uint8_t fr_bytes[20];
+    assert_int_equal(0, frame_encoder_encode(fe, fr_bytes, &fr));
+
+    // differential decoding, as done by physical channel
+    uint8_t bit = 0;
+    for (int i = 0; i < FRAME_DATA_LEN; ++i) {
+        bit ^= (fr_bytes[1 + i / 8] >> (i % 8)) & 1;
+        fr_data[i] = bit;
+        if (ber && !(rand() % ber)) {
+            fr_data[i] ^= 1;
+        }
+    }
+}
+
+// bit-sliced filter must give the same result as viterbi_decode for all SCRs
+static void test_viterbi_filter(void **state)
+{
+    (void) state;   // unused
+
+    const int bands[] = { TETRAPOL_BAND_VHF, TETRAPOL_BAND_UHF, };
+    srand(0);
+    for (int b = 0; b < ARRAY_LEN(bands); ++b) {
+        scr_search_t *ss = scr_search_create(bands[b], 50);
+        assert_non_null(ss);
+
+        for (int n = 0; n < 50; ++n) {
+            frame_encoder_t *fe = frame_encoder_create(bands[b],
+                    rand() % SCR_SEARCH_NSCR, DIR_DOWNLINK);
+            assert_non_null(fe);
+            uint8_t fr_data[FRAME_DATA_LEN];
+            mk_frame(fr_data, fe, 1 + n);
+            frame_encoder_destroy(fe);
+
+            uint8_t fr_deint0[FRAME_DATA_LEN1];
+            frame_descramble_deint1(fr_deint0, fr_data, bands[b], 0);
+
+            for (int w = 0; w < SCR_SEARCH_NSCR / 64; ++w) {
+                uint64_t in[FRAME_DATA_LEN1];
+                for (int i = 0; i < FRAME_DATA_LEN1; ++i) {
+                    in[i] = ss->scr_pat[i][w] ^ -(uint64_t)fr_deint0[i];
+                }
+                const uint64_t pass = viterbi_filter(in, FRAME_DATA_LEN1 / 2);
+
+                for (int j = 0; j < 64; ++j) {
+                    uint8_t fr_deint[FRAME_DATA_LEN1];
+                    frame_descramble_deint1(fr_deint, fr_data, bands[b],
+                            64 * w + j);
+                    for (int i = 0; i < FRAME_DATA_LEN1; ++i) {
+                        assert_int_equal(fr_deint[i], (in[i] >> j) & 1);
+                    }
+
+                    uint8_t dec[FRAME_DATA_LEN1 / 2];
+                    const int fixed = viterbi_decode(dec, fr_deint,
+                            FRAME_DATA_LEN1 / 2);
+                    assert_int_equal(fixed < MAX_FIXED1, (pass >> j) & 1);
+                }
+            }
+        }
+
+        scr_search_destroy(ss);
+    }
+}
+
+static void test_scr_search_detect(void **state)
+{
+    (void) state;   // unused
+
+    const int confidence = 20;
+    srand(0);
+    for (int n = 0; n < 10; ++n) {
+        const int scr = rand() % SCR_SEARCH_NSCR;
+        scr_search_t *ss = scr_search_create(TETRAPOL_BAND_UHF, confidence);
+        assert_non_null(ss);
+        frame_encoder_t *fe = frame_encoder_create(TETRAPOL_BAND_UHF, scr,
+                DIR_DOWNLINK);
+        assert_non_null(fe);
+
+        int i = 0;
+        int scr_detected = SCR_SEARCH_NONE;
+        while (scr_detected == SCR_SEARCH_NONE) {
+            uint8_t fr_data[FRAME_DATA_LEN];
+            mk_frame(fr_data, fe, 200);
+            scr_detected = scr_search_push(ss, fr_data);
+            assert_true(++i <= 2 * confidence);
+        }
+        assert_int_equal(scr, scr_detected);
+        assert_int_equal(scr, scr_search_get_guess(ss));
+
+        frame_encoder_destroy(fe);
+        scr_search_destroy(ss);
+    }
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_viterbi_filter),
+        unit_test(test_scr_search_detect),
+    };
+
+    return run_tests(tests);
+}
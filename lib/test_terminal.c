@@ -0,0 +1,175 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <tetrapol/log.h>
+#include <tetrapol/terminal.h>
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+    NADDRS = 0x10000,
+};
+
+static void unpack(addr_t *addr, int a)
+{
+    addr->z = a >> 15;
+    addr->y = (a >> 12) & 7;
+    addr->x = a & 0xfff;
+}
+
+// random inserts and erases are checked against set of live addresses
+static void test_insert_erase(void **state)
+{
+    (void) state;   // unused
+
+    const tetrapol_cfg_t cfg = {
+        .band = TETRAPOL_BAND_UHF,
+        .dir = DIR_DOWNLINK,
+        .radio_ch_type = TETRAPOL_RADIO_CCH,
+        .input_fmt = TETRAPOL_INPUT_UNPACKED,
+    };
+    tetrapol_t *tetrapol = tetrapol_create(&cfg);
+    assert_non_null(tetrapol);
+    terminal_list_t *tlist = terminal_list_create(tetrapol_get_tpol(tetrapol),
+            TETRAPOL_LOG_CH_SDCH);
+    assert_non_null(tlist);
+
+    bool *live = calloc(NADDRS, sizeof(bool));
+    assert_non_null(live);
+    addr_t addr;
+    for (int i = 0; i < 20000; ++i) {
+        // addresses from few pages, to get collisions
+        const int a = (rand() % 3) * 0x5000 + rand() % 2000;
+        unpack(&addr, a);
+        assert_int_equal(live[a], terminal_list_lookup(tlist, &addr) != NULL);
+        if (rand() % 3) {
+            terminal_t *term = terminal_list_insert(tlist, &addr);
+            assert_non_null(term);
+            assert_true(term == terminal_list_lookup(tlist, &addr));
+            assert_true(term == terminal_list_insert(tlist, &addr));
+            live[a] = true;
+        } else {
+            terminal_list_erase(tlist, &addr);
+            assert_null(terminal_list_lookup(tlist, &addr));
+            live[a] = false;
+        }
+    }
+
+    int nlive = 0;
+    for (int a = 0; a < NADDRS; ++a) {
+        unpack(&addr, a);
+        assert_int_equal(live[a], terminal_list_lookup(tlist, &addr) != NULL);
+        nlive += live[a];
+    }
+    assert_true(nlive > 0);
+
+    time_evt_t te;
+    memset(&te, 0, sizeof(te));
+    terminal_list_tick(tlist, &te);
+    terminal_list_rx_glitch(tlist);
+
+    free(live);
+    terminal_list_destroy(tlist);
+    tetrapol_destroy(tetrapol);
+}
+
+typedef struct {
+    int nevicts[2];
+    addr_t last;
+} evict_cnt_t;
+
+static void count_evict(tetrapol_t *tetrapol, void *ctx,
+        const tetrapol_evt_evict_t *evt)
+{
+    evict_cnt_t *cnt = ctx;
+
+    assert_int_equal(TETRAPOL_LOG_CH_SDCH, evt->log_ch);
+    ++cnt->nevicts[evt->reason];
+    cnt->last = evt->addr;
+}
+
+static void tick(terminal_list_t *tlist, int msec)
+{
+    time_evt_t te;
+    memset(&te, 0, sizeof(te));
+    te.tv.tv_sec = msec / 1000;
+    te.tv.tv_usec = (msec % 1000) * 1000;
+    terminal_list_tick(tlist, &te);
+}
+
+// idle terminals are evicted by timeout, the oldest one by limit
+static void test_evict(void **state)
+{
+    (void) state;   // unused
+
+    const tetrapol_cfg_t cfg = {
+        .band = TETRAPOL_BAND_UHF,
+        .dir = DIR_DOWNLINK,
+        .radio_ch_type = TETRAPOL_RADIO_CCH,
+        .input_fmt = TETRAPOL_INPUT_UNPACKED,
+    };
+    tetrapol_t *tetrapol = tetrapol_create(&cfg);
+    assert_non_null(tetrapol);
+    assert_int_equal(TETRAPOL_TERMINAL_TIMEOUT_DEFAULT,
+            tetrapol_get_terminal_timeout(tetrapol));
+    tetrapol_set_terminal_timeout(tetrapol, 2);
+    tetrapol_set_terminals_max(tetrapol, 3);
+    assert_int_equal(3, tetrapol_get_terminals_max(tetrapol));
+
+    evict_cnt_t cnt;
+    memset(&cnt, 0, sizeof(cnt));
+    const tetrapol_event_handler_t handler = {
+        .evict = count_evict,
+    };
+    tetrapol_set_event_handler(tetrapol, &handler, &cnt);
+
+    terminal_list_t *tlist = terminal_list_create(tetrapol_get_tpol(tetrapol),
+            TETRAPOL_LOG_CH_SDCH);
+    assert_non_null(tlist);
+
+    addr_t addr[4];
+    for (int i = 0; i < 3; ++i) {
+        unpack(&addr[i], 0x100 + i);
+        assert_non_null(terminal_list_insert(tlist, &addr[i]));
+    }
+    tick(tlist, 1000);
+    assert_int_equal(0, cnt.nevicts[TETRAPOL_EVICT_IDLE]);
+
+    // list is full, the least recently active terminal is evicted
+    unpack(&addr[3], 0x7123);
+    terminal_t *term = terminal_list_insert(tlist, &addr[3]);
+    assert_non_null(term);
+    assert_int_equal(1, cnt.nevicts[TETRAPOL_EVICT_LRU]);
+    assert_int_equal(0x100, addr_pack(&cnt.last));
+    assert_null(terminal_list_lookup(tlist, &addr[0]));
+
+    // terminals inserted at 0 expire at 2 s, the new one at 3 s
+    tick(tlist, 1980);
+    assert_int_equal(0, cnt.nevicts[TETRAPOL_EVICT_IDLE]);
+    tick(tlist, 2000);
+    assert_int_equal(2, cnt.nevicts[TETRAPOL_EVICT_IDLE]);
+    assert_null(terminal_list_lookup(tlist, &addr[1]));
+    assert_null(terminal_list_lookup(tlist, &addr[2]));
+    assert_true(term == terminal_list_lookup(tlist, &addr[3]));
+    tick(tlist, 3000);
+    assert_int_equal(3, cnt.nevicts[TETRAPOL_EVICT_IDLE]);
+    assert_int_equal(0x7123, addr_pack(&cnt.last));
+    assert_null(terminal_list_lookup(tlist, &addr[3]));
+
+    terminal_list_destroy(tlist);
+    tetrapol_destroy(tetrapol);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_insert_erase),
+        unit_test(test_evict),
+    };
+
+    return run_tests(tests);
+}
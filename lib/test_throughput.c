@@ -0,0 +1,413 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <tetrapol/chan_gen.h>
+#include <tetrapol/frame.h>
+#include <tetrapol/log.h>
+#include <tetrapol/phys_ch.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+enum {
+    SUPERFRAME_LEN = 200,
+    // TETRAPOL frame lasts 20 ms
+    FRAMES_PER_S = 50,
+};
+
+typedef struct {
+    chan_gen_stats_t sent;
+    int64_t frames;         ///< frames decoded
+    int64_t frames_locked;  ///< frames decoded with known frame number
+    int64_t tsdus;
+    int64_t stats_evts;     ///< periodic stats events
+    tetrapol_stats_t stats; ///< decoder counters at the end of stream
+    double time;            ///< CPU time spent by decoding
+} result_t;
+
+static double cpu_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void count_events(FILE *out, result_t *res)
+{
+    char line[4096];
+    rewind(out);
+    while (fgets(line, sizeof(line), out)) {
+        if (strstr(line, "\"event\": \"frame\"")) {
+            ++res->frames;
+            if (!strstr(line, "\"frame_no\": null")) {
+                ++res->frames_locked;
+            }
+        } else if (strstr(line, "\"event\": \"tsdu\"")) {
+            ++res->tsdus;
+        } else if (strstr(line, "\"event\": \"stats\"")) {
+            ++res->stats_evts;
+        }
+    }
+}
+
+/**
+  Generate stream and feed it into physical channel.
+
+  @param stats_period Period of stats event, 0 to disable.
+  @param handler Event handler, events are counted only for
+      tetrapol_json_handler.
+  */
+static void decode(const chan_gen_cfg_t *gen_cfg, int stats_period,
+        const tetrapol_event_handler_t *handler, void *ctx, result_t *res)
+{
+    memset(res, 0, sizeof(*res));
+
+    // whole stream is generated first, only decoding is measured
+    chan_gen_t *gen = chan_gen_create(gen_cfg);
+    assert_non_null(gen);
+    int len = FRAME_LEN + gen_cfg->nframes * (FRAME_LEN + 1);
+    if (gen_cfg->input_fmt == TETRAPOL_INPUT_PACKED) {
+        len = len / 8 + 1;
+    }
+    uint8_t *data = malloc(len);
+    assert_non_null(data);
+    len = chan_gen_read(gen, data, len);
+    assert_int_equal(0, chan_gen_read(gen, data, 1));
+    memcpy(&res->sent, chan_gen_get_stats(gen), sizeof(res->sent));
+    chan_gen_destroy(gen);
+
+    const tetrapol_cfg_t cfg = {
+        .band = gen_cfg->band,
+        .dir = DIR_DOWNLINK,
+        .radio_ch_type = gen_cfg->radio_ch_type,
+        .input_fmt = gen_cfg->input_fmt,
+    };
+    FILE *out = tmpfile();
+    assert_non_null(out);
+    tetrapol_t *tetrapol = tetrapol_create(&cfg);
+    assert_non_null(tetrapol);
+    tetrapol_set_output(tetrapol, out);
+    tetrapol_set_stats_period(tetrapol, stats_period);
+    tetrapol_set_event_handler(tetrapol, handler, ctx);
+    phys_ch_t *phys_ch = tetrapol_phys_ch_create(tetrapol);
+    assert_non_null(phys_ch);
+
+    const double t0 = cpu_time();
+    for (int offs = 0; offs < len; ) {
+        const int r = tetrapol_phys_ch_recv(phys_ch, data + offs, len - offs);
+        assert_true(r >= 0);
+        offs += r;
+        assert_int_equal(0, tetrapol_phys_ch_process(phys_ch));
+    }
+    res->time = cpu_time() - t0;
+    memcpy(&res->stats, tetrapol_get_stats(tetrapol), sizeof(res->stats));
+
+    tetrapol_phys_ch_destroy(phys_ch);
+    tetrapol_destroy(tetrapol);
+    free(data);
+
+    if (handler == &tetrapol_json_handler) {
+        count_events(out, res);
+    } else {
+        // JSON events are not written by other handlers
+        fseek(out, 0, SEEK_END);
+        assert_int_equal(0, ftell(out));
+    }
+    fclose(out);
+}
+
+static void report(const char *name, const result_t *res)
+{
+    const double fps = res->frames / res->time;
+    printf("{ \"test\": \"%s\", \"frames_sent\": %" PRId64 ", "
+            "\"frames_lost\": %" PRId64 ", \"frames_recovered\": %" PRId64 ", "
+            "\"frames_per_s\": %.0f, \"rt_factor\": %.1f }\n",
+            name, res->sent.frames, res->sent.frames_lost, res->frames,
+            fps, fps / FRAMES_PER_S);
+}
+
+static const chan_gen_cfg_t cfg_cch = {
+    .band = TETRAPOL_BAND_UHF,
+    .radio_ch_type = TETRAPOL_RADIO_CCH,
+    .input_fmt = TETRAPOL_INPUT_UNPACKED,
+    .scr = 67,
+    .nterminals = 100,
+    .nframes = 10 * SUPERFRAME_LEN,
+    .seed = 1,
+};
+
+static const chan_gen_cfg_t cfg_tch = {
+    .band = TETRAPOL_BAND_UHF,
+    .radio_ch_type = TETRAPOL_RADIO_TCH,
+    .input_fmt = TETRAPOL_INPUT_UNPACKED,
+    .scr = 12,
+    .nterminals = 100,
+    .nframes = 10 * SUPERFRAME_LEN,
+    .seed = 2,
+};
+
+static void set_impairments(chan_gen_cfg_t *cfg)
+{
+    cfg->ber_ppm = 2000;
+    cfg->burst_ppm = 5000;
+    cfg->burst_len = 40;
+    cfg->slip_ppm = 2000;
+    cfg->dropout_ppm = 1000;
+    cfg->dropout_len = 5;
+}
+
+// clean CCH, all frames are decoded, BCH lock is acquired
+static void test_cch_clean(void **state)
+{
+    (void) state;   // unused
+
+    result_t res;
+    decode(&cfg_cch, 0, &tetrapol_json_handler, NULL, &res);
+    report("cch_clean", &res);
+
+    assert_int_equal(cfg_cch.nframes, res.sent.frames);
+    assert_true(res.frames >= res.sent.frames - 2);
+    // SCR detection and the first BCH
+    assert_true(res.frames_locked >= res.sent.frames - SUPERFRAME_LEN);
+    // BCH twice per superframe and SDCH traffic
+    assert_true(res.tsdus > 2 * res.sent.frames / SUPERFRAME_LEN);
+}
+
+static void test_tch_clean(void **state)
+{
+    (void) state;   // unused
+
+    result_t res;
+    decode(&cfg_tch, 0, &tetrapol_json_handler, NULL, &res);
+    report("tch_clean", &res);
+
+    assert_int_equal(cfg_tch.nframes, res.sent.frames);
+    assert_true(res.frames >= res.sent.frames - 2);
+    assert_true(res.tsdus > 0);
+}
+
+// impaired streams, decoder must recover from errors, slips and dropouts
+static void test_impaired(void **state)
+{
+    (void) state;   // unused
+
+    chan_gen_cfg_t cfgs[] = { cfg_cch, cfg_tch, };
+    const char *names[] = { "cch_impaired", "tch_impaired", };
+    for (int i = 0; i < 2; ++i) {
+        chan_gen_cfg_t *cfg = &cfgs[i];
+        set_impairments(cfg);
+        cfg->nframes = 50 * SUPERFRAME_LEN;
+
+        result_t res;
+        decode(cfg, 0, &tetrapol_json_handler, NULL, &res);
+        report(names[i], &res);
+
+        assert_true(res.sent.bit_errs > 0);
+        assert_true(res.sent.slips > 0);
+        assert_true(res.sent.dropouts > 0);
+        const int64_t received = res.sent.frames - res.sent.frames_lost;
+        assert_true(res.frames >= received * 8 / 10);
+    }
+}
+
+// decoder counters match generated stream, stats are emitted periodically
+static void test_stats(void **state)
+{
+    (void) state;   // unused
+
+    chan_gen_cfg_t cfg = cfg_cch;
+    set_impairments(&cfg);
+    cfg.nframes = 50 * SUPERFRAME_LEN;
+
+    result_t res;
+    decode(&cfg, 0, &tetrapol_json_handler, NULL, &res);
+    const tetrapol_stats_t *st = &res.stats;
+    assert_int_equal(res.frames, st->frames - st->frames_broken);
+    assert_true(st->crc_errs <= st->frames_broken);
+    assert_true(st->frames_broken > 0);
+    assert_true(st->sync_found >= 1);
+    assert_true(st->sync_lost + 1 >= st->sync_found);
+    assert_true(st->sync_bits > 0);
+    assert_true(st->scr_trials > 0);
+    assert_true(st->mb_errs > 0);
+    assert_true(st->tsdus > 0);
+    assert_int_equal(res.tsdus, st->tsdus);
+    uint64_t nframes = 0;
+    for (int i = 0; i <= TETRAPOL_STATS_BITS_FIXED_MAX; ++i) {
+        nframes += st->bits_fixed[i];
+    }
+    assert_int_equal(st->frames, nframes);
+    for (int i = 0; i < TETRAPOL_STAGE_NUM; ++i) {
+        assert_int_equal(0, st->cycles[i]);
+    }
+    assert_int_equal(0, res.stats_evts);
+
+    // the same stream with stats enabled, 10 s period
+    const tetrapol_stats_t stats0 = res.stats;
+    decode(&cfg, 10, &tetrapol_json_handler, NULL, &res);
+    assert_int_equal(stats0.frames, res.stats.frames);
+    assert_int_equal(stats0.tsdus, res.stats.tsdus);
+    assert_true(res.stats.cycles[TETRAPOL_STAGE_DECODE] > 0);
+    assert_true(res.stats.cycles[TETRAPOL_STAGE_LOG_CH] > 0);
+    const int64_t stream_time = res.sent.frames / FRAMES_PER_S;
+    assert_true(res.stats_evts >= stream_time / 10 - 1);
+    assert_true(res.stats_evts <= stream_time / 10);
+}
+
+typedef struct {
+    int64_t frames;     ///< frames decoded without errors
+    int64_t frames_locked;
+    int64_t tsdus;
+    int64_t tsdus_decoded;
+    int64_t lsdus;
+    int64_t sync_found;
+    int64_t sync_lost;
+    int64_t stats_evts;
+} evt_counts_t;
+
+static void count_frame(tetrapol_t *tetrapol, void *ctx,
+        const tetrapol_evt_frame_t *evt)
+{
+    evt_counts_t *cnt = ctx;
+    assert_non_null(evt->fr);
+    assert_int_equal(tetrapol_get_frame_no(tetrapol), evt->frame_no);
+    if (!evt->fr->broken) {
+        ++cnt->frames;
+        if (evt->frame_no != TETRAPOL_FRAME_NO_UNKNOWN) {
+            ++cnt->frames_locked;
+        }
+    }
+}
+
+static void count_sync(tetrapol_t *tetrapol, void *ctx, bool has_sync)
+{
+    evt_counts_t *cnt = ctx;
+    if (has_sync) {
+        ++cnt->sync_found;
+    } else {
+        ++cnt->sync_lost;
+    }
+}
+
+static void count_tsdu(tetrapol_t *tetrapol, void *ctx,
+        const tetrapol_evt_tsdu_t *evt)
+{
+    evt_counts_t *cnt = ctx;
+    assert_true(evt->data_len >= 0);
+    ++cnt->tsdus;
+    if (evt->tsdu) {
+        ++cnt->tsdus_decoded;
+    }
+}
+
+static void count_lsdu(tetrapol_t *tetrapol, void *ctx,
+        const tetrapol_evt_lsdu_t *evt)
+{
+    evt_counts_t *cnt = ctx;
+    assert_true((evt->cd == NULL) != (evt->vch == NULL));
+    ++cnt->lsdus;
+}
+
+static void count_stats(tetrapol_t *tetrapol, void *ctx,
+        const tetrapol_stats_t *stats, long time)
+{
+    evt_counts_t *cnt = ctx;
+    assert_true(stats->frames > 0);
+    ++cnt->stats_evts;
+}
+
+// custom handler gets the same events as built-in JSON handler
+static void test_event_handler(void **state)
+{
+    (void) state;   // unused
+
+    const tetrapol_event_handler_t handler = {
+        .frame = count_frame,
+        .sync = count_sync,
+        .tsdu = count_tsdu,
+        .lsdu = count_lsdu,
+        .stats = count_stats,
+    };
+
+    chan_gen_cfg_t cfg = cfg_cch;
+    set_impairments(&cfg);
+    cfg.nframes = 50 * SUPERFRAME_LEN;
+
+    result_t res_json;
+    decode(&cfg, 10, &tetrapol_json_handler, NULL, &res_json);
+
+    evt_counts_t cnt;
+    memset(&cnt, 0, sizeof(cnt));
+    result_t res;
+    decode(&cfg, 10, &handler, &cnt, &res);
+    assert_int_equal(res_json.frames, cnt.frames);
+    assert_int_equal(res_json.frames_locked, cnt.frames_locked);
+    assert_int_equal(res_json.tsdus, cnt.tsdus);
+    assert_int_equal(res_json.stats_evts, cnt.stats_evts);
+    assert_true(cnt.tsdus_decoded > 0);
+    // generator does not produce UI_CD and UI_VCH frames
+    assert_int_equal(0, cnt.lsdus);
+    assert_int_equal(res.stats.sync_found, cnt.sync_found);
+    assert_int_equal(res.stats.sync_lost, cnt.sync_lost);
+
+    // all events disabled
+    decode(&cfg, 10, NULL, NULL, &res);
+    assert_int_equal(res_json.stats.frames, res.stats.frames);
+}
+
+/**
+  Report decoding throughput as real-time factor (channels decoded by single
+  core). Wall-clock limit depends on machine, it is enforced only when
+  TETRAPOL_MIN_RT_FACTOR environment variable is set, e.g. to 500.
+  */
+static void test_throughput(void **state)
+{
+    (void) state;   // unused
+
+    const char *env = getenv("TETRAPOL_MIN_RT_FACTOR");
+    const double min_rt_factor = env ? atof(env) : 0.0;
+
+    chan_gen_cfg_t cfgs[] = { cfg_cch, cfg_tch, };
+    const char *names[] = { "cch_throughput", "tch_throughput", };
+    for (int i = 0; i < 2; ++i) {
+        chan_gen_cfg_t *cfg = &cfgs[i];
+        cfg->input_fmt = TETRAPOL_INPUT_PACKED;
+        cfg->nframes = 100 * SUPERFRAME_LEN;
+
+        result_t res;
+        decode(cfg, 0, &tetrapol_json_handler, NULL, &res);
+        report(names[i], &res);
+
+        assert_true(res.frames >= res.sent.frames - 2);
+        const double rt_factor = res.frames / res.time / FRAMES_PER_S;
+        if (env && rt_factor < min_rt_factor) {
+            fprintf(stderr, "%s: real-time factor %.1f < %.1f\n", names[i],
+                    rt_factor, min_rt_factor);
+        }
+        assert_true(rt_factor >= min_rt_factor);
+    }
+}
+
+int main(void)
+{
+    // decoding errors are expected for impaired streams
+    log_set_lvl(WTF);
+
+    const UnitTest tests[] = {
+        unit_test(test_cch_clean),
+        unit_test(test_tch_clean),
+        unit_test(test_impaired),
+        unit_test(test_stats),
+        unit_test(test_event_handler),
+        unit_test(test_throughput),
+    };
+
+    return run_tests(tests);
+}
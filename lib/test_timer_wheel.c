@@ -0,0 +1,155 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <tetrapol/timer_wheel.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+
+enum {
+    NTIMERS = 1000,
+};
+
+typedef struct {
+    tw_timer_t timer;
+    uint64_t expires;   ///< expected expiration, 0 when not pending
+} item_t;
+
+typedef struct {
+    timer_wheel_t *tw;
+    item_t items[NTIMERS];
+    uint64_t now;
+    int nfired;
+} ctx_t;
+
+static void expire(tw_timer_t *timer, void *arg)
+{
+    ctx_t *ctx = arg;
+    item_t *item = TW_CONTAINER_OF(timer, item_t, timer);
+
+    assert_false(tw_timer_pending(timer));
+    assert_int_equal(ctx->now, item->expires);
+    item->expires = 0;
+    ++ctx->nfired;
+
+    // restart some timers from callback
+    if (rand() % 4 == 0) {
+        item->expires = ctx->now + 1 + rand() % 100;
+        timer_wheel_add(ctx->tw, timer, item->expires);
+    }
+}
+
+static uint64_t rand_delay(void)
+{
+    switch (rand() % 4) {
+        case 0:  return rand() % 64;
+        case 1:  return rand() % 4096;
+        case 2:  return rand() % 300000;
+        default: return rand() % 20000000;
+    }
+}
+
+// random timers are checked against expected expiration ticks
+static void test_random(void **state)
+{
+    (void) state;   // unused
+
+    static ctx_t ctx;
+    timer_wheel_t *tw = timer_wheel_create(5);
+    assert_non_null(tw);
+    ctx.tw = tw;
+    ctx.now = 5;
+
+    for (int i = 0; i < NTIMERS; ++i) {
+        tw_timer_init(&ctx.items[i].timer);
+    }
+
+    int npending = 0;
+    for (int round = 0; round < 2000; ++round) {
+        for (int i = 0; i < 20; ++i) {
+            item_t *item = &ctx.items[rand() % NTIMERS];
+            if (rand() % 3) {
+                item->expires = ctx.now + 1 + rand_delay();
+                timer_wheel_add(tw, &item->timer, item->expires);
+            } else {
+                timer_wheel_cancel(tw, &item->timer);
+                item->expires = 0;
+            }
+        }
+
+        // single ticks and jumps
+        const uint64_t now = ctx.now + ((rand() % 8) ? 1 : rand() % 50000);
+        while (ctx.now < now) {
+            // callback checks time of each expiration
+            timer_wheel_advance(tw, ++ctx.now, expire, &ctx);
+        }
+        assert_int_equal(ctx.now, timer_wheel_now(tw));
+
+        npending = 0;
+        for (int i = 0; i < NTIMERS; ++i) {
+            assert_int_equal(ctx.items[i].expires != 0,
+                    tw_timer_pending(&ctx.items[i].timer));
+            assert_true(!ctx.items[i].expires ||
+                    ctx.items[i].expires > ctx.now);
+            npending += ctx.items[i].expires != 0;
+        }
+        assert_int_equal(npending, timer_wheel_count(tw));
+    }
+    assert_true(ctx.nfired > 0);
+
+    timer_wheel_destroy(tw);
+}
+
+static void dummy_expire(tw_timer_t *timer, void *arg)
+{
+    int *nfired = arg;
+    ++*nfired;
+}
+
+// timers in past expire with the next advance, even with large jump
+static void test_past(void **state)
+{
+    (void) state;   // unused
+
+    timer_wheel_t *tw = timer_wheel_create(1000);
+    assert_non_null(tw);
+
+    tw_timer_t t1, t2;
+    tw_timer_init(&t1);
+    tw_timer_init(&t2);
+    timer_wheel_add(tw, &t1, 10);
+    timer_wheel_add(tw, &t2, UINT64_MAX);
+    assert_int_equal(2, timer_wheel_count(tw));
+
+    int nfired = 0;
+    timer_wheel_advance(tw, 1000, dummy_expire, &nfired);
+    assert_int_equal(0, nfired);
+    timer_wheel_advance(tw, 1001, dummy_expire, &nfired);
+    assert_int_equal(1, nfired);
+    assert_false(tw_timer_pending(&t1));
+    assert_true(tw_timer_pending(&t2));
+
+    timer_wheel_cancel(tw, &t2);
+    timer_wheel_cancel(tw, &t2);
+    assert_int_equal(0, timer_wheel_count(tw));
+
+    // empty wheel jumps directly
+    timer_wheel_advance(tw, 1ull << 40, dummy_expire, &nfired);
+    assert_int_equal(1ull << 40, timer_wheel_now(tw));
+
+    timer_wheel_destroy(tw);
+}
+
+int main(void)
+{
+    srand(0);
+
+    const UnitTest tests[] = {
+        unit_test(test_random),
+        unit_test(test_past),
+    };
+
+    return run_tests(tests);
+}
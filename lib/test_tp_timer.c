@@ -41,19 +41,22 @@ static void test_t1(void **state)
     tp_timer_t *timer = tp_timer_create();
     assert_non_null(timer);
 
-    assert_true(tp_timer_register(timer, callback1, (void *)1000));
+    tp_timer_entry_t *e1 = tp_timer_register(timer, callback1, (void *)1000);
+    assert_non_null(e1);
     tv_exp1.tv_usec = 1;
     tp_timer_tick(timer, false, 1);
-    tp_timer_cancel(timer, callback1, (void *)1000);
+    tp_timer_cancel(timer, e1);
 
-    assert_true(tp_timer_register(timer, callback1, (void *)1000));
-    assert_false(tp_timer_register(timer, callback1, (void *)1000));
+    e1 = tp_timer_register(timer, callback1, (void *)1000);
+    assert_non_null(e1);
+    assert_null(tp_timer_register(timer, callback1, (void *)1000));
 
-    assert_true(tp_timer_register(timer, callback2, (void *)0x100));
-    assert_true(tp_timer_register(timer, callback2, (void *)0x200));
+    assert_non_null(tp_timer_register(timer, callback2, (void *)0x100));
+    assert_non_null(tp_timer_register(timer, callback2, (void *)0x200));
 
-    tp_timer_cancel(timer, callback1, (void *)1000);
-    tp_timer_cancel(timer, callback1, (void *)1000);
+    tp_timer_cancel(timer, e1);
+    // canceled handle is detected
+    tp_timer_cancel(timer, e1);
 
     tv_exp1.tv_usec = -1;
     tv_exp2.tv_usec = 3;
@@ -63,10 +66,129 @@ static void test_t1(void **state)
     tp_timer_destroy(timer);
 }
 
+typedef struct {
+    tp_timer_t *timer;
+    tp_timer_entry_t *self;
+    int ncalls;
+    int nglitches;
+    struct timeval tv;  ///< time of the last call
+} cnt_t;
+
+static void count(time_evt_t *te, void *ptr)
+{
+    cnt_t *cnt = ptr;
+
+    ++cnt->ncalls;
+    cnt->nglitches += te->rx_glitch;
+    cnt->tv = te->tv;
+}
+
+static void count_cancel(time_evt_t *te, void *ptr)
+{
+    cnt_t *cnt = ptr;
+
+    count(te, ptr);
+    tp_timer_cancel(cnt->timer, cnt->self);
+}
+
+/// callbacks with deadline are called only when due
+static void test_deadline(void **state)
+{
+    (void) state;   // unused
+
+    tp_timer_t *timer = tp_timer_create();
+    assert_non_null(timer);
+
+    cnt_t once, periodic, tick;
+    memset(&once, 0, sizeof(once));
+    memset(&periodic, 0, sizeof(periodic));
+    memset(&tick, 0, sizeof(tick));
+    assert_non_null(tp_timer_add(timer, 50000, 0, count, &once));
+    tp_timer_entry_t *ep = tp_timer_add(timer, 0, 1000000, count, &periodic);
+    assert_non_null(ep);
+    assert_non_null(tp_timer_register(timer, count, &tick));
+
+    tp_timer_tick(timer, false, 20000);
+    assert_int_equal(1, periodic.ncalls);
+    assert_int_equal(0, once.ncalls);
+    tp_timer_tick(timer, false, 20000);
+    assert_int_equal(0, once.ncalls);
+    // glitch is reported by the next call of each callback
+    tp_timer_tick(timer, true, 20000);
+    assert_int_equal(1, once.ncalls);
+    assert_int_equal(1, once.nglitches);
+    assert_int_equal(60000, once.tv.tv_usec);
+    assert_int_equal(1, tick.nglitches);
+    assert_int_equal(0, periodic.nglitches);
+
+    for (int i = 0; i < 46; ++i) {
+        tp_timer_tick(timer, false, 20000);
+    }
+    assert_int_equal(1, periodic.ncalls);
+    tp_timer_tick(timer, false, 20000);
+    assert_int_equal(2, periodic.ncalls);
+    assert_int_equal(1, periodic.nglitches);
+    assert_int_equal(1, periodic.tv.tv_sec);
+    assert_int_equal(0, periodic.tv.tv_usec);
+    assert_int_equal(1, once.ncalls);
+    assert_int_equal(50, tick.ncalls);
+
+    // long gap is reported once, period is kept
+    tp_timer_tick(timer, false, 3500000);
+    assert_int_equal(3, periodic.ncalls);
+    tp_timer_tick(timer, false, 480000);
+    assert_int_equal(3, periodic.ncalls);
+    tp_timer_tick(timer, false, 20000);
+    assert_int_equal(4, periodic.ncalls);
+    assert_int_equal(5, periodic.tv.tv_sec);
+
+    tp_timer_cancel(timer, ep);
+    tp_timer_tick(timer, false, 2000000);
+    assert_int_equal(4, periodic.ncalls);
+
+    // callbacks can cancel itself
+    cnt_t self;
+    memset(&self, 0, sizeof(self));
+    self.timer = timer;
+    self.self = tp_timer_add(timer, 0, 20000, count_cancel, &self);
+    assert_non_null(self.self);
+    tp_timer_tick(timer, false, 20000);
+    tp_timer_tick(timer, false, 20000);
+    assert_int_equal(1, self.ncalls);
+
+    tp_timer_destroy(timer);
+}
+
+/// time cannot go backwards
+static void test_negative_tick(void **state)
+{
+    (void) state;   // unused
+
+    tp_timer_t *timer = tp_timer_create();
+    assert_non_null(timer);
+
+    cnt_t once, tick;
+    memset(&once, 0, sizeof(once));
+    memset(&tick, 0, sizeof(tick));
+    assert_non_null(tp_timer_add(timer, 20000, 0, count, &once));
+    assert_non_null(tp_timer_register(timer, count, &tick));
+
+    tp_timer_tick(timer, false, -1);
+    assert_int_equal(0, tick.ncalls);
+    tp_timer_tick(timer, false, 20000);
+    assert_int_equal(1, tick.ncalls);
+    assert_int_equal(1, once.ncalls);
+    assert_int_equal(20000, once.tv.tv_usec);
+
+    tp_timer_destroy(timer);
+}
+
 int main(void)
 {
     const UnitTest tests[] = {
         unit_test(test_t1),
+        unit_test(test_deadline),
+        unit_test(test_negative_tick),
     };
 
     return run_tests(tests);
@@ -0,0 +1,260 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <tetrapol/log.h>
+#include <tetrapol/misc.h>
+#include <tetrapol/tpdu.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// group list with interleaved lists, see test_tsdu.c
+static const uint8_t d_group_list[] = {
+    D_GROUP_LIST,
+    0x20, 0x07, 0x42,
+    0x01, 0x00, 0x01, 0x23,
+    0x02, 0x00, 0x04, 0x56,
+    0x81,
+    0x01, 0x20,
+    0xc1,
+    0x05, 0x31, 0x23, 0x01, 0x11,
+    0x41,
+    0x03, 0x00, 0x07, 0x89,
+    0x00,
+};
+
+enum {
+    SEG_LEN = 10,
+    NSEGMENTS = (ARRAY_LEN(d_group_list) + SEG_LEN - 1) / SEG_LEN,
+};
+
+/// segment of d_group_list in TPDU_UI, PAS 0001-3-3 9.5.1.2
+static void make_segment(hdlc_frame_t *hdlc_fr, int seg_ref, int packet_num)
+{
+    const bool last = packet_num == NSEGMENTS - 1;
+    const uint8_t *data = &d_group_list[packet_num * SEG_LEN];
+    const int len = last ?
+        ARRAY_LEN(d_group_list) - packet_num * SEG_LEN : SEG_LEN;
+
+    memset(hdlc_fr, 0, sizeof(*hdlc_fr));
+    hdlc_fr->addr.y = 1;
+    hdlc_fr->addr.x = 0x123;
+    hdlc_fr->command.cmd = COMMAND_UNNUMBERED_UI;
+    // ext, seg, prio 1, id_tsap 2
+    hdlc_fr->data[0] = 0x80 | (last ? 0 : 0x40) | 0x10 | 0x02;
+    hdlc_fr->data[1] = 0x80 | seg_ref;
+    hdlc_fr->data[2] = packet_num;
+    int hdr_len = 3;
+    if (last) {
+        hdlc_fr->data[hdr_len++] = len;
+    }
+    memcpy(&hdlc_fr->data[hdr_len], data, len);
+    hdlc_fr->nbits = 8 * (hdr_len + len);
+}
+
+static tpdu_ui_t *create(tetrapol_t **tetrapol)
+{
+    const tetrapol_cfg_t cfg = {
+        .band = TETRAPOL_BAND_UHF,
+        .dir = DIR_DOWNLINK,
+        .radio_ch_type = TETRAPOL_RADIO_CCH,
+        .input_fmt = TETRAPOL_INPUT_UNPACKED,
+    };
+    *tetrapol = tetrapol_create(&cfg);
+    assert_non_null(*tetrapol);
+    tetrapol_set_event_handler(*tetrapol, NULL, NULL);
+
+    tpdu_ui_t *tpdu = tpdu_ui_create(tetrapol_get_tpol(*tetrapol),
+            FRAME_TYPE_DATA, TETRAPOL_LOG_CH_SDCH);
+    assert_non_null(tpdu);
+
+    return tpdu;
+}
+
+// segments received out of order and repeated, interleaved DUs
+static void test_reassembly(void **state)
+{
+    (void) state;   // unused
+
+    tetrapol_t *tetrapol;
+    tpdu_ui_t *tpdu = create(&tetrapol);
+
+    static const int order[] = { 2, 0, 2, 0, 1, };
+    hdlc_frame_t hdlc_fr;
+    tsdu_t *tsdu;
+    for (int i = 0; i < ARRAY_LEN(order); ++i) {
+        for (int seg_ref = 5; seg_ref <= 6; ++seg_ref) {
+            make_segment(&hdlc_fr, seg_ref, order[i]);
+            assert_int_equal(0, tpdu_ui_push_hdlc_frame(tpdu, &hdlc_fr, &tsdu));
+            if (i != ARRAY_LEN(order) - 1) {
+                assert_null(tsdu);
+                continue;
+            }
+
+            assert_non_null(tsdu);
+            const tsdu_d_group_list_t *gl = (const tsdu_d_group_list_t *)tsdu;
+            assert_int_equal(D_GROUP_LIST, gl->base.codop);
+            assert_int_equal(3, gl->ngroup);
+            assert_int_equal(0x789, gl->group[2].neighbouring_cell);
+            assert_int_equal(1, gl->nopen);
+            tsdu_destroy(tsdu);
+        }
+    }
+
+    // DU is released after completion, segment starts new one
+    make_segment(&hdlc_fr, 5, 1);
+    assert_int_equal(0, tpdu_ui_push_hdlc_frame(tpdu, &hdlc_fr, &tsdu));
+    assert_null(tsdu);
+
+    tpdu_ui_destroy(tpdu);
+    tetrapol_destroy(tetrapol);
+}
+
+// incomplete DU is dropped after T454
+static void test_t454(void **state)
+{
+    (void) state;   // unused
+
+    tetrapol_t *tetrapol;
+    tpdu_ui_t *tpdu = create(&tetrapol);
+
+    time_evt_t te;
+    memset(&te, 0, sizeof(te));
+    te.tv.tv_sec = 1;
+    assert_int_equal(-1, tpdu_du_tick(&te, tpdu));
+
+    hdlc_frame_t hdlc_fr;
+    tsdu_t *tsdu;
+    make_segment(&hdlc_fr, 7, 0);
+    assert_int_equal(0, tpdu_ui_push_hdlc_frame(tpdu, &hdlc_fr, &tsdu));
+    make_segment(&hdlc_fr, 8, 0);
+    assert_int_equal(0, tpdu_ui_push_hdlc_frame(tpdu, &hdlc_fr, &tsdu));
+    assert_int_equal(SYS_PAR_T454, tpdu_du_tick(&te, tpdu));
+
+    // DU 8 is younger
+    te.tv.tv_sec = 5;
+    make_segment(&hdlc_fr, 8, 1);
+    assert_int_equal(0, tpdu_ui_push_hdlc_frame(tpdu, &hdlc_fr, &tsdu));
+    assert_int_equal(SYS_PAR_T454 - 4000000, tpdu_du_tick(&te, tpdu));
+
+    te.tv.tv_sec = 11;
+    assert_int_equal(4000000, tpdu_du_tick(&te, tpdu));
+    te.tv.tv_sec = 15;
+    assert_int_equal(-1, tpdu_du_tick(&te, tpdu));
+
+    // segments of expired DUs do not complete anything
+    make_segment(&hdlc_fr, 7, 1);
+    assert_int_equal(0, tpdu_ui_push_hdlc_frame(tpdu, &hdlc_fr, &tsdu));
+    make_segment(&hdlc_fr, 7, 2);
+    assert_int_equal(0, tpdu_ui_push_hdlc_frame(tpdu, &hdlc_fr, &tsdu));
+    assert_null(tsdu);
+    make_segment(&hdlc_fr, 7, 0);
+    assert_int_equal(0, tpdu_ui_push_hdlc_frame(tpdu, &hdlc_fr, &tsdu));
+    assert_non_null(tsdu);
+    tsdu_destroy(tsdu);
+
+    tpdu_ui_destroy(tpdu);
+    tetrapol_destroy(tetrapol);
+}
+
+typedef struct {
+    int ntsdu;
+    int data_len;
+    uint8_t data[64];
+} tsdu_ctx_t;
+
+static void tsdu_evt(tetrapol_t *tetrapol, void *arg,
+        const tetrapol_evt_tsdu_t *evt)
+{
+    tsdu_ctx_t *ctx = arg;
+    ++ctx->ntsdu;
+    ctx->data_len = evt->data_len;
+    memcpy(ctx->data, evt->data, evt->data_len);
+}
+
+/// DT of connection with TSAP reference 3, PAS 0001-3-3 9.6.1
+static void make_dt(hdlc_frame_t *hdlc_fr, bool seg, bool d,
+        const uint8_t *data, int len)
+{
+    memset(hdlc_fr, 0, sizeof(*hdlc_fr));
+    hdlc_fr->addr.y = 1;
+    hdlc_fr->addr.x = 0x123;
+    hdlc_fr->command.cmd = COMMAND_INFORMATION;
+    hdlc_fr->data[0] = (seg ? 0x40 : 0) | (d ? 0x20 : 0) | 0x1b;
+    hdlc_fr->data[1] = (3 << 4) | 5;
+    int hdr_len = 2;
+    if (!seg && d) {
+        hdlc_fr->data[hdr_len++] = len;
+    }
+    memcpy(&hdlc_fr->data[hdr_len], data, len);
+    hdlc_fr->nbits = 8 * (hdr_len + len);
+}
+
+// segmented TPDU is reassembled in buffer taken only for its duration
+static void test_segmented_tpdu(void **state)
+{
+    (void) state;   // unused
+
+    const tetrapol_cfg_t cfg = {
+        .band = TETRAPOL_BAND_UHF,
+        .dir = DIR_DOWNLINK,
+        .radio_ch_type = TETRAPOL_RADIO_CCH,
+        .input_fmt = TETRAPOL_INPUT_UNPACKED,
+    };
+    tetrapol_t *tetrapol = tetrapol_create(&cfg);
+    assert_non_null(tetrapol);
+    tsdu_ctx_t ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    const tetrapol_event_handler_t handler = {
+        .tsdu = tsdu_evt,
+    };
+    tetrapol_set_event_handler(tetrapol, &handler, &ctx);
+
+    tpdu_t *tpdu = tpdu_create(tetrapol_get_tpol(tetrapol),
+            TETRAPOL_LOG_CH_SDCH);
+    assert_non_null(tpdu);
+
+    // the first DT without data opens connection
+    hdlc_frame_t hdlc_fr;
+    make_dt(&hdlc_fr, false, false, NULL, 0);
+    assert_int_equal(0, tpdu_push_hdlc_frame(tpdu, &hdlc_fr));
+
+    for (int round = 0; round < 2; ++round) {
+        for (int i = 0; i < NSEGMENTS; ++i) {
+            const bool last = i == NSEGMENTS - 1;
+            const int len = last ?
+                ARRAY_LEN(d_group_list) - i * SEG_LEN : SEG_LEN;
+            make_dt(&hdlc_fr, !last, true, &d_group_list[i * SEG_LEN], len);
+            assert_int_equal(0, tpdu_push_hdlc_frame(tpdu, &hdlc_fr));
+            assert_int_equal(round + last, ctx.ntsdu);
+        }
+        assert_int_equal(ARRAY_LEN(d_group_list), ctx.data_len);
+        assert_memory_equal(d_group_list, ctx.data, ctx.data_len);
+    }
+
+    // unsegmented TPDU is passed directly
+    make_dt(&hdlc_fr, false, true, d_group_list, 5);
+    assert_int_equal(0, tpdu_push_hdlc_frame(tpdu, &hdlc_fr));
+    assert_int_equal(3, ctx.ntsdu);
+    assert_int_equal(5, ctx.data_len);
+
+    // pending segments are released with TPDU
+    make_dt(&hdlc_fr, true, true, d_group_list, SEG_LEN);
+    assert_int_equal(0, tpdu_push_hdlc_frame(tpdu, &hdlc_fr));
+    tpdu_destroy(tpdu);
+    tetrapol_destroy(tetrapol);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_reassembly),
+        unit_test(test_t454),
+        unit_test(test_segmented_tpdu),
+    };
+
+    return run_tests(tests);
+}
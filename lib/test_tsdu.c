@@ -0,0 +1,205 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <tetrapol/log.h>
+#include <tetrapol/misc.h>
+#include <tetrapol/tsdu.h>
+#include <tetrapol/tsdu_arena.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void test_arena(void **state)
+{
+    (void) state;   // unused
+
+    tsdu_arena_t *arena = tsdu_arena_create(256);
+    assert_non_null(arena);
+
+    // allocations are aligned
+    uint8_t *p1 = tsdu_arena_alloc(arena, 3);
+    uint8_t *p2 = tsdu_arena_alloc(arena, 8);
+    assert_non_null(p1);
+    assert_non_null(p2);
+    assert_int_equal(0, (uintptr_t)p2 % sizeof(uint64_t));
+    assert_true(p2 >= p1 + 3);
+
+    // the last allocation is extended in place, others are copied
+    memset(p2, 0x55, 8);
+    assert_true(p2 == tsdu_arena_realloc(arena, p2, 8, 64));
+    uint8_t *p3 = tsdu_arena_realloc(arena, p1, 3, 16);
+    assert_non_null(p3);
+    assert_true(p3 > p2);
+
+    // exhausted arena falls back to malloc
+    uint8_t *p4 = tsdu_arena_alloc(arena, 1024);
+    assert_non_null(p4);
+    memset(p4, 0xaa, 1024);
+    uint8_t *p5 = tsdu_arena_realloc(arena, p2, 64, 512);
+    assert_non_null(p5);
+    assert_int_equal(0x55, p5[7]);
+
+    // reset starts from the beginning
+    tsdu_arena_reset(arena);
+    assert_true(p1 == tsdu_arena_alloc(arena, 1));
+
+    tsdu_arena_destroy(arena);
+}
+
+// group list with interleaved lists, exercise reallocation
+static const uint8_t d_group_list[] = {
+    D_GROUP_LIST,
+    0x20,   // revision 1
+    0x07,   // index list
+    0x42,   // 2 talk groups
+    0x01, 0x00, 0x01, 0x23,
+    0x02, 0x00, 0x04, 0x56,
+    0x81,   // 1 emergency
+    0x01, 0x20,
+    0xc1,   // 1 open
+    0x05, 0x31, 0x23, 0x01, 0x11,
+    0x41,   // 1 talk group
+    0x03, 0x00, 0x07, 0x89,
+    0x00,   // end
+};
+
+static void test_decode_arena(void **state)
+{
+    (void) state;   // unused
+
+    tsdu_arena_t *arena = tsdu_arena_create(1024);
+    assert_non_null(arena);
+
+    tsdu_t *tsdu1;
+    tsdu_t *tsdu2;
+    assert_int_equal(0, tsdu_decode(d_group_list, ARRAY_LEN(d_group_list),
+                &tsdu1));
+    assert_int_equal(0, tsdu_decode_arena(d_group_list,
+                ARRAY_LEN(d_group_list), arena, &tsdu2));
+    assert_non_null(tsdu1);
+    assert_non_null(tsdu2);
+
+    const tsdu_d_group_list_t *gl1 = (const tsdu_d_group_list_t *)tsdu1;
+    const tsdu_d_group_list_t *gl2 = (const tsdu_d_group_list_t *)tsdu2;
+    assert_int_equal(D_GROUP_LIST, gl2->base.codop);
+    assert_int_equal(3, gl2->ngroup);
+    assert_int_equal(1, gl2->nemergency);
+    assert_int_equal(1, gl2->nopen);
+    assert_int_equal(gl1->ngroup, gl2->ngroup);
+    for (int i = 0; i < gl1->ngroup; ++i) {
+        assert_int_equal(gl1->group[i].coverage_id, gl2->group[i].coverage_id);
+        assert_int_equal(gl1->group[i].neighbouring_cell,
+                gl2->group[i].neighbouring_cell);
+    }
+    assert_int_equal(0x789, gl2->group[2].neighbouring_cell);
+    assert_int_equal(gl1->emergency[0].cell_id.bs_id,
+            gl2->emergency[0].cell_id.bs_id);
+    assert_int_equal(gl1->emergency[0].cell_id.rsw_id,
+            gl2->emergency[0].cell_id.rsw_id);
+    assert_int_equal(gl1->open[0].group_id, gl2->open[0].group_id);
+    assert_int_equal(gl1->open[0].neighbouring_cell,
+            gl2->open[0].neighbouring_cell);
+
+    tsdu_destroy(tsdu1);
+    tsdu_arena_reset(arena);
+
+    // random data of all codops, arena is much smaller than some TSDUs
+    tsdu_arena_t *small = tsdu_arena_create(64);
+    assert_non_null(small);
+    for (int i = 0; i < 10000; ++i) {
+        uint8_t data[64];
+        for (int j = 0; j < ARRAY_LEN(data); ++j) {
+            data[j] = rand();
+        }
+        // address list is not limited by data length
+        if (data[0] == D_ADDITIONAL_PARTICIPANTS) {
+            data[0] = D_DATA_END;
+        }
+        const int len = 1 + rand() % ARRAY_LEN(data);
+        const int ret1 = tsdu_decode(data, len, &tsdu1);
+        const int ret2 = tsdu_decode_arena(data, len,
+                (i % 2) ? arena : small, &tsdu2);
+        assert_int_equal(ret1, ret2);
+        assert_int_equal(tsdu1 == NULL, tsdu2 == NULL);
+        if (tsdu1) {
+            assert_int_equal(tsdu1->codop, tsdu2->codop);
+        }
+        tsdu_destroy(tsdu1);
+        tsdu_arena_reset((i % 2) ? arena : small);
+    }
+
+    tsdu_arena_destroy(small);
+    tsdu_arena_destroy(arena);
+}
+
+// truncated TSDU is not decoded
+static void test_decode_truncated(void **state)
+{
+    (void) state;   // unused
+
+    const uint8_t u_terminate[] = { U_TERMINATE, 0x05, };
+    const uint8_t u_data_request[] = {
+        U_DATA_REQUEST, 0x01, 0x23, 0x45, 0x67, 0x89,
+    };
+    // OG_NB = 5, groups end at the last bit
+    const uint8_t d_crisis_notification[] = {
+        D_CRISIS_NOTIFICATION, 0x00, 0x00, 0x00, 0x00, 0x00, 0x12, 0x34,
+        0x00, 0x50, 0x01, 0x00, 0x20, 0x03, 0x00, 0x40, 0x05,
+    };
+    const struct {
+        const uint8_t *data;
+        int len;
+    } msgs[] = {
+        { u_terminate, ARRAY_LEN(u_terminate), },
+        { u_data_request, ARRAY_LEN(u_data_request), },
+        { d_crisis_notification, ARRAY_LEN(d_crisis_notification), },
+    };
+
+    for (int i = 0; i < ARRAY_LEN(msgs); ++i) {
+        tsdu_t *tsdu;
+        assert_int_equal(0, tsdu_decode(msgs[i].data, msgs[i].len, &tsdu));
+        assert_non_null(tsdu);
+        tsdu_destroy(tsdu);
+
+        assert_int_equal(0, tsdu_decode(msgs[i].data, msgs[i].len - 1,
+                    &tsdu));
+        assert_null(tsdu);
+    }
+
+    tsdu_t *tsdu;
+    assert_int_equal(0, tsdu_decode(u_data_request,
+                ARRAY_LEN(u_data_request), &tsdu));
+    const tsdu_u_data_request_t *dr = (const tsdu_u_data_request_t *)tsdu;
+    assert_int_equal(0x1, dr->trans_mode);
+    assert_int_equal(0x2345, dr->trans_param1);
+    assert_int_equal(0x6789, dr->trans_param2);
+    tsdu_destroy(tsdu);
+
+    assert_int_equal(0, tsdu_decode(d_crisis_notification,
+                ARRAY_LEN(d_crisis_notification), &tsdu));
+    const tsdu_d_crisis_notification_t *cn =
+        (const tsdu_d_crisis_notification_t *)tsdu;
+    assert_int_equal(5, cn->og_nb);
+    for (int i = 0; i < cn->og_nb; ++i) {
+        assert_int_equal(i + 1, cn->group_ids[i]);
+    }
+    tsdu_destroy(tsdu);
+}
+
+int main(void)
+{
+    // decoding errors of random data are expected
+    log_set_lvl(WTF);
+    srand(0);
+
+    const UnitTest tests[] = {
+        unit_test(test_arena),
+        unit_test(test_decode_arena),
+        unit_test(test_decode_truncated),
+    };
+
+    return run_tests(tests);
+}
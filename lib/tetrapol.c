@@ -1,13 +1,20 @@
 #define LOG_PREFIX "tetrapol"
 
+#include <tetrapol/frame_json.h>
 #include <tetrapol/log.h>
 #include <tetrapol/tetrapol_int.h>
+#include <tetrapol/tpdu.h>
 #include <tetrapol/tsdu_json.h>
 #include <tetrapol/tsdu_print.h>
 
 #include <stdlib.h>
 #include <string.h>
 
+enum {
+    /// enough for most of TSDUs, larger ones fall back to malloc
+    TSDU_ARENA_SIZE = 16 * 1024,
+};
+
 struct tetrapol_priv_t {
     tpol_t tpol;
 };
@@ -19,27 +26,76 @@ tetrapol_t *tetrapol_create(const tetrapol_cfg_t *cfg)
         return NULL;
     }
 
-    if (cfg->radio_ch_type != TETRAPOL_RADIO_CCH &&
+    if (cfg->radio_ch_type != TETRAPOL_RADIO_AUTO &&
+            cfg->radio_ch_type != TETRAPOL_RADIO_CCH &&
             cfg->radio_ch_type != TETRAPOL_RADIO_TCH) {
         LOG(ERR, "Invalid value for parameter radio_ch_type=%d",
                 cfg->radio_ch_type);
         return NULL;
     }
 
+    if (cfg->input_fmt != TETRAPOL_INPUT_UNPACKED &&
+            cfg->input_fmt != TETRAPOL_INPUT_PACKED &&
+            cfg->input_fmt != TETRAPOL_INPUT_SOFT) {
+        LOG(ERR, "Invalid value for parameter input_fmt=%d", cfg->input_fmt);
+        return NULL;
+    }
+
+    if (cfg->rx_buf_len > TETRAPOL_RX_BUF_LEN_MAX) {
+        LOG(ERR, "Invalid value for parameter rx_buf_len=%u",
+                cfg->rx_buf_len);
+        return NULL;
+    }
+
     tetrapol_t *tetrapol = malloc(sizeof(tetrapol_t));
     if (!tetrapol) {
         return NULL;
     }
 
+    tetrapol->tpol.out = out_buf_create(stdout);
+    if (!tetrapol->tpol.out) {
+        free(tetrapol);
+        return NULL;
+    }
+
+    tetrapol->tpol.tsdu_arena = tsdu_arena_create(TSDU_ARENA_SIZE);
+    if (!tetrapol->tpol.tsdu_arena) {
+        out_buf_destroy(tetrapol->tpol.out);
+        free(tetrapol);
+        return NULL;
+    }
+
+    tetrapol->tpol.tpdu_pool = tpdu_pool_create();
+    if (!tetrapol->tpol.tpdu_pool) {
+        tsdu_arena_destroy(tetrapol->tpol.tsdu_arena);
+        out_buf_destroy(tetrapol->tpol.out);
+        free(tetrapol);
+        return NULL;
+    }
+
     memcpy(&tetrapol->tpol.cfg, cfg, sizeof(tetrapol_cfg_t));
     tetrapol->tpol.rx_offs = 0;
-    tetrapol->tpol.frame_no = FRAME_NO_UNKNOWN;
+    tetrapol->tpol.frame_no = TETRAPOL_FRAME_NO_UNKNOWN;
+    tetrapol->tpol.rx_time_sec = -1;
+    tetrapol->tpol.ch_id = TETRAPOL_CH_ID_NONE;
+    tetrapol->tpol.log_lvl = log_global_lvl;
+    memset(&tetrapol->tpol.stats, 0, sizeof(tetrapol->tpol.stats));
+    tetrapol->tpol.stats_period = 0;
+    tetrapol->tpol.terminal_timeout = TETRAPOL_TERMINAL_TIMEOUT_DEFAULT;
+    tetrapol->tpol.terminals_max = 0;
+    tetrapol->tpol.evt = tetrapol_json_handler;
+    tetrapol->tpol.evt_ctx = NULL;
 
     return tetrapol;
 }
 
 void tetrapol_destroy(tetrapol_t *tetrapol)
 {
+    if (tetrapol) {
+        out_buf_destroy(tetrapol->tpol.out);
+        tsdu_arena_destroy(tetrapol->tpol.tsdu_arena);
+        tpdu_pool_destroy(tetrapol->tpol.tpdu_pool);
+    }
     free(tetrapol);
 }
 
@@ -48,14 +104,157 @@ const tetrapol_cfg_t *tetrapol_get_cfg(tetrapol_t *tetrapol)
     return &tetrapol->tpol.cfg;
 }
 
+void tetrapol_set_output(tetrapol_t *tetrapol, FILE *out)
+{
+    out_buf_set_output(tetrapol->tpol.out, out);
+}
+
+void tetrapol_set_ch_id(tetrapol_t *tetrapol, int ch_id)
+{
+    tetrapol->tpol.ch_id = ch_id;
+}
+
+int tetrapol_get_ch_id(tetrapol_t *tetrapol)
+{
+    return tetrapol->tpol.ch_id;
+}
+
+void tetrapol_set_log_lvl(tetrapol_t *tetrapol, int lvl)
+{
+    tetrapol->tpol.log_lvl = lvl;
+}
+
+int tetrapol_get_log_lvl(tetrapol_t *tetrapol)
+{
+    return tetrapol->tpol.log_lvl;
+}
+
+void tetrapol_set_stats_period(tetrapol_t *tetrapol, int period)
+{
+    tetrapol->tpol.stats_period = period;
+}
+
+int tetrapol_get_stats_period(tetrapol_t *tetrapol)
+{
+    return tetrapol->tpol.stats_period;
+}
+
+void tetrapol_set_terminal_timeout(tetrapol_t *tetrapol, int timeout)
+{
+    tetrapol->tpol.terminal_timeout = timeout;
+}
+
+int tetrapol_get_terminal_timeout(tetrapol_t *tetrapol)
+{
+    return tetrapol->tpol.terminal_timeout;
+}
+
+void tetrapol_set_terminals_max(tetrapol_t *tetrapol, int max)
+{
+    tetrapol->tpol.terminals_max = max;
+}
+
+int tetrapol_get_terminals_max(tetrapol_t *tetrapol)
+{
+    return tetrapol->tpol.terminals_max;
+}
+
+const tetrapol_stats_t *tetrapol_get_stats(tetrapol_t *tetrapol)
+{
+    return &tetrapol->tpol.stats;
+}
+
+void tetrapol_set_event_handler(tetrapol_t *tetrapol,
+        const tetrapol_event_handler_t *handler, void *ctx)
+{
+    if (handler) {
+        tetrapol->tpol.evt = *handler;
+    } else {
+        memset(&tetrapol->tpol.evt, 0, sizeof(tetrapol->tpol.evt));
+    }
+    tetrapol->tpol.evt_ctx = ctx;
+}
+
+uint64_t tetrapol_get_rx_offs(tetrapol_t *tetrapol)
+{
+    return tetrapol->tpol.rx_offs;
+}
+
+int tetrapol_get_frame_no(tetrapol_t *tetrapol)
+{
+    return tetrapol->tpol.frame_no;
+}
+
 tpol_t *tetrapol_get_tpol(tetrapol_t *tetrapol)
 {
     return (tpol_t *)tetrapol;
 }
 
+static tetrapol_t *get_tetrapol(tpol_t *tpol)
+{
+    return (tetrapol_t *)tpol;
+}
+
+void tetrapol_evt_frame(tpol_t *tpol, const frame_t *fr, int scr)
+{
+    if (tpol->evt.frame) {
+        const tetrapol_evt_frame_t evt = {
+            .rx_offs = tpol->rx_offs,
+            .frame_no = tpol->frame_no,
+            .scr = scr,
+            .fr = fr,
+        };
+        tpol->evt.frame(get_tetrapol(tpol), tpol->evt_ctx, &evt);
+    }
+}
+
+void tetrapol_evt_scr(tpol_t *tpol, int scr)
+{
+    if (tpol->evt.scr) {
+        tpol->evt.scr(get_tetrapol(tpol), tpol->evt_ctx, scr);
+    }
+}
+
+void tetrapol_evt_sync(tpol_t *tpol, bool has_sync)
+{
+    if (tpol->evt.sync) {
+        tpol->evt.sync(get_tetrapol(tpol), tpol->evt_ctx, has_sync);
+    }
+}
+
+void tetrapol_evt_radio_ch_type(tpol_t *tpol, int radio_ch_type)
+{
+    if (tpol->evt.radio_ch_type) {
+        tpol->evt.radio_ch_type(get_tetrapol(tpol), tpol->evt_ctx,
+                radio_ch_type);
+    }
+}
+
+void tetrapol_evt_lsdu(tpol_t *tpol, const tetrapol_evt_lsdu_t *evt)
+{
+    if (tpol->evt.lsdu) {
+        tpol->evt.lsdu(get_tetrapol(tpol), tpol->evt_ctx, evt);
+    }
+}
+
+void tetrapol_evt_evict(tpol_t *tpol, const tetrapol_evt_evict_t *evt)
+{
+    if (tpol->evt.evict) {
+        tpol->evt.evict(get_tetrapol(tpol), tpol->evt_ctx, evt);
+    }
+}
+
+void tetrapol_evt_stats(tpol_t *tpol, long time)
+{
+    if (tpol->evt.stats) {
+        tpol->evt.stats(get_tetrapol(tpol), tpol->evt_ctx, &tpol->stats,
+                time);
+    }
+}
+
 void tetrapol_evt_tsdu(tpol_t *tpol, const tpol_tsdu_t *tpol_tsdu)
 {
-    if (tpol_tsdu->log_ch == LOG_CH_BCH) {
+    if (tpol_tsdu->log_ch == TETRAPOL_LOG_CH_BCH) {
         if (tpol_tsdu->data_len <= 0) {
             return;
         }
@@ -65,16 +264,182 @@ void tetrapol_evt_tsdu(tpol_t *tpol, const tpol_tsdu_t *tpol_tsdu)
         }
     }
 
-    tsdu_t *tsdu = NULL;
-    tsdu_decode(tpol_tsdu->data, tpol_tsdu->data_len, &tsdu);
-    if (tsdu) {
+    ++tpol->stats.tsdus;
+
+    if (tpol_tsdu->tsdu) {
         LOG_IF(INFO) {
             LOG_("\n");
             LOGF("\tTSAP_ID=%d\tPRIO=%d\n", tpol_tsdu->tsap_id, tpol_tsdu->prio);
-            tsdu_print(tsdu);
+            tsdu_print(tpol_tsdu->tsdu);
+        }
+    }
+
+    if (tpol->evt.tsdu) {
+        tpol->evt.tsdu(get_tetrapol(tpol), tpol->evt_ctx, tpol_tsdu);
+    }
+}
+
+/// write "name": val, pair of JSON object
+static void put_counter(out_buf_t *out, const char *name, uint64_t val)
+{
+    out_buf_putc(out, '"');
+    out_buf_puts(out, name);
+    out_buf_puts(out, "\": ");
+    out_buf_put_uint(out, val);
+    out_buf_puts(out, ", ");
+}
+
+static void json_stats(tetrapol_t *tetrapol, void *ctx,
+        const tetrapol_stats_t *st, long time)
+{
+    static const char *stage_names[] = {
+        [TETRAPOL_STAGE_SYNC] = "sync",
+        [TETRAPOL_STAGE_SCR] = "scr",
+        [TETRAPOL_STAGE_DECODE] = "decode",
+        [TETRAPOL_STAGE_LOG_CH] = "log_ch",
+    };
+    const tpol_t *tpol = tetrapol_get_tpol(tetrapol);
+    out_buf_t *out = tpol->out;
+
+    tetrapol_json_begin(tpol, "stats");
+    out_buf_puts(out, "\"time\": ");
+    out_buf_put_int(out, time);
+    out_buf_puts(out, ", ");
+    put_counter(out, "sync_bits", st->sync_bits);
+    put_counter(out, "sync_found", st->sync_found);
+    put_counter(out, "sync_lost", st->sync_lost);
+    put_counter(out, "frames", st->frames);
+    put_counter(out, "frames_broken", st->frames_broken);
+    put_counter(out, "crc_errs", st->crc_errs);
+    out_buf_puts(out, "\"bits_fixed\": [");
+    for (int i = 0; i <= TETRAPOL_STATS_BITS_FIXED_MAX; ++i) {
+        if (i) {
+            out_buf_puts(out, ", ");
         }
-        tsdu_destroy(tsdu);
+        out_buf_put_uint(out, st->bits_fixed[i]);
+    }
+    out_buf_puts(out, "], ");
+    put_counter(out, "scr_trials", st->scr_trials);
+    put_counter(out, "mb_errs", st->mb_errs);
+    put_counter(out, "fcs_errs", st->fcs_errs);
+    put_counter(out, "stuffing", st->stuffing);
+    put_counter(out, "tsdus", st->tsdus);
+    out_buf_puts(out, "\"cycles\": { ");
+    for (int i = 0; i < TETRAPOL_STAGE_NUM; ++i) {
+        out_buf_putc(out, '"');
+        out_buf_puts(out, stage_names[i]);
+        out_buf_puts(out, "\": ");
+        out_buf_put_uint(out, st->cycles[i]);
+        out_buf_puts(out, (i + 1 < TETRAPOL_STAGE_NUM) ? ", " : " ");
     }
+    out_buf_puts(out, "} ");
+    tetrapol_json_end(tpol);
+}
+
+static void json_frame(tetrapol_t *tetrapol, void *ctx,
+        const tetrapol_evt_frame_t *evt)
+{
+    // only valid frames are reported in JSON
+    if (!evt->fr->broken) {
+        frame_json(tetrapol_get_tpol(tetrapol), evt->fr);
+    }
+}
+
+static void json_scr(tetrapol_t *tetrapol, void *ctx, int scr)
+{
+    const tpol_t *tpol = tetrapol_get_tpol(tetrapol);
+
+    tetrapol_json_begin(tpol, "scr");
+    out_buf_puts(tpol->out, "\"scr\": ");
+    out_buf_put_int(tpol->out, scr);
+    out_buf_puts(tpol->out, " ");
+    tetrapol_json_end(tpol);
+}
+
+static void json_radio_ch_type(tetrapol_t *tetrapol, void *ctx,
+        int radio_ch_type)
+{
+    static const char *names[] = {
+        [TETRAPOL_RADIO_AUTO] = "AUTO",
+        [TETRAPOL_RADIO_CCH] = "CCH",
+        [TETRAPOL_RADIO_TCH] = "TCH",
+    };
+    const tpol_t *tpol = tetrapol_get_tpol(tetrapol);
 
-    tsdu_json(tpol, tpol_tsdu);
+    tetrapol_json_begin(tpol, "radio_ch_type");
+    out_buf_puts(tpol->out, "\"radio_ch_type\": \"");
+    out_buf_puts(tpol->out, names[radio_ch_type]);
+    out_buf_puts(tpol->out, "\" ");
+    tetrapol_json_end(tpol);
+}
+
+static void json_tsdu(tetrapol_t *tetrapol, void *ctx,
+        const tetrapol_evt_tsdu_t *evt)
+{
+    tsdu_json(tetrapol_get_tpol(tetrapol), evt);
+}
+
+static void json_evict(tetrapol_t *tetrapol, void *ctx,
+        const tetrapol_evt_evict_t *evt)
+{
+    const tpol_t *tpol = tetrapol_get_tpol(tetrapol);
+
+    tetrapol_json_begin(tpol, "evict");
+    out_buf_puts(tpol->out, "\"rx_offs\": ");
+    out_buf_put_uint(tpol->out, tpol->rx_offs);
+    out_buf_puts(tpol->out, ", \"log_ch\": \"");
+    out_buf_puts(tpol->out, tetrapol_log_ch_str(evt->log_ch));
+    out_buf_puts(tpol->out, "\", \"addr\": { \"z\": ");
+    out_buf_put_int(tpol->out, evt->addr.z);
+    out_buf_puts(tpol->out, ", \"y\": ");
+    out_buf_put_int(tpol->out, evt->addr.y);
+    out_buf_puts(tpol->out, ", \"x\": ");
+    out_buf_put_int(tpol->out, evt->addr.x);
+    out_buf_puts(tpol->out, " }, \"reason\": \"");
+    out_buf_puts(tpol->out, evt->reason == TETRAPOL_EVICT_IDLE ? "idle" : "lru");
+    out_buf_puts(tpol->out, "\" ");
+    tetrapol_json_end(tpol);
+}
+
+const tetrapol_event_handler_t tetrapol_json_handler = {
+    .frame = json_frame,
+    .scr = json_scr,
+    .radio_ch_type = json_radio_ch_type,
+    .tsdu = json_tsdu,
+    .stats = json_stats,
+    .evict = json_evict,
+};
+
+const char *tetrapol_log_ch_str(int log_ch)
+{
+    switch (log_ch) {
+        case TETRAPOL_LOG_CH_BCH:    return "BCH";
+        case TETRAPOL_LOG_CH_DACH:   return "DACH";
+        case TETRAPOL_LOG_CH_PCH:    return "PCH";
+        case TETRAPOL_LOG_CH_RACH:   return "RACH";
+        case TETRAPOL_LOG_CH_RCH:    return "RCH";
+        case TETRAPOL_LOG_CH_SDCH:   return "SDCH";
+        case TETRAPOL_LOG_CH_SCH:    return "SCH";
+        case TETRAPOL_LOG_CH_VCH:    return "VCH";
+    }
+
+    return "FIXME";
+}
+
+void tetrapol_json_begin(const tpol_t *tpol, const char *event)
+{
+    out_buf_puts(tpol->out, "{ \"event\": \"");
+    out_buf_puts(tpol->out, event);
+    out_buf_puts(tpol->out, "\", ");
+    if (tpol->ch_id != TETRAPOL_CH_ID_NONE) {
+        out_buf_puts(tpol->out, "\"channel\": ");
+        out_buf_put_int(tpol->out, tpol->ch_id);
+        out_buf_puts(tpol->out, ", ");
+    }
+}
+
+void tetrapol_json_end(const tpol_t *tpol)
+{
+    out_buf_puts(tpol->out, "}\n");
+    out_buf_end_event(tpol->out);
 }
@@ -56,6 +56,12 @@ static inline void addr_parse(addr_t *addr, const uint8_t *buf, int skip)
     addr->x = get_bits(12, buf, 4 + skip);
 }
 
+/// address packed into 16 bits as transmitted, z(1) y(3) x(12)
+static inline uint16_t addr_pack(const addr_t *addr)
+{
+    return ((addr->z & 1) << 15) | ((addr->y & 7) << 12) | (addr->x & 0xfff);
+}
+
 // size of buffer required for printing any address
 #define ADDR_PRINT_BUF_SIZE (15)
 
@@ -4,6 +4,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 /// PAS 0001-3-3 7.4.1.1
 /**
@@ -38,6 +39,151 @@ static inline uint32_t get_bits(int len, const uint8_t *data, int skip)
     return r;
 }
 
+/** Load 8 bytes from unaligned address as big endian integer. */
+static inline uint64_t load_be64(const uint8_t *data)
+{
+    uint64_t w;
+    memcpy(&w, data, sizeof(w));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    w = __builtin_bswap64(w);
+#endif
+
+    return w;
+}
+
+/**
+  Sequential reader of bit fields from byte array, bits are read in the same
+  order as by get_bits(). Each field is extracted from single 64-bit word,
+  loaded from data or from the last 8 bytes kept in reader.
+  */
+typedef struct {
+    const uint8_t *data;
+    int len;            ///< length of data in bytes
+    int pos;            ///< bits already read
+    /// the last 8 bytes of data, zeros at begin for shorter data
+    uint64_t tail;
+} bit_reader_t;
+
+static inline void br_init(bit_reader_t *br, const uint8_t *data, int len)
+{
+    br->data = data;
+    br->len = len;
+    br->pos = 0;
+    if (len >= 8) {
+        br->tail = load_be64(&data[len - 8]);
+    } else {
+        br->tail = 0;
+        for (int i = 0; i < len; ++i) {
+            br->tail = (br->tail << 8) | data[i];
+        }
+    }
+}
+
+/**
+  Read next len bits (1 to 32) as integer, bits past the end of data are
+  read as zeros, see br_overflow().
+
+  Forced inline, the cursor would be kept in memory by -Og build otherwise.
+  */
+static inline __attribute__((always_inline))
+uint32_t br_read(bit_reader_t *br, int len)
+{
+    const unsigned int pos = br->pos;
+    const int offs = pos / 8;
+    // bytes from offs to the end of data
+    const int ntail = br->len - offs;
+    uint64_t w;
+
+    if (ntail >= 8) {
+        w = load_be64(&br->data[offs]);
+    } else if (ntail > 0) {
+        w = br->tail << (64 - 8 * ntail);
+    } else {
+        w = 0;
+    }
+    br->pos = pos + len;
+
+    return (w << (pos % 8)) >> (64 - len);
+}
+
+static inline void br_skip(bit_reader_t *br, int len)
+{
+    br->pos += len;
+}
+
+/** Move to absolute position pos in bits. */
+static inline void br_seek(bit_reader_t *br, int pos)
+{
+    br->pos = pos;
+}
+
+/** Get true when more bits were read than available. */
+static inline bool br_overflow(const bit_reader_t *br)
+{
+    return br->pos > 8 * br->len;
+}
+
+/**
+  Pack 8 bits from one bit per byte into single byte, the same bit order as
+  pack_bits(). Input bits must be 0 or 1.
+  */
+static inline uint8_t pack_bits8(const uint8_t *bits)
+{
+    uint64_t x = 0;
+    for (int i = 7; i >= 0; --i) {
+        x = (x << 8) | bits[i];
+    }
+    // bit i of product byte 7 is sum of bits[i] << 8*i and 1 << 7*(7-i)+7
+    return (x * UINT64_C(0x0102040810204080)) >> 56;
+}
+
+/**
+  Pack 64 bits from one bit per byte into word, the first bit is held in LSB.
+  Input bits must be 0 or 1.
+  */
+static inline uint64_t pack_bits64(const uint8_t *bits)
+{
+    uint64_t w = 0;
+    for (int i = 0; i < 8; ++i) {
+        w |= (uint64_t)pack_bits8(&bits[8 * i]) << (8 * i);
+    }
+
+    return w;
+}
+
+/**
+  Get len bits (1 to 64) from array of words starting at bit offs, the first
+  bit of array is held in LSB of the first word.
+  */
+static inline uint64_t get_word_bits(const uint64_t *words, int offs, int len)
+{
+    const uint64_t mask = (len < 64) ? (UINT64_C(1) << len) - 1 : ~UINT64_C(0);
+    const int s = offs % 64;
+
+    words += offs / 64;
+    uint64_t val = words[0] >> s;
+    if (s + len > 64) {
+        val |= words[1] << (64 - s);
+    }
+
+    return val & mask;
+}
+
+/** Store len bits (1 to 64) of val into array of words at bit offs. */
+static inline void put_word_bits(uint64_t *words, int offs, int len,
+        uint64_t val)
+{
+    const uint64_t mask = (len < 64) ? (UINT64_C(1) << len) - 1 : ~UINT64_C(0);
+    const int s = offs % 64;
+
+    words += offs / 64;
+    val &= mask;
+    words[0] = (words[0] & ~(mask << s)) | (val << s);
+    if (s + len > 64) {
+        words[1] = (words[1] & ~(mask >> (64 - s))) | (val >> (64 - s));
+    }
+}
+
 static inline int cmpzero(const void *data, int len)
 {
     for (int i = 0; i < len; ++i) {
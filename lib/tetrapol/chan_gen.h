@@ -0,0 +1,69 @@
+#pragma once
+
+#include <tetrapol/tetrapol.h>
+
+#include <stdint.h>
+
+/**
+  Synthetic downlink channel generator, produces bit stream of TETRAPOL
+  control (CCH) or traffic (TCH) channel as received by radio frontend.
+
+  CCH carries BCH (D_SYSTEM_INFO in frames 0-3 and 100-103 of each
+  superframe), PCH (frames 98, 99), RCH (frames 14, 39, 64, 89) and SDCH
+  HDLC traffic (UI D_GROUP_PAGING and RR frames) for pool of terminals in
+  remaining frames. TCH carries voice frames, every 25th pair of frames is
+  stolen by HDLC traffic on SCH.
+
+  Stream can be impaired by random bit errors, error bursts, bit slips and
+  dropouts. Probabilities are given in parts per million, BER per bit, other
+  impairments per frame.
+  */
+typedef struct chan_gen_priv_t chan_gen_t;
+
+typedef struct {
+    int band;           ///< TETRAPOL_BAND_VHF or TETRAPOL_BAND_UHF
+    int radio_ch_type;  ///< TETRAPOL_RADIO_CCH or TETRAPOL_RADIO_TCH
+    int input_fmt;      ///< TETRAPOL_INPUT_UNPACKED or TETRAPOL_INPUT_PACKED
+    int scr;            ///< scrambling constant, 0 to 127
+    int nterminals;     ///< size of pool of terminals for HDLC traffic
+    int64_t nframes;    ///< length of stream in frames, 0 for endless
+    uint64_t seed;      ///< seed of random number generator, must not be 0
+    int ber_ppm;        ///< random bit errors
+    int burst_ppm;      ///< error burst starts in frame
+    int burst_len;      ///< length of error burst in bits
+    int slip_ppm;       ///< bit is dropped or inserted in frame
+    int dropout_ppm;    ///< frame and dropout_len - 1 frames are lost
+    int dropout_len;    ///< length of dropout in frames
+} chan_gen_cfg_t;
+
+typedef struct {
+    int64_t frames;     ///< frames sent, including frames lost in dropouts
+    int64_t frames_lost;    ///< frames replaced by noise
+    int64_t bits;       ///< length of stream in bits
+    int64_t bit_errs;   ///< bits flipped by random errors and bursts
+    int64_t bursts;
+    int64_t slips;
+    int64_t dropouts;
+    int64_t hdlc_frames;    ///< HDLC frames sent on SDCH or SCH
+} chan_gen_stats_t;
+
+/**
+  Create channel generator.
+
+  @return New generator or NULL.
+  */
+chan_gen_t *chan_gen_create(const chan_gen_cfg_t *cfg);
+void chan_gen_destroy(chan_gen_t *gen);
+
+/**
+  Read generated stream, compatible with tetrapol_engine_read_t.
+
+  @param gen Generator (void * to be usable as engine read callback).
+  @param buf Output buffer, format is given by input_fmt.
+  @param len Size of buf.
+
+  @return Number of bytes written, 0 at the end of stream.
+  */
+int chan_gen_read(void *gen, uint8_t *buf, int len);
+
+const chan_gen_stats_t *chan_gen_get_stats(const chan_gen_t *gen);
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <tetrapol/tetrapol.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+  Engine decodes multiple channels in parallel. Each channel has own
+  tetrapol_t and physical channel instance, channels are scheduled across
+  fixed pool of worker threads. Single channel is processed by one worker
+  at time, data of channel are processed in order.
+
+  Events of all channels are written into the same output (stdout by
+  default) tagged with channel id.
+  */
+typedef struct tetrapol_engine_priv_t tetrapol_engine_t;
+
+/**
+  Read input data of channel.
+
+  @param ctx Context passed to tetrapol_engine_add_channel().
+  @param buf Output buffer, format is given by input_fmt of channel.
+  @param len Size of buf.
+
+  @return Number of bytes read, 0 at the end of input, -1 on error.
+  */
+typedef int (*tetrapol_engine_read_t)(void *ctx, uint8_t *buf, int len);
+
+/**
+  Create engine.
+
+  @param nworkers Number of worker threads.
+
+  @return New engine or NULL.
+  */
+tetrapol_engine_t *tetrapol_engine_create(int nworkers);
+void tetrapol_engine_destroy(tetrapol_engine_t *engine);
+
+/**
+  Add channel, must be called before tetrapol_engine_run().
+
+  @param cfg Channel configuration.
+  @param read Input of channel.
+  @param ctx Context for read.
+
+  @return Channel id (0, 1, ...) or -1 on error.
+  */
+int tetrapol_engine_add_channel(tetrapol_engine_t *engine,
+        const tetrapol_cfg_t *cfg, tetrapol_engine_read_t read, void *ctx);
+
+/**
+  Get TETRAPOL instance of channel, can be used to set output or log level
+  of channel.
+  */
+tetrapol_t *tetrapol_engine_get_tetrapol(tetrapol_engine_t *engine,
+        int ch_id);
+
+/**
+  Decode all channels until end of their input.
+
+  @return 0 on success, -1 when processing of any channel failed.
+  */
+int tetrapol_engine_run(tetrapol_engine_t *engine);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <tetrapol/bit_utils.h>
 #include <stdint.h>
 
 enum {
@@ -69,17 +70,27 @@ typedef struct {
     // TODO
 } frame_direct_emergecy_t;
 
+/**
+  Bit positions in packed frame, PAS 0001-2 6.1 and PAS 0001-2 6.2.
+  */
+enum {
+    FRAME_D = 0,
+    FRAME_DATA_FN = 1,
+    FRAME_DATA_PAYLOAD = 3,
+    FRAME_DATA_ASB = 67,
+    FRAME_DATA_CRC = 69,
+    FRAME_DATA_ZERO = 74,
+    FRAME_DATA_BITS = 76,
+    FRAME_VOICE1 = 1,
+    FRAME_VOICE_ASB = 21,
+    FRAME_VOICE_CRC = 23,
+    FRAME_VOICE2 = 26,
+    FRAME_VOICE_BITS = 126,
+};
+
 typedef struct {
-    union {
-        uint8_t d;
-        uint8_t blob_[0];    ///< used to copy data into frame structure
-        frame_voice_t voice;
-        frame_data_t data;
-        frame_hr_data_t hr_data;
-        frame_rach_t rach;
-        frame_training_t trainign;
-        frame_direct_emergecy_t direct_emergecy;
-    };
+    /// decoded bits, the first bit (D) is held in LSB of bits[0]
+    uint64_t bits[2];
     int fr_type;
     /**
       0  - Frame does not have uncorrected errors and CRC matches.
@@ -95,12 +106,73 @@ typedef struct {
     int bits_fixed;
 } frame_t;
 
+/** Get len bits (1 to 64) of frame starting at bit offs. */
+static inline uint64_t frame_get_bits(const frame_t *fr, int offs, int len)
+{
+    return get_word_bits(fr->bits, offs, len);
+}
+
+/** Set len bits (1 to 64) of frame starting at bit offs. */
+static inline void frame_set_bits(frame_t *fr, int offs, int len,
+        uint64_t val)
+{
+    put_word_bits(fr->bits, offs, len, val);
+}
+
+static inline int frame_d(const frame_t *fr)
+{
+    return fr->bits[0] & 1;
+}
+
+/** Frame number of data frame, fn[0] is held in LSB. */
+static inline int frame_fn(const frame_t *fr)
+{
+    return frame_get_bits(fr, FRAME_DATA_FN, 2);
+}
+
+/** ASB of data or voice frame, asb[0] is held in LSB. */
+static inline int frame_asb(const frame_t *fr)
+{
+    return frame_get_bits(fr, (fr->fr_type == FRAME_TYPE_DATA) ?
+            FRAME_DATA_ASB : FRAME_VOICE_ASB, 2);
+}
+
+/** 64 bits of data frame payload, the first bit is held in LSB. */
+static inline uint64_t frame_data_payload(const frame_t *fr)
+{
+    return frame_get_bits(fr, FRAME_DATA_PAYLOAD, 64);
+}
+
+/**
+  Frame bits stored one bit per byte, the layout of frame_t used before
+  bits were packed into words.
+  */
+typedef union {
+    uint8_t d;
+    uint8_t blob_[128];
+    frame_voice_t voice;
+    frame_data_t data;
+    frame_hr_data_t hr_data;
+    frame_rach_t rach;
+    frame_training_t trainign;
+    frame_direct_emergecy_t direct_emergecy;
+} frame_unpacked_t;
+
+/** Convert all 128 bits of frame into one bit per byte. */
+void frame_unpack(frame_unpacked_t *u, const frame_t *fr);
 
 // == Frame decoder ==
 typedef struct frame_decoder_priv_t frame_decoder_t;
 
 frame_decoder_t *frame_decoder_create(int band, int scr, int fr_type);
 void frame_decoder_destroy(frame_decoder_t *fd);
+
+/**
+  Set decoder parameters. Decoding plan for band and SCR is cached in
+  decoder, switching between already used SCRs is cheap.
+
+  @param scr Scrambling constant, 0 to 127.
+  */
 void frame_decoder_reset(frame_decoder_t *fd, int band, int scr, int fr_type);
 void frame_decoder_set_scr(frame_decoder_t *fd, int scr);
 
@@ -113,6 +185,30 @@ void frame_decoder_set_scr(frame_decoder_t *fd, int scr);
   */
 void frame_decoder_decode(frame_decoder_t *fd, frame_t *fr, const uint8_t *fr_data);
 
+/**
+  Decode frame using soft decisions.
+
+  @param fr_rel Reliability of received symbols (before differential decoding
+    done by physical channel) for each bit in fr_data, 0 to VITERBI_MAX_REL.
+  */
+void frame_decoder_decode_soft(frame_decoder_t *fd, frame_t *fr,
+        const uint8_t *fr_data, const uint8_t *fr_rel);
+
+/**
+  Descramble, decode differential precoding and deinterleave the first part
+  of frame (52 bits common to data and voice frames).
+
+  All steps are linear, result for SCR s equals to result for SCR 0 xored
+  with result of the same operation applied on zeroed frame with SCR s.
+
+  @param fr_data_deint Output, 52 bits, one bit per byte.
+  @param fr_data Frame data, FRAME_DATA_LEN bits, one bit per byte.
+  @param band TETRAPOL_BAND_VHF or TETRAPOL_BAND_UHF.
+  @param scr Scrambling constant.
+  */
+void frame_descramble_deint1(uint8_t *fr_data_deint, const uint8_t *fr_data,
+        int band, int scr);
+
 // == Frame encoder ==
 typedef struct frame_encoder_priv_t frame_encoder_t;
 
@@ -10,5 +10,12 @@ link_t *link_create(tpol_t *tpol, int log_ch);
 void link_destroy(link_t *link);
 int link_push_hdlc_frame(link_t *link, const hdlc_frame_t *hdlc_fr);
 void link_rx_glitch(link_t *link);
-void link_tick(time_evt_t* te, link_t *link);
+
+/**
+  Expire timers of link, RX glitch of te is not propagated, use
+  link_rx_glitch().
+
+  @return Time in us until the next timer expiration, -1 if there is none.
+  */
+int link_tick(time_evt_t* te, link_t *link);
 
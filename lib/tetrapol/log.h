@@ -17,7 +17,8 @@
 #define INFO 40
 #define DBG 60
 
-extern int log_global_lvl;
+// log level is per thread, so parallel instances can use own level
+extern _Thread_local int log_global_lvl;
 
 // define LOG_LVL to override log level for single file
 #ifndef LOG_LVL
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <tetrapol/tsdu_arena.h>
+
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -486,4 +488,10 @@ enum {
 bool address_decode(address_t *address, const uint8_t **data_ptr);
 void address_print(const address_t *address);
 
-int address_list_decode(address_list_t **ptr_addrs, const uint8_t *data);
+/**
+  Append addresses into list.
+
+  @param arena Arena used for list allocation, NULL for malloc.
+  */
+int address_list_decode(address_list_t **ptr_addrs, const uint8_t *data,
+        tsdu_arena_t *arena);
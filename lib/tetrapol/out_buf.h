@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+  Output buffer for events of single TETRAPOL instance.
+
+  Events are formatted into buffer by hand-written formatters and written
+  into output stream in batches. Only whole events are written, stream is
+  locked while buffer is flushed, so instances running in parallel can share
+  single stream. Buffer is flushed when it fills up, when output is changed
+  and by out_buf_flush().
+  */
+typedef struct out_buf_priv_t out_buf_t;
+
+out_buf_t *out_buf_create(FILE *out);
+
+/** Flush buffered events and release buffer. */
+void out_buf_destroy(out_buf_t *ob);
+
+/** Flush buffered events into current stream and switch to new one. */
+void out_buf_set_output(out_buf_t *ob, FILE *out);
+
+/**
+  Write buffered events into output stream.
+
+  @return 0 on success, -1 on write error (buffered events are dropped)
+  */
+int out_buf_flush(out_buf_t *ob);
+
+/** Mark end of event, buffer is flushed when it is full enough. */
+void out_buf_end_event(out_buf_t *ob);
+
+void out_buf_write(out_buf_t *ob, const char *str, int len);
+void out_buf_puts(out_buf_t *ob, const char *str);
+void out_buf_putc(out_buf_t *ob, char c);
+
+/** Append integer in decimal, the same as printf("%" PRId64). */
+void out_buf_put_int(out_buf_t *ob, int64_t val);
+
+/** Append integer in decimal, the same as printf("%" PRIu64). */
+void out_buf_put_uint(out_buf_t *ob, uint64_t val);
+
+/**
+  Append integer in decimal padded by zeros to width digits,
+  the same as printf("%0*" PRIu64, width, val).
+  */
+void out_buf_put_uint0(out_buf_t *ob, uint64_t val, int width);
+
+/** Append bytes as lowercase hex with no spaces, see sprint_hex2(). */
+void out_buf_put_hex(out_buf_t *ob, const uint8_t *bytes, int n);
@@ -18,6 +18,11 @@ typedef struct phys_ch_priv_t phys_ch_t;
   */
 phys_ch_t *tetrapol_phys_ch_create(tetrapol_t *tetrapol);
 void tetrapol_phys_ch_destroy(phys_ch_t *phys_ch);
+
+/**
+  Decode all frames from data received so far, events are written into
+  output before return.
+  */
 int tetrapol_phys_ch_process(phys_ch_t *phys_ch);
 
 /** Get SCR, scrambling constant parameter. */
@@ -35,6 +40,14 @@ void tetrapol_phys_ch_set_scr_confidence(phys_ch_t *phys_ch, int scr_confidence)
 /**
   Eat some data from buf into channel decoder.
 
+  Format of data is selected by input_fmt in tetrapol_cfg_t, one bit per byte
+  (TETRAPOL_INPUT_UNPACKED), 8 bits per byte (TETRAPOL_INPUT_PACKED) with
+  first bit in LSB or one soft decision (int8_t) per byte
+  (TETRAPOL_INPUT_SOFT).
+
+  Amount of data accepted in single call is limited by rx_buf_len in
+  tetrapol_cfg_t, tetrapol_phys_ch_process() must be called to free space.
+
   @return number of bytes consumed
 */
 int tetrapol_phys_ch_recv(phys_ch_t *phys_ch, uint8_t *buf, int len);
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+
+/// returned by scr_search_push when SCR is not detected yet
+#define SCR_SEARCH_NONE -1
+
+enum {
+    SCR_SEARCH_NSCR = 128,  ///< number of SCR candidates
+};
+
+/**
+  SCR (scrambling constant) detection.
+
+  Each received frame is decoded with all SCR candidates, SCR is detected when
+  score of the best candidate exceeds score of the second one by confidence.
+  Candidates are first checked by a cheap filter which evaluates all
+  candidates at once, full frame decoding is used only for candidates which
+  pass it. When some candidate has positive score, candidates with zero score
+  are not checked at all.
+  */
+typedef struct scr_search_priv_t scr_search_t;
+
+/**
+  Create new SCR search instance.
+
+  @param band VHF or UHF
+  @param confidence Required confidence (~ no. of valid frames).
+
+  @return new instance or NULL
+  */
+scr_search_t *scr_search_create(int band, int confidence);
+void scr_search_destroy(scr_search_t *ss);
+
+/** Forget collected statistics, start new search. */
+void scr_search_reset(scr_search_t *ss);
+
+int scr_search_get_confidence(scr_search_t *ss);
+void scr_search_set_confidence(scr_search_t *ss, int confidence);
+
+/**
+  Update statistics with one frame.
+
+  @param fr_data Frame data, FRAME_DATA_LEN bits, one bit per byte.
+
+  @return detected SCR or SCR_SEARCH_NONE
+  */
+int scr_search_push(scr_search_t *ss, const uint8_t *fr_data);
+
+/** Get SCR candidate with the best score. */
+int scr_search_get_guess(scr_search_t *ss);
+
+/** Get number of frames fully decoded by search since creation. */
+uint64_t scr_search_get_trials(scr_search_t *ss);
+
+/** Add (or subtract) value to score of SCR candidate. */
+void scr_search_add_score(scr_search_t *ss, int scr, int score);
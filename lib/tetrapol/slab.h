@@ -0,0 +1,26 @@
+#pragma once
+
+/**
+  Pool of objects of fixed size.
+
+  Objects are carved from chunks allocated on demand, released objects are
+  kept in free list and reused, so allocation and release are O(1) without
+  malloc. Memory is returned to system by slab_destroy() only.
+  */
+typedef struct slab_priv_t slab_t;
+
+/**
+  Create slab.
+
+  @param obj_size Size of object in bytes.
+  @param chunk_len Number of objects allocated at once.
+  */
+slab_t *slab_create(int obj_size, int chunk_len);
+void slab_destroy(slab_t *slab);
+
+/** @return uninitialized object aligned to 8 bytes or NULL on failure */
+void *slab_alloc(slab_t *slab);
+void slab_free(slab_t *slab, void *obj);
+
+/** Number of allocated objects. */
+int slab_count(const slab_t *slab);
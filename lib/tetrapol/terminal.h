@@ -14,15 +14,24 @@ typedef struct terminal_priv_t terminal_t;
   */
 int terminal_push_hdlc_frame(terminal_t* term, const hdlc_frame_t *hdlc_fr);
 
+/**
+  Terminals seen on logical channel. Each terminal has single timer in
+  timer wheel for the earlier of T454 of its segmented TSDUs and terminal
+  timeout (see tetrapol_set_terminal_timeout()), so tick visits only
+  terminals with expired timers. Idle terminals and the least recently
+  active terminal over the limit (see tetrapol_set_terminals_max()) are
+  evicted and reported by evict event.
+  */
 typedef struct terminal_list_priv_t terminal_list_t;
 
 terminal_list_t *terminal_list_create(tpol_t *tpol, int log_ch);
 void terminal_list_destroy(terminal_list_t *tlist);
 
 /**
-  Lookup terminal with specified address.
+  Lookup terminal with specified address, O(1).
 
-  @return pointer to terminal or NULL if not found.
+  @return pointer to terminal or NULL if not found. Pointer is valid until
+  the terminal is erased or evicted.
   */
 terminal_t* terminal_list_lookup(const terminal_list_t* tlist,
         const addr_t *addr);
@@ -32,6 +41,8 @@ terminal_t* terminal_list_lookup(const terminal_list_t* tlist,
 
   @return Pointer to new terminal structure or NULL if error occures. If
   terminal with given address already exists just returns its address.
+  Pointer is valid until the terminal is erased or evicted. The least
+  recently active terminal is evicted when the list is full.
   */
 terminal_t* terminal_list_insert(terminal_list_t* tlist, const addr_t *addr);
 
@@ -49,12 +60,13 @@ int terminal_list_push_hdlc_frame(terminal_list_t* tlist,
         const hdlc_frame_t *hdlc_fr);
 
 /**
-  Report RX glitch to all terminals.
+  Report RX glitch to all terminals in O(1), link of terminal is notified
+  before its next frame.
   */
 void terminal_list_rx_glitch(terminal_list_t* tlist);
 
 /**
-  Call periodicaly to expire old sessions.
+  Call periodicaly to expire T454 timers and evict idle terminals.
   @param tlist list with all terminals.
   @param te passing time event.
   */
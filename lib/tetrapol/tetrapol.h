@@ -1,6 +1,14 @@
 #pragma once
 
+#include <tetrapol/addr.h>
+#include <tetrapol/frame.h>
+#include <tetrapol/lsdu_cd.h>
+#include <tetrapol/lsdu_vch.h>
+#include <tetrapol/tsdu.h>
+
+#include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -19,23 +27,259 @@ enum {
 
 /** Radio channel type. */
 enum {
-    // TETRAPOL_RADIO_AUTO = 0,     // not supported yet
+    TETRAPOL_RADIO_AUTO = 0,        ///< detect CCH/TCH from received frames
     TETRAPOL_RADIO_CCH = 1,
     TETRAPOL_RADIO_TCH = 2,
 };
 
+/** Channel id of instance, events are not tagged when not set. */
+enum {
+    TETRAPOL_CH_ID_NONE = -1,
+};
+
+/** Format of demodulated data passed into physical channel. */
+enum {
+    TETRAPOL_INPUT_UNPACKED = 0,    ///< one bit per byte
+    TETRAPOL_INPUT_PACKED = 1,      ///< 8 bits per byte, first bit in LSB
+    /// int8_t per bit, sign is the bit value (positive is 1, otherwise 0),
+    /// magnitude is reliability (soft decision)
+    TETRAPOL_INPUT_SOFT = 2,
+};
+
+/** Limit of receive buffer capacity (rx_buf_len) in bits. */
+enum {
+    TETRAPOL_RX_BUF_LEN_MAX = 1 << 29,
+};
+
 typedef struct {
     uint8_t band;
     uint8_t dir;
     uint8_t radio_ch_type;
+    uint8_t input_fmt;
+    /// Capacity of receive buffer of physical channel in bits (one bit is
+    /// single input byte for unpacked and soft input), 0 for default.
+    /// Physical channel accepts slightly less than capacity in single call.
+    uint32_t rx_buf_len;
 } tetrapol_cfg_t;
 
+/** Decoding stages measured by tetrapol_stats_t.cycles. */
+enum {
+    TETRAPOL_STAGE_SYNC,    ///< frame synchronization search
+    TETRAPOL_STAGE_SCR,     ///< SCR detection
+    TETRAPOL_STAGE_DECODE,  ///< frame decoding (Viterbi, CRC)
+    TETRAPOL_STAGE_LOG_CH,  ///< logical channels and event output
+    TETRAPOL_STAGE_NUM,
+};
+
+/** Last bucket of bits_fixed histogram, counts also frames above it. */
+enum {
+    TETRAPOL_STATS_BITS_FIXED_MAX = 15,
+};
+
+/**
+  Counters of decoder, updated during processing of received data.
+  Counters are cumulative since instance creation.
+  */
+typedef struct {
+    uint64_t sync_bits;     ///< bits scanned by frame synchronization search
+    uint64_t sync_found;
+    uint64_t sync_lost;
+    uint64_t frames;        ///< frames decoded, including broken ones
+    uint64_t frames_broken; ///< frames with uncorrected errors or bad CRC
+    uint64_t crc_errs;      ///< frames decoded by Viterbi, but CRC failed
+    /// histogram of bits fixed by Viterbi decoder per frame
+    uint64_t bits_fixed[TETRAPOL_STATS_BITS_FIXED_MAX + 1];
+    uint64_t scr_trials;    ///< frames decoded by SCR detection
+    uint64_t mb_errs;       ///< data frames dropped by multiblock reassembly
+    uint64_t fcs_errs;      ///< HDLC frames with broken FCS
+    uint64_t stuffing;      ///< HDLC stuffing frames
+    uint64_t tsdus;         ///< TSDUs decoded
+    /// CPU cycles spent in each stage (nanoseconds when CPU time stamp
+    /// counter is not available), measured only when stats are enabled
+    uint64_t cycles[TETRAPOL_STAGE_NUM];
+} tetrapol_stats_t;
+
+enum {
+    TETRAPOL_FRAME_NO_UNKNOWN = -1,
+};
+
+/** Logical channels. */
+enum {
+    TETRAPOL_LOG_CH_BCH,
+    TETRAPOL_LOG_CH_DACH,
+    TETRAPOL_LOG_CH_DCH,
+    TETRAPOL_LOG_CH_PCH,
+    TETRAPOL_LOG_CH_RACH,
+    TETRAPOL_LOG_CH_RCH,
+    TETRAPOL_LOG_CH_SCH,
+    TETRAPOL_LOG_CH_SDCH,
+    TETRAPOL_LOG_CH_VCH,
+};
+
+enum {
+    TETRAPOL_TSAP_ID_UNKNOWN = -1,
+};
+
+enum {
+    TETRAPOL_TSAP_REF_UNKNOWN = -1,
+};
+
+enum {
+    TETRAPOL_TPDU_TYPE_TPDU,
+    TETRAPOL_TPDU_TYPE_TPDU_UI,
+};
+
 typedef struct tetrapol_priv_t tetrapol_t;
 
+/** Decoded frame, broken frames are reported as well. */
+typedef struct {
+    uint64_t rx_offs;   ///< offset of frame end in received stream (bits)
+    /// frame number in superframe or TETRAPOL_FRAME_NO_UNKNOWN
+    int frame_no;
+    int scr;            ///< scrambling constant used for decoding
+    const frame_t *fr;
+} tetrapol_evt_frame_t;
+
+/** Transport layer service data unit. */
+typedef struct {
+    int log_ch;
+    addr_t addr;
+    uint8_t tpdu_type;
+    int prio;
+    int tsap_id;
+    int tsap_ref_swmi;
+    int tsap_ref_rt;
+    int data_len;
+    const uint8_t *data;
+    const tsdu_t *tsdu;     ///< decoded TSDU, NULL when decoding failed
+} tetrapol_evt_tsdu_t;
+
+/** Link layer service data unit, on control or voice channel. */
+typedef struct {
+    int log_ch;
+    addr_t addr;
+    const lsdu_cd_t *cd;    ///< UI_CD frame or NULL
+    const lsdu_vch_t *vch;  ///< UI_VCH frame or NULL
+} tetrapol_evt_lsdu_t;
+
+/** Reason of terminal eviction. */
+enum {
+    TETRAPOL_EVICT_IDLE,    ///< no frame from terminal within terminal timeout
+    TETRAPOL_EVICT_LRU,     ///< least recently active, terminal limit reached
+};
+
+/** Default of tetrapol_set_terminal_timeout() in seconds. */
+enum {
+    TETRAPOL_TERMINAL_TIMEOUT_DEFAULT = 600,
+};
+
+/**
+  State of terminal was dropped, segmented TSDUs which were not completed
+  are lost.
+  */
+typedef struct {
+    int log_ch;
+    addr_t addr;
+    int reason;             ///< TETRAPOL_EVICT_*
+} tetrapol_evt_evict_t;
+
+/**
+  Callbacks for decoded events. Any of them can be NULL, event is not
+  reported then. Pointers passed into callback are valid only for the call.
+  */
+typedef struct {
+    void (*frame)(tetrapol_t *tetrapol, void *ctx,
+            const tetrapol_evt_frame_t *evt);
+    /// SCR used for decoding has changed
+    void (*scr)(tetrapol_t *tetrapol, void *ctx, int scr);
+    /// frame synchronization was found or lost
+    void (*sync)(tetrapol_t *tetrapol, void *ctx, bool has_sync);
+    /// channel type detected for TETRAPOL_RADIO_AUTO
+    void (*radio_ch_type)(tetrapol_t *tetrapol, void *ctx, int radio_ch_type);
+    void (*tsdu)(tetrapol_t *tetrapol, void *ctx,
+            const tetrapol_evt_tsdu_t *evt);
+    void (*lsdu)(tetrapol_t *tetrapol, void *ctx,
+            const tetrapol_evt_lsdu_t *evt);
+    /// periodic stats, see tetrapol_set_stats_period()
+    void (*stats)(tetrapol_t *tetrapol, void *ctx,
+            const tetrapol_stats_t *stats, long time);
+    /// terminal state dropped, see tetrapol_set_terminal_timeout()
+    void (*evict)(tetrapol_t *tetrapol, void *ctx,
+            const tetrapol_evt_evict_t *evt);
+} tetrapol_event_handler_t;
+
+/**
+  Built-in handler, writes events as JSON into output of instance
+  (see tetrapol_set_output()). It is the default event handler, its
+  callbacks can be called from other handlers, ctx is not used.
+  */
+extern const tetrapol_event_handler_t tetrapol_json_handler;
+
 tetrapol_t *tetrapol_create(const tetrapol_cfg_t *cfg);
 void tetrapol_destroy(tetrapol_t *tetrapol);
 const tetrapol_cfg_t *tetrapol_get_cfg(tetrapol_t *tetrapol);
 
+/**
+  Set stream for decoded events, default is stdout. Events are buffered and
+  written in batches of whole events with stream locked, so instances running
+  in parallel can share it. Pending events are written into previous stream.
+  */
+void tetrapol_set_output(tetrapol_t *tetrapol, FILE *out);
+
+/**
+  Set channel id, all events of instance are tagged with it.
+  */
+void tetrapol_set_ch_id(tetrapol_t *tetrapol, int ch_id);
+int tetrapol_get_ch_id(tetrapol_t *tetrapol);
+
+/**
+  Set log level of instance, used by tetrapol_engine_t while it processes
+  the instance. Default is log level of thread which created the instance.
+  */
+void tetrapol_set_log_lvl(tetrapol_t *tetrapol, int lvl);
+int tetrapol_get_log_lvl(tetrapol_t *tetrapol);
+
+/**
+  Enable periodic "stats" event with decoder counters, emitted every period
+  seconds of stream time. Counting of cycles spent in decoding stages is
+  enabled as well. Default is 0, periodic event and cycle counting disabled.
+  */
+void tetrapol_set_stats_period(tetrapol_t *tetrapol, int period);
+int tetrapol_get_stats_period(tetrapol_t *tetrapol);
+
+const tetrapol_stats_t *tetrapol_get_stats(tetrapol_t *tetrapol);
+
+/**
+  Set timeout of terminal state (link state, segmented TSDUs being
+  reassembled). Terminal is evicted when no frame was received from it for
+  timeout seconds of stream time. 0 disables eviction, default is
+  TETRAPOL_TERMINAL_TIMEOUT_DEFAULT. Applies to frames received afterwards.
+  */
+void tetrapol_set_terminal_timeout(tetrapol_t *tetrapol, int timeout);
+int tetrapol_get_terminal_timeout(tetrapol_t *tetrapol);
+
+/**
+  Limit number of terminals tracked by logical channel, the least recently
+  active terminal is evicted when a new one appears. Default is 0, unlimited.
+  */
+void tetrapol_set_terminals_max(tetrapol_t *tetrapol, int max);
+int tetrapol_get_terminals_max(tetrapol_t *tetrapol);
+
+/**
+  Set handler of decoded events, default is tetrapol_json_handler.
+
+  @param handler Callbacks are copied into instance, NULL disables all events.
+  @param ctx Passed into callbacks.
+  */
+void tetrapol_set_event_handler(tetrapol_t *tetrapol,
+        const tetrapol_event_handler_t *handler, void *ctx);
+
+/** Offset of current position in received stream in bits. */
+uint64_t tetrapol_get_rx_offs(tetrapol_t *tetrapol);
+
+/** Number of current frame in superframe or TETRAPOL_FRAME_NO_UNKNOWN. */
+int tetrapol_get_frame_no(tetrapol_t *tetrapol);
+
 #ifdef __cplusplus
 }
 #endif
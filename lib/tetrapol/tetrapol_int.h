@@ -3,54 +3,64 @@
 // Internal library functions of tetrapol.c
 
 #include <tetrapol/addr.h>
+#include <tetrapol/out_buf.h>
 #include <tetrapol/tetrapol.h>
+#include <tetrapol/tsdu_arena.h>
 
-enum {
-    FRAME_NO_UNKNOWN = -1,
-};
-
-enum {
-    LOG_CH_BCH,
-    LOG_CH_DACH,
-    LOG_CH_DCH,
-    LOG_CH_PCH,
-    LOG_CH_RACH,
-    LOG_CH_RCH,
-    LOG_CH_SCH,
-    LOG_CH_SDCH,
-    LOG_CH_VCH,
-};
-
-enum {
-    TSAP_ID_UNKNOWN = -1,
-};
-
-enum {
-    TSAP_REF_UNKNOWN = -1,
-};
+typedef struct tpdu_pool_priv_t tpdu_pool_t;
 
 typedef struct {
     tetrapol_cfg_t cfg;
     uint64_t rx_offs;
     int frame_no;
+    out_buf_t *out; ///< output for events
+    tsdu_arena_t *tsdu_arena;   ///< for TSDUs released right after event
+    tpdu_pool_t *tpdu_pool;     ///< reassembly of segmented TPDU
+    /// rx_time of frame event up to seconds, formatted for rx_time_sec
+    int64_t rx_time_sec;
+    char rx_time[80];
+    int ch_id;
+    int log_lvl;
+    tetrapol_stats_t stats;
+    int stats_period;   ///< period of stats event in seconds, 0 disabled
+    int terminal_timeout;   ///< in seconds, 0 disabled
+    int terminals_max;      ///< per logical channel, 0 unlimited
+    tetrapol_event_handler_t evt;
+    void *evt_ctx;
 } tpol_t;
 
-enum {
-    TPDU_TYPE_TPDU,
-    TPDU_TYPE_TPDU_UI,
-};
-
-typedef struct {
-    int log_ch;
-    addr_t addr;
-    uint8_t tpdu_type;
-    int prio;
-    int tsap_id;
-    int tsap_ref_swmi;
-    int tsap_ref_rt;
-    int data_len;
-    const uint8_t *data;
-} tpol_tsdu_t;
+typedef tetrapol_evt_tsdu_t tpol_tsdu_t;
 
 tpol_t *tetrapol_get_tpol(tetrapol_t *tetrapol);
+
+// Event dispatch into event handler of instance, see tetrapol_event_handler_t.
+void tetrapol_evt_frame(tpol_t *tpol, const frame_t *fr, int scr);
+void tetrapol_evt_scr(tpol_t *tpol, int scr);
+void tetrapol_evt_sync(tpol_t *tpol, bool has_sync);
+void tetrapol_evt_radio_ch_type(tpol_t *tpol, int radio_ch_type);
+/**
+  Report TSDU, tpol_tsdu->tsdu is decoded by caller (TPDU layer) and only
+  borrowed, so it is decoded once for all consumers.
+  */
 void tetrapol_evt_tsdu(tpol_t *tpol, const tpol_tsdu_t *tpol_tsdu);
+void tetrapol_evt_lsdu(tpol_t *tpol, const tetrapol_evt_lsdu_t *evt);
+void tetrapol_evt_evict(tpol_t *tpol, const tetrapol_evt_evict_t *evt);
+
+/**
+  Emit stats event with current counters.
+
+  @param time Stream time in seconds.
+  */
+void tetrapol_evt_stats(tpol_t *tpol, long time);
+
+/// name of logical channel used in JSON
+const char *tetrapol_log_ch_str(int log_ch);
+
+/**
+  Start JSON event, write event header into output buffer. Must be followed
+  by tetrapol_json_end().
+  */
+void tetrapol_json_begin(const tpol_t *tpol, const char *event);
+
+/// close JSON event, output buffer is flushed when it is full enough
+void tetrapol_json_end(const tpol_t *tpol);
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+  Hierarchical timer wheel.
+
+  Timers are embedded into structures of user, time is counted in ticks of
+  length chosen by user. Add and cancel are O(1), advance visits only slots
+  passed by time and timers which are due. Far timers are kept in upper
+  levels with coarse resolution and cascaded into lower levels as the time
+  approaches.
+  */
+typedef struct timer_wheel_priv_t timer_wheel_t;
+
+typedef struct tw_timer_t {
+    struct tw_timer_t *next;
+    struct tw_timer_t **pprev;  ///< NULL when timer is not pending
+    uint64_t expires;           ///< tick of expiration
+} tw_timer_t;
+
+/** Called for expired timer, timer is not pending and can be added again. */
+typedef void (*tw_callback_t)(tw_timer_t *timer, void *ctx);
+
+/// get pointer to structure from pointer to its member
+#define TW_CONTAINER_OF(ptr, type, member) \
+    ((type *)((char *)(ptr) - offsetof(type, member)))
+
+/**
+  Create timer wheel.
+
+  @param now Initial time in ticks.
+  */
+timer_wheel_t *timer_wheel_create(uint64_t now);
+
+/** Destroy wheel, pending timers are not touched. */
+void timer_wheel_destroy(timer_wheel_t *tw);
+
+static inline void tw_timer_init(tw_timer_t *timer)
+{
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+static inline bool tw_timer_pending(const tw_timer_t *timer)
+{
+    return timer->pprev != NULL;
+}
+
+/**
+  Start timer, pending timer is restarted.
+
+  @param expires Tick when timer expires, timers in past expire by the next
+  advance.
+  */
+void timer_wheel_add(timer_wheel_t *tw, tw_timer_t *timer, uint64_t expires);
+
+/** Stop timer, does nothing when timer is not pending. */
+void timer_wheel_cancel(timer_wheel_t *tw, tw_timer_t *timer);
+
+uint64_t timer_wheel_now(const timer_wheel_t *tw);
+
+/** Number of pending timers. */
+int timer_wheel_count(const timer_wheel_t *tw);
+
+/**
+  Advance time, callback is called for each expired timer. Callback can add
+  and cancel any timers.
+
+  @param now New time in ticks, time never goes back.
+  */
+void timer_wheel_advance(timer_wheel_t *tw, uint64_t now, tw_callback_t cb,
+        void *ctx);
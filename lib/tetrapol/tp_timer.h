@@ -5,17 +5,54 @@
 
 typedef struct {
     struct timeval tv;
+    /// received data were lost since the previous call of callback
     bool rx_glitch;
 } time_evt_t;
+
+/**
+  Scheduler of callbacks driven by time of received stream. Callbacks are
+  called on every tick or by deadline, deadlines are kept in timer wheel,
+  so tick runs only callbacks which are due.
+  */
 typedef struct tp_timer_priv_t tp_timer_t;
+typedef struct tp_timer_entry_priv_t tp_timer_entry_t;
 
 typedef void (*timer_callback_t)(time_evt_t *te, void *ptr);
 
 tp_timer_t *tp_timer_create(void);
 void tp_timer_destroy(tp_timer_t *timer);
+
+/**
+  Advance time and run callbacks which are due.
+
+  @param rx_glitch Received data were lost, reported to each callback by
+    its next call.
+  @param usec Time since the previous tick, negative tick is rejected.
+  */
 void tp_timer_tick(tp_timer_t *timer, bool rx_glitch, int usec);
-bool tp_timer_register(tp_timer_t *timer, timer_callback_t timer_func, void *ptr);
-void tp_timer_cancel(tp_timer_t *timer, timer_callback_t timer_func, void *ptr);
+
+/**
+  Register callback called on every tick, in order of registration.
+
+  @return Handle for tp_timer_cancel() or NULL on failure, also when the
+    same callback and ptr is already registered.
+  */
+tp_timer_entry_t *tp_timer_register(tp_timer_t *timer,
+        timer_callback_t timer_func, void *ptr);
+
+/**
+  Register callback called by the first tick at or after deadline.
+
+  @param delay Time from now until deadline in us.
+  @param period Callback is called again every period us, 0 for single
+    call. Handle of single call is released before callback is called.
+  @return Handle for tp_timer_cancel() or NULL on failure.
+  */
+tp_timer_entry_t *tp_timer_add(tp_timer_t *timer, int delay, int period,
+        timer_callback_t timer_func, void *ptr);
+
+/** Cancel callback in O(1), can be called from callbacks. */
+void tp_timer_cancel(tp_timer_t *timer, tp_timer_entry_t *entry);
 
 /**
  * @brief time_delta Compute difference in two timestamps (us)
@@ -23,7 +23,23 @@ int tpdu_push_hdlc_frame(tpdu_t *tpdu, const hdlc_frame_t *hdlc_fr);
 void tpdu_rx_glitch(tpdu_t *tpdu);
 
 void tpdu_destroy(tpdu_t *tpdu);
-void tpdu_du_tick(time_evt_t *te, void *tpdu_du);
+
+/**
+  Check T454 timers of segmented DUs, expired DUs are dropped.
+
+  @return Time in us until the next T454 expiration, -1 when no DU waits
+  for segments.
+  */
+int tpdu_du_tick(time_evt_t *te, void *tpdu_du);
+
+/**
+  Pool of buffers for reassembly of segmented TPDU and TPDU_UI, shared by
+  all links of instance (tpol_t.tpdu_pool). Buffers are taken only while
+  segmented TPDU is in progress, for TPDU_UI only payload of segments is
+  kept.
+  */
+tpdu_pool_t *tpdu_pool_create(void);
+void tpdu_pool_destroy(tpdu_pool_t *pool);
 
 tpdu_ui_t *tpdu_ui_create(tpol_t *tpol, frame_type_t fr_type, int log_ch);
 void tpdu_ui_destroy(tpdu_ui_t *tpdu);
@@ -34,6 +50,7 @@ void tpdu_ui_destroy(tpdu_ui_t *tpdu);
  * @param tpdu
  * @param hdlc_fr
  * @param tsdu Set to pointer to decoded TSDU if available, NULL otherwise.
+ *   It is the same TSDU as passed to TSDU event, caller must free it.
  *
  * @return 0 on sucess, -1 on error
  */
@@ -45,6 +62,7 @@ int tpdu_ui_push_hdlc_frame(tpdu_ui_t *tpdu, const hdlc_frame_t *hdlc_fr, tsdu_t
  * @param tpdu
  * @param hdlc_fr
  * @param tsdu Set to pointer to decoded TSDU if available, NULL otherwise.
+ *   It is the same TSDU as passed to TSDU event, caller must free it.
  *
  * @return 0 on sucess, -1 on error
  */
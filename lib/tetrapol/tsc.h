@@ -0,0 +1,22 @@
+#pragma once
+
+// CPU time stamp counter, internal header of library and benchmarks
+
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#else
+#define HAVE_TSC 0
+#endif
+
+/// Read time stamp counter, returns 0 when HAVE_TSC is 0.
+static inline uint64_t tsc_read(void)
+{
+#if HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
@@ -2,6 +2,7 @@
 
 #include <tetrapol/addr.h>
 #include <tetrapol/msg_coding.h>
+#include <tetrapol/tsdu_arena.h>
 
 #include <stdbool.h>
 #include <stdint.h>
@@ -555,3 +556,13 @@ void tsdu_destroy(tsdu_base_t *tsdu);
  */
 int tsdu_decode(const uint8_t *data, int len, tsdu_t **tsdu);
 
+/**
+  Decode TSDU into arena, all parts of TSDU are allocated from arena.
+
+  Decoded TSDU is valid until tsdu_arena_reset() and must not be passed
+  into tsdu_destroy(). Parameters and return value are the same as for
+  tsdu_decode().
+  */
+int tsdu_decode_arena(const uint8_t *data, int len, tsdu_arena_t *arena,
+        tsdu_t **tsdu);
+
@@ -0,0 +1,41 @@
+#pragma once
+
+/**
+  Bump allocator for decoded TSDUs.
+
+  All parts of TSDU decoded by tsdu_decode_arena() are carved from single
+  memory block, whole arena is released at once by tsdu_arena_reset() in
+  O(1). When block is exhausted, allocations fall back to malloc and are
+  released by the next reset.
+  */
+typedef struct tsdu_arena_priv_t tsdu_arena_t;
+
+/**
+  Create arena.
+
+  @param size Size of memory block in bytes.
+  */
+tsdu_arena_t *tsdu_arena_create(int size);
+void tsdu_arena_destroy(tsdu_arena_t *arena);
+
+/** Release all allocations, pointers into arena became invalid. */
+void tsdu_arena_reset(tsdu_arena_t *arena);
+
+/**
+  Allocate memory from arena, or by malloc when arena is NULL.
+
+  @return pointer aligned for TSDU structures or NULL on failure
+  */
+void *tsdu_arena_alloc(tsdu_arena_t *arena, int size);
+
+/**
+  Resize allocation, realloc() when arena is NULL. The last allocation
+  is extended in place when possible.
+
+  @param old_size Size of ptr used for allocation, ignored if arena is NULL.
+  */
+void *tsdu_arena_realloc(tsdu_arena_t *arena, void *ptr, int old_size,
+        int size);
+
+/** Free allocation, only allocations done without arena are released. */
+void tsdu_arena_free(tsdu_arena_t *arena, void *ptr);
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+
+enum {
+    /// max. number of decoded bits, path metrics must fit into 8 bits
+    VITERBI_MAX_SIZE = 127,
+    /// max. reliability of received bit for soft decoder
+    VITERBI_MAX_REL = 127,
+};
+
+/**
+  Tail-biting Viterbi decoder for TETRAPOL frame convolutional code
+  (PAS 0001-2 6.1.2, PAS 0001-2 6.2.2).
+
+  All 4 possible starting states are decoded in single pass over trellis, the
+  best path which ends in its starting state wins.
+
+  @param dec Output, decoded bits, one bit per byte.
+  @param in_bits Received bits (2 * size), one bit per byte.
+  @param size Number of decoded bits, at most VITERBI_MAX_SIZE.
+
+  @return Number of fixed bits (Hamming distance of received bits from
+    the nearest codeword).
+  */
+int viterbi_decode(uint8_t *dec, const uint8_t *in_bits, int size);
+
+/**
+  Soft decision version of viterbi_decode(), received bits are weighted
+  by their reliability. For equal reliabilities result is the same as for
+  viterbi_decode().
+
+  @param in_rel Reliability of each received bit, 0 to VITERBI_MAX_REL.
+
+  @return Number of fixed bits (Hamming distance of received bits from
+    decoded codeword).
+  */
+int viterbi_decode_soft(uint8_t *dec, const uint8_t *in_bits,
+        const uint8_t *in_rel, int size);
+
+/**
+  Same as viterbi_decode(), but decoded bits are stored packed into array of
+  words (the first bit in LSB of the first word) starting at bit offs. Other
+  bits of dec are left untouched.
+  */
+int viterbi_decode_bits(uint64_t *dec, int offs, const uint8_t *in_bits,
+        int size);
+
+/** Soft decision version of viterbi_decode_bits(). */
+int viterbi_decode_soft_bits(uint64_t *dec, int offs, const uint8_t *in_bits,
+        const uint8_t *in_rel, int size);
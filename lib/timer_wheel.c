@@ -0,0 +1,156 @@
+#define LOG_PREFIX "timer_wheel"
+#include <tetrapol/log.h>
+#include <tetrapol/timer_wheel.h>
+
+#include <stdlib.h>
+
+enum {
+    TW_BITS = 6,
+    TW_SLOTS = 1 << TW_BITS,
+    TW_MASK = TW_SLOTS - 1,
+    TW_LEVELS = 4,
+};
+
+/// timers further in future are kept at the end of the last level
+#define TW_RANGE (1ull << (TW_BITS * TW_LEVELS))
+
+struct timer_wheel_priv_t {
+    /// level L slot S holds timers expiring in block S of 64^L ticks
+    tw_timer_t *slots[TW_LEVELS][TW_SLOTS];
+    uint64_t now;
+    int count;
+};
+
+timer_wheel_t *timer_wheel_create(uint64_t now)
+{
+    timer_wheel_t *tw = calloc(1, sizeof(timer_wheel_t));
+    if (!tw) {
+        return NULL;
+    }
+    tw->now = now;
+
+    return tw;
+}
+
+void timer_wheel_destroy(timer_wheel_t *tw)
+{
+    free(tw);
+}
+
+static void list_insert(tw_timer_t **head, tw_timer_t *timer)
+{
+    timer->next = *head;
+    if (timer->next) {
+        timer->next->pprev = &timer->next;
+    }
+    *head = timer;
+    timer->pprev = head;
+}
+
+static void list_unlink(tw_timer_t *timer)
+{
+    *timer->pprev = timer->next;
+    if (timer->next) {
+        timer->next->pprev = timer->pprev;
+    }
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+/// move list into local head, so its items can be unlinked from callbacks
+static void list_move(tw_timer_t **dst, tw_timer_t **src)
+{
+    *dst = *src;
+    *src = NULL;
+    if (*dst) {
+        (*dst)->pprev = dst;
+    }
+}
+
+/// put timer into slot, timer must not expire before now
+static void place(timer_wheel_t *tw, tw_timer_t *timer)
+{
+    uint64_t expires = timer->expires;
+    if (expires - tw->now >= TW_RANGE) {
+        expires = tw->now + TW_RANGE - 1;
+    }
+    const uint64_t delta = expires - tw->now;
+
+    int level = 0;
+    while (level < TW_LEVELS - 1 &&
+            delta >= (1ull << (TW_BITS * (level + 1)))) {
+        ++level;
+    }
+    list_insert(&tw->slots[level][(expires >> (TW_BITS * level)) & TW_MASK],
+            timer);
+}
+
+void timer_wheel_add(timer_wheel_t *tw, tw_timer_t *timer, uint64_t expires)
+{
+    if (tw_timer_pending(timer)) {
+        list_unlink(timer);
+    } else {
+        ++tw->count;
+    }
+    // current tick is already processed
+    timer->expires = expires > tw->now ? expires : tw->now + 1;
+    place(tw, timer);
+}
+
+void timer_wheel_cancel(timer_wheel_t *tw, tw_timer_t *timer)
+{
+    if (tw_timer_pending(timer)) {
+        list_unlink(timer);
+        --tw->count;
+    }
+}
+
+uint64_t timer_wheel_now(const timer_wheel_t *tw)
+{
+    return tw->now;
+}
+
+int timer_wheel_count(const timer_wheel_t *tw)
+{
+    return tw->count;
+}
+
+/// move timers from slot of upper level into lower levels
+static void cascade(timer_wheel_t *tw, int level)
+{
+    tw_timer_t *list;
+    list_move(&list, &tw->slots[level][(tw->now >> (TW_BITS * level)) & TW_MASK]);
+    while (list) {
+        tw_timer_t *timer = list;
+        list_unlink(timer);
+        place(tw, timer);
+    }
+}
+
+void timer_wheel_advance(timer_wheel_t *tw, uint64_t now, tw_callback_t cb,
+        void *ctx)
+{
+    while (tw->now < now) {
+        if (!tw->count) {
+            tw->now = now;
+            break;
+        }
+
+        ++tw->now;
+        for (int level = 1; level < TW_LEVELS; ++level) {
+            if (tw->now & ((1ull << (TW_BITS * level)) - 1)) {
+                break;
+            }
+            cascade(tw, level);
+        }
+
+        tw_timer_t *list;
+        list_move(&list, &tw->slots[0][tw->now & TW_MASK]);
+        while (list) {
+            tw_timer_t *timer = list;
+            list_unlink(timer);
+            --tw->count;
+            cb(timer, ctx);
+        }
+    }
+}
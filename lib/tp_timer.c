@@ -1,19 +1,45 @@
 #define LOG_PREFIX "timer"
 #include "tetrapol/log.h"
+#include "tetrapol/timer_wheel.h"
 #include "tetrapol/tp_timer.h"
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
-typedef struct {
+enum {
+    /// resolution of deadlines
+    TP_TIMER_RES_USEC = 1000,
+    /// entries are allocated in chunks and reused
+    TP_TIMER_CHUNK_LEN = 64,
+};
+
+struct tp_timer_entry_priv_t {
     timer_callback_t func;
     void *ptr;
-} callback_t;
+    bool every_tick;
+    int period;             ///< in us, 0 for single call
+    uint64_t deadline;      ///< in us
+    uint32_t glitch_gen;    ///< last RX glitch reported to callback
+    tw_timer_t tw_timer;
+    /// list of callbacks called on every tick, or list of free entries
+    tp_timer_entry_t *prev;
+    tp_timer_entry_t *next;
+};
 
 struct tp_timer_priv_t {
-    int ncallbacks;
-    callback_t *callbacks;
-    time_evt_t te;
+    timer_wheel_t *tw;
+    tp_timer_entry_t *ticks_first;
+    tp_timer_entry_t *ticks_last;
+    /// next entry called by tick, updated when it is canceled by callback
+    tp_timer_entry_t *ticks_next;
+    /// periodic entry called by wheel, NULL when it is canceled by callback
+    tp_timer_entry_t *running;
+    tp_timer_entry_t *free;
+    tp_timer_entry_t **chunks;
+    int nchunks;
+    uint64_t usec;          ///< time since creation
+    uint32_t glitch_gen;    ///< number of RX glitches
 };
 
 tp_timer_t *tp_timer_create(void)
@@ -23,6 +49,12 @@ tp_timer_t *tp_timer_create(void)
         return NULL;
     }
 
+    timer->tw = timer_wheel_create(0);
+    if (!timer->tw) {
+        free(timer);
+        return NULL;
+    }
+
     return timer;
 }
 
@@ -31,58 +63,203 @@ void tp_timer_destroy(tp_timer_t *timer)
     if (!timer) {
         return;
     }
-    free(timer->callbacks);
+    for (int i = 0; i < timer->nchunks; ++i) {
+        free(timer->chunks[i]);
+    }
+    free(timer->chunks);
+    timer_wheel_destroy(timer->tw);
     free(timer);
 }
 
+static void run(tp_timer_t *timer, tp_timer_entry_t *entry)
+{
+    time_evt_t te;
+    te.tv.tv_sec = timer->usec / 1000000;
+    te.tv.tv_usec = timer->usec % 1000000;
+    te.rx_glitch = entry->glitch_gen != timer->glitch_gen;
+    entry->glitch_gen = timer->glitch_gen;
+
+    entry->func(&te, entry->ptr);
+}
+
+static void release(tp_timer_t *timer, tp_timer_entry_t *entry)
+{
+    entry->func = NULL;
+    entry->next = timer->free;
+    timer->free = entry;
+}
+
+/// convert deadline into tick of wheel, rounded up
+static uint64_t wheel_tick(uint64_t usec)
+{
+    return (usec + TP_TIMER_RES_USEC - 1) / TP_TIMER_RES_USEC;
+}
+
+static void expire(tw_timer_t *tw_timer, void *ctx)
+{
+    tp_timer_t *timer = ctx;
+    tp_timer_entry_t *entry = TW_CONTAINER_OF(tw_timer, tp_timer_entry_t,
+            tw_timer);
+
+    if (!entry->period) {
+        // handle is released, callback can register another one
+        const timer_callback_t func = entry->func;
+        void *ptr = entry->ptr;
+        const uint32_t glitch_gen = entry->glitch_gen;
+        release(timer, entry);
+
+        tp_timer_entry_t tmp = {
+            .func = func,
+            .ptr = ptr,
+            .glitch_gen = glitch_gen,
+        };
+        run(timer, &tmp);
+        return;
+    }
+
+    timer->running = entry;
+    run(timer, entry);
+    if (!timer->running) {
+        return;
+    }
+    timer->running = NULL;
+
+    do {
+        entry->deadline += entry->period;
+    } while (entry->deadline <= timer->usec);
+    timer_wheel_add(timer->tw, &entry->tw_timer, wheel_tick(entry->deadline));
+}
+
 void tp_timer_tick(tp_timer_t *timer, bool rx_glitch, int usec)
 {
-    timer->te.tv.tv_usec += usec;
-    timer->te.tv.tv_sec += timer->te.tv.tv_usec / 1000000;
-    timer->te.tv.tv_usec %= 1000000;
-    timer->te.rx_glitch = rx_glitch;
+    if (usec < 0) {
+        LOG(WTF, "negative tick %d us", usec);
+        return;
+    }
+
+    timer->usec += usec;
+    if (rx_glitch) {
+        ++timer->glitch_gen;
+    }
+
+    for (tp_timer_entry_t *entry = timer->ticks_first; entry;
+            entry = timer->ticks_next) {
+        timer->ticks_next = entry->next;
+        run(timer, entry);
+    }
+    timer->ticks_next = NULL;
+
+    timer_wheel_advance(timer->tw, timer->usec / TP_TIMER_RES_USEC, expire,
+            timer);
+}
+
+static tp_timer_entry_t *alloc_entry(tp_timer_t *timer,
+        timer_callback_t timer_func, void *ptr)
+{
+    if (!timer->free) {
+        tp_timer_entry_t **chunks = realloc(timer->chunks,
+                (timer->nchunks + 1) * sizeof(*chunks));
+        if (!chunks) {
+            LOG(ERR, "ERR OOM");
+            return NULL;
+        }
+        timer->chunks = chunks;
 
-    for (int i = 0; i < timer->ncallbacks; ++i) {
-        timer->callbacks[i].func(&timer->te, timer->callbacks[i].ptr);
+        tp_timer_entry_t *chunk = calloc(TP_TIMER_CHUNK_LEN,
+                sizeof(tp_timer_entry_t));
+        if (!chunk) {
+            LOG(ERR, "ERR OOM");
+            return NULL;
+        }
+        timer->chunks[timer->nchunks++] = chunk;
+        for (int i = TP_TIMER_CHUNK_LEN - 1; i >= 0; --i) {
+            release(timer, &chunk[i]);
+        }
     }
+
+    tp_timer_entry_t *entry = timer->free;
+    timer->free = entry->next;
+    memset(entry, 0, sizeof(*entry));
+    entry->func = timer_func;
+    entry->ptr = ptr;
+    entry->glitch_gen = timer->glitch_gen;
+    tw_timer_init(&entry->tw_timer);
+
+    return entry;
 }
 
-bool tp_timer_register(tp_timer_t *timer, timer_callback_t timer_func, void *ptr)
+tp_timer_entry_t *tp_timer_register(tp_timer_t *timer,
+        timer_callback_t timer_func, void *ptr)
 {
     // check for double-registration
-    for (int i = 0; i < timer->ncallbacks; ++i) {
-        if (timer->callbacks[i].func == timer_func &&
-                timer->callbacks[i].ptr == ptr) {
+    for (tp_timer_entry_t *e = timer->ticks_first; e; e = e->next) {
+        if (e->func == timer_func && e->ptr == ptr) {
             LOG(WTF, "double registration of callback");
-            return false;
+            return NULL;
         }
     }
 
-    ++timer->ncallbacks;
-    callback_t *p = realloc(timer->callbacks, sizeof(callback_t[timer->ncallbacks]));
-    if (!p) {
-        LOG(ERR, "ERR OOM");
-        return false;
+    tp_timer_entry_t *entry = alloc_entry(timer, timer_func, ptr);
+    if (!entry) {
+        return NULL;
     }
-    timer->callbacks = p;
-    timer->callbacks[timer->ncallbacks - 1].func = timer_func;
-    timer->callbacks[timer->ncallbacks - 1].ptr = ptr;
 
-    return true;
+    entry->every_tick = true;
+    entry->prev = timer->ticks_last;
+    if (timer->ticks_last) {
+        timer->ticks_last->next = entry;
+    } else {
+        timer->ticks_first = entry;
+    }
+    timer->ticks_last = entry;
+
+    return entry;
+}
+
+tp_timer_entry_t *tp_timer_add(tp_timer_t *timer, int delay, int period,
+        timer_callback_t timer_func, void *ptr)
+{
+    tp_timer_entry_t *entry = alloc_entry(timer, timer_func, ptr);
+    if (!entry) {
+        return NULL;
+    }
+
+    entry->period = period;
+    entry->deadline = timer->usec + delay;
+    timer_wheel_add(timer->tw, &entry->tw_timer, wheel_tick(entry->deadline));
+
+    return entry;
 }
 
-void tp_timer_cancel(tp_timer_t *timer, timer_callback_t timer_func, void *ptr)
+void tp_timer_cancel(tp_timer_t *timer, tp_timer_entry_t *entry)
 {
-    for (int i = 0; i < timer->ncallbacks; ++i) {
-        if (timer->callbacks[i].func == timer_func &&
-                timer->callbacks[i].ptr == ptr) {
-            memmove(&timer->callbacks[i], &timer->callbacks[i + 1],
-                    sizeof(callback_t[timer->ncallbacks - i - 1]));
-            --timer->ncallbacks;
-            return;
+    if (!entry->func) {
+        LOG(WTF, "callback not found");
+        return;
+    }
+
+    if (entry->every_tick) {
+        if (timer->ticks_next == entry) {
+            timer->ticks_next = entry->next;
+        }
+        if (entry->prev) {
+            entry->prev->next = entry->next;
+        } else {
+            timer->ticks_first = entry->next;
         }
+        if (entry->next) {
+            entry->next->prev = entry->prev;
+        } else {
+            timer->ticks_last = entry->prev;
+        }
+    } else {
+        if (timer->running == entry) {
+            timer->running = NULL;
+        }
+        timer_wheel_cancel(timer->tw, &entry->tw_timer);
     }
-    LOG(WTF, "callback not found");
+
+    release(timer, entry);
 }
 
 int timeval_abs_delta(const struct timeval *tv1, const struct timeval *tv2)
@@ -1,6 +1,7 @@
 #define LOG_PREFIX "tpdu"
 #include <tetrapol/log.h>
 #include <tetrapol/misc.h>
+#include <tetrapol/slab.h>
 #include <tetrapol/tsdu.h>
 #include <tetrapol/tpdu.h>
 #include <tetrapol/misc.h>
@@ -21,13 +22,52 @@ enum {
 
 #define TPDU_CODE_PREFIX_MASK (0x18)
 
+enum {
+    /// DU header of segmented TPDU_UI, PAS 0001-3-3 9.5.1.2
+    TPDU_UI_SEG_HDR_LEN = 3,
+    TPDU_POOL_CHUNK_DUS = 16,
+    TPDU_POOL_CHUNK_SEGMENTS = 64,
+    TPDU_POOL_CHUNK_SEG_BUFS = 4,
+    /// maximal length of TSDU reassembled from segmented TPDU
+    TPDU_SEG_BUF_LEN = 2000,
+};
+
+/// payload of single segment of TPDU_UI
 typedef struct {
-    struct timeval tv;
+    uint8_t len;
+    uint8_t data[sizeof(((hdlc_frame_t *)NULL)->data) - TPDU_UI_SEG_HDR_LEN];
+} du_segment_t;
+
+typedef struct segmented_du_t segmented_du_t;
+
+struct segmented_du_t {
+    struct timeval tv;  ///< start of T454, zero until the next tick
+    /// list of DUs ordered by the last received segment, head expires first
+    segmented_du_t *prev;
+    segmented_du_t *next;
+    uint64_t received;  ///< bitmap of received segments, SYS_PAR_N452 bits
+    uint8_t seg_ref;
     uint8_t id_tsap;
     uint8_t prio;
     uint8_t nsegments;  ///< total amount of segments (HDLC frames) in DU
-    hdlc_frame_t *hdlc_frs[SYS_PAR_N452];
-} segmented_du_t;
+    du_segment_t *segs[SYS_PAR_N452];
+};
+
+typedef struct seg_buf_t seg_buf_t;
+
+/// TSDU reassembled from segmented TPDU of single connection
+struct seg_buf_t {
+    seg_buf_t *next;
+    int conn;           ///< index of connection in tpdu_t.conns
+    int len;
+    uint8_t data[TPDU_SEG_BUF_LEN];
+};
+
+struct tpdu_pool_priv_t {
+    slab_t *dus;
+    slab_t *segments;
+    slab_t *seg_bufs;
+};
 
 typedef enum {
     CONNECTION_STATE_NC = 0,    ///< not connected
@@ -37,42 +77,89 @@ typedef enum {
 } connection_state_t;
 
 typedef struct {
-    connection_state_t state;
+    uint8_t state;      ///< connection_state_t
     int8_t tsap_id;
     int8_t tsap_ref_swmi;
     int8_t tsap_ref_rt;
-    int seg_len;
-    uint8_t segbuf[2000];
 } connection_t;
 
 struct tpdu_priv_t {
     // connections are listed by TSAP reference (SwMI side)
     // 8 normal, 7 fast connections
     connection_t conns[8+7];
+    /// buffers of connections receiving segmented TPDU, taken from pool
+    seg_buf_t *seg_bufs;
     int log_ch;
     tpol_t *tpol;
 };
 
 struct tpdu_priv_ui_t {
     frame_type_t fr_type;
-    segmented_du_t *seg_du[128];
+    segmented_du_t *seg_du_first;
+    segmented_du_t *seg_du_last;
     int log_ch;
     tpol_t *tpol;
 };
 
-static void connection_reset(connection_t *conn)
+/// find buffer of connection, NULL when there is no segmented TPDU pending
+static seg_buf_t *seg_buf_lookup(tpdu_t *tpdu, connection_t *conn)
+{
+    const int idx = conn - tpdu->conns;
+    seg_buf_t *buf = tpdu->seg_bufs;
+    while (buf && buf->conn != idx) {
+        buf = buf->next;
+    }
+
+    return buf;
+}
+
+static seg_buf_t *seg_buf_get(tpdu_t *tpdu, connection_t *conn)
+{
+    seg_buf_t *buf = seg_buf_lookup(tpdu, conn);
+    if (buf) {
+        return buf;
+    }
+
+    buf = slab_alloc(tpdu->tpol->tpdu_pool->seg_bufs);
+    if (!buf) {
+        LOG(ERR, "ERR OOM");
+        return NULL;
+    }
+    buf->conn = conn - tpdu->conns;
+    buf->len = 0;
+    buf->next = tpdu->seg_bufs;
+    tpdu->seg_bufs = buf;
+
+    return buf;
+}
+
+static void seg_buf_release(tpdu_t *tpdu, connection_t *conn)
+{
+    const int idx = conn - tpdu->conns;
+    for (seg_buf_t **pbuf = &tpdu->seg_bufs; *pbuf; pbuf = &(*pbuf)->next) {
+        if ((*pbuf)->conn == idx) {
+            seg_buf_t *buf = *pbuf;
+            *pbuf = buf->next;
+            slab_free(tpdu->tpol->tpdu_pool->seg_bufs, buf);
+            return;
+        }
+    }
+}
+
+static void connection_reset(tpdu_t *tpdu, connection_t *conn)
 {
     conn->state = CONNECTION_STATE_NC;
-    conn->seg_len = 0;
+    seg_buf_release(tpdu, conn);
 }
 
-static void connection_fcr(connection_t *conn, int tsap_id, int tsap_ref)
+static void connection_fcr(tpdu_t *tpdu, connection_t *conn, int tsap_id,
+        int tsap_ref)
 {
     LOG(INFO, "FCR TSAP_ref: %d TSAP_id: %d", tsap_ref, tsap_id);
 
     if (conn->state != CONNECTION_STATE_NC) {
         LOG(INFO, "closing existing connection");
-        connection_reset(conn);
+        connection_reset(tpdu, conn);
     }
 
     conn->state = CONNECTION_STATE_CONNECTED;
@@ -81,33 +168,35 @@ static void connection_fcr(connection_t *conn, int tsap_id, int tsap_ref)
     conn->tsap_ref_rt = tsap_ref;
 }
 
-static void connection_cr(connection_t *conn, int tsap_id, int tsap_ref)
+static void connection_cr(tpdu_t *tpdu, connection_t *conn, int tsap_id,
+        int tsap_ref)
 {
     LOG(INFO, "CR TSAP_ref: %d TSAP_id: %d", tsap_ref, tsap_id);
 
     if (conn->state != CONNECTION_STATE_NC) {
         LOG(INFO, "closing existing connection");
-        connection_reset(conn);
+        connection_reset(tpdu, conn);
     }
 
     conn->state = CONNECTION_STATE_CR;
     conn->tsap_id = tsap_id;
     conn->tsap_ref_swmi = tsap_ref;
-    conn->tsap_ref_rt = TSAP_REF_UNKNOWN;
+    conn->tsap_ref_rt = TETRAPOL_TSAP_REF_UNKNOWN;
 }
 
-static void connection_cc(connection_t *conn, int tsap_ref_swmi, int tsap_ref_rt)
+static void connection_cc(tpdu_t *tpdu, connection_t *conn, int tsap_ref_swmi,
+        int tsap_ref_rt)
 {
     LOG(INFO, "CC TSAP_ref_SwMI=%d TSAP_ref_RT=%d", tsap_ref_swmi, tsap_ref_rt);
 
     if (conn->state != CONNECTION_STATE_NC) {
         LOG(INFO, "closing existing connection");
-        connection_reset(conn);
+        connection_reset(tpdu, conn);
     }
 
     conn->state = CONNECTION_STATE_CONNECTED;
     // when we receive CC we are missing CR from uplink
-    conn->tsap_id = TSAP_ID_UNKNOWN;
+    conn->tsap_id = TETRAPOL_TSAP_ID_UNKNOWN;
     conn->tsap_ref_swmi = tsap_ref_swmi;
     conn->tsap_ref_rt = tsap_ref_rt;
 }
@@ -123,7 +212,7 @@ static int connection_dt(connection_t *conn, int tsap_ref_swmi, int tsap_ref_rt,
             conn->state = CONNECTION_STATE_CONNECTED;
             conn->tsap_ref_rt = tsap_ref_rt;
             conn->tsap_ref_swmi = tsap_ref_swmi;
-            conn->tsap_id = TSAP_ID_UNKNOWN;
+            conn->tsap_id = TETRAPOL_TSAP_ID_UNKNOWN;
         } else {
             LOG(INFO, "Link broken, connection does not exists");
             conn->state = CONNECTION_STATE_BROKEN;
@@ -136,7 +225,7 @@ static int connection_dt(connection_t *conn, int tsap_ref_swmi, int tsap_ref_rt,
             conn->state = CONNECTION_STATE_CONNECTED;
             conn->tsap_ref_rt = tsap_ref_rt;
             conn->tsap_ref_swmi = tsap_ref_swmi;
-            conn->tsap_id = TSAP_ID_UNKNOWN;
+            conn->tsap_id = TETRAPOL_TSAP_ID_UNKNOWN;
         }
         return -1;
     }
@@ -187,7 +276,7 @@ tpdu_t *tpdu_create(tpol_t *tpol, int log_ch)
     }
 
     for (int i = 0; i < ARRAY_LEN(tpdu->conns); ++i) {
-        connection_reset(&tpdu->conns[i]);
+        connection_reset(tpdu, &tpdu->conns[i]);
     }
     tpdu->tpol = tpol;
     tpdu->log_ch = log_ch;
@@ -195,19 +284,50 @@ tpdu_t *tpdu_create(tpol_t *tpol, int log_ch)
     return tpdu;
 }
 
+/**
+  Decode TSDU and report it. The same decoded TSDU is borrowed by event
+  handler and then passed to caller. When caller does not take TSDU
+  (tsdu is NULL), it is decoded into arena which is reset after event.
+
+  @return 0 on success, -1 when TSDU decoding fails
+  */
+static int tsdu_deliver(tpol_t *tpol, tpol_tsdu_t *tpol_tsdu, tsdu_t **tsdu)
+{
+    tsdu_t *decoded = NULL;
+    int ret;
+    if (tsdu) {
+        ret = tsdu_decode(tpol_tsdu->data, tpol_tsdu->data_len, &decoded);
+    } else {
+        ret = tsdu_decode_arena(tpol_tsdu->data, tpol_tsdu->data_len,
+                tpol->tsdu_arena, &decoded);
+    }
+    tpol_tsdu->tsdu = decoded;
+    tetrapol_evt_tsdu(tpol, tpol_tsdu);
+
+    if (tsdu) {
+        *tsdu = decoded;
+    } else {
+        tsdu_arena_reset(tpol->tsdu_arena);
+    }
+
+    return ret;
+}
+
 int tpdu_push_hdlc_frame(tpdu_t *tpdu, const hdlc_frame_t *hdlc_fr)
 {
     tpol_tsdu_t tpol_tsdu;
     tpol_tsdu.log_ch = tpdu->log_ch;
-    tpol_tsdu.tpdu_type = TPDU_TYPE_TPDU;
+    tpol_tsdu.tpdu_type = TETRAPOL_TPDU_TYPE_TPDU;
     tpol_tsdu.prio = 0;
 
-    const bool ext              = get_bits(1, hdlc_fr->data, 0);
-    const bool seg              = get_bits(1, hdlc_fr->data, 1);
-    const bool d                = get_bits(1, hdlc_fr->data, 2);
-    const uint8_t code          = get_bits(5, hdlc_fr->data, 3);
-    const uint8_t par_field     = get_bits(4, hdlc_fr->data + 1, 0);
-    const uint8_t dest_ref      = get_bits(4, hdlc_fr->data + 1, 4);
+    bit_reader_t br;
+    br_init(&br, hdlc_fr->data, sizeof(hdlc_fr->data));
+    const bool ext              = br_read(&br, 1);
+    const bool seg              = br_read(&br, 1);
+    const bool d                = br_read(&br, 1);
+    const uint8_t code          = br_read(&br, 5);
+    const uint8_t par_field     = br_read(&br, 4);
+    const uint8_t dest_ref      = br_read(&br, 4);
 
     if (ext) {
         LOG(WTF, "TPDU: ext != 0");
@@ -251,7 +371,7 @@ int tpdu_push_hdlc_frame(tpdu_t *tpdu, const hdlc_frame_t *hdlc_fr)
 
         switch(code_prefix) {
             case TPDU_CODE_CR:
-                connection_cr(conn, dest_ref, par_field);
+                connection_cr(tpdu, conn, dest_ref, par_field);
                 // TODO: decode bs_ref, rt_ref, call_priority
                 payload += 2;
                 payload_len -= 2;
@@ -263,7 +383,7 @@ int tpdu_push_hdlc_frame(tpdu_t *tpdu, const hdlc_frame_t *hdlc_fr)
                 break;
 
             case TPDU_CODE_CC:
-                connection_cc(conn, par_field, dest_ref);
+                connection_cc(tpdu, conn, par_field, dest_ref);
                 if (payload_len != 1) {
                     LOG(WTF, "Invalid CC lenght=%d", payload_len)
                     return -1;
@@ -273,7 +393,7 @@ int tpdu_push_hdlc_frame(tpdu_t *tpdu, const hdlc_frame_t *hdlc_fr)
                 return 0;
 
             case TPDU_CODE_FCR:
-                connection_fcr(conn, dest_ref, par_field);
+                connection_fcr(tpdu, conn, dest_ref, par_field);
                 break;
 
             default:
@@ -288,7 +408,7 @@ int tpdu_push_hdlc_frame(tpdu_t *tpdu, const hdlc_frame_t *hdlc_fr)
             case TPDU_CODE_DC:
                 ret_val = connection_dc_dr_fdr(conn, par_field, dest_ref);
                 if (ret_val == -1) {
-                    connection_reset(conn);
+                    connection_reset(tpdu, conn);
                     return 0;
                 }
                 if (ret_val == -2) {
@@ -309,41 +429,50 @@ int tpdu_push_hdlc_frame(tpdu_t *tpdu, const hdlc_frame_t *hdlc_fr)
     }
 
     if (seg) {
-        if (conn->seg_len + payload_len > SIZEOF(connection_t, segbuf)) {
+        seg_buf_t *buf = seg_buf_get(tpdu, conn);
+        if (!buf) {
+            return -1;
+        }
+        if (buf->len + payload_len > SIZEOF(seg_buf_t, data)) {
             LOG(WTF, "Too large TPDU, increase buffer size");
             return -1;
         }
-        memcpy(&conn->segbuf[conn->seg_len], payload, payload_len);
-        conn->seg_len += payload_len;
+        memcpy(&buf->data[buf->len], payload, payload_len);
+        buf->len += payload_len;
         LOG(INFO, "Segmentation part len=%d seg_len=%d dest_ref=%d",
-                payload_len, conn->seg_len, dest_ref);
+                payload_len, buf->len, dest_ref);
     } else {
-        if (conn->seg_len) {
-            if (conn->seg_len + payload_len > SIZEOF(connection_t, segbuf)) {
-                conn->seg_len = 0;
+        seg_buf_t *buf = seg_buf_lookup(tpdu, conn);
+        if (buf && buf->len) {
+            if (buf->len + payload_len > SIZEOF(seg_buf_t, data)) {
+                seg_buf_release(tpdu, conn);
                 LOG(WTF, "Too large TPDU, increase buffer size");
                 return -1;
             }
-            memcpy(&conn->segbuf[conn->seg_len], payload, payload_len);
-            conn->seg_len += payload_len;
+            memcpy(&buf->data[buf->len], payload, payload_len);
+            buf->len += payload_len;
             LOG(INFO, "Segmentation complete len=%d seg_len=%d dest_ref=%d",
-                    payload_len, conn->seg_len, dest_ref);
+                    payload_len, buf->len, dest_ref);
             // TODO: prio, qos
 
             memcpy(&tpol_tsdu.addr, &hdlc_fr->addr, sizeof(tpol_tsdu.addr));
-            tpol_tsdu.data_len = conn->seg_len;
-            tpol_tsdu.data = conn->segbuf;
-            tetrapol_evt_tsdu(tpdu->tpol, &tpol_tsdu);
+            tpol_tsdu.data_len = buf->len;
+            tpol_tsdu.data = buf->data;
+            tsdu_deliver(tpdu->tpol, &tpol_tsdu, NULL);
 
-            conn->seg_len = 0;
+            seg_buf_release(tpdu, conn);
         } else {
+            // drop buffer with empty segments
+            if (buf) {
+                seg_buf_release(tpdu, conn);
+            }
             if (d) {
                 // TODO: prio, qos
 
                 memcpy(&tpol_tsdu.addr, &hdlc_fr->addr, sizeof(tpol_tsdu.addr));
                 tpol_tsdu.data_len = payload_len;
                 tpol_tsdu.data = payload;
-                tetrapol_evt_tsdu(tpdu->tpol, &tpol_tsdu);
+                tsdu_deliver(tpdu->tpol, &tpol_tsdu, NULL);
             }
         }
     }
@@ -353,7 +482,7 @@ int tpdu_push_hdlc_frame(tpdu_t *tpdu, const hdlc_frame_t *hdlc_fr)
             case TPDU_CODE_DR:
             case TPDU_CODE_FDR:
             case TPDU_CODE_DC:
-                connection_reset(conn);
+                connection_reset(tpdu, conn);
                 break;
 
             case TPDU_CODE_DT:
@@ -370,15 +499,79 @@ int tpdu_push_hdlc_frame(tpdu_t *tpdu, const hdlc_frame_t *hdlc_fr)
 
 void tpdu_destroy(tpdu_t *tpdu)
 {
+    if (!tpdu) {
+        return;
+    }
+    while (tpdu->seg_bufs) {
+        seg_buf_release(tpdu, &tpdu->conns[tpdu->seg_bufs->conn]);
+    }
     free(tpdu);
 }
 
-static void tpdu_ui_segments_destroy(segmented_du_t *du)
+tpdu_pool_t *tpdu_pool_create(void)
+{
+    tpdu_pool_t *pool = calloc(1, sizeof(tpdu_pool_t));
+    if (!pool) {
+        return NULL;
+    }
+
+    pool->dus = slab_create(sizeof(segmented_du_t), TPDU_POOL_CHUNK_DUS);
+    pool->segments = slab_create(sizeof(du_segment_t),
+            TPDU_POOL_CHUNK_SEGMENTS);
+    pool->seg_bufs = slab_create(sizeof(seg_buf_t), TPDU_POOL_CHUNK_SEG_BUFS);
+    if (!pool->dus || !pool->segments || !pool->seg_bufs) {
+        tpdu_pool_destroy(pool);
+        return NULL;
+    }
+
+    return pool;
+}
+
+void tpdu_pool_destroy(tpdu_pool_t *pool)
 {
-    for (int i = 0; i < SYS_PAR_N452; ++i) {
-        free(du->hdlc_frs[i]);
+    if (!pool) {
+        return;
     }
-    free(du);
+    slab_destroy(pool->dus);
+    slab_destroy(pool->segments);
+    slab_destroy(pool->seg_bufs);
+    free(pool);
+}
+
+static void seg_du_unlink(tpdu_ui_t *tpdu, segmented_du_t *du)
+{
+    if (du->prev) {
+        du->prev->next = du->next;
+    } else {
+        tpdu->seg_du_first = du->next;
+    }
+    if (du->next) {
+        du->next->prev = du->prev;
+    } else {
+        tpdu->seg_du_last = du->prev;
+    }
+}
+
+static void seg_du_append(tpdu_ui_t *tpdu, segmented_du_t *du)
+{
+    du->prev = tpdu->seg_du_last;
+    du->next = NULL;
+    if (tpdu->seg_du_last) {
+        tpdu->seg_du_last->next = du;
+    } else {
+        tpdu->seg_du_first = du;
+    }
+    tpdu->seg_du_last = du;
+}
+
+static void seg_du_destroy(tpdu_ui_t *tpdu, segmented_du_t *du)
+{
+    tpdu_pool_t *pool = tpdu->tpol->tpdu_pool;
+    for (uint64_t received = du->received; received; received &= received - 1) {
+        slab_free(pool->segments, du->segs[__builtin_ctzll(received)]);
+    }
+    seg_du_unlink(tpdu, du);
+    slab_free(pool->dus, du);
 }
 
 tpdu_ui_t *tpdu_ui_create(tpol_t *tpol, frame_type_t fr_type, int log_ch)
@@ -401,11 +594,8 @@ tpdu_ui_t *tpdu_ui_create(tpol_t *tpol, frame_type_t fr_type, int log_ch)
 
 void tpdu_ui_destroy(tpdu_ui_t *tpdu)
 {
-    for (int i = 0; i < ARRAY_LEN(tpdu->seg_du); ++i) {
-        if (!tpdu->seg_du[i]) {
-            continue;
-        }
-        tpdu_ui_segments_destroy(tpdu->seg_du[i]);
+    while (tpdu->seg_du_first) {
+        seg_du_destroy(tpdu, tpdu->seg_du_first);
     }
     free(tpdu);
 }
@@ -422,18 +612,20 @@ static int tpdu_ui_push_hdlc_frame_(tpdu_ui_t *tpdu,
         return -1;
     }
 
-    bool ext                    = get_bits(1, hdlc_fr->data, 0);
-    const bool seg              = get_bits(1, hdlc_fr->data, 1);
-    const uint8_t prio          = get_bits(2, hdlc_fr->data, 2);
-    const uint8_t id_tsap       = get_bits(4, hdlc_fr->data, 4);
+    bit_reader_t br;
+    br_init(&br, hdlc_fr->data, sizeof(hdlc_fr->data));
+    bool ext                    = br_read(&br, 1);
+    const bool seg              = br_read(&br, 1);
+    const uint8_t prio          = br_read(&br, 2);
+    const uint8_t id_tsap       = br_read(&br, 4);
 
     tpol_tsdu_t tpol_tsdu;
-    tpol_tsdu.tpdu_type = TPDU_TYPE_TPDU_UI;
+    tpol_tsdu.tpdu_type = TETRAPOL_TPDU_TYPE_TPDU_UI;
     tpol_tsdu.log_ch = tpdu->log_ch;
     tpol_tsdu.prio = prio;
     tpol_tsdu.tsap_id = id_tsap;
-    tpol_tsdu.tsap_ref_swmi = TSAP_REF_UNKNOWN;
-    tpol_tsdu.tsap_ref_rt = TSAP_REF_UNKNOWN;
+    tpol_tsdu.tsap_ref_swmi = TETRAPOL_TSAP_REF_UNKNOWN;
+    tpol_tsdu.tsap_ref_rt = TETRAPOL_TSAP_REF_UNKNOWN;
 
     LOG(DBG, "DU EXT=%d SEG=%d PRIO=%d ID_TSAP=%d", ext, seg, prio, id_tsap);
     if (ext == 0 && seg == 0) {
@@ -441,29 +633,23 @@ static int tpdu_ui_push_hdlc_frame_(tpdu_ui_t *tpdu,
         if ((tpdu->fr_type == FRAME_TYPE_DATA && hdlc_fr->nbits > (3*8)) ||
                 (tpdu->fr_type == FRAME_TYPE_HR_DATA &&
                  hdlc_fr->nbits > (6*8))) {
-            const int len = get_bits(8, hdlc_fr->data + 1, 0);
+            const int len = br_read(&br, 8);
 
             memcpy(&tpol_tsdu.addr, &hdlc_fr->addr, sizeof(tpol_tsdu.addr));
             tpol_tsdu.data_len = len;
             tpol_tsdu.data = hdlc_fr->data + 2;
-            tetrapol_evt_tsdu(tpdu->tpol, &tpol_tsdu);
+            const int ret = tsdu_deliver(tpdu->tpol, &tpol_tsdu, tsdu);
 
-            if (tsdu) {
-                return tsdu_decode(hdlc_fr->data + 2, len, tsdu);
-            }
-            return 0;
+            return tsdu ? ret : 0;
         }
         const int len = hdlc_fr->nbits / 8 - 1;
 
         memcpy(&tpol_tsdu.addr, &hdlc_fr->addr, sizeof(tpol_tsdu.addr));
         tpol_tsdu.data_len = len;
         tpol_tsdu.data = hdlc_fr->data + 1;
-        tetrapol_evt_tsdu(tpdu->tpol, &tpol_tsdu);
+        const int ret = tsdu_deliver(tpdu->tpol, &tpol_tsdu, tsdu);
 
-        if (tsdu) {
-            return tsdu_decode(hdlc_fr->data + 1, len, tsdu);
-        }
-        return 0;
+        return tsdu ? ret : 0;
     }
 
     if (ext != 1) {
@@ -476,16 +662,16 @@ static int tpdu_ui_push_hdlc_frame_(tpdu_ui_t *tpdu,
         return -1;
     }
 
-    ext                         = get_bits(1, hdlc_fr->data + 1, 0);
-    uint8_t seg_ref             = get_bits(7, hdlc_fr->data + 1, 1);
+    ext                         = br_read(&br, 1);
+    uint8_t seg_ref             = br_read(&br, 7);
     if (!ext) {
         LOG(WTF, "unsupported short ext");
         return -1;
     }
 
-    ext                         = get_bits(1, hdlc_fr->data + 2, 0);
-    const bool res              = get_bits(1, hdlc_fr->data + 2, 1);
-    const uint8_t packet_num    = get_bits(6, hdlc_fr->data + 2, 2);
+    ext                         = br_read(&br, 1);
+    const bool res              = br_read(&br, 1);
+    const uint8_t packet_num    = br_read(&br, 6);
     if (ext) {
         LOG(WTF, "unsupported long ext");
         return -1;
@@ -496,36 +682,68 @@ static int tpdu_ui_push_hdlc_frame_(tpdu_ui_t *tpdu,
     }
     LOG(DBG, "UI SEGM_REF=%d, PACKET_NUM=%d", seg_ref, packet_num);
 
-    segmented_du_t *seg_du = tpdu->seg_du[seg_ref];
-    if (seg_du == NULL) {
-        seg_du = calloc(1, sizeof(segmented_du_t));
-        if (!seg_du) {
-            return -1;
-        }
-        tpdu->seg_du[seg_ref] = seg_du;
-        seg_du->id_tsap = id_tsap;
-        seg_du->prio = prio;
+    // only few DUs are pending, the last active is the most likely
+    segmented_du_t *seg_du = tpdu->seg_du_last;
+    while (seg_du && seg_du->seg_ref != seg_ref) {
+        seg_du = seg_du->prev;
     }
-
-    if (seg_du->hdlc_frs[packet_num]) {
+    if (seg_du && (seg_du->received & (1ull << packet_num))) {
         // segment already recieved
         return 0;
     }
 
-    seg_du->hdlc_frs[packet_num] = malloc(sizeof(hdlc_frame_t));
-    if (!seg_du->hdlc_frs[packet_num]) {
-        LOG(ERR, "ERR OOM");
+    // only payload of segment is kept
+    const int hdr_len = TPDU_UI_SEG_HDR_LEN + (seg ? 0 : 1);
+    int len = hdlc_fr->nbits / 8 - hdr_len;
+    if (!seg) {
+        const int n = hdlc_fr->data[TPDU_UI_SEG_HDR_LEN];
+        if (n > hdlc_fr->nbits / 8) {
+            LOG(WTF, "hdlc_fr.len=%d < tsdu_payload_len=%d",
+                    hdlc_fr->nbits / 8, n);
+            return -1;
+        }
+        len = n;
+    }
+    if (len < 0 || tpdu->fr_type != FRAME_TYPE_DATA) {
+        len = 0;
+    }
+    if (len > (int)sizeof(hdlc_fr->data) - hdr_len) {
+        len = sizeof(hdlc_fr->data) - hdr_len;
+    }
+
+    tpdu_pool_t *pool = tpdu->tpol->tpdu_pool;
+    du_segment_t *segment = slab_alloc(pool->segments);
+    if (!segment) {
         return -1;
     }
-    memcpy(seg_du->hdlc_frs[packet_num], hdlc_fr, sizeof(hdlc_frame_t));
+    segment->len = len;
+    memcpy(segment->data, &hdlc_fr->data[hdr_len], len);
+
+    if (seg_du == NULL) {
+        seg_du = slab_alloc(pool->dus);
+        if (!seg_du) {
+            slab_free(pool->segments, segment);
+            return -1;
+        }
+        seg_du->received = 0;
+        seg_du->seg_ref = seg_ref;
+        seg_du->id_tsap = id_tsap;
+        seg_du->prio = prio;
+        seg_du->nsegments = 0;
+    } else {
+        seg_du_unlink(tpdu, seg_du);
+    }
+    seg_du->segs[packet_num] = segment;
+    seg_du->received |= 1ull << packet_num;
 
     if (seg == 0) {
         seg_du->nsegments = packet_num + 1;
     }
 
-    // reset T454 timer
+    // reset T454 timer, DU is moved to the end of list
     seg_du->tv.tv_sec = 0;
     seg_du->tv.tv_usec = 0;
+    seg_du_append(tpdu, seg_du);
 
     // last segment is still missing
     if (!seg_du->nsegments) {
@@ -533,57 +751,38 @@ static int tpdu_ui_push_hdlc_frame_(tpdu_ui_t *tpdu,
     }
 
     // check if we have all segments
-    for (int i = 0; i < seg_du->nsegments; ++i) {
-        if (!seg_du->hdlc_frs[i]) {
-            return 0;
-        }
+    const uint64_t all = (seg_du->nsegments == 64) ?
+        UINT64_MAX : (1ull << seg_du->nsegments) - 1;
+    if ((seg_du->received & all) != all) {
+        return 0;
     }
 
-    // max_segments * (sizeof(hdlc_frame_t->data) - TPDU_DU_header)
-    uint8_t data[SYS_PAR_N452 * (sizeof(((hdlc_frame_t*)NULL)->data) - 3)];
     int data_len = 0;
-    // collect data from all segments
     if (tpdu->fr_type == FRAME_TYPE_DATA) {
-        uint8_t *d = data;
         for (int i = 0; i < seg_du->nsegments; ++i) {
-            hdlc_frame_t *hfr = seg_du->hdlc_frs[i];
-            int n_ext = 1;
-            // skip ext headers
-            while (get_bits(1, hfr->data + n_ext - 1, 0)) {
-                ++n_ext;
-            }
-            int n;
-            if (i == (seg_du->nsegments - 1)) {
-                n = hfr->data[n_ext++];
-                if (n > hfr->nbits / 8) {
-                    LOG(WTF, "hdlc_fr.len=%d < tsdu_payload_len=%d",
-                            hfr->nbits / 8, n);
-                    return -1;
-                }
-            } else {
-                n = (hfr->nbits / 8) - n_ext;
-            }
-            data_len += n;
-            memcpy(d, &hfr->data[n_ext], n);
-            d += n;
+            data_len += seg_du->segs[i]->len;
         }
     } else {    // FRAME_TYPE_HR_DATA
         LOG(WTF, "FRAME_TYPE_HR_DATA not implemented");
         // TODO
     }
 
-    tpdu_ui_segments_destroy(seg_du);
-    tpdu->seg_du[seg_ref] = NULL;
+    // gather payload of segments into TSDU
+    uint8_t data[data_len ? data_len : 1];
+    uint8_t *d = data;
+    for (int i = 0; i < seg_du->nsegments && data_len; ++i) {
+        memcpy(d, seg_du->segs[i]->data, seg_du->segs[i]->len);
+        d += seg_du->segs[i]->len;
+    }
+
+    seg_du_destroy(tpdu, seg_du);
 
     memcpy(&tpol_tsdu.addr, &hdlc_fr->addr, sizeof(tpol_tsdu.addr));
     tpol_tsdu.data_len = data_len;
     tpol_tsdu.data = data;
-    tetrapol_evt_tsdu(tpdu->tpol, &tpol_tsdu);
+    const int ret = tsdu_deliver(tpdu->tpol, &tpol_tsdu, tsdu);
 
-    if (tsdu) {
-        return tsdu_decode(data, data_len, tsdu);
-    }
-    return 0;
+    return tsdu ? ret : 0;
 }
 
 int tpdu_ui_push_hdlc_frame(tpdu_ui_t *tpdu, const hdlc_frame_t *hdlc_fr,
@@ -607,28 +806,28 @@ void tpdu_rx_glitch(tpdu_t *tpdu)
     }
 }
 
-void tpdu_du_tick(time_evt_t *te, void *tpdu_du)
+int tpdu_du_tick(time_evt_t *te, void *tpdu_du)
 {
     tpdu_ui_t *tpdu = tpdu_du;
 
-    // set/check T454 timer
-    for (int i = 0; i < ARRAY_LEN(tpdu->seg_du); ++i) {
-        if (!tpdu->seg_du[i]) {
-            continue;
-        }
-
-        if (!tpdu->seg_du[i]->tv.tv_sec && !tpdu->seg_du[i]->tv.tv_usec) {
-            tpdu->seg_du[i]->tv.tv_sec = te->tv.tv_sec;
-            tpdu->seg_du[i]->tv.tv_usec = te->tv.tv_usec;
-            continue;
-        }
+    // start T454 for DUs with new segments, they are at the end of list
+    for (segmented_du_t *du = tpdu->seg_du_last;
+            du && !du->tv.tv_sec && !du->tv.tv_usec; du = du->prev) {
+        du->tv.tv_sec = te->tv.tv_sec;
+        du->tv.tv_usec = te->tv.tv_usec;
+    }
 
-        if (timeval_abs_delta(&tpdu->seg_du[i]->tv, &te->tv) < SYS_PAR_T454) {
-            continue;
+    // check T454 timer, the oldest DU is first
+    while (tpdu->seg_du_first) {
+        const int left = SYS_PAR_T454 -
+            timeval_abs_delta(&tpdu->seg_du_first->tv, &te->tv);
+        if (left > 0) {
+            return left;
         }
 
         // TODO: report error to application layer
-        tpdu_ui_segments_destroy(tpdu->seg_du[i]);
-        tpdu->seg_du[i] = NULL;
+        seg_du_destroy(tpdu, tpdu->seg_du_first);
     }
+
+    return -1;
 }
@@ -10,10 +10,10 @@
 #include <stdlib.h>
 #include <string.h>
 
-#define CHECK_LEN(len, min_len, tsdu) \
+#define CHECK_LEN(len, min_len, tsdu, arena) \
     if ((len) < (min_len)) { \
         LOG(ERR, "data too short %d < %d", (len), (min_len)); \
-        tsdu_destroy((tsdu_base_t *)tsdu); \
+        tsdu_release((tsdu_base_t *)(tsdu), (arena)); \
         return NULL; \
     }
 
@@ -33,12 +33,12 @@ static void tsdu_base_set_nopts(tsdu_base_t *tsdu, int noptionals)
     memset(tsdu->optionals, 0, sizeof(void *[noptionals]));
 }
 
-#define tsdu_create(TSDU_TYPE, noptionals) \
-    (TSDU_TYPE *) tsdu_create_(sizeof(TSDU_TYPE), noptionals)
+#define tsdu_create(arena, TSDU_TYPE, noptionals) \
+    (TSDU_TYPE *) tsdu_create_(arena, sizeof(TSDU_TYPE), noptionals)
 
-static tsdu_t *tsdu_create_(int size, int noptionals)
+static tsdu_t *tsdu_create_(tsdu_arena_t *arena, int size, int noptionals)
 {
-    tsdu_t *tsdu = malloc(size);
+    tsdu_t *tsdu = tsdu_arena_alloc(arena, size);
     if (!tsdu) {
         return NULL;
     }
@@ -57,21 +57,31 @@ void tsdu_destroy(tsdu_base_t *tsdu)
     free(tsdu);
 }
 
-static void activation_mode_decode(activation_mode_t *am, uint8_t data)
+/// release TSDU when decoding fails, TSDU in arena is released by reset
+static void tsdu_release(tsdu_base_t *tsdu, tsdu_arena_t *arena)
 {
-    am->hook = get_bits(2, &data, 0);
-    am->type = get_bits(2, &data, 2);
+    if (!arena) {
+        tsdu_destroy(tsdu);
+    }
 }
 
-static void cell_id_decode1(cell_id_t *cell_id, const uint8_t *data)
+static void activation_mode_decode(activation_mode_t *am, bit_reader_t *br)
 {
-    int type = get_bits(2, data, 0);
+    am->hook = br_read(br, 2);
+    am->type = br_read(br, 2);
+}
+
+static void cell_id_decode1(cell_id_t *cell_id, bit_reader_t *br)
+{
+    const int type = br_read(br, 2);
+    const int id6 = br_read(br, 6);
+    const int id4 = br_read(br, 4);
     if (type == CELL_ID_FORMAT_0) {
-        cell_id->bs_id = get_bits(6, data, 2);
-        cell_id->rsw_id = get_bits(4, data, 8);
+        cell_id->bs_id = id6;
+        cell_id->rsw_id = id4;
     } else if (type == CELL_ID_FORMAT_1) {
-        cell_id->bs_id = get_bits(4, data, 8);
-        cell_id->rsw_id = get_bits(6, data, 2);
+        cell_id->bs_id = id4;
+        cell_id->rsw_id = id6;
     } else {
         LOG(WTF, "unknown cell_id_type (%d)", type);
         cell_id->bs_id = -1;
@@ -80,15 +90,18 @@ static void cell_id_decode1(cell_id_t *cell_id, const uint8_t *data)
 }
 
 // specific for d_system_info - cell in offline mode
-static void cell_id_decode2(cell_id_t *cell_id, const uint8_t *data)
+static void cell_id_decode2(cell_id_t *cell_id, bit_reader_t *br)
 {
-    int type = get_bits(2, data, 8);
+    br_skip(br, 4);
+    const int id4 = br_read(br, 4);
+    const int type = br_read(br, 2);
+    const int id6 = br_read(br, 6);
     if (type == CELL_ID_FORMAT_0) {
-        cell_id->bs_id = get_bits(6, data, 10);
-        cell_id->rsw_id = get_bits(4, data, 4);;
+        cell_id->bs_id = id6;
+        cell_id->rsw_id = id4;
     } else if (type == CELL_ID_FORMAT_1) {
-        cell_id->bs_id = get_bits(4, data, 4);;
-        cell_id->rsw_id = get_bits(6, data, 10);;
+        cell_id->bs_id = id4;
+        cell_id->rsw_id = id6;
     } else {
         LOG(WTF, "unknown cell_id_type (%d)", type);
         cell_id->bs_id = -1;
@@ -97,13 +110,15 @@ static void cell_id_decode2(cell_id_t *cell_id, const uint8_t *data)
 }
 
 static tsdu_d_authentication_t *
-d_authentication_decode(const uint8_t *data, int len)
+d_authentication_decode(const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
-    tsdu_d_authentication_t *tsdu = tsdu_create(tsdu_d_authentication_t, 0);
+    tsdu_d_authentication_t *tsdu =
+        tsdu_create(arena, tsdu_d_authentication_t, 0);
     if (!tsdu) {
         return NULL;
     }
-    CHECK_LEN(len, 16, tsdu);
+    CHECK_LEN(len, 16, tsdu, arena);
 
     tsdu->key_reference._data = data[1];
     memcpy(tsdu->valid_rt, &data[2], sizeof(tsdu->valid_rt));
@@ -112,11 +127,12 @@ d_authentication_decode(const uint8_t *data, int len)
 }
 
 static tsdu_d_crisis_notification_t *d_crisis_notification_decode(
-        const uint8_t *data, int len)
+        const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
-    CHECK_LEN(len, 10, NULL);
+    CHECK_LEN(len, 10, NULL, arena);
 
-    tsdu_d_crisis_notification_t *tsdu = tsdu_create(
+    tsdu_d_crisis_notification_t *tsdu = tsdu_create(arena,
             tsdu_d_crisis_notification_t, 0);
     if (!tsdu) {
         return NULL;
@@ -131,55 +147,68 @@ static tsdu_d_crisis_notification_t *d_crisis_notification_decode(
     if (data[8]) {
         LOG(WTF, "Crisis - nonzero undocumented field=0x%02x", data[8]);
     }
-    tsdu->og_nb = get_bits(4, &data[9], 0);
+    bit_reader_t br;
+    br_init(&br, data, len);
+    br_seek(&br, 9 * 8);
+    tsdu->og_nb = br_read(&br, 4);
     if (tsdu->og_nb > 5) {
         LOG(WTF, "Too large OG_NB %d", tsdu->og_nb);
-        tsdu_destroy(&tsdu->base);
+        tsdu_release(&tsdu->base, arena);
         return NULL;
     }
-    CHECK_LEN(len, 10 + (12 * tsdu->og_nb) / 12, tsdu);
     for (int i = 0; i < tsdu->og_nb; ++i) {
-        tsdu->group_ids[i] = get_bits(12, &data[9], 4 + 12*i);
+        tsdu->group_ids[i] = br_read(&br, 12);
+    }
+    if (br_overflow(&br)) {
+        LOG(ERR, "data too short %d < %d", len, (br.pos + 7) / 8);
+        tsdu_release(&tsdu->base, arena);
+        return NULL;
     }
 
     return tsdu;
 }
 
-static tsdu_d_group_reject_t *d_group_reject_decode(const uint8_t *data, int len)
+static tsdu_d_group_reject_t *d_group_reject_decode(
+        const uint8_t *data, int len, tsdu_arena_t *arena)
 {
-    CHECK_LEN(len, 6, NULL);
+    CHECK_LEN(len, 6, NULL, arena);
 
-    tsdu_d_group_reject_t *tsdu = tsdu_create(tsdu_d_group_reject_t, 0);
+    tsdu_d_group_reject_t *tsdu = tsdu_create(arena, tsdu_d_group_reject_t, 0);
     if (!tsdu) {
         return NULL;
     }
 
-    activation_mode_decode(&tsdu->activation_mode, data[1]);
-    tsdu->group_id  = get_bits(12, data + 1, 4);
-    tsdu->coverage_id = data[3];
-    tsdu->_zero = data[4];
+    bit_reader_t br;
+    br_init(&br, data, len);
+    br_skip(&br, 8);
+    activation_mode_decode(&tsdu->activation_mode, &br);
+    tsdu->group_id  = br_read(&br, 12);
+    tsdu->coverage_id = br_read(&br, 8);
+    tsdu->_zero = br_read(&br, 8);
     if (tsdu->_zero) {
         LOG(WTF, "Nonzero zero=0x%02x", tsdu->_zero);
     }
-    tsdu->cause = data[5];
+    tsdu->cause = br_read(&br, 8);
 
     return tsdu;
 }
 
-static tsdu_d_cch_open_t *d_cch_open_decode(const uint8_t *data, int len)
+static tsdu_d_cch_open_t *d_cch_open_decode(const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
     if (len != 1) {
         LOG(WTF, "Invalid len 1 != %d", len);
         return NULL;
     }
-    return tsdu_create(tsdu_d_cch_open_t, 0);
+    return tsdu_create(arena, tsdu_d_cch_open_t, 0);
 }
 
-static tsdu_d_refusal_t *d_refusal_decode(const uint8_t *data, int len)
+static tsdu_d_refusal_t *d_refusal_decode(const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
-    CHECK_LEN(len, 2, NULL);
+    CHECK_LEN(len, 2, NULL, arena);
 
-    tsdu_d_refusal_t *tsdu = tsdu_create(tsdu_d_refusal_t, 0);
+    tsdu_d_refusal_t *tsdu = tsdu_create(arena, tsdu_d_refusal_t, 0);
     if (!tsdu) {
         return NULL;
     }
@@ -188,11 +217,12 @@ static tsdu_d_refusal_t *d_refusal_decode(const uint8_t *data, int len)
     return tsdu;
 }
 
-static tsdu_d_reject_t *d_reject_decode(const uint8_t *data, int len)
+static tsdu_d_reject_t *d_reject_decode(const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
-    CHECK_LEN(len, 2, NULL);
+    CHECK_LEN(len, 2, NULL, arena);
 
-    tsdu_d_reject_t *tsdu = tsdu_create(tsdu_d_reject_t, 0);
+    tsdu_d_reject_t *tsdu = tsdu_create(arena, tsdu_d_reject_t, 0);
     if (!tsdu) {
         return NULL;
     }
@@ -201,17 +231,20 @@ static tsdu_d_reject_t *d_reject_decode(const uint8_t *data, int len)
     return tsdu;
 }
 
-static tsdu_d_call_alert_t *d_call_alert_decode(const uint8_t *data, int len)
+static tsdu_d_call_alert_t *d_call_alert_decode(const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
-    return tsdu_create(tsdu_d_call_alert_t, 0);
+    return tsdu_create(arena, tsdu_d_call_alert_t, 0);
 }
 
 static tsdu_d_hook_on_invitation_t *d_hook_on_invitation_decode(
-        const uint8_t *data, int len)
+        const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
-    CHECK_LEN(len, 2, NULL);
+    CHECK_LEN(len, 2, NULL, arena);
 
-    tsdu_d_hook_on_invitation_t *tsdu = tsdu_create(tsdu_d_hook_on_invitation_t, 0);
+    tsdu_d_hook_on_invitation_t *tsdu =
+        tsdu_create(arena, tsdu_d_hook_on_invitation_t, 0);
     if (!tsdu) {
         return NULL;
     }
@@ -220,11 +253,12 @@ static tsdu_d_hook_on_invitation_t *d_hook_on_invitation_decode(
     return tsdu;
 }
 
-static tsdu_d_release_t *d_release_decode(const uint8_t *data, int len)
+static tsdu_d_release_t *d_release_decode(const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
-    CHECK_LEN(len, 2, NULL);
+    CHECK_LEN(len, 2, NULL, arena);
 
-    tsdu_d_release_t *tsdu = tsdu_create(tsdu_d_release_t, 0);
+    tsdu_d_release_t *tsdu = tsdu_create(arena, tsdu_d_release_t, 0);
     if (!tsdu) {
         return NULL;
     }
@@ -234,32 +268,33 @@ static tsdu_d_release_t *d_release_decode(const uint8_t *data, int len)
 }
 
 static tsdu_d_additional_participants_t *d_additional_participants_decode(
-        const uint8_t *data, int len)
+        const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
-    CHECK_LEN(len, 7, NULL);
+    CHECK_LEN(len, 7, NULL, arena);
 
-    tsdu_d_additional_participants_t *tsdu = tsdu_create(
+    tsdu_d_additional_participants_t *tsdu = tsdu_create(arena,
             tsdu_d_additional_participants_t, 1);
     if (!tsdu) {
         return NULL;
     }
 
     tsdu->coverage_id = data[1];
-    if (address_list_decode(&tsdu->calling_adr, &data[2]) == -1) {
-        tsdu_destroy(&tsdu->base);
+    if (address_list_decode(&tsdu->calling_adr, &data[2], arena) == -1) {
+        tsdu_release(&tsdu->base, arena);
         return NULL;
     }
 
     if (len >= 8) {
-        if (address_list_decode(&tsdu->calling_adr, &data[7]) == -1) {
-            tsdu_destroy(&tsdu->base);
+        if (address_list_decode(&tsdu->calling_adr, &data[7], arena) == -1) {
+            tsdu_release(&tsdu->base, arena);
             return NULL;
         }
     }
 
     if (len >= 13) {
-        if (address_list_decode(&tsdu->calling_adr, &data[12]) == -1) {
-            tsdu_destroy(&tsdu->base);
+        if (address_list_decode(&tsdu->calling_adr, &data[12], arena) == -1) {
+            tsdu_release(&tsdu->base, arena);
             return NULL;
         }
     }
@@ -267,11 +302,12 @@ static tsdu_d_additional_participants_t *d_additional_participants_decode(
     return tsdu;
 }
 
-static tsdu_d_call_setup_t *d_call_setup_decode(const uint8_t *data, int len)
+static tsdu_d_call_setup_t *d_call_setup_decode(const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
-    CHECK_LEN(len, 6, NULL);
+    CHECK_LEN(len, 6, NULL, arena);
 
-    tsdu_d_call_setup_t *tsdu = tsdu_create(tsdu_d_call_setup_t, 0);
+    tsdu_d_call_setup_t *tsdu = tsdu_create(arena, tsdu_d_call_setup_t, 0);
     if (!tsdu) {
         return NULL;
     }
@@ -294,14 +330,15 @@ static tsdu_d_call_setup_t *d_call_setup_decode(const uint8_t *data, int len)
     return tsdu;
 }
 
-static tsdu_d_ability_mngt_t *d_ability_mngt_decode(const uint8_t *data, int len)
+static tsdu_d_ability_mngt_t *d_ability_mngt_decode(
+        const uint8_t *data, int len, tsdu_arena_t *arena)
 {
     if (len - 1 > SIZEOF(tsdu_d_ability_mngt_t, data)) {
         LOG(WTF, "Message too long %d", len - 1);
         return NULL;
     }
 
-    tsdu_d_ability_mngt_t *tsdu = tsdu_create(tsdu_d_ability_mngt_t, 0);
+    tsdu_d_ability_mngt_t *tsdu = tsdu_create(arena, tsdu_d_ability_mngt_t, 0);
     if (!tsdu) {
         return NULL;
     }
@@ -312,21 +349,23 @@ static tsdu_d_ability_mngt_t *d_ability_mngt_decode(const uint8_t *data, int len
     return tsdu;
 }
 
-static tsdu_d_dch_open_t *d_dch_open_decode(const uint8_t *data, int len)
+static tsdu_d_dch_open_t *d_dch_open_decode(const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
     if (len != 1) {
         LOG(WTF, "Invalid len 1 != %d", len);
         return NULL;
     }
 
-    return tsdu_create(tsdu_d_dch_open_t, 0);
+    return tsdu_create(arena, tsdu_d_dch_open_t, 0);
 }
 
-static tsdu_d_data_request_t *d_data_request_decode(const uint8_t *data, int len)
+static tsdu_d_data_request_t *d_data_request_decode(
+        const uint8_t *data, int len, tsdu_arena_t *arena)
 {
-    CHECK_LEN(len, 16, NULL);
+    CHECK_LEN(len, 16, NULL, arena);
 
-    tsdu_d_data_request_t *tsdu = tsdu_create(tsdu_d_data_request_t, 0);
+    tsdu_d_data_request_t *tsdu = tsdu_create(arena, tsdu_d_data_request_t, 0);
     if (!tsdu) {
         return NULL;
     }
@@ -334,33 +373,39 @@ static tsdu_d_data_request_t *d_data_request_decode(const uint8_t *data, int len
     tsdu->key_reference_auth._data = data[1];
     memcpy(tsdu->valid_rt, &data[2], sizeof(tsdu->valid_rt));
     tsdu->key_reference_ciph._data = data[10];
-    tsdu->trans_mode =      get_bits(4, &data[11], 4);
-    tsdu->trans_param1 =    get_bits(16, &data[12], 0);
-    tsdu->trans_param2 =    get_bits(16, &data[14], 0);
+    bit_reader_t br;
+    br_init(&br, data, len);
+    br_seek(&br, 11 * 8 + 4);
+    tsdu->trans_mode =      br_read(&br, 4);
+    tsdu->trans_param1 =    br_read(&br, 16);
+    tsdu->trans_param2 =    br_read(&br, 16);
     tsdu->has_trans_param3 = (tsdu->trans_mode == TRANS_MODE_UDP_MSG);
     if (tsdu->has_trans_param3) {
-        CHECK_LEN(len, 18, tsdu);
-        tsdu->trans_param3 = get_bits(16, &data[16], 0);
+        CHECK_LEN(len, 18, tsdu, arena);
+        tsdu->trans_param3 = br_read(&br, 16);
     }
     return tsdu;
 }
 
-static tsdu_d_connect_cch_t *d_connect_cch_decode(const uint8_t *data, int len)
+static tsdu_d_connect_cch_t *d_connect_cch_decode(const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
     if (len != 1) {
         LOG(WTF, "Invalid len 1 != %d", len);
         return NULL;
     }
 
-    return tsdu_create(tsdu_d_connect_cch_t, 0);
+    return tsdu_create(arena, tsdu_d_connect_cch_t, 0);
 }
 
 static tsdu_d_data_authentication_t *d_data_authentication_decode(
-        const uint8_t *data, int len)
+        const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
-    CHECK_LEN(len, 11, NULL);
+    CHECK_LEN(len, 11, NULL, arena);
 
-    tsdu_d_data_authentication_t *tsdu = tsdu_create(tsdu_d_data_authentication_t, 0);
+    tsdu_d_data_authentication_t *tsdu =
+        tsdu_create(arena, tsdu_d_data_authentication_t, 0);
     if (!tsdu) {
         return NULL;
     }
@@ -371,7 +416,8 @@ static tsdu_d_data_authentication_t *d_data_authentication_decode(
     return tsdu;
 }
 
-static tsdu_d_data_msg_down_t *d_data_msg_down_decode(const uint8_t *data, int len)
+static tsdu_d_data_msg_down_t *d_data_msg_down_decode(
+        const uint8_t *data, int len, tsdu_arena_t *arena)
 {
     if (len - 1 > SIZEOF(tsdu_d_data_msg_down_t, data)) {
         LOG(WTF, "Message too large %d > %d",
@@ -379,7 +425,8 @@ static tsdu_d_data_msg_down_t *d_data_msg_down_decode(const uint8_t *data, int l
         return NULL;
     }
 
-    tsdu_d_data_msg_down_t *tsdu = tsdu_create(tsdu_d_data_msg_down_t, 0);
+    tsdu_d_data_msg_down_t *tsdu =
+        tsdu_create(arena, tsdu_d_data_msg_down_t, 0);
     if (!tsdu) {
         return NULL;
     }
@@ -391,13 +438,15 @@ static tsdu_d_data_msg_down_t *d_data_msg_down_decode(const uint8_t *data, int l
 }
 
 static tsdu_d_authorisation_t *
-d_authorisation_decode(const uint8_t *data, int len)
+d_authorisation_decode(const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
-    tsdu_d_authorisation_t *tsdu = tsdu_create(tsdu_d_authorisation_t, 0);
+    tsdu_d_authorisation_t *tsdu =
+        tsdu_create(arena, tsdu_d_authorisation_t, 0);
     if (!tsdu) {
         return NULL;
     }
-    CHECK_LEN(len, 8, tsdu);
+    CHECK_LEN(len, 8, tsdu, arena);
 
     tsdu->has_key_reference = (data[1] == IEI_KEY_REFERENCE);
     if (tsdu->has_key_reference) {
@@ -407,30 +456,36 @@ d_authorisation_decode(const uint8_t *data, int len)
     return tsdu;
 }
 
-static tsdu_d_group_paging_t *d_group_paging_decode(const uint8_t *data, int len)
+static tsdu_d_group_paging_t *d_group_paging_decode(
+        const uint8_t *data, int len, tsdu_arena_t *arena)
 {
-    tsdu_d_group_paging_t *tsdu = tsdu_create(tsdu_d_group_paging_t, 0);
+    tsdu_d_group_paging_t *tsdu = tsdu_create(arena, tsdu_d_group_paging_t, 0);
     if (!tsdu) {
         return NULL;
     }
-    CHECK_LEN(len, 5, tsdu);
+    CHECK_LEN(len, 5, tsdu, arena);
 
-    activation_mode_decode(&tsdu->activation_mode, data[1]);
-    tsdu->group_id              = get_bits(12, &data[1], 4);
-    tsdu->coverage_id           = get_bits(8,  &data[3], 0);
-    tsdu->key_reference._data   = get_bits(8,  &data[4], 0);
+    bit_reader_t br;
+    br_init(&br, data, len);
+    br_skip(&br, 8);
+    activation_mode_decode(&tsdu->activation_mode, &br);
+    tsdu->group_id              = br_read(&br, 12);
+    tsdu->coverage_id           = br_read(&br, 8);
+    tsdu->key_reference._data   = br_read(&br, 8);
 
     return tsdu;
 }
 
 static tsdu_d_forced_registration_t *
-d_forced_registration_decode(const uint8_t *data, int len)
+d_forced_registration_decode(const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
-    tsdu_d_forced_registration_t *tsdu = tsdu_create(tsdu_d_forced_registration_t, 0);
+    tsdu_d_forced_registration_t *tsdu =
+        tsdu_create(arena, tsdu_d_forced_registration_t, 0);
     if (!tsdu) {
         return NULL;
     }
-    CHECK_LEN(len, 9, tsdu);
+    CHECK_LEN(len, 9, tsdu, arena);
 
     const uint8_t *adr_data = &data[1];
     if (address_decode(&tsdu->calling_adr, &adr_data)) {
@@ -440,24 +495,29 @@ d_forced_registration_decode(const uint8_t *data, int len)
 }
 
 static tsdu_d_group_activation_t *
-d_group_activation_decode(const uint8_t *data, int len)
+d_group_activation_decode(const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
-    tsdu_d_group_activation_t *tsdu = tsdu_create(tsdu_d_group_activation_t, 0);
+    tsdu_d_group_activation_t *tsdu =
+        tsdu_create(arena, tsdu_d_group_activation_t, 0);
     if (!tsdu) {
         return NULL;
     }
 
-    CHECK_LEN(len, 9, tsdu);
+    CHECK_LEN(len, 9, tsdu, arena);
 
+    bit_reader_t br;
+    br_init(&br, data, len);
+    br_skip(&br, 8);
     int _zero0;
-    activation_mode_decode(&tsdu->activation_mode, data[1]);
-    tsdu->group_id              = get_bits(12, data + 1, 4);
-    tsdu->coverage_id           = get_bits(8,  data + 3, 0);
-    _zero0                      = get_bits(4,  data + 4, 0);
-    tsdu->channel_id            = get_bits(12, data + 4, 4);
-    tsdu->u_ch_scrambling       = get_bits(8,  data + 6, 0);
-    tsdu->d_ch_scrambling       = get_bits(8,  data + 7, 0);
-    tsdu->key_reference._data   = get_bits(8,  data + 8, 0);
+    activation_mode_decode(&tsdu->activation_mode, &br);
+    tsdu->group_id              = br_read(&br, 12);
+    tsdu->coverage_id           = br_read(&br, 8);
+    _zero0                      = br_read(&br, 4);
+    tsdu->channel_id            = br_read(&br, 12);
+    tsdu->u_ch_scrambling       = br_read(&br, 8);
+    tsdu->d_ch_scrambling       = br_read(&br, 8);
+    tsdu->key_reference._data   = br_read(&br, 8);
 
     if (_zero0 != 0) {
         LOG(WTF, "nonzero padding: 0x%02x", _zero0);
@@ -466,7 +526,7 @@ d_group_activation_decode(const uint8_t *data, int len)
     tsdu->has_addr_tti = false;
     if (len >= 12) {
         // FIXME: proper IEI handling
-        uint8_t iei = get_bits(8, data + 9, 0);
+        uint8_t iei = br_read(&br, 8);
         if (iei != IEI_TTI) {
             LOG(WTF, "expected IEI_TTI got %d", iei);
         } else {
@@ -482,9 +542,10 @@ d_group_activation_decode(const uint8_t *data, int len)
     return tsdu;
 }
 
-static tsdu_d_group_list_t *d_group_list_decode(const uint8_t *data, int len)
+static tsdu_d_group_list_t *d_group_list_decode(const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
-    tsdu_d_group_list_t *tsdu = tsdu_create(tsdu_d_group_list_t, 3);
+    tsdu_d_group_list_t *tsdu = tsdu_create(arena, tsdu_d_group_list_t, 3);
     if (!tsdu) {
         return NULL;
     }
@@ -493,34 +554,38 @@ static tsdu_d_group_list_t *d_group_list_decode(const uint8_t *data, int len)
     tsdu->ngroup = 0;
     tsdu->nopen = 0;
 
+    bit_reader_t br;
+    br_init(&br, data, len);
+    br_skip(&br, 8);
+
     int rlen = 2; ///< required data length
-    CHECK_LEN(len, rlen, tsdu);
-    tsdu->reference_list._data = get_bits(8, data + 1, 0);
+    CHECK_LEN(len, rlen, tsdu, arena);
+    tsdu->reference_list._data = br_read(&br, 8);
     if (tsdu->reference_list.revision == 0) {
         return tsdu;
     }
 
     rlen += 1;
-    CHECK_LEN(len, rlen, tsdu);
-    tsdu->index_list._data = get_bits(8, data + 2, 0);
-    data += 3;
+    CHECK_LEN(len, rlen, tsdu, arena);
+    tsdu->index_list._data = br_read(&br, 8);
     do {
         rlen += 1;
-        CHECK_LEN(len, rlen, tsdu);
+        CHECK_LEN(len, rlen, tsdu, arena);
         const type_nb_t type_nb = {
-            ._data = get_bits(8, data, 0),
+            ._data = br_read(&br, 8),
         };
         if (type_nb.type == TYPE_NB_TYPE_END) {
             break;
         }
-        data += 1;
 
         if (type_nb.type == TYPE_NB_TYPE_EMERGENCY) {
             const int n = tsdu->nemergency + type_nb.number;
+            const int l_old = tsdu->nemergency * sizeof(tsdu->emergency[0]);
             const int l = sizeof(tsdu_d_group_list_emergency_t[n]);
-            tsdu_d_group_list_emergency_t *p = realloc(tsdu->emergency, l);
+            tsdu_d_group_list_emergency_t *p = tsdu_arena_realloc(arena,
+                    tsdu->emergency, l_old, l);
             if (!p) {
-                tsdu_destroy(&tsdu->base);
+                tsdu_release(&tsdu->base, arena);
                 return NULL;
             }
             tsdu->emergency = p;
@@ -530,21 +595,22 @@ static tsdu_d_group_list_t *d_group_list_decode(const uint8_t *data, int len)
                     break;
                 }
                 const int i = tsdu->nemergency;
-                cell_id_decode1(&tsdu->emergency[i].cell_id, data);
-                int zero = get_bits(4, data + 1, 4);
+                cell_id_decode1(&tsdu->emergency[i].cell_id, &br);
+                int zero = br_read(&br, 4);
                 if (zero != 0) {
                     LOG(WTF, "nonzero padding (%d)", zero);
                 }
-                data += 2;
             }
         }
 
         if (type_nb.type == TYPE_NB_TYPE_OPEN) {
             const int n = tsdu->nopen + type_nb.number;
+            const int l_old = tsdu->nopen * sizeof(tsdu->open[0]);
             const int l = sizeof(tsdu_d_group_list_open_t[n]);
-            tsdu_d_group_list_open_t *p = realloc(tsdu->open, l);
+            tsdu_d_group_list_open_t *p = tsdu_arena_realloc(arena,
+                    tsdu->open, l_old, l);
             if (!p) {
-                tsdu_destroy(&tsdu->base);
+                tsdu_release(&tsdu->base, arena);
                 return NULL;
             }
             tsdu->open = p;
@@ -554,25 +620,26 @@ static tsdu_d_group_list_t *d_group_list_decode(const uint8_t *data, int len)
                     break;
                 }
                 const int i = tsdu->nopen;
-                tsdu->open[i].coverage_id           = get_bits(8, data, 0);
-                tsdu->open[i].call_priority         = get_bits(4, data + 1, 0);
-                tsdu->open[i].group_id              = get_bits(12, data + 1, 4);
-                uint8_t padding                     = get_bits(2, data + 3, 0);
+                tsdu->open[i].coverage_id           = br_read(&br, 8);
+                tsdu->open[i].call_priority         = br_read(&br, 4);
+                tsdu->open[i].group_id              = br_read(&br, 12);
+                uint8_t padding                     = br_read(&br, 2);
                 if (padding != 0) {
                     LOG(WTF, "nonzero padding (%d)", padding);
                 }
-                tsdu->open[i].och_parameters.add    = get_bits(1, data + 3, 2);
-                tsdu->open[i].och_parameters.mbn    = get_bits(1, data + 3, 3);
-                tsdu->open[i].neighbouring_cell     = get_bits(12, data + 3, 4);
-                data += 5;
+                tsdu->open[i].och_parameters.add    = br_read(&br, 1);
+                tsdu->open[i].och_parameters.mbn    = br_read(&br, 1);
+                tsdu->open[i].neighbouring_cell     = br_read(&br, 12);
             }
         }
         if (type_nb.type == TYPE_NB_TYPE_TALK_GROUP) {
             const int n = tsdu->ngroup + type_nb.number;
+            const int l_old = tsdu->ngroup * sizeof(tsdu->group[0]);
             const int l = sizeof(tsdu_d_group_list_talk_group_t[n]);
-            tsdu_d_group_list_talk_group_t *p = realloc(tsdu->group, l);
+            tsdu_d_group_list_talk_group_t *p = tsdu_arena_realloc(arena,
+                    tsdu->group, l_old, l);
             if (!p) {
-                tsdu_destroy(&tsdu->base);
+                tsdu_release(&tsdu->base, arena);
                 return NULL;
             }
             tsdu->group = p;
@@ -582,17 +649,16 @@ static tsdu_d_group_list_t *d_group_list_decode(const uint8_t *data, int len)
                     break;
                 }
                 const int i = tsdu->ngroup;
-                tsdu->group[i].coverage_id          = get_bits(8, data, 0);
-                uint8_t zero                        = get_bits(8, data + 1, 0);
+                tsdu->group[i].coverage_id          = br_read(&br, 8);
+                uint8_t zero                        = br_read(&br, 8);
                 if (zero != 0) {
                     LOG(WTF, "nonzero padding in talk group-1 (%d)", zero);
                 }
-                uint8_t padding                     = get_bits(4, data + 2, 0);
+                uint8_t padding                     = br_read(&br, 4);
                 if (padding != 0) {
                     LOG(WTF, "nonzero padding in talk group-2 (%d)", padding);
                 }
-                tsdu->group[i].neighbouring_cell    = get_bits(12, data + 2, 4);
-                data += 4;
+                tsdu->group[i].neighbouring_cell    = br_read(&br, 12);
             }
         }
     } while(true);
@@ -601,35 +667,39 @@ static tsdu_d_group_list_t *d_group_list_decode(const uint8_t *data, int len)
 }
 
 static tsdu_d_group_composition_t *d_group_composition_decode(
-        const uint8_t *data, int len)
+        const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
-    tsdu_d_group_composition_t *tsdu = tsdu_create(tsdu_d_group_composition_t, 0);
+    tsdu_d_group_composition_t *tsdu =
+        tsdu_create(arena, tsdu_d_group_composition_t, 0);
     if (!tsdu) {
         return NULL;
     }
 
-    CHECK_LEN(len, 3, tsdu);
+    CHECK_LEN(len, 3, tsdu, arena);
 
-    tsdu->group_id = get_bits(12, data + 1, 0);
-    tsdu->og_nb = get_bits(4, data + 2, 4);
+    bit_reader_t br;
+    br_init(&br, data, len);
+    br_skip(&br, 8);
+    tsdu->group_id = br_read(&br, 12);
+    tsdu->og_nb = br_read(&br, 4);
 
-    CHECK_LEN(len, 3 + (12*tsdu->og_nb + 7) / 8, tsdu);
+    CHECK_LEN(len, 3 + (12*tsdu->og_nb + 7) / 8, tsdu, arena);
 
-    int skip = 0;
     for (int i = 0; i < tsdu->og_nb; ++i) {
-        tsdu->group_ids[i] = get_bits(12, data + 3, skip);
-        skip += 12;
+        tsdu->group_ids[i] = br_read(&br, 12);
     }
 
     return tsdu;
 }
 
 static cell_id_list_t *iei_cell_id_list_decode(cell_id_list_t *cell_ids,
-        const uint8_t *data, int len)
+        bit_reader_t *br, int len, tsdu_arena_t *arena)
 {
-    int n = cell_ids ? cell_ids->len : 0;
-    n += len / 2;
-    cell_id_list_t *p = realloc(cell_ids,
+    const int n_old = cell_ids ? cell_ids->len : 0;
+    const int n = n_old + len / 2;
+    cell_id_list_t *p = tsdu_arena_realloc(arena, cell_ids,
+            sizeof(cell_id_list_t) + sizeof(cell_id_t[n_old]),
             sizeof(cell_id_list_t) + sizeof(cell_id_t[n]));
     if (!p) {
         LOG(ERR, "ERR OOM");
@@ -641,19 +711,21 @@ static cell_id_list_t *iei_cell_id_list_decode(cell_id_list_t *cell_ids,
     cell_ids = p;
 
     for ( ; cell_ids->len < n; ++cell_ids->len) {
-        cell_id_decode1(&cell_ids->cell_ids[cell_ids->len], data);
-        data += 2;
+        cell_id_decode1(&cell_ids->cell_ids[cell_ids->len], br);
+        br_skip(br, 4);
     }
 
     return cell_ids;
 }
 
-cell_bn_list_t *iei_cell_bn_list_decode(
-        cell_bn_list_t *cell_bns, const uint8_t *data, int len)
+static cell_bn_list_t *iei_cell_bn_list_decode(
+        cell_bn_list_t *cell_bns, bit_reader_t *br, int len,
+        tsdu_arena_t *arena)
 {
-    int n = cell_bns ? cell_bns->len : 0;
-    n +=  len * 2 / 3;
-    cell_bn_list_t *p = realloc(cell_bns,
+    const int n_old = cell_bns ? cell_bns->len : 0;
+    const int n = n_old + len * 2 / 3;
+    cell_bn_list_t *p = tsdu_arena_realloc(arena, cell_bns,
+            sizeof(cell_bn_list_t) + sizeof(cell_bn_t[n_old]),
             sizeof(cell_bn_list_t) + sizeof(cell_bn_t[n]));
     if (!p) {
         LOG(ERR, "ERR OOM");
@@ -664,24 +736,28 @@ cell_bn_list_t *iei_cell_bn_list_decode(
     }
     cell_bns = p;
 
-    for (int offs = 0; cell_bns->len < n; ++cell_bns->len) {
-        cell_bns->cell_bn[cell_bns->len]._data = get_bits(12, data, offs);
-        offs += 12;
+    for ( ; cell_bns->len < n; ++cell_bns->len) {
+        cell_bns->cell_bn[cell_bns->len]._data = br_read(br, 12);
     }
 
     return cell_bns;
 }
 
-static tsdu_d_neighbouring_cell_t *d_neighbouring_cell_decode(const uint8_t *data, int len)
+static tsdu_d_neighbouring_cell_t *d_neighbouring_cell_decode(
+        const uint8_t *data, int len, tsdu_arena_t *arena)
 {
-    tsdu_d_neighbouring_cell_t *tsdu = tsdu_create(tsdu_d_neighbouring_cell_t, 2);
+    tsdu_d_neighbouring_cell_t *tsdu =
+        tsdu_create(arena, tsdu_d_neighbouring_cell_t, 2);
     if (!tsdu) {
         return NULL;
     }
-    CHECK_LEN(len, 2, tsdu);
+    CHECK_LEN(len, 2, tsdu, arena);
 
-    uint8_t _zero                               = get_bits(4, data + 1, 0);
-    tsdu->ccr_config.number                     = get_bits(4, data + 1, 4);
+    bit_reader_t br;
+    br_init(&br, data, len);
+    br_skip(&br, 8);
+    uint8_t _zero                               = br_read(&br, 4);
+    tsdu->ccr_config.number                     = br_read(&br, 4);
     if (_zero != 0) {
         LOG(WTF, "d_neighbouring_cell padding != 0 (%d)", _zero);
     }
@@ -690,42 +766,41 @@ static tsdu_d_neighbouring_cell_t *d_neighbouring_cell_decode(const uint8_t *dat
         return tsdu;
     }
 
-    tsdu->ccr_param = data[2];
+    tsdu->ccr_param = br_read(&br, 8);
     if (tsdu->ccr_param) {
         LOG(WTF, "d_neighbouring_cell ccr_param != 0 (%d)", tsdu->ccr_param);
     }
 
-    data += 3;
     len -= 3;
-    CHECK_LEN(len, 3 * tsdu->ccr_config.number, tsdu);
+    CHECK_LEN(len, 3 * tsdu->ccr_config.number, tsdu, arena);
     for (int i = 0; i < tsdu->ccr_config.number; ++i) {
-        tsdu->adj_cells[i].bn_nb                = get_bits(4,  data, 0);
-        tsdu->adj_cells[i].channel_id           = get_bits(12, data, 4);
-        tsdu->adj_cells[i].adjacent_param._data = get_bits(8,  data + 2, 0);
+        tsdu->adj_cells[i].bn_nb                = br_read(&br, 4);
+        tsdu->adj_cells[i].channel_id           = br_read(&br, 12);
+        tsdu->adj_cells[i].adjacent_param._data = br_read(&br, 8);
         if (tsdu->adj_cells[i].adjacent_param._reserved) {
             LOG(WTF, "adjacent_param._reserved != 0");
         }
-        data += 3;
         len -= 3;
     }
 
     while (len > 0) {
-        CHECK_LEN(len, 2, tsdu);
-        const uint8_t iei                       = get_bits(8, data, 0);
-        const uint8_t ie_len                    = get_bits(8, data + 1, 0);
-        data += 2;
+        CHECK_LEN(len, 2, tsdu, arena);
+        const uint8_t iei                       = br_read(&br, 8);
+        const uint8_t ie_len                    = br_read(&br, 8);
         len -= 2;
-        CHECK_LEN(len, ie_len, tsdu);
+        CHECK_LEN(len, ie_len, tsdu, arena);
+        // list might not use all bytes of IE
+        const int ie_end = br.pos + 8 * ie_len;
         if (iei == IEI_CELL_ID_LIST && ie_len) {
             cell_id_list_t *p = iei_cell_id_list_decode(
-                    tsdu->cell_ids, data, ie_len);
+                    tsdu->cell_ids, &br, ie_len, arena);
             if (!p) {
                 break;
             }
             tsdu->cell_ids = p;
         } else if (iei == IEI_ADJACENT_BN_LIST && ie_len) {
             cell_bn_list_t *p = iei_cell_bn_list_decode(
-                    tsdu->cell_bns, data, ie_len);
+                    tsdu->cell_bns, &br, ie_len, arena);
             if (!p) {
                 break;
             }
@@ -735,43 +810,47 @@ static tsdu_d_neighbouring_cell_t *d_neighbouring_cell_decode(const uint8_t *dat
                 LOG(WTF, "d_neighbouring_cell unknown iei (0x%x)", iei);
             }
         }
-        data += ie_len;
+        br_seek(&br, ie_end);
         len -= ie_len;
     }
 
     return tsdu;
 }
 
-static tsdu_d_system_info_t *d_system_info_decode(const uint8_t *data, int len)
+static tsdu_d_system_info_t *d_system_info_decode(const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
-    tsdu_d_system_info_t *tsdu = tsdu_create(tsdu_d_system_info_t, 0);
+    tsdu_d_system_info_t *tsdu = tsdu_create(arena, tsdu_d_system_info_t, 0);
     if (!tsdu) {
         return NULL;
     }
 
     // minimal size of disconnected mode
-    CHECK_LEN(len, 9, tsdu);
+    CHECK_LEN(len, 9, tsdu, arena);
 
-    tsdu->cell_state._data = get_bits(8, data + 1, 0);
+    bit_reader_t br;
+    br_init(&br, data, len);
+    br_skip(&br, 8);
+    tsdu->cell_state._data = br_read(&br, 8);
     switch (tsdu->cell_state.mode) {
         case CELL_STATE_MODE_NORMAL:
-            CHECK_LEN(len, 17, tsdu);
-            tsdu->cell_config._data                     = get_bits( 8, data + 2, 0);
-            tsdu->country_code                          = get_bits( 8, data + 3, 0);
-            tsdu->system_id._data                       = get_bits( 8, data + 4, 0);
-            tsdu->loc_area_id._data                     = get_bits( 8, data + 5, 0);
-            tsdu->bn_id                                 = get_bits( 8, data + 6, 0);
-            cell_id_decode1(&tsdu->cell_id, data + 7);
-            tsdu->cell_bn._data                         = get_bits(12, data + 8, 4);
-            tsdu->u_ch_scrambling                       = get_bits( 8, data + 10, 0);
-            tsdu->cell_radio_param.tx_max               = get_bits( 3, data + 11, 0);
-            tsdu->cell_radio_param.radio_link_timeout   = get_bits( 5, data + 11, 3);
-            tsdu->cell_radio_param.pwr_tx_adjust        = get_bits( 4, data + 12, 0);
-            tsdu->cell_radio_param.rx_lev_access        = get_bits( 4, data + 12, 4);
-            tsdu->system_time                           = get_bits( 8, data + 13, 0);
-            tsdu->cell_access._data                     = get_bits( 8, data + 14, 0);
-            tsdu->_unused_1                             = get_bits( 4, data + 15, 0);
-            tsdu->superframe_cpt                        = get_bits(12, data + 15, 4);
+            CHECK_LEN(len, 17, tsdu, arena);
+            tsdu->cell_config._data                     = br_read(&br,  8);
+            tsdu->country_code                          = br_read(&br,  8);
+            tsdu->system_id._data                       = br_read(&br,  8);
+            tsdu->loc_area_id._data                     = br_read(&br,  8);
+            tsdu->bn_id                                 = br_read(&br,  8);
+            cell_id_decode1(&tsdu->cell_id, &br);
+            tsdu->cell_bn._data                         = br_read(&br, 12);
+            tsdu->u_ch_scrambling                       = br_read(&br,  8);
+            tsdu->cell_radio_param.tx_max               = br_read(&br,  3);
+            tsdu->cell_radio_param.radio_link_timeout   = br_read(&br,  5);
+            tsdu->cell_radio_param.pwr_tx_adjust        = br_read(&br,  4);
+            tsdu->cell_radio_param.rx_lev_access        = br_read(&br,  4);
+            tsdu->system_time                           = br_read(&br,  8);
+            tsdu->cell_access._data                     = br_read(&br,  8);
+            tsdu->_unused_1                             = br_read(&br,  4);
+            tsdu->superframe_cpt                        = br_read(&br, 12);
             break;
 
         default:
@@ -782,29 +861,33 @@ static tsdu_d_system_info_t *d_system_info_decode(const uint8_t *data, int len)
         case CELL_STATE_MODE_DISC_RADIOSWITCH:
         case CELL_STATE_MODE_DISC_BSC:
             tsdu->cell_state._data &= 0xf0;
-            cell_id_decode2(&tsdu->cell_id, data + 1);
-            tsdu->bn_id                                 = get_bits( 8, data + 3, 0);
-            tsdu->u_ch_scrambling                       = get_bits( 8, data + 4, 0);
-            tsdu->cell_radio_param.tx_max               = get_bits( 3, data + 5, 0);
-            tsdu->cell_radio_param.radio_link_timeout   = get_bits( 5, data + 5, 3);
-            tsdu->cell_radio_param.pwr_tx_adjust        = get_bits( 4, data + 6, 0);
-            tsdu->cell_radio_param.rx_lev_access        = get_bits( 4, data + 6, 4);
-            tsdu->band                                  = get_bits( 4, data + 7, 0);
-            tsdu->channel_id                            = get_bits(12, data + 7, 4);
+            // cell_id shares byte with cell_state
+            br_seek(&br, 8);
+            cell_id_decode2(&tsdu->cell_id, &br);
+            tsdu->bn_id                                 = br_read(&br,  8);
+            tsdu->u_ch_scrambling                       = br_read(&br,  8);
+            tsdu->cell_radio_param.tx_max               = br_read(&br,  3);
+            tsdu->cell_radio_param.radio_link_timeout   = br_read(&br,  5);
+            tsdu->cell_radio_param.pwr_tx_adjust        = br_read(&br,  4);
+            tsdu->cell_radio_param.rx_lev_access        = br_read(&br,  4);
+            tsdu->band                                  = br_read(&br,  4);
+            tsdu->channel_id                            = br_read(&br, 12);
             break;
     }
 
     return tsdu;
 }
 
-static tsdu_d_registration_nak_t *d_registration_nak_decode(const uint8_t *data, int len)
+static tsdu_d_registration_nak_t *d_registration_nak_decode(
+        const uint8_t *data, int len, tsdu_arena_t *arena)
 {
-    tsdu_d_registration_nak_t *tsdu = tsdu_create(tsdu_d_registration_nak_t, 0);
+    tsdu_d_registration_nak_t *tsdu =
+        tsdu_create(arena, tsdu_d_registration_nak_t, 0);
     if (!tsdu) {
         return NULL;
     }
 
-    CHECK_LEN(len, 10, tsdu);
+    CHECK_LEN(len, 10, tsdu, arena);
 
     tsdu->cause                 = data[1];
     const uint8_t *adr_data = &data[2];
@@ -812,19 +895,24 @@ static tsdu_d_registration_nak_t *d_registration_nak_decode(const uint8_t *data,
         LOG(ERR, "Only single address NAK is supported");
     }
     tsdu->bn_id                 = data[7];
-    cell_id_decode1(&tsdu->cell_id, data + 8);
+    bit_reader_t br;
+    br_init(&br, data, len);
+    br_seek(&br, 8 * 8);
+    cell_id_decode1(&tsdu->cell_id, &br);
 
     return tsdu;
 }
 
-static tsdu_d_registration_ack_t *d_registration_ack_decode(const uint8_t *data, int len)
+static tsdu_d_registration_ack_t *d_registration_ack_decode(
+        const uint8_t *data, int len, tsdu_arena_t *arena)
 {
-    tsdu_d_registration_ack_t *tsdu = tsdu_create(tsdu_d_registration_ack_t, 0);
+    tsdu_d_registration_ack_t *tsdu =
+        tsdu_create(arena, tsdu_d_registration_ack_t, 0);
     if (!tsdu) {
         return NULL;
     }
 
-    CHECK_LEN(len, 14, tsdu);
+    CHECK_LEN(len, 14, tsdu, arena);
 
     tsdu->complete_reg          = data[1];
     tsdu->rt_min_activity       = data[2];
@@ -836,7 +924,10 @@ static tsdu_d_registration_ack_t *d_registration_ack_decode(const uint8_t *data,
     tsdu->rt_min_registration   = data[9];
     tsdu->tlr_value             = data[10];
     tsdu->rt_data_info._data    = data[11];
-    tsdu->group_id              = get_bits(12, data + 12, 0);
+    bit_reader_t br;
+    br_init(&br, data, len);
+    br_seek(&br, 12 * 8);
+    tsdu->group_id              = br_read(&br, 12);
 
     tsdu->has_coverage_id = false;
     if (len >= 16) {
@@ -854,45 +945,52 @@ static tsdu_d_registration_ack_t *d_registration_ack_decode(const uint8_t *data,
     return tsdu;
 }
 
-static tsdu_d_connect_dch_t *d_connect_dch_decode(const uint8_t *data, int len)
+static tsdu_d_connect_dch_t *d_connect_dch_decode(const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
-    tsdu_d_connect_dch_t *tsdu = tsdu_create(tsdu_d_connect_dch_t, 0);
+    tsdu_d_connect_dch_t *tsdu = tsdu_create(arena, tsdu_d_connect_dch_t, 0);
     if (!tsdu) {
         return NULL;
     }
 
-    CHECK_LEN(len, 6, tsdu);
+    CHECK_LEN(len, 6, tsdu, arena);
 
-    tsdu->dch_low_layer    = data[1];
-    tsdu->channel_id       = get_bits(12, &data[2], 4);
-    tsdu->u_ch_scrambling  = data[4];
-    tsdu->d_ch_scrambling  = data[5];
+    bit_reader_t br;
+    br_init(&br, data, len);
+    br_skip(&br, 8);
+    tsdu->dch_low_layer    = br_read(&br, 8);
+    br_skip(&br, 4);
+    tsdu->channel_id       = br_read(&br, 12);
+    tsdu->u_ch_scrambling  = br_read(&br, 8);
+    tsdu->d_ch_scrambling  = br_read(&br, 8);
 
     return tsdu;
 }
 
-static tsdu_d_return_t *d_return_decode(const uint8_t *data, int len)
+static tsdu_d_return_t *d_return_decode(const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
-    tsdu_d_return_t *tsdu = tsdu_create(tsdu_d_return_t, 0);
+    tsdu_d_return_t *tsdu = tsdu_create(arena, tsdu_d_return_t, 0);
     if (!tsdu) {
         return NULL;
     }
 
-    CHECK_LEN(len, 2, tsdu);
+    CHECK_LEN(len, 2, tsdu, arena);
 
     tsdu->cause = data[1];
 
     return tsdu;
 }
 
-static tsdu_d_group_idle_t *d_group_idle_decode(const uint8_t *data, int len)
+static tsdu_d_group_idle_t *d_group_idle_decode(const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
-    tsdu_d_group_idle_t *tsdu = tsdu_create(tsdu_d_group_idle_t, 0);
+    tsdu_d_group_idle_t *tsdu = tsdu_create(arena, tsdu_d_group_idle_t, 0);
     if (!tsdu) {
         return NULL;
     }
 
-    CHECK_LEN(len, 2, tsdu);
+    CHECK_LEN(len, 2, tsdu, arena);
 
     tsdu->cause = data[1];
 
@@ -900,12 +998,13 @@ static tsdu_d_group_idle_t *d_group_idle_decode(const uint8_t *data, int len)
 }
 
 static tsdu_d_location_activity_ack_t *d_location_activity_ack_decode(
-        const uint8_t *data, int len)
+        const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
-    CHECK_LEN(len, 2, NULL);
+    CHECK_LEN(len, 2, NULL, arena);
 
     tsdu_d_location_activity_ack_t *tsdu =
-        tsdu_create(tsdu_d_location_activity_ack_t, 0);
+        tsdu_create(arena, tsdu_d_location_activity_ack_t, 0);
     if (!tsdu) {
         return NULL;
     }
@@ -915,27 +1014,33 @@ static tsdu_d_location_activity_ack_t *d_location_activity_ack_decode(
     return tsdu;
 }
 
-static tsdu_d_ech_overload_id_t *d_ech_overload_id_decode(const uint8_t *data, int len)
+static tsdu_d_ech_overload_id_t *d_ech_overload_id_decode(
+        const uint8_t *data, int len, tsdu_arena_t *arena)
 {
-    tsdu_d_ech_overload_id_t *tsdu = tsdu_create(tsdu_d_ech_overload_id_t, 0);
+    tsdu_d_ech_overload_id_t *tsdu =
+        tsdu_create(arena, tsdu_d_ech_overload_id_t, 0);
     if (!tsdu) {
         return NULL;
     }
 
-    CHECK_LEN(len, 6, tsdu);
+    CHECK_LEN(len, 6, tsdu, arena);
 
-    tsdu->activation_mode.hook = get_bits(2, data + 1, 0);
-    tsdu->activation_mode.type = get_bits(2, data + 1, 2);
-    tsdu->group_id = get_bits(12, data + 1, 4);
-    cell_id_decode1(&tsdu->cell_id, data + 3);
-    tsdu->organisation = get_bits(8, data + 5, 0);
+    bit_reader_t br;
+    br_init(&br, data, len);
+    br_skip(&br, 8);
+    activation_mode_decode(&tsdu->activation_mode, &br);
+    tsdu->group_id = br_read(&br, 12);
+    cell_id_decode1(&tsdu->cell_id, &br);
+    br_skip(&br, 4);
+    tsdu->organisation = br_read(&br, 8);
 
     return tsdu;
 }
 
-static tsdu_unknown_codop_t *d_unknown_parse(const uint8_t *data, int len)
+static tsdu_unknown_codop_t *d_unknown_parse(const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
-    tsdu_unknown_codop_t *tsdu = tsdu_create(tsdu_unknown_codop_t, 1);
+    tsdu_unknown_codop_t *tsdu = tsdu_create(arena, tsdu_unknown_codop_t, 1);
     if (!tsdu) {
         return NULL;
     }
@@ -945,9 +1050,9 @@ static tsdu_unknown_codop_t *d_unknown_parse(const uint8_t *data, int len)
         return tsdu;
     }
 
-    tsdu->data = malloc(len);
+    tsdu->data = tsdu_arena_alloc(arena, len);
     if (!tsdu->data) {
-        tsdu_destroy(&tsdu->base);
+        tsdu_release(&tsdu->base, arena);
         return NULL;
     }
 
@@ -956,29 +1061,32 @@ static tsdu_unknown_codop_t *d_unknown_parse(const uint8_t *data, int len)
     return tsdu;
 }
 
-static tsdu_d_data_end_t *d_data_end_decode(const uint8_t *data, int len)
+static tsdu_d_data_end_t *d_data_end_decode(const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
-    tsdu_d_data_end_t *tsdu = tsdu_create(tsdu_d_data_end_t, 0);
+    tsdu_d_data_end_t *tsdu = tsdu_create(arena, tsdu_d_data_end_t, 0);
     if (!tsdu) {
         return NULL;
     }
 
-    CHECK_LEN(len, 2, tsdu);
+    CHECK_LEN(len, 2, tsdu, arena);
     tsdu->cause = data[1];
 
     return tsdu;
 }
 
-static tsdu_d_datagram_notify_t *d_datagram_notify_decode(const uint8_t *data, int len)
+static tsdu_d_datagram_notify_t *d_datagram_notify_decode(
+        const uint8_t *data, int len, tsdu_arena_t *arena)
 {
-    tsdu_d_datagram_notify_t *tsdu = tsdu_create(tsdu_d_datagram_notify_t, 0);
+    tsdu_d_datagram_notify_t *tsdu =
+        tsdu_create(arena, tsdu_d_datagram_notify_t, 0);
     if (!tsdu) {
         return NULL;
     }
 
-    CHECK_LEN(len, 5, tsdu);
+    CHECK_LEN(len, 5, tsdu, arena);
 
-    tsdu->call_priority         = get_bits(4, data + 1, 4);
+    tsdu->call_priority         = data[1] & 0x0f;
     tsdu->message_reference     = data[2] | (data[3] << 8);
     tsdu->key_reference._data   = data[4];
 
@@ -991,7 +1099,8 @@ static tsdu_d_datagram_notify_t *d_datagram_notify_decode(const uint8_t *data, i
     return tsdu;
 }
 
-static tsdu_d_datagram_t *d_datagram_decode(const uint8_t *data, int len)
+static tsdu_d_datagram_t *d_datagram_decode(const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
     if (len < 5) {
         LOG(WTF, "too short");
@@ -999,14 +1108,15 @@ static tsdu_d_datagram_t *d_datagram_decode(const uint8_t *data, int len)
     }
     len -= 5;
 
-    tsdu_d_datagram_t *tsdu = malloc(sizeof(tsdu_d_datagram_t) + len);
+    tsdu_d_datagram_t *tsdu = tsdu_arena_alloc(arena,
+            sizeof(tsdu_d_datagram_t) + len);
     if (!tsdu) {
         return NULL;
     }
 
     tsdu_base_set_nopts(&tsdu->base, 0);
 
-    tsdu->call_priority = get_bits(4, data + 1, 4);
+    tsdu->call_priority = data[1] & 0x0f;
     tsdu->message_reference = data[2] | (data[3] << 8);
     tsdu->key_reference._data = data[4];
     tsdu->len = len;
@@ -1016,7 +1126,8 @@ static tsdu_d_datagram_t *d_datagram_decode(const uint8_t *data, int len)
 }
 
 static tsdu_d_explicit_short_data_t *d_explicit_short_data_decode(
-        const uint8_t *data, int len)
+        const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
     if (len < 1) {
         LOG(WTF, "too short");
@@ -1024,7 +1135,7 @@ static tsdu_d_explicit_short_data_t *d_explicit_short_data_decode(
     }
     len -= 1;
 
-    tsdu_d_explicit_short_data_t *tsdu = malloc(
+    tsdu_d_explicit_short_data_t *tsdu = tsdu_arena_alloc(arena,
             sizeof(tsdu_d_explicit_short_data_t) + len);
     if (!tsdu) {
         LOG(ERR, "ERR OOM");
@@ -1038,9 +1149,10 @@ static tsdu_d_explicit_short_data_t *d_explicit_short_data_decode(
     return tsdu;
 }
 
-static tsdu_d_call_start_t *d_call_start_decode(const uint8_t *data, int len)
+static tsdu_d_call_start_t *d_call_start_decode(const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
-    tsdu_d_call_start_t *tsdu = tsdu_create(tsdu_d_call_start_t, 0);
+    tsdu_d_call_start_t *tsdu = tsdu_create(arena, tsdu_d_call_start_t, 0);
     if (!tsdu) {
         return NULL;
     }
@@ -1051,7 +1163,7 @@ static tsdu_d_call_start_t *d_call_start_decode(const uint8_t *data, int len)
         return tsdu;
     }
 
-    CHECK_LEN(len, 2, tsdu);
+    CHECK_LEN(len, 2, tsdu, arena);
     ++data;
     --len;
 
@@ -1080,7 +1192,7 @@ static tsdu_d_call_start_t *d_call_start_decode(const uint8_t *data, int len)
 
             default:
                 LOG(WTF, "Unexpected IEI 0x%x", iei);
-                tsdu_destroy(&tsdu->base);
+                tsdu_release(&tsdu->base, arena);
                 return NULL;
         }
     }
@@ -1091,83 +1203,94 @@ static tsdu_d_call_start_t *d_call_start_decode(const uint8_t *data, int len)
     return tsdu;
 }
 
-static tsdu_d_call_connect_t *d_call_connect_decode(const uint8_t *data, int len)
+static tsdu_d_call_connect_t *d_call_connect_decode(
+        const uint8_t *data, int len, tsdu_arena_t *arena)
 {
-    tsdu_d_call_connect_t *tsdu = tsdu_create(tsdu_d_call_connect_t, 0);
+    tsdu_d_call_connect_t *tsdu = tsdu_create(arena, tsdu_d_call_connect_t, 0);
     if (!tsdu) {
         return NULL;
     }
-    CHECK_LEN(len, 15, tsdu);
-
-    tsdu->call_type._data       = data[1];
-    tsdu->channel_id            = get_bits(12, &data[2], 4);
-    tsdu->u_ch_scrambling       = data[4];
-    tsdu->d_ch_scrambling       = data[5];
-    tsdu->key_reference._data   = data[6];
+    CHECK_LEN(len, 15, tsdu, arena);
+
+    bit_reader_t br;
+    br_init(&br, data, len);
+    br_skip(&br, 8);
+    tsdu->call_type._data       = br_read(&br, 8);
+    br_skip(&br, 4);
+    tsdu->channel_id            = br_read(&br, 12);
+    tsdu->u_ch_scrambling       = br_read(&br, 8);
+    tsdu->d_ch_scrambling       = br_read(&br, 8);
+    tsdu->key_reference._data   = br_read(&br, 8);
     memcpy(tsdu->valid_rt, &data[7], SIZEOF(tsdu_d_call_connect_t, valid_rt));
     tsdu->has_key_of_call =
         (tsdu->key_reference.key_type == KEY_TYPE_ESC) &&
         (tsdu->key_reference.key_index == KEY_INDEX_KEY_SUPPLIED);
     if (tsdu->has_key_of_call) {
-        CHECK_LEN(len, 31, tsdu);
+        CHECK_LEN(len, 31, tsdu, arena);
         memcpy(tsdu->key_of_call, &data[15], sizeof(key_of_call_t));
     }
 
     return tsdu;
 }
 
-static tsdu_u_registration_req_t *u_registration_req_decode(const uint8_t *data, int len)
+static tsdu_u_registration_req_t *u_registration_req_decode(
+        const uint8_t *data, int len, tsdu_arena_t *arena)
 {
-    tsdu_u_registration_req_t *tsdu = tsdu_create(tsdu_u_registration_req_t, 0);
+    tsdu_u_registration_req_t *tsdu =
+        tsdu_create(arena, tsdu_u_registration_req_t, 0);
     if (!tsdu) {
         return NULL;
     }
 
-    CHECK_LEN(len, 15, tsdu);
+    CHECK_LEN(len, 15, tsdu, arena);
 
     const uint8_t *adr_data = &data[1];
     if (address_decode(&tsdu->host_adr, &adr_data)) {
         LOG(ERR, "Only single address ACK is supported");
     }
-    tsdu->serial_nb[0]          = get_bits(4, data + 7, 0);
-    tsdu->serial_nb[1]          = get_bits(4, data + 7, 4);
-    tsdu->serial_nb[2]          = get_bits(4, data + 8, 0);
-    tsdu->serial_nb[3]          = get_bits(4, data + 8, 4);
-    tsdu->serial_nb[4]          = get_bits(4, data + 9, 0);
-    tsdu->serial_nb[5]          = get_bits(4, data + 9, 4);
-    tsdu->serial_nb[6]          = get_bits(4, data + 10, 0);
-    tsdu->serial_nb[7]          = get_bits(4, data + 10, 4);
-    tsdu->reg_seq               = get_bits(16, data + 11, 0);
+    bit_reader_t br;
+    br_init(&br, data, len);
+    br_seek(&br, 7 * 8);
+    for (int i = 0; i < 8; ++i) {
+        tsdu->serial_nb[i]      = br_read(&br, 4);
+    }
+    tsdu->reg_seq               = br_read(&br, 16);
     tsdu->complete_reg          = data[12];
     tsdu->rt_status._data       = data[13];
 
     return tsdu;
 }
 
-static tsdu_u_data_request_t *u_data_request_decode(const uint8_t *data, int len)
+static tsdu_u_data_request_t *u_data_request_decode(
+        const uint8_t *data, int len, tsdu_arena_t *arena)
 {
-    CHECK_LEN(len, 5, NULL);
+    CHECK_LEN(len, 6, NULL, arena);
 
-    tsdu_u_data_request_t *tsdu = tsdu_create(tsdu_u_data_request_t, 0);
+    tsdu_u_data_request_t *tsdu = tsdu_create(arena, tsdu_u_data_request_t, 0);
     if (!tsdu) {
         return NULL;
     }
 
-    tsdu->trans_mode =      get_bits(4, &data[1], 4);
-    tsdu->trans_param1 =    get_bits(16, &data[2], 0);
-    tsdu->trans_param2 =    get_bits(16, &data[4], 0);
+    bit_reader_t br;
+    br_init(&br, data, len);
+    br_seek(&br, 12);
+    tsdu->trans_mode =      br_read(&br, 4);
+    tsdu->trans_param1 =    br_read(&br, 16);
+    tsdu->trans_param2 =    br_read(&br, 16);
 
     return tsdu;
 }
 
 static tsdu_u_authentication_t *
-u_authentication_decode(const uint8_t *data, int len)
+u_authentication_decode(const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
-    tsdu_u_authentication_t *tsdu = tsdu_create(tsdu_u_authentication_t, 0);
+    tsdu_u_authentication_t *tsdu =
+        tsdu_create(arena, tsdu_u_authentication_t, 0);
     if (!tsdu) {
         return NULL;
     }
-    CHECK_LEN(len, 6, tsdu);
+    CHECK_LEN(len, 6, tsdu, arena);
 
     tsdu->val             = data[1];
     memcpy(tsdu->result_rt, &data[2], sizeof(tsdu->result_rt));
@@ -1176,13 +1299,14 @@ u_authentication_decode(const uint8_t *data, int len)
 }
 
 static tsdu_u_terminate_t *
-u_terminate_decode(const uint8_t *data, int len)
+u_terminate_decode(const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
-    tsdu_u_terminate_t *tsdu = tsdu_create(tsdu_u_terminate_t, 0);
+    tsdu_u_terminate_t *tsdu = tsdu_create(arena, tsdu_u_terminate_t, 0);
     if (!tsdu) {
         return NULL;
     }
-    CHECK_LEN(len, 1, tsdu);
+    CHECK_LEN(len, 2, tsdu, arena);
 
     tsdu->cause           = data[1];
 
@@ -1190,13 +1314,14 @@ u_terminate_decode(const uint8_t *data, int len)
 }
 
 static tsdu_u_call_connect_t *
-u_call_connect_decode(const uint8_t *data, int len)
+u_call_connect_decode(const uint8_t *data, int len,
+        tsdu_arena_t *arena)
 {
-    tsdu_u_call_connect_t *tsdu = tsdu_create(tsdu_u_call_connect_t, 0);
+    tsdu_u_call_connect_t *tsdu = tsdu_create(arena, tsdu_u_call_connect_t, 0);
     if (!tsdu) {
         return NULL;
     }
-    CHECK_LEN(len, 6, tsdu);
+    CHECK_LEN(len, 6, tsdu, arena);
 
     tsdu->val             = data[1];
     memcpy(tsdu->result_rt, &data[2], sizeof(tsdu->result_rt));
@@ -1204,7 +1329,8 @@ u_call_connect_decode(const uint8_t *data, int len)
     return tsdu;
 }
 
-int tsdu_decode(const uint8_t *data, int len, tsdu_t **tsdu)
+static int tsdu_decode_(const uint8_t *data, int len, tsdu_arena_t *arena,
+        tsdu_t **tsdu)
 {
     if (len < 1) {
         LOG(ERR, "%d data too short %d < %d", __LINE__, len, 1);
@@ -1215,180 +1341,181 @@ int tsdu_decode(const uint8_t *data, int len, tsdu_t **tsdu)
         return -1;
     }
 
-    const codop_t codop = get_bits(8, data, 0);
+    const codop_t codop = data[0];
 
     *tsdu = NULL;
     switch (codop) {
         case D_ABILITY_MNGT:
-            *tsdu = (tsdu_t *)d_ability_mngt_decode(data, len);
+            *tsdu = (tsdu_t *)d_ability_mngt_decode(data, len, arena);
             break;
 
         case D_ADDITIONAL_PARTICIPANTS:
-            *tsdu = (tsdu_t *)d_additional_participants_decode(data, len);
+            *tsdu = (tsdu_t *)d_additional_participants_decode(
+                    data, len, arena);
             break;
 
         case D_AUTHENTICATION:
-            *tsdu = (tsdu_t *)d_authentication_decode(data, len);
+            *tsdu = (tsdu_t *)d_authentication_decode(data, len, arena);
             break;
 
         case D_AUTHORISATION:
-            *tsdu = (tsdu_t *)d_authorisation_decode(data, len);
+            *tsdu = (tsdu_t *)d_authorisation_decode(data, len, arena);
             break;
 
         case D_CALL_ALERT:
-            *tsdu = (tsdu_t *)d_call_alert_decode(data, len);
+            *tsdu = (tsdu_t *)d_call_alert_decode(data, len, arena);
             break;
 
         case D_CALL_CONNECT:
-            *tsdu = (tsdu_t *)d_call_connect_decode(data, len);
+            *tsdu = (tsdu_t *)d_call_connect_decode(data, len, arena);
             break;
 
         case D_CALL_START:
-            *tsdu = (tsdu_t *)d_call_start_decode(data, len);
+            *tsdu = (tsdu_t *)d_call_start_decode(data, len, arena);
             break;
 
         case D_CALL_SETUP:
-            *tsdu = (tsdu_t *)d_call_setup_decode(data, len);
+            *tsdu = (tsdu_t *)d_call_setup_decode(data, len, arena);
             break;
 
         case D_CCH_OPEN:
-            *tsdu = (tsdu_t *)d_cch_open_decode(data, len);
+            *tsdu = (tsdu_t *)d_cch_open_decode(data, len, arena);
             break;
 
         case D_CONNECT_CCH:
-            *tsdu = (tsdu_t *)d_connect_cch_decode(data, len);
+            *tsdu = (tsdu_t *)d_connect_cch_decode(data, len, arena);
             break;
 
         case D_CRISIS_NOTIFICATION:
-            *tsdu = (tsdu_t *)d_crisis_notification_decode(data, len);
+            *tsdu = (tsdu_t *)d_crisis_notification_decode(data, len, arena);
             break;
 
         case D_DATA_AUTHENTICATION:
-            *tsdu = (tsdu_t *)d_data_authentication_decode(data, len);
+            *tsdu = (tsdu_t *)d_data_authentication_decode(data, len, arena);
             break;
 
         case D_DATA_END:
-            *tsdu = (tsdu_t *)d_data_end_decode(data, len);
+            *tsdu = (tsdu_t *)d_data_end_decode(data, len, arena);
             break;
 
         case D_DATA_MSG_DOWN:
-            *tsdu = (tsdu_t *)d_data_msg_down_decode(data, len);
+            *tsdu = (tsdu_t *)d_data_msg_down_decode(data, len, arena);
             break;
 
         case D_DATA_REQUEST:
-            *tsdu = (tsdu_t *)d_data_request_decode(data, len);
+            *tsdu = (tsdu_t *)d_data_request_decode(data, len, arena);
             break;
 
         case D_DATAGRAM:
-            *tsdu = (tsdu_t *)d_datagram_decode(data, len);
+            *tsdu = (tsdu_t *)d_datagram_decode(data, len, arena);
             break;
 
         case D_DATAGRAM_NOTIFY:
-            *tsdu = (tsdu_t *)d_datagram_notify_decode(data, len);
+            *tsdu = (tsdu_t *)d_datagram_notify_decode(data, len, arena);
             break;
 
         case D_DCH_OPEN:
-            *tsdu = (tsdu_t *)d_dch_open_decode(data, len);
+            *tsdu = (tsdu_t *)d_dch_open_decode(data, len, arena);
             break;
 
         case D_ECH_OVERLOAD_ID:
-            *tsdu = (tsdu_t *)d_ech_overload_id_decode(data, len);
+            *tsdu = (tsdu_t *)d_ech_overload_id_decode(data, len, arena);
             break;
 
         case D_EXPLICIT_SHORT_DATA:
-            *tsdu = (tsdu_t *)d_explicit_short_data_decode(data, len);
+            *tsdu = (tsdu_t *)d_explicit_short_data_decode(data, len, arena);
             break;
 
         case D_FORCED_REGISTRATION:
-            *tsdu = (tsdu_t *)d_forced_registration_decode(data, len);
+            *tsdu = (tsdu_t *)d_forced_registration_decode(data, len, arena);
             break;
 
         case D_GROUP_ACTIVATION:
-            *tsdu = (tsdu_t *)d_group_activation_decode(data, len);
+            *tsdu = (tsdu_t *)d_group_activation_decode(data, len, arena);
             break;
 
         case D_GROUP_COMPOSITION:
-            *tsdu = (tsdu_t *)d_group_composition_decode(data, len);
+            *tsdu = (tsdu_t *)d_group_composition_decode(data, len, arena);
             break;
 
         case D_GROUP_LIST:
-            *tsdu = (tsdu_t *)d_group_list_decode(data, len);
+            *tsdu = (tsdu_t *)d_group_list_decode(data, len, arena);
             break;
 
         case D_GROUP_PAGING:
-            *tsdu = (tsdu_t *)d_group_paging_decode(data, len);
+            *tsdu = (tsdu_t *)d_group_paging_decode(data, len, arena);
             break;
 
         case D_GROUP_REJECT:
-            *tsdu = (tsdu_t *)d_group_reject_decode(data, len);
+            *tsdu = (tsdu_t *)d_group_reject_decode(data, len, arena);
             break;
 
         case D_HOOK_ON_INVITATION:
-            *tsdu = (tsdu_t *)d_hook_on_invitation_decode(data, len);
+            *tsdu = (tsdu_t *)d_hook_on_invitation_decode(data, len, arena);
             break;
 
         case D_LOCATION_ACTIVITY_ACK:
-            *tsdu = (tsdu_t *)d_location_activity_ack_decode(data, len);
+            *tsdu = (tsdu_t *)d_location_activity_ack_decode(data, len, arena);
             break;
 
         case D_NEIGHBOURING_CELL:
-            *tsdu = (tsdu_t *)d_neighbouring_cell_decode(data, len);
+            *tsdu = (tsdu_t *)d_neighbouring_cell_decode(data, len, arena);
             break;
 
         case D_SYSTEM_INFO:
-            *tsdu = (tsdu_t *)d_system_info_decode(data, len);
+            *tsdu = (tsdu_t *)d_system_info_decode(data, len, arena);
             break;
 
         case D_REGISTRATION_NAK:
-            *tsdu = (tsdu_t *)d_registration_nak_decode(data, len);
+            *tsdu = (tsdu_t *)d_registration_nak_decode(data, len, arena);
             break;
 
         case D_REGISTRATION_ACK:
-            *tsdu = (tsdu_t *)d_registration_ack_decode(data, len);
+            *tsdu = (tsdu_t *)d_registration_ack_decode(data, len, arena);
             break;
 
         case D_CONNECT_DCH:
-            *tsdu = (tsdu_t *)d_connect_dch_decode(data, len);
+            *tsdu = (tsdu_t *)d_connect_dch_decode(data, len, arena);
             break;
 
         case D_REFUSAL:
-            *tsdu = (tsdu_t *)d_refusal_decode(data, len);
+            *tsdu = (tsdu_t *)d_refusal_decode(data, len, arena);
             break;
 
         case D_REJECT:
-            *tsdu = (tsdu_t *)d_reject_decode(data, len);
+            *tsdu = (tsdu_t *)d_reject_decode(data, len, arena);
             break;
 
         case D_RELEASE:
-            *tsdu = (tsdu_t *)d_release_decode(data, len);
+            *tsdu = (tsdu_t *)d_release_decode(data, len, arena);
             break;
 
         case D_RETURN:
-            *tsdu = (tsdu_t *)d_return_decode(data, len);
+            *tsdu = (tsdu_t *)d_return_decode(data, len, arena);
             break;
 
         case D_GROUP_IDLE:
-            *tsdu = (tsdu_t *)d_group_idle_decode(data, len);
+            *tsdu = (tsdu_t *)d_group_idle_decode(data, len, arena);
             break;
 
         case U_AUTHENTICATION:
-            *tsdu = (tsdu_t *)u_authentication_decode(data, len);
+            *tsdu = (tsdu_t *)u_authentication_decode(data, len, arena);
             break;
 
         case U_CALL_CONNECT:
-            *tsdu = (tsdu_t *)u_call_connect_decode(data, len);
+            *tsdu = (tsdu_t *)u_call_connect_decode(data, len, arena);
             break;
 
         case U_DATA_REQUEST:
-            *tsdu = (tsdu_t *)u_data_request_decode(data, len);
+            *tsdu = (tsdu_t *)u_data_request_decode(data, len, arena);
             break;
 
         case U_REGISTRATION_REQ:
-            *tsdu = (tsdu_t *)u_registration_req_decode(data, len);
+            *tsdu = (tsdu_t *)u_registration_req_decode(data, len, arena);
             break;
 
         case U_TERMINATE:
-            *tsdu = (tsdu_t *)u_terminate_decode(data, len);
+            *tsdu = (tsdu_t *)u_terminate_decode(data, len, arena);
             break;
 
         case D_ACCESS_DISABLED:
@@ -1448,12 +1575,12 @@ int tsdu_decode(const uint8_t *data, int len, tsdu_t **tsdu)
         case U_OCH_SETUP:
         case U_TRANSFER_REQ:
             LOG(ERR, "Unsupported codop 0x%02x", codop);
-            *tsdu = (tsdu_t *)d_unknown_parse(data, len);
+            *tsdu = (tsdu_t *)d_unknown_parse(data, len, arena);
             break;
 
         default:
             LOG(WTF, "Unknown codop=0x%02x", codop);
-            *tsdu = (tsdu_t *)d_unknown_parse(data, len);
+            *tsdu = (tsdu_t *)d_unknown_parse(data, len, arena);
             break;
     }
 
@@ -1464,3 +1591,18 @@ int tsdu_decode(const uint8_t *data, int len, tsdu_t **tsdu)
     return 0;
 }
 
+int tsdu_decode(const uint8_t *data, int len, tsdu_t **tsdu)
+{
+    return tsdu_decode_(data, len, NULL, tsdu);
+}
+
+int tsdu_decode_arena(const uint8_t *data, int len, tsdu_arena_t *arena,
+        tsdu_t **tsdu)
+{
+    if (!arena) {
+        LOG(ERR, "arena == NULL");
+        return -1;
+    }
+
+    return tsdu_decode_(data, len, arena, tsdu);
+}
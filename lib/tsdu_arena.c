@@ -0,0 +1,131 @@
+#define LOG_PREFIX "tsdu_arena"
+
+#include <tetrapol/log.h>
+#include <tetrapol/tsdu_arena.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// allocation done by malloc when memory block is exhausted
+typedef struct overflow_t {
+    struct overflow_t *next;
+    uint64_t data[];
+} overflow_t;
+
+struct tsdu_arena_priv_t {
+    char *data;
+    int size;
+    int used;
+    int last;           ///< offset of the last allocation
+    overflow_t *overflow;
+};
+
+enum {
+    /// alignment of allocations, enough for members of TSDU structures
+    ALIGN = sizeof(uint64_t) > sizeof(void *) ?
+        sizeof(uint64_t) : sizeof(void *),
+};
+
+tsdu_arena_t *tsdu_arena_create(int size)
+{
+    tsdu_arena_t *arena = malloc(sizeof(tsdu_arena_t));
+    if (!arena) {
+        return NULL;
+    }
+
+    arena->data = malloc(size);
+    if (!arena->data) {
+        free(arena);
+        return NULL;
+    }
+    arena->size = size;
+    arena->used = 0;
+    arena->last = -1;
+    arena->overflow = NULL;
+
+    return arena;
+}
+
+void tsdu_arena_destroy(tsdu_arena_t *arena)
+{
+    if (!arena) {
+        return;
+    }
+    tsdu_arena_reset(arena);
+    free(arena->data);
+    free(arena);
+}
+
+void tsdu_arena_reset(tsdu_arena_t *arena)
+{
+    while (arena->overflow) {
+        overflow_t *next = arena->overflow->next;
+        free(arena->overflow);
+        arena->overflow = next;
+    }
+    arena->used = 0;
+    arena->last = -1;
+}
+
+static void *overflow_alloc(tsdu_arena_t *arena, int size)
+{
+    overflow_t *o = malloc(sizeof(overflow_t) + size);
+    if (!o) {
+        LOG(ERR, "ERR OOM");
+        return NULL;
+    }
+    LOG(DBG, "arena exhausted, size=%d used=%d", size, arena->used);
+    o->next = arena->overflow;
+    arena->overflow = o;
+
+    return o->data;
+}
+
+void *tsdu_arena_alloc(tsdu_arena_t *arena, int size)
+{
+    if (!arena) {
+        return malloc(size);
+    }
+
+    const int offs = (arena->used + ALIGN - 1) & ~(ALIGN - 1);
+    if (size > arena->size - offs) {
+        return overflow_alloc(arena, size);
+    }
+    arena->used = offs + size;
+    arena->last = offs;
+
+    return &arena->data[offs];
+}
+
+void *tsdu_arena_realloc(tsdu_arena_t *arena, void *ptr, int old_size,
+        int size)
+{
+    if (!arena) {
+        return realloc(ptr, size);
+    }
+
+    if (!ptr) {
+        return tsdu_arena_alloc(arena, size);
+    }
+
+    if (arena->last >= 0 && ptr == &arena->data[arena->last] &&
+            size <= arena->size - arena->last) {
+        arena->used = arena->last + size;
+        return ptr;
+    }
+
+    void *p = tsdu_arena_alloc(arena, size);
+    if (p) {
+        memcpy(p, ptr, (old_size < size) ? old_size : size);
+    }
+
+    return p;
+}
+
+void tsdu_arena_free(tsdu_arena_t *arena, void *ptr)
+{
+    if (!arena) {
+        free(ptr);
+    }
+}
@@ -1,89 +1,89 @@
 #define LOG_PREFIX "tsdu_json"
 
 #include <tetrapol/log.h>
-#include <tetrapol/misc.h>
 #include <tetrapol/tsdu_json.h>
 
 enum {
-    /// buffer large enough to satisfy all internal sprintf
-    SPRINTF_BUF_LEN = 32768,
+    /// longest data written as hex, longer are written as null
+    HEX_DATA_LEN_MAX = 16383,
 };
 
-static const char *addr_json(char *buf, const addr_t *addr)
+static void put_addr(out_buf_t *out, const addr_t *addr)
 {
-    sprintf(buf, "{ \"z\": %d, \"y\": %d, \"x\": %d }",
-            addr->z, addr->y, addr->x);
-    return buf;
+    out_buf_puts(out, "{ \"z\": ");
+    out_buf_put_int(out, addr->z);
+    out_buf_puts(out, ", \"y\": ");
+    out_buf_put_int(out, addr->y);
+    out_buf_puts(out, ", \"x\": ");
+    out_buf_put_int(out, addr->x);
+    out_buf_puts(out, " }");
 }
 
-void tsdu_json(const tpol_t *tpol, const tpol_tsdu_t *tsdu)
+/// write "name": val, pair, val is null when unknown
+static void put_int_or_null(out_buf_t *out, const char *name, int val,
+        int unknown)
 {
-    printf("{ \"event\": \"tsdu\", ");
-    printf("\"rx_offs\": %lu, ", tpol->rx_offs);
+    out_buf_putc(out, '"');
+    out_buf_puts(out, name);
+    if (val != unknown) {
+        out_buf_puts(out, "\": ");
+        out_buf_put_int(out, val);
+        out_buf_puts(out, ", ");
+    } else {
+        out_buf_puts(out, "\": null, ");
+    }
+}
 
-    printf("\"tsdu\": { ");
-    {
-        char buf[SPRINTF_BUF_LEN];  ///< buffer for sprintf
+void tsdu_json(const tpol_t *tpol, const tpol_tsdu_t *tsdu)
+{
+    out_buf_t *out = tpol->out;
 
-        if (tpol->frame_no != FRAME_NO_UNKNOWN) {
-            printf("\"frame_no\": %d, ", tpol->frame_no);
-        } else {
-            printf("\"frame_no\": null, ");
-        }
+    tetrapol_json_begin(tpol, "tsdu");
+    out_buf_puts(out, "\"rx_offs\": ");
+    out_buf_put_uint(out, tpol->rx_offs);
+    out_buf_puts(out, ", ");
 
-        const char *log_ch_str;
-        switch (tsdu->log_ch) {
-            case LOG_CH_BCH:    log_ch_str = "BCH";     break;
-            case LOG_CH_DACH:   log_ch_str = "DACH";    break;
-            case LOG_CH_PCH:    log_ch_str = "PCH";     break;
-            case LOG_CH_RACH:   log_ch_str = "RACH";    break;
-            case LOG_CH_RCH:    log_ch_str = "RCH";     break;
-            case LOG_CH_SDCH:   log_ch_str = "SDCH";    break;
-            case LOG_CH_SCH:    log_ch_str = "SCH";     break;
-            case LOG_CH_VCH:    log_ch_str = "VCH";     break;
+    out_buf_puts(out, "\"tsdu\": { ");
+    {
+        put_int_or_null(out, "frame_no", tpol->frame_no,
+                TETRAPOL_FRAME_NO_UNKNOWN);
 
-            default:
-                log_ch_str = "FIXME";
-        };
-        printf("\"log_ch\": \"%s\", ", log_ch_str);
-        printf("\"addr\": %s, ", addr_json(buf, &tsdu->addr));
+        out_buf_puts(out, "\"log_ch\": \"");
+        out_buf_puts(out, tetrapol_log_ch_str(tsdu->log_ch));
+        out_buf_puts(out, "\", \"addr\": ");
+        put_addr(out, &tsdu->addr);
+        out_buf_puts(out, ", ");
 
         const char *tpdu_type;
         switch (tsdu->tpdu_type) {
-            case TPDU_TYPE_TPDU:    tpdu_type = "TPDU";     break;
-            case TPDU_TYPE_TPDU_UI: tpdu_type = "TPDU_UI";  break;
-            default:                tpdu_type = "FIXME";
+            case TETRAPOL_TPDU_TYPE_TPDU:    tpdu_type = "TPDU";     break;
+            case TETRAPOL_TPDU_TYPE_TPDU_UI: tpdu_type = "TPDU_UI";  break;
+            default:                         tpdu_type = "FIXME";
         };
-        printf("\"tpdu_type\": \"%s\", ", tpdu_type);
+        out_buf_puts(out, "\"tpdu_type\": \"");
+        out_buf_puts(out, tpdu_type);
+        out_buf_puts(out, "\", ");
 
-        if (tsdu->tsap_id != TSAP_ID_UNKNOWN) {
-            printf("\"tsap_id\": %d, ", tsdu->tsap_id);
-        } else {
-            printf("\"tsap_id\": null, ");
-        }
+        put_int_or_null(out, "tsap_id", tsdu->tsap_id,
+                TETRAPOL_TSAP_ID_UNKNOWN);
 
-        if (tsdu->tpdu_type == TPDU_TYPE_TPDU) {
-            if (tsdu->tsap_ref_swmi != TSAP_REF_UNKNOWN) {
-                printf("\"tsap_ref_swmi\": %d, ", tsdu->tsap_ref_swmi);
-            } else {
-                printf("\"tsap_ref_swmi\": null, ");
-            }
-            if (tsdu->tsap_ref_rt != TSAP_REF_UNKNOWN) {
-                printf("\"tsap_ref_rt\": %d, ", tsdu->tsap_ref_rt);
-            } else {
-                printf("\"tsap_ref_rt\": null, ");
-            }
-        } else if (tsdu->tpdu_type == TPDU_TYPE_TPDU_UI) {
+        if (tsdu->tpdu_type == TETRAPOL_TPDU_TYPE_TPDU) {
+            put_int_or_null(out, "tsap_ref_swmi", tsdu->tsap_ref_swmi,
+                    TETRAPOL_TSAP_REF_UNKNOWN);
+            put_int_or_null(out, "tsap_ref_rt", tsdu->tsap_ref_rt,
+                    TETRAPOL_TSAP_REF_UNKNOWN);
+        } else if (tsdu->tpdu_type == TETRAPOL_TPDU_TYPE_TPDU_UI) {
         }
 
-        if ( (2 * tsdu->data_len + 1) <= sizeof(buf)) {
-            printf("\"data\": { \"encoding\": \"hex\", \"value\": \"%s\" } ",
-                    sprint_hex2(buf, tsdu->data, tsdu->data_len));
+        if (tsdu->data_len <= HEX_DATA_LEN_MAX) {
+            out_buf_puts(out, "\"data\": { \"encoding\": \"hex\", \"value\": \"");
+            out_buf_put_hex(out, tsdu->data, tsdu->data_len);
+            out_buf_puts(out, "\" } ");
         } else {
-            printf("\"data\": null");
+            out_buf_puts(out, "\"data\": null");
         }
     }
-    printf("} ");
+    out_buf_puts(out, "} ");
 
-    printf("}\n");
+    tetrapol_json_end(tpol);
 }
@@ -0,0 +1,303 @@
+#include <tetrapol/bit_utils.h>
+#include <tetrapol/viterbi.h>
+
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/*
+  Path metrics for all 4 starting states are evaluated at once. Trellis has
+  4 states, which gives 16 lanes of 8 bit metrics, lane 4 * state + start
+  holds metric of path from starting state 'start' into state 'state'.
+
+  Transitions into state d come from states d / 2 and d / 2 + 2, decision bit
+  for each lane is set when path from the second one is better.
+  */
+
+// unreachable state, keeps this value with saturating arithmetic
+#define METRIC_MAX 0xff
+#define SOFT_METRIC_MAX INT16_MAX
+
+// replicate value for each state into 4 lanes
+#define L4(a, b, c, d) a, a, a, a, b, b, b, b, c, c, c, c, d, d, d, d
+
+/**
+  Branch metrics for transitions from states 0, 1 into states 0, 1, 2, 3,
+  indexed by received bit pair (first bit in LSB). Branch metrics for
+  transitions from states 2, 3 are 2 - bm.
+  Encoder outputs for transitions are 0, 3, 1, 2 (and 3, 0, 2, 1).
+  */
+static const uint8_t bm_lanes[4][2][16] = {
+    { { L4(0, 2, 1, 1) }, { L4(2, 0, 1, 1) }, },
+    { { L4(1, 1, 0, 2) }, { L4(1, 1, 2, 0) }, },
+    { { L4(1, 1, 2, 0) }, { L4(1, 1, 0, 2) }, },
+    { { L4(2, 0, 1, 1) }, { L4(0, 2, 1, 1) }, },
+};
+
+/// encoder output for transition into state d from state d / 2 + 2 * sel,
+/// indexed by d + 4 * sel
+static const uint8_t viterbi_table[8] = { 0, 3, 1, 2, 3, 0, 2, 1 };
+
+static void init_metrics(uint8_t *metrics)
+{
+    memset(metrics, METRIC_MAX, 16);
+    for (int s = 0; s < 4; ++s) {
+        metrics[4 * s + s] = 0;
+    }
+}
+
+static void init_metrics_soft(int16_t *metrics)
+{
+    for (int i = 0; i < 16; ++i) {
+        metrics[i] = SOFT_METRIC_MAX;
+    }
+    for (int s = 0; s < 4; ++s) {
+        metrics[4 * s + s] = 0;
+    }
+}
+
+/**
+  Trace the best path back from its final state s.
+
+  @param path Output, decoded bits packed into words, first bit in LSB.
+  @return number of received bits which differ from the path
+  */
+static int traceback(uint64_t *path, const uint16_t *decisions,
+        const uint8_t *in_bits, int size, int s)
+{
+    int nerrs = 0;
+    int z = s;
+    path[0] = path[1] = 0;
+    for (int p = 0; p < size; ++p) {
+        const int k = (size + p - 2) % size;
+        path[k / 64] |= (uint64_t)(z & 1) << (k % 64);
+        const int sel = (decisions[p] >> (4 * z + s)) & 1;
+        const int e = viterbi_table[z + 4 * sel];
+        nerrs += (in_bits[2*p] != (e & 1)) + (in_bits[2*p + 1] != (e >> 1));
+        z = z / 2 + 2 * sel;
+    }
+
+    return nerrs;
+}
+
+/// costs of all 4 possible encoder outputs for received bit pair
+static inline void branch_costs(int *c, const uint8_t *in_bits,
+        const uint8_t *in_rel)
+{
+    for (int e = 0; e < 4; ++e) {
+        c[e] = (in_bits[0] != (e & 1)) * in_rel[0] +
+            (in_bits[1] != (e >> 1)) * in_rel[1];
+    }
+}
+
+#ifdef __SSE2__
+
+static void forward(uint8_t *metrics, uint16_t *decisions,
+        const uint8_t *in_bits, int size)
+{
+    __m128i m = _mm_loadu_si128((const __m128i *)metrics);
+
+    for (int p = size - 1; p >= 0; --p) {
+        const int r = in_bits[2*p] | (in_bits[2*p + 1] << 1);
+        const __m128i bm1 = _mm_loadu_si128((const __m128i *)bm_lanes[r][0]);
+        const __m128i bm2 = _mm_loadu_si128((const __m128i *)bm_lanes[r][1]);
+
+        const __m128i m1 = _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 1, 0, 0));
+        const __m128i m2 = _mm_shuffle_epi32(m, _MM_SHUFFLE(3, 3, 2, 2));
+        const __m128i c1 = _mm_adds_epu8(m1, bm1);
+        const __m128i c2 = _mm_adds_epu8(m2, bm2);
+        m = _mm_min_epu8(c1, c2);
+        decisions[p] = ~_mm_movemask_epi8(_mm_cmpeq_epi8(m, c1));
+    }
+
+    _mm_storeu_si128((__m128i *)metrics, m);
+}
+
+/*
+  Soft metrics are 16 bit, a holds lanes of states 0, 1 and b lanes of
+  states 2, 3.
+  */
+static void forward_soft(int16_t *metrics, uint16_t *decisions,
+        const uint8_t *in_bits, const uint8_t *in_rel, int size)
+{
+    __m128i a = _mm_loadu_si128((const __m128i *)metrics);
+    __m128i b = _mm_loadu_si128((const __m128i *)(metrics + 8));
+
+    for (int p = size - 1; p >= 0; --p) {
+        int c[4];
+        branch_costs(c, &in_bits[2*p], &in_rel[2*p]);
+
+#define SET_BM(c0, c1) \
+        _mm_set_epi16(c1, c1, c1, c1, c0, c0, c0, c0)
+        const __m128i bm1a = SET_BM(c[0], c[3]);
+        const __m128i bm2a = SET_BM(c[3], c[0]);
+        const __m128i bm1b = SET_BM(c[1], c[2]);
+        const __m128i bm2b = SET_BM(c[2], c[1]);
+#undef SET_BM
+
+        const __m128i ca1 = _mm_adds_epi16(_mm_unpacklo_epi64(a, a), bm1a);
+        const __m128i ca2 = _mm_adds_epi16(_mm_unpacklo_epi64(b, b), bm2a);
+        const __m128i cb1 = _mm_adds_epi16(_mm_unpackhi_epi64(a, a), bm1b);
+        const __m128i cb2 = _mm_adds_epi16(_mm_unpackhi_epi64(b, b), bm2b);
+        a = _mm_min_epi16(ca1, ca2);
+        b = _mm_min_epi16(cb1, cb2);
+        decisions[p] = ~_mm_movemask_epi8(_mm_packs_epi16(
+                    _mm_cmpeq_epi16(a, ca1), _mm_cmpeq_epi16(b, cb1)));
+    }
+
+    _mm_storeu_si128((__m128i *)metrics, a);
+    _mm_storeu_si128((__m128i *)(metrics + 8), b);
+}
+
+#else
+
+static inline uint8_t adds_u8(uint8_t a, uint8_t b)
+{
+    const unsigned s = a + b;
+    return (s > METRIC_MAX) ? METRIC_MAX : s;
+}
+
+static void forward(uint8_t *metrics, uint16_t *decisions,
+        const uint8_t *in_bits, int size)
+{
+    for (int p = size - 1; p >= 0; --p) {
+        const int r = in_bits[2*p] | (in_bits[2*p + 1] << 1);
+
+        uint8_t m[16];
+        uint16_t dec = 0;
+        for (int i = 0; i < 16; ++i) {
+            const int d = i / 4;
+            const int s = i % 4;
+            const uint8_t c1 = adds_u8(metrics[4 * (d / 2) + s],
+                    bm_lanes[r][0][i]);
+            const uint8_t c2 = adds_u8(metrics[4 * (d / 2 + 2) + s],
+                    bm_lanes[r][1][i]);
+            const uint8_t sel = c2 < c1;
+            m[i] = sel ? c2 : c1;
+            dec |= sel << i;
+        }
+        memcpy(metrics, m, sizeof(m));
+        decisions[p] = dec;
+    }
+}
+
+static void forward_soft(int16_t *metrics, uint16_t *decisions,
+        const uint8_t *in_bits, const uint8_t *in_rel, int size)
+{
+    for (int p = size - 1; p >= 0; --p) {
+        int c[4];
+        branch_costs(c, &in_bits[2*p], &in_rel[2*p]);
+
+        int16_t m[16];
+        uint16_t dec = 0;
+        for (int i = 0; i < 16; ++i) {
+            const int d = i / 4;
+            const int s = i % 4;
+            int c1 = metrics[4 * (d / 2) + s] + c[viterbi_table[d]];
+            int c2 = metrics[4 * (d / 2 + 2) + s] + c[viterbi_table[d + 4]];
+            c1 = (c1 > SOFT_METRIC_MAX) ? SOFT_METRIC_MAX : c1;
+            c2 = (c2 > SOFT_METRIC_MAX) ? SOFT_METRIC_MAX : c2;
+            const uint8_t sel = c2 < c1;
+            m[i] = sel ? c2 : c1;
+            dec |= sel << i;
+        }
+        memcpy(metrics, m, sizeof(m));
+        decisions[p] = dec;
+    }
+}
+
+#endif
+
+/// find the best path which ends in its starting state, the lowest state wins
+static int decode(uint64_t *path, const uint8_t *in_bits, int size)
+{
+    uint8_t metrics[16];
+    uint16_t decisions[VITERBI_MAX_SIZE];
+
+    init_metrics(metrics);
+    forward(metrics, decisions, in_bits, size);
+
+    int s = 0;
+    for (int i = 1; i < 4; ++i) {
+        if (metrics[4 * i + i] < metrics[4 * s + s]) {
+            s = i;
+        }
+    }
+
+    return traceback(path, decisions, in_bits, size, s);
+}
+
+static int decode_soft(uint64_t *path, const uint8_t *in_bits,
+        const uint8_t *in_rel, int size)
+{
+    int16_t metrics[16];
+    uint16_t decisions[VITERBI_MAX_SIZE];
+
+    init_metrics_soft(metrics);
+    forward_soft(metrics, decisions, in_bits, in_rel, size);
+
+    int s = 0;
+    for (int i = 1; i < 4; ++i) {
+        if (metrics[4 * i + i] < metrics[4 * s + s]) {
+            s = i;
+        }
+    }
+
+    return traceback(path, decisions, in_bits, size, s);
+}
+
+static void unpack_path(uint8_t *dec, const uint64_t *path, int size)
+{
+    for (int i = 0; i < size; ++i) {
+        dec[i] = (path[i / 64] >> (i % 64)) & 1;
+    }
+}
+
+static void put_path(uint64_t *dec, int offs, const uint64_t *path, int size)
+{
+    for (int i = 0; i < size; i += 64) {
+        const int len = (size - i < 64) ? size - i : 64;
+        put_word_bits(dec, offs + i, len, path[i / 64]);
+    }
+}
+
+int viterbi_decode(uint8_t *dec, const uint8_t *in_bits, int size)
+{
+    uint64_t path[2];
+    const int nerrs = decode(path, in_bits, size);
+    unpack_path(dec, path, size);
+
+    return nerrs;
+}
+
+int viterbi_decode_soft(uint8_t *dec, const uint8_t *in_bits,
+        const uint8_t *in_rel, int size)
+{
+    uint64_t path[2];
+    const int nerrs = decode_soft(path, in_bits, in_rel, size);
+    unpack_path(dec, path, size);
+
+    return nerrs;
+}
+
+int viterbi_decode_bits(uint64_t *dec, int offs, const uint8_t *in_bits,
+        int size)
+{
+    uint64_t path[2];
+    const int nerrs = decode(path, in_bits, size);
+    put_path(dec, offs, path, size);
+
+    return nerrs;
+}
+
+int viterbi_decode_soft_bits(uint64_t *dec, int offs, const uint8_t *in_bits,
+        const uint8_t *in_rel, int size)
+{
+    uint64_t path[2];
+    const int nerrs = decode_soft(path, in_bits, in_rel, size);
+    put_path(dec, offs, path, size);
+
+    return nerrs;
+}